@@ -0,0 +1,64 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "polyscope/utilities.h"
+
+namespace polyscope {
+
+// Which triangles a ray cast should pass through, by the side the ray approaches from. The front side is the one from
+// which the vertices appear counter-clockwise.
+enum class RayCastFaceCull { None, Back, Front };
+
+// The nearest intersection of a ray with a set of triangles
+struct TriangleRayHit {
+  bool isHit = false;
+  size_t triangle = INVALID_IND; // index of the triangle in the list the BVH was built from
+  float t = std::numeric_limits<float>::infinity(); // the hit is at origin + t * dir
+  glm::vec3 baryCoords{0., 0., 0.};                 // barycentric coordinates of the hit within the triangle
+};
+
+// A bounding volume hierarchy over a list of triangles, for casting rays against meshes on the CPU.
+//
+// The tree is built top-down, choosing each split with the surface area heuristic evaluated over a fixed number of
+// bins. The top of the tree is built serially (binning in parallel), then the remaining subtrees are built in
+// parallel. The triangle corners are copied in to leaf order, so the BVH does not reference the input after building.
+class TriangleBVH {
+public:
+  // Build over the triangles, given as 3 vertex indices each. Triangles with out-of-range indices are skipped.
+  void build(const std::vector<glm::vec3>& vertexPositions, const std::vector<uint32_t>& triangleVertexInds);
+  void clear();
+
+  bool isBuilt() const { return built; }
+  size_t nTriangles() const { return triangleOrder.size(); }
+
+  // Find the nearest hit of the ray origin + t * dir with t in [tMin, tMax]. dir need not be normalized.
+  TriangleRayHit rayCast(glm::vec3 origin, glm::vec3 dir, float tMin = 0.,
+                         float tMax = std::numeric_limits<float>::infinity(),
+                         RayCastFaceCull cull = RayCastFaceCull::None) const;
+
+private:
+  // Interior nodes have count == 0, and their children are at nodes[first] and nodes[first + 1]. Leaves hold the
+  // triangles triangleOrder[first] to triangleOrder[first + count].
+  struct Node {
+    glm::vec3 bboxMin;
+    uint32_t first;
+    glm::vec3 bboxMax;
+    uint32_t count;
+  };
+  struct Builder;
+
+  bool built = false;
+  std::vector<Node> nodes;
+  std::vector<uint32_t> triangleOrder;    // original index of each triangle, in leaf order
+  std::vector<glm::vec3> triangleCorners; // 3 per triangle, in leaf order
+};
+
+} // namespace polyscope
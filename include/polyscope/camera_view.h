@@ -41,6 +41,7 @@ public:
   virtual void drawPick() override;
   virtual void drawPickDelayed() override;
   virtual void updateObjectSpaceBounds() override;
+  virtual float getCullingPadding() override;
   virtual std::string typeName() override;
   virtual void refresh() override;
 
@@ -107,9 +107,28 @@ struct Context {
 
   PickResult currSelectionPickResult;
   bool haveSelectionVal = false;
+  std::vector<RegionPickResult> regionSelection;
+  bool pickBufferValid = false; // the last render of the pick buffer can be reused, see renderPickBuffer()
+  uint64_t pickBufferFramebufferID = 0;
+  glm::mat4 pickBufferViewMat, pickBufferProjMat;
   uint64_t nextPickBufferInd = 1;
-  std::unordered_map<Structure*, std::tuple<uint64_t, uint64_t>> structureRanges;
-  std::unordered_map<Quantity*, std::tuple<uint64_t, uint64_t>> quantityRanges;
+  uint64_t nextPickRangeAllocationID = 0;
+  std::map<uint64_t, pick::PickBufferRange> pickRanges; // allocated ranges, by start index
+  std::unordered_map<Structure*, uint64_t> structurePickRangeStarts;
+  std::unordered_map<Quantity*, uint64_t> quantityPickRangeStarts;
+  std::map<uint64_t, uint64_t> freePickRanges;                  // released ranges below nextPickBufferInd, start -> end
+  std::set<std::pair<uint64_t, uint64_t>> freePickRangesBySize; // the same ranges, as (size, start)
+
+  // ======================================================
+  // === Culling globals, see renderScene()
+  // ======================================================
+
+  bool cullingPassValid = false; // while rendering the scene, culledStructures holds the result for cullingViewProjMat
+  glm::mat4 cullingViewProjMat;
+  std::unordered_set<Structure*> culledStructures;
+  size_t cullingStructuresTested = 0;
+  size_t cullingCulledByFrustum = 0;
+  size_t cullingCulledBySlicePlanes = 0;
 
   // ======================================================
   // === Internal globals from internal.h
@@ -50,6 +50,7 @@ public:
   virtual void buildCustomUI() override;
   virtual void buildCustomOptionsUI() override;
   virtual void buildPickUI(const PickResult&) override;
+  virtual std::vector<uint64_t> pickIndicesInRegion(const PickRegion& region) override;
 
   virtual void draw() override;
   virtual void drawDelayed() override;
@@ -57,6 +58,8 @@ public:
   virtual void drawPickDelayed() override;
 
   virtual void updateObjectSpaceBounds() override;
+  virtual bool ensureCullingBoundsCurrent() override;
+  virtual float getCullingPadding() override;
   virtual std::string typeName() override;
 
   virtual void refresh() override;
@@ -162,6 +165,8 @@ public:
 
 
 private:
+  uint64_t boundsPositionsUpdateCount = INVALID_IND_64; // update count of the positions the bounds are from
+
   // Storage for the managed buffers above. You should generally interact with these through the managed buffers, not
   // these members.
   std::vector<glm::vec3> nodePositionsData;
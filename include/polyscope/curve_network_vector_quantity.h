@@ -34,6 +34,7 @@ public:
   virtual void draw() override;
   virtual void buildCustomUI() override;
   virtual std::string niceName() override;
+  virtual float getCullingPadding() override;
   virtual void refresh() override;
   virtual void buildNodeInfoGUI(size_t vInd) override;
 };
@@ -50,6 +51,7 @@ public:
   virtual void draw() override;
   virtual void buildCustomUI() override;
   virtual std::string niceName() override;
+  virtual float getCullingPadding() override;
   virtual void refresh() override;
   virtual void buildEdgeInfoGUI(size_t vInd) override;
 };
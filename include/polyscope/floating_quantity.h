@@ -14,6 +14,7 @@ public:
   virtual ~FloatingQuantity() {};
 
   virtual void buildUI() override;
+  virtual float getCullingPadding() override; // (images and the like may be drawn anywhere on the screen)
 };
 
 
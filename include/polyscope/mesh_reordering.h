@@ -0,0 +1,30 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace polyscope {
+
+// Compute an order in which to draw the faces of a mesh so that nearby faces are drawn together. The faces (which may
+// be polygons) are given in the usual flat layout, with the vertices of face i at faceVertexInds[faceStart[i]] to
+// faceVertexInds[faceStart[i+1]]. Returns a permutation of the faces: entry i is the face to draw i'th.
+//
+// The faces are first sorted along a Morton curve through their centers, which keeps runs of consecutive faces (like
+// meshlets) compact in space. Then each block of blockSize consecutive faces is reordered with Forsyth's linear-speed
+// vertex cache optimization, which greedily picks the next face to reuse the most recently drawn vertices. The blocks
+// are independent, so this part runs in parallel.
+std::vector<uint32_t> computeFaceDrawOrder(const std::vector<glm::vec3>& vertexPositions,
+                                           const std::vector<uint32_t>& faceStart,
+                                           const std::vector<uint32_t>& faceVertexInds, size_t blockSize = 4096);
+
+// Same as above, for a list of triangles (3 vertex indices each)
+std::vector<uint32_t> computeTriangleDrawOrder(const std::vector<glm::vec3>& vertexPositions,
+                                               const std::vector<uint32_t>& triangleVertexInds,
+                                               size_t blockSize = 4096);
+
+} // namespace polyscope
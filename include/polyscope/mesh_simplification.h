@@ -0,0 +1,36 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace polyscope {
+
+// One level of a simplified triangle mesh hierarchy. The simplified mesh has no vertices of its own: each is one of
+// the original vertices, chosen to represent all of the nearby vertices merged in to it. This means any per-vertex
+// data of the original mesh can be used directly with the simplified triangles.
+struct SimplifiedMeshLevel {
+  float error;                              // bound on how far the surface moved, in the units of the positions
+  std::vector<uint32_t> triangleVertexInds; // 3 per triangle, indices of original vertices
+};
+
+// Build successively coarser simplifications of a triangle mesh, each with roughly a quarter of the triangles of the
+// last, stopping once a level has at most minTriangles triangles or there are maxLevels levels.
+//
+// Each level merges the vertices within each cell of a uniform grid (with twice the cell width of the level before),
+// in to the vertex of the cell with the lowest quadric error with respect to the planes of all the triangles incident
+// on the cell (Lindstrom 2000). Triangles which become degenerate are dropped. Unlike greedy edge collapses, every
+// step of this runs in parallel, and it only needs a small fixed amount of memory per vertex.
+//
+// If cancel is given and becomes true while building, the build stops before the next level and returns no levels.
+std::vector<SimplifiedMeshLevel> buildSimplifiedMeshHierarchy(const std::vector<glm::vec3>& vertexPositions,
+                                                              const std::vector<uint32_t>& triangleVertexInds,
+                                                              size_t minTriangles = 1024, size_t maxLevels = 8,
+                                                              const std::atomic<bool>* cancel = nullptr);
+
+} // namespace polyscope
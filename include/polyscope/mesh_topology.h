@@ -0,0 +1,47 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace polyscope {
+
+// Connectivity helpers for meshes, written to scale to very large inputs (tens of millions of faces). Triangle meshes
+// are given as a flat list of 3 vertex indices per triangle. Halfedge 3*iF+j of triangle iF points from its j'th
+// vertex to its (j+1)%3'th vertex.
+
+// The unique edges of a triangle mesh. Edges are numbered in Polyscope's canonical ordering: the order in which they
+// are first encountered when iterating over halfedges.
+struct EdgeTopology {
+  size_t nEdges = 0;
+  std::vector<uint32_t> halfedgeEdge; // for each halfedge, the index of its edge
+
+  // For each halfedge, another halfedge along the same edge, or INVALID_IND_32 if there is none. Edges with many
+  // incident halfedges are joined to the first of them in halfedge order (and the first to the second).
+  // (only populated if requested)
+  std::vector<uint32_t> halfedgeTwin;
+};
+
+// Edges are found by bucketing the halfedges by their smaller vertex, then sorting each bucket by packed 64-bit
+// (larger vertex, halfedge) keys, all in parallel. This uses a small fixed amount of memory per halfedge, rather
+// than hashing each edge. Throws if a vertex index is >= nVertices.
+EdgeTopology buildEdgeTopology(const std::vector<uint32_t>& triangleVertexInds, size_t nVertices,
+                               bool computeTwins = false);
+
+// The faces incident on each vertex, in compressed sparse row form: the faces incident on vertex iV are
+// faceInds[vertexStart[iV]] ... faceInds[vertexStart[iV+1]-1], in increasing order. A face is listed once for each
+// time the vertex appears in it. This allows per-vertex sums over faces to be computed as a parallel gather, rather
+// than a scatter which would have conflicting writes.
+struct VertexFaceAdjacency {
+  std::vector<uint32_t> vertexStart; // [nVertices + 1]
+  std::vector<uint32_t> faceInds;
+};
+
+// Takes a polygon mesh in the same flat format as SurfaceMesh (faceIndsStart has nFaces+1 entries). Throws if a
+// vertex index is >= nVertices.
+VertexFaceAdjacency buildVertexFaceAdjacency(const std::vector<uint32_t>& faceIndsStart,
+                                             const std::vector<uint32_t>& faceIndsEntries, size_t nVertices);
+
+} // namespace polyscope
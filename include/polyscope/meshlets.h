@@ -0,0 +1,56 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace polyscope {
+
+// A meshlet is a contiguous run of triangles in a mesh's draw order, along with conservative bounds which allow the
+// whole run to be skipped when it cannot be visible. All quantities are in the object space of the mesh.
+struct Meshlet {
+  uint32_t triangleStart;
+  uint32_t triangleCount;
+
+  // bounding sphere
+  glm::vec3 center;
+  float radius;
+
+  // Normal cone: every triangle normal is within the cone around coneAxis. coneCutoff is the sine of the cone's half
+  // angle, or 1 if the normals are too spread out for the cone to be useful.
+  glm::vec3 coneAxis;
+  float coneCutoff;
+};
+
+// Split the triangles (3 vertex indices each) in to meshlets of at most trianglesPerMeshlet consecutive triangles.
+// Meshlets respect the existing triangle order, so they are only spatially coherent if that order is.
+std::vector<Meshlet> buildMeshlets(const std::vector<glm::vec3>& vertexPositions,
+                                   const std::vector<uint32_t>& triangleVertexInds, size_t trianglesPerMeshlet = 128);
+
+// The view to cull meshlets against, expressed in the object space of the mesh
+struct MeshletCullView {
+  std::array<glm::vec4, 6> frustumPlanes; // inward-facing, with unit normals
+  std::vector<glm::vec4> clipPlanes;      // geometry with dot(xyz, p) + w < 0 is discarded, with unit normals
+  bool cullBackfaces = false;             // if true, use the normal cones to skip meshlets which are all back-facing
+  bool orthographic = false;
+  glm::vec3 cameraPosition; // used for perspective views
+  glm::vec3 viewDirection;  // used for orthographic views
+};
+
+// Build the cull view for a mesh with the given model matrix, from the current camera and the given slice planes
+// (as world-space (center, normal) pairs).
+MeshletCullView buildMeshletCullView(const glm::mat4& modelMat, const glm::mat4& viewMat, const glm::mat4& projMat,
+                                     bool orthographic,
+                                     const std::vector<std::array<glm::vec3, 2>>& worldSlicePlanes,
+                                     bool cullBackfaces);
+
+// Cull the meshlets and return the surviving triangles as a compacted list of (start, count) ranges of triangle
+// corners (3 per triangle), suitable for a multi-draw. Adjacent visible meshlets are merged in to a single range.
+std::vector<std::array<uint32_t, 2>> cullMeshlets(const std::vector<Meshlet>& meshlets, const MeshletCullView& view);
+
+} // namespace polyscope
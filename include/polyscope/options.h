@@ -53,6 +53,9 @@ extern bool usePrefsFile;
 // Should we redraw every frame, even if not requested? (default: false)
 extern bool alwaysRedraw;
 
+// Skip drawing structures which are entirely outside of the view, or removed by a slice plane (default: true)
+extern bool enableCulling;
+
 // Should we center/scale every structure after it is loaded up (default: false)
 extern bool autocenterStructures;
 extern bool autoscaleStructures;
@@ -108,6 +111,20 @@ extern float uiScale;
 extern TransparencyMode transparencyMode;
 extern int transparencyRenderPasses;
 
+// Reorder the triangles of meshes when they are registered, so that they draw more efficiently (see
+// computeFaceDrawOrder() in mesh_reordering.h). This is invisible to users: all indexing and picking still refers to
+// the original elements. It costs some time at registration, so it is off by default. (default: false)
+extern bool optimizeMeshDrawOrder;
+
+// Answer pick queries by casting a ray against the structures on the CPU (see rayCast() in pick.h), rather than
+// rendering the pick buffer. This is only done when every enabled structure supports it, otherwise picking falls back
+// on the pick buffer as usual. (default: false)
+extern bool pickWithRayCast;
+
+// Region selections made in the UI also select elements hidden behind others (see pickInScreenRectangle() in pick.h).
+// (default: false)
+extern bool regionSelectionIncludesOccluded;
+
 // === Advanced ImGui configuration
 
 // If false, Polyscope will not create any ImGui UIs at all, but will still set up ImGui and invoke its render steps
@@ -157,6 +174,12 @@ extern std::function<std::tuple<ImFont*, ImFont*>(ImFontAtlas*)> prepareImGuiFon
 // (default is -1 which means try all of them)
 extern int eglDeviceIndex;
 
+// A soft limit, in bytes, on the host-side memory used by managed data buffers. Once data has been uploaded to the
+// render device, the host-side copies of the least-recently-used buffers are freed at the end of each frame to stay
+// under this limit. They are transparently restored (by copying back from the device, or recomputing) the next time
+// they are accessed. (default: 0, which means no limit)
+extern size_t hostBufferMemoryBudget;
+
 // === Debug options
 
 // Enables optional error checks in the rendering system
@@ -165,5 +188,9 @@ extern bool enableRenderErrorChecks;
 // Render the pick buffer to screen rather than the regular scene
 extern bool debugDrawPickBuffer;
 
+// Record the CPU and GPU time spent in each part of the frame, and show it in a window (see profiler.h)
+// (default: false)
+extern bool enableProfiler;
+
 } // namespace options
 } // namespace polyscope
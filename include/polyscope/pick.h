@@ -2,10 +2,14 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "polyscope/utilities.h"
 #include "polyscope/weak_handle.h"
@@ -15,6 +19,9 @@ namespace polyscope {
 // Forward decls
 class Structure;
 class Quantity;
+namespace render {
+class ReadbackRequest;
+}
 
 // == Main query
 
@@ -45,6 +52,94 @@ struct PickResult {
 PickResult pickAtScreenCoords(glm::vec2 screenCoords); // takes screen coordinates
 PickResult pickAtBufferInds(glm::ivec2 bufferInds);    // takes indices into render buffer
 
+// == Asynchronous pick queries
+// The functions above wait for the render device to finish drawing the pick buffer before reading it, which stalls
+// the render loop. These versions render the pick buffer immediately, but copy the result back in the background, so
+// it can be collected on a later frame. Use them for continuous queries, like inspecting what is under the mouse
+// every frame.
+class PickQuery {
+public:
+  bool isReady();         // true once getResult() will not block
+  PickResult getResult(); // waits for the result if it has not arrived yet
+
+private:
+  friend std::shared_ptr<PickQuery> pickAtBufferIndsAsync(glm::ivec2 bufferInds);
+
+  glm::ivec2 bufferInds;
+  glm::mat4 viewMat, projMat;         // the camera when the query was issued
+  uint64_t pickRangeAllocationID = 0; // ranges with this allocationID or later were not in the pick buffer read
+  std::shared_ptr<render::ReadbackRequest> colorReadback;
+  std::shared_ptr<render::ReadbackRequest> depthReadback;
+  bool resultReady = false;
+  PickResult result;
+};
+
+std::shared_ptr<PickQuery> pickAtScreenCoordsAsync(glm::vec2 screenCoords); // takes screen coordinates
+std::shared_ptr<PickQuery> pickAtBufferIndsAsync(glm::ivec2 bufferInds);    // takes indices into render buffer
+
+
+// == Ray casting
+// Ray casts intersect a ray with the structures in the scene on the CPU, without a render pass or pick buffer indices.
+// Each structure builds a bounding volume hierarchy over its triangles the first time it is ray cast (see bvh.h).
+// Currently surface meshes, simple triangle meshes, and the boundary of volume meshes can be hit; other structures are
+// ignored. Slice planes are respected, but whole-element culling is not.
+
+// Return type for ray casts
+struct RayCastResult {
+  bool isHit = false;
+  Structure* structure = nullptr;
+  WeakHandle<Structure> structureHandle; // same as .structure, but with lifetime tracking
+  std::string structureType = "";
+  std::string structureName = "";
+  size_t faceIndex = INVALID_IND; // the face which was hit (for a simple triangle mesh, the triangle)
+  size_t cellIndex = INVALID_IND; // for a volume mesh, the cell the face belongs to
+  std::array<size_t, 3> triangleVertices{{INVALID_IND, INVALID_IND, INVALID_IND}}; // the triangle of the face hit
+  glm::vec3 baryCoords{0., 0., 0.}; // barycentric coordinates of the hit within that triangle
+  glm::vec3 position;               // in world coordinates
+  float distance = std::numeric_limits<float>::infinity(); // in world units, from the ray origin
+};
+
+// Find the nearest hit along a world-space ray, up to maxDistance from the origin
+RayCastResult rayCast(glm::vec3 origin, glm::vec3 dir, float maxDistance = std::numeric_limits<float>::infinity());
+
+
+// == Region selection
+// Region selections return every element drawn inside a rectangle or lasso on the screen. They render the pick buffer
+// once and read back the whole region in a single transfer. Each element appears once in the result, grouped by the
+// structure (or quantity) it belongs to.
+//
+// With includeOccluded, elements hidden behind others are also selected if their position projects inside the region.
+// This is tested on the CPU, and currently supported for the points of point clouds, the vertices and faces of surface
+// meshes, and the nodes and edges of curve networks.
+
+// Return type for region selections, one for each structure (or quantity) with anything in the region
+struct RegionPickResult {
+  Structure* structure = nullptr;
+  Quantity* quantity = nullptr;
+  WeakHandle<Structure> structureHandle; // same as .structure, but with lifetime tracking
+  std::string structureType = "";
+  std::string structureName = "";
+  std::string quantityName = "";
+  std::vector<uint64_t> localIndices; // sorted, each means the same as a PickResult::localIndex
+};
+
+// The region is given in screen coordinates, as two opposite corners of a rectangle, or the vertices of a polygon
+std::vector<RegionPickResult> pickInScreenRectangle(glm::vec2 screenCornerA, glm::vec2 screenCornerB,
+                                                    bool includeOccluded = false);
+std::vector<RegionPickResult> pickInScreenLasso(const std::vector<glm::vec2>& screenPolygon,
+                                                bool includeOccluded = false);
+
+// A region of the render buffer, used to test positions during region selection (internal)
+struct PickRegion {
+  glm::mat4 viewProjMat;
+  glm::vec2 bufferSize;
+  glm::vec2 bboxMin, bboxMax;   // bounds of the region, in buffer coordinates
+  std::vector<glm::vec2> lasso; // the polygon, in buffer coordinates, or empty if the region is the whole box
+
+  bool containsBufferPoint(glm::vec2 bufferCoords) const;
+  bool containsWorldPoint(glm::vec3 worldPos) const; // true if in the view frustum and projecting inside the region
+};
+
 
 // == Stateful picking: track and update a current selection
 
@@ -56,6 +151,12 @@ bool haveSelection();
 void resetSelectionIfStructure(Structure* s); // If something from this structure is selected, clear the selection
                                               // (useful if a structure is being deleted)
 
+// Get/Set the region selection, made in the UI by ctrl-dragging a rectangle or ctrl-alt-dragging a lasso
+std::vector<RegionPickResult> getRegionSelection();
+void setRegionSelection(std::vector<RegionPickResult> newSelection);
+void resetRegionSelection();
+bool haveRegionSelection();
+
 namespace pick {
 
 // Old, deprecated picking API. Use the above functions instead.
@@ -70,16 +171,42 @@ std::tuple<Structure*, Quantity*, uint64_t> evaluatePickQueryFull(int xPos,
 
 // == Helpers
 
+// Draw all structures to the pick buffer, for a query at the given buffer coordinates (internal). Returns false if
+// there is nothing to read back, because the location is outside the buffer or the buffer could not be bound.
+// The buffer is only re-rendered if something has changed since the last call; see invalidatePickBuffer().
+bool renderPickBuffer(int xPos, int yPos);
+
+// Mark the pick buffer as out of date, so the next query renders it again (internal). This happens on
+// requestRedraw(), and whenever pick indices are allocated or released. Camera and buffer size changes are detected
+// automatically.
+void invalidatePickBuffer();
+
 // Set up picking (internal)
 // Called by a structure/quantity to figure out what data it should render to the pick buffer.
 // Request 'count' contiguous indices for drawing a pick buffer. The return value is the start of the range.
 uint64_t requestPickBufferRange(Structure* requestingStructure, uint64_t count);
 uint64_t requestPickBufferRange(Quantity* requestingQuantity, uint64_t count);
 
+// Return pick indices to be reused (internal). A structure or quantity holds at most one range: requesting a new one
+// releases the old one, and removing a structure releases its range along with those of its quantities.
+void releasePickBufferRange(Quantity* quantity);
+void releasePickBufferRanges(Structure* structure);
+
+// An allocated range of pick indices, which runs from its start (the key it is stored under) to end (internal)
+struct PickBufferRange {
+  uint64_t end;
+  Structure* structure;  // for quantity ranges, the parent structure of the quantity
+  Quantity* quantity;    // null for structure ranges
+  uint64_t allocationID; // increases with every allocation, so reads from an older pick buffer can be checked
+};
+
 // Convert between global pick indexing for the whole program, and local per-structure pick indexing
 std::tuple<Structure*, Quantity*, uint64_t> globalIndexToLocal(uint64_t globalInd);
 uint64_t localIndexToGlobal(std::tuple<Structure*, Quantity*, uint64_t> localPick);
 
+// True if the global index lies in a range which was allocated before the given PickBufferRange::allocationID
+bool pickIndexAllocatedBefore(uint64_t globalInd, uint64_t allocationID);
+
 // Convert indices to float3 color and back
 // Structures will want to use these to fill their pick buffers
 inline glm::vec3 indToVec(uint64_t globalInd);
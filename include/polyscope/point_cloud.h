@@ -52,11 +52,14 @@ public:
   virtual void buildPickUI(const PickResult& result) override;
 
   // Standard structure overrides
+  virtual std::vector<uint64_t> pickIndicesInRegion(const PickRegion& region) override;
   virtual void draw() override;
   virtual void drawDelayed() override;
   virtual void drawPick() override;
   virtual void drawPickDelayed() override;
   virtual void updateObjectSpaceBounds() override;
+  virtual bool ensureCullingBoundsCurrent() override;
+  virtual float getCullingPadding() override;
   virtual std::string typeName() override;
   virtual void refresh() override;
 
@@ -144,6 +147,12 @@ public:
   PointCloud* setMaterial(std::string name);
   std::string getMaterial();
 
+  // Store the data compactly on the GPU: positions are quantized to 16 bits per coordinate relative to the bounding
+  // box, and scalar quantities are stored as half-precision floats. This halves their device memory and upload
+  // cost, at a small loss of precision in what is drawn. The host-side values are unaffected.
+  PointCloud* setCompactStorage(bool newVal);
+  bool getCompactStorage();
+
   // Rendering helpers used by quantities
   void setPointCloudUniforms(render::ShaderProgram& p);
   void setPointProgramGeometryAttributes(render::ShaderProgram& p);
@@ -154,6 +163,8 @@ public:
 
 
 private:
+  uint64_t boundsPositionsUpdateCount = INVALID_IND_64; // update count of the positions the bounds are from
+
   // Storage for the managed buffers above. You should generally interact with this directly through them.
   std::vector<glm::vec3> pointsData;
 
@@ -162,6 +173,7 @@ private:
   PersistentValue<glm::vec3> pointColor;
   PersistentValue<ScaledValue<float>> pointRadius;
   PersistentValue<std::string> material;
+  PersistentValue<bool> compactStorage;
 
   // Drawing related things
   // if nullptr, prepare() (resp. preparePick()) needs to be called
@@ -172,6 +184,7 @@ private:
   // Do setup work related to drawing, including allocating openGL data
   void ensureRenderProgramPrepared();
   void ensurePickProgramPrepared();
+  void updateDeviceStorageFormats(); // apply compactStorage to the managed buffers
 
   // === Quantity adder implementations
   PointCloudScalarQuantity* addScalarQuantityImpl(std::string name, const std::vector<float>& data, DataType type);
@@ -200,6 +213,8 @@ private:
 // Shorthand to add a point cloud to polyscope
 template <class T>
 PointCloud* registerPointCloud(std::string name, const T& points);
+// (a temporary std::vector<glm::vec3> has its storage adopted rather than copied)
+inline PointCloud* registerPointCloud(std::string name, std::vector<glm::vec3>&& points);
 template <class T>
 PointCloud* registerPointCloud2D(std::string name, const T& points);
 
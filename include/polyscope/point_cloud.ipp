@@ -17,6 +17,16 @@ PointCloud* registerPointCloud(std::string name, const T& points) {
   }
   return s;
 }
+inline PointCloud* registerPointCloud(std::string name, std::vector<glm::vec3>&& points) {
+  checkInitialized();
+
+  PointCloud* s = new PointCloud(name, std::move(points));
+  bool success = registerStructure(s);
+  if (!success) {
+    safeDelete(s);
+  }
+  return s;
+}
 template <class T>
 PointCloud* registerPointCloud2D(std::string name, const T& points) {
   checkInitialized();
@@ -25,6 +25,9 @@ public:
 
   virtual std::string niceName() override;
 
+  // Match the device storage of the values to the parent's compact storage setting
+  void updateDeviceStorageFormat();
+
 protected:
   void createProgram();
 
@@ -18,6 +18,7 @@ public:
   virtual void buildCustomUI() override;
   virtual void buildPickUI(size_t ind) override;
   virtual std::string niceName() override;
+  virtual float getCullingPadding() override;
   virtual void refresh() override;
 };
 
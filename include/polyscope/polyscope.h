@@ -152,6 +152,17 @@ void removeAllStructures();
 // Recompute the global state::lengthScale, boundingBox, and center by looping over registered structures
 void updateStructureExtents();
 
+// Total memory held by the managed buffers of all registered structures and their quantities
+render::ManagedBufferMemoryUsage getMemoryUsage();
+
+// How many enabled structures were skipped when the scene was last rendered (see options::enableCulling)
+struct CullingStats {
+  size_t structuresTested = 0;
+  size_t culledByFrustum = 0;
+  size_t culledBySlicePlanes = 0;
+};
+CullingStats getCullingStats();
+
 // Group management
 Group* createGroup(std::string name);
 Group* getGroup(std::string name);
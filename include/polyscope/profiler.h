@@ -0,0 +1,68 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace polyscope {
+namespace profiler {
+
+// A lightweight profiler for the cost of each frame. While options::enableProfiler is set, each ScopedTimer records the
+// CPU time spent in its scope, along with the GPU time spent on the render commands issued within it. The GPU times
+// come from timestamp queries, which are read back on a later frame once they are available, so the profiler never
+// stalls the render loop. Polyscope's own rendering passes and the drawing of each structure are instrumented; user
+// code may add its own timers too. The most recent frames are retained, see getTimerStats() and writeChromeTrace().
+
+// Record the time spent in the enclosing scope. Does nothing unless options::enableProfiler is set.
+class ScopedTimer {
+public:
+  ScopedTimer(const char* name);
+  ScopedTimer(const char* label, const std::string& detail); // named like "label: detail"
+  ~ScopedTimer();
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  bool active = false; // false if the profiler was disabled when the timer was created
+  size_t frameInd = 0;
+  size_t eventInd = 0;
+
+  void begin(std::string name);
+};
+
+// Statistics for all of the timers with the same name, over the retained frames. A name which is recorded several
+// times in one frame (e.g. once per depth-peeling pass) counts the total for that frame.
+struct TimerStats {
+  std::string name;
+  int depth = 0;            // nesting depth of the timer, when it was first recorded
+  size_t frameCount = 0;    // number of frames in which the timer was recorded
+  double meanCPUMs = 0.;    // per frame, in milliseconds
+  double maxCPUMs = 0.;
+  size_t gpuFrameCount = 0; // number of those frames whose GPU times have been read back
+  double meanGPUMs = 0.;
+  double maxGPUMs = 0.;
+};
+std::vector<TimerStats> getTimerStats(); // in the order the timers were first recorded
+size_t getRetainedFrameCount();
+
+// Discard all retained frames (and the timestamp queries waiting on them)
+void clearFrames();
+
+// Write the retained frames as a trace in the Chrome trace event format, which can be opened with Perfetto or
+// chrome://tracing. CPU and GPU times are shown as separate threads. The device clock is unrelated to the host clock,
+// so each frame's GPU events are aligned to start at the CPU start time of the frame's first timer.
+void writeChromeTrace(std::string filename);
+
+// Called internally at the start of each frame. A frame drawn while a timer is running (e.g. a screenshot taken in the
+// user callback) is recorded as part of the enclosing one.
+void beginFrame();
+
+// Build the profiler window, if the profiler is enabled
+void buildProfilerGui();
+
+} // namespace profiler
+} // namespace polyscope
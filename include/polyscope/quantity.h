@@ -56,6 +56,10 @@ public:
   virtual std::string niceName();
   std::string uniquePrefix();
 
+  // How far outside of the parent structure's bounding box the quantity may draw, like the length of vectors. Used to
+  // cull structures which are out of view, see Structure::getCullingPadding(). Infinite if it cannot be bounded.
+  virtual float getCullingPadding();
+
   // === Member variables ===
   Structure& parent;      // the parent structure with which this quantity is associated
   const std::string name; // a name for this quantity, which must be unique amongst quantities on `parent`
@@ -34,6 +34,7 @@ enum class DrawMode {
   IndexedLineStripAdjacency,
   TrianglesInstanced,
   TriangleStripInstanced,
+  IndexedPointsTransformFeedback, // no rasterization, captures vertex shader output `a_valueOut` to a buffer
 };
 
 enum class TextureFormat { RGB8 = 0, RGBA8, RG16F, RGB16F, RGBA16F, RGBA32F, RGB32F, R32F, R16F, DEPTH24 };
@@ -58,6 +59,13 @@ enum class RenderDataType {
 
 enum class DeviceBufferType { Attribute, Texture1d, Texture2d, Texture3d };
 
+// How float-valued attribute data is stored on the render device. Shaders always read the values as floats.
+//   Float32: full precision (the default)
+//   Float16: half-precision floats, converted back to floats automatically
+//   UNorm16: 16-bit values quantized relative to a bounding box, which arrive in the shader in [0,1] and must be
+//            rescaled there (see AttributeBuffer::setQuantizationBounds())
+enum class AttributeStorageFormat { Float32 = 0, Float16, UNorm16 };
+
 int dimension(const TextureFormat& x);
 int sizeInBytes(const TextureFormat& f);
 std::string modeName(const TransparencyMode& m);
@@ -66,9 +74,43 @@ int sizeInBytes(const RenderDataType& r);
 int renderDataTypeCountCompatbility(const RenderDataType r1, const RenderDataType r2);
 std::string getImageOriginRule(ImageOrigin imageOrigin);
 std::string deviceBufferTypeName(const DeviceBufferType& d);
+std::string attributeStorageFormatName(const AttributeStorageFormat& f);
 
 namespace render {
 
+// A copy of data from the render device back to the host, which is queued without waiting for the device to finish
+// its outstanding work. The data typically arrives a frame or two later. Poll isReady() to check without blocking;
+// getBytes() waits for the copy if it has not completed yet.
+class ReadbackRequest {
+public:
+  ReadbackRequest(size_t sizeInBytes_);
+  virtual ~ReadbackRequest() {};
+
+  virtual bool isReady() = 0;
+  const std::vector<unsigned char>& getBytes();
+  size_t getSizeInBytes() const { return sizeInBytes; }
+
+protected:
+  // Block until the copy completes, then fill `bytes`. Called at most once.
+  virtual void complete() = 0;
+
+  size_t sizeInBytes;
+  bool completed = false;
+  std::vector<unsigned char> bytes;
+};
+
+// A timestamp of when the render device reaches a point in its command stream, used for profiling. Like a
+// ReadbackRequest, the value arrives some time after record() is called. Poll isReady() rather than waiting on it.
+// Queries can be recorded again once their value has been read, so they may be kept in a pool and reused.
+class TimestampQuery {
+public:
+  virtual ~TimestampQuery() {};
+
+  virtual void record() = 0;
+  virtual bool isReady() = 0;
+  virtual uint64_t getNanoseconds() = 0; // only meaningful once isReady(), and relative to other timestamps
+};
+
 class AttributeBuffer {
 public:
   AttributeBuffer(RenderDataType dataType_, int arrayCount);
@@ -96,13 +138,47 @@ public:
   virtual void setData(const std::vector<std::array<glm::vec3, 3>>& data) = 0;
   virtual void setData(const std::vector<std::array<glm::vec3, 4>>& data) = 0;
 
+  // Update a subset of the entries in an already-populated buffer, without reallocating or touching the rest of it.
+  // Copies data[dataStart, dataStart+count) to buffer entries [bufferStart, bufferStart+count). The target range must
+  // lie within the size of the data most recently passed to setData().
+  // clang-format off
+  virtual void setDataRange(const std::vector<glm::vec2>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<glm::vec3>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<glm::vec4>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<float>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<double>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<int32_t>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<glm::ivec2>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<glm::ivec3>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<glm::ivec4>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<uint32_t>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<glm::uvec2>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<glm::uvec3>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<glm::uvec4>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<std::array<glm::vec3, 2>>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<std::array<glm::vec3, 3>>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  virtual void setDataRange(const std::vector<std::array<glm::vec3, 4>>& data, size_t dataStart, size_t bufferStart, size_t count) = 0;
+  // clang-format on
+
   virtual uint32_t getNativeBufferID() = 0; // used to interop with external things, e.g. ImGui
 
+  // == Compact storage
+  // Optionally store float-valued data at reduced precision on the device, see AttributeStorageFormat. The format must
+  // be chosen before any data is set, and is only supported for non-array Float/VectorNFloat buffers. For UNorm16,
+  // setQuantizationBounds() must be called before setting data, and values are mapped from [lower, upper] to [0,1]
+  // componentwise (values outside are clamped). Shaders recover them as offset + value * scale.
+  void setStorageFormat(AttributeStorageFormat newFormat);
+  AttributeStorageFormat getStorageFormat() const { return storageFormat; }
+  void setQuantizationBounds(glm::vec4 lower, glm::vec4 upper);
+  glm::vec4 getQuantizationOffset() const { return quantizationLower; }
+  glm::vec4 getQuantizationScale() const { return quantizationUpper - quantizationLower; }
+
   // == Getters
   RenderDataType getType() const { return dataType; }
   int getArrayCount() const { return arrayCount; }
   int64_t getDataSize() const { return dataSize; }
-  int64_t getDataSizeInBytes() const { return dataSize * sizeInBytes(dataType) * getArrayCount(); }
+  int64_t getStoredEntrySizeInBytes() const; // size of one entry on the device, accounting for compact storage
+  int64_t getDataSizeInBytes() const { return dataSize * getStoredEntrySizeInBytes(); }
   uint64_t getUniqueID() const { return uniqueID; }
   bool isSet() const { return setFlag; }
 
@@ -136,6 +212,11 @@ public:
   virtual std::vector<glm::uvec3> getDataRange_uvec3(size_t ind, size_t count) = 0;
   virtual std::vector<glm::uvec4> getDataRange_uvec4(size_t ind, size_t count) = 0;
 
+  // Asynchronously get a range of indices from the buffer, see ReadbackRequest. The bytes arrive in the device storage
+  // format; decodeReadback() expands them to the same layout the getDataRange_*() functions return.
+  virtual std::shared_ptr<ReadbackRequest> getDataRangeAsync(size_t ind, size_t count) = 0;
+  std::vector<unsigned char> decodeReadback(const std::vector<unsigned char>& stored) const;
+
 protected:
   RenderDataType dataType;
   int arrayCount;
@@ -144,6 +225,15 @@ protected:
                            // this counts # elements of the specified type, s.t. array'd mulitpliers are still just one
   uint64_t bufferSize = 0; // the size of the allocated buffer (which might be larger than the data sixze)
   uint64_t uniqueID;
+
+  AttributeStorageFormat storageFormat = AttributeStorageFormat::Float32;
+  glm::vec4 quantizationLower{0., 0., 0., 0.};
+  glm::vec4 quantizationUpper{1., 1., 1., 1.};
+
+  // Helpers for backends implementing compact storage. These convert `count` floats to/from the stored 16-bit
+  // representation, where the floats are the components of consecutive entries.
+  std::vector<uint16_t> encodeCompactStorage(const float* values, size_t count) const;
+  void decodeCompactStorage(const uint16_t* stored, size_t count, float* values) const;
 };
 
 class TextureBuffer {
@@ -277,10 +367,18 @@ public:
 
   // Query pixel
   virtual std::array<float, 4> readFloat4(int xPos, int yPos) = 0;
+  // a block of sizeX * sizeY pixels starting at (xStart, yStart), row by row
+  virtual std::vector<std::array<float, 4>> readFloat4Block(int xStart, int yStart, int sizeX, int sizeY) = 0;
   virtual float readDepth(int xPos, int yPos) = 0;
   virtual void blitTo(FrameBuffer* other) = 0;
   virtual std::vector<unsigned char> readBuffer() = 0;
 
+  // Asynchronous versions of the queries above, see ReadbackRequest. The bytes hold the same values as the blocking
+  // versions would return (4 floats, 1 float, or RGBA bytes for the whole buffer).
+  virtual std::shared_ptr<ReadbackRequest> readFloat4Async(int xPos, int yPos) = 0;
+  virtual std::shared_ptr<ReadbackRequest> readDepthAsync(int xPos, int yPos) = 0;
+  virtual std::shared_ptr<ReadbackRequest> readBufferAsync() = 0;
+
   virtual uint32_t getNativeBufferID() = 0;
   uint64_t getUniqueID() const { return uniqueID; }
 
@@ -424,6 +522,16 @@ public:
   // Indices
   virtual void setInstanceCount(uint32_t instanceCount) = 0;
 
+  // Draw ranges
+  // Restrict draw() to a list of (start, count) ranges of the data (vertices, or indices for indexed programs), which
+  // are issued as a single multi-draw. An empty list draws nothing. Only supported for Triangles and IndexedTriangles.
+  virtual void setDrawRanges(const std::vector<std::array<uint32_t, 2>>& ranges) = 0;
+  virtual void clearDrawRanges() = 0; // go back to drawing all of the data
+
+  // Transform feedback
+  // (the output buffer must already be allocated with at least as many entries as will be drawn)
+  virtual void setTransformFeedbackBuffer(std::shared_ptr<AttributeBuffer> externalBuffer) = 0;
+
   // Call once to initialize GLSL code used by multiple shaders
   static void initCommonShaders(); // TODO
 
@@ -432,6 +540,7 @@ public:
 
   virtual void validateData() = 0;
 
+  DrawMode getDrawMode() const { return drawMode; }
   uint64_t getUniqueID() const { return uniqueID; }
 
 protected:
@@ -454,6 +563,13 @@ protected:
 
   // instancing
   uint32_t instanceCount = INVALID_IND_32;
+
+  // draw ranges
+  bool useDrawRanges = false;
+  std::vector<std::array<uint32_t, 2>> drawRanges;
+
+  // transform feedback
+  std::shared_ptr<AttributeBuffer> transformFeedbackBuffer;
 };
 
 
@@ -577,6 +693,8 @@ public:
                                                              unsigned int sizeY_) = 0;
   // create frame buffers
   virtual std::shared_ptr<FrameBuffer> generateFrameBuffer(unsigned int sizeX_, unsigned int sizeY_) = 0;
+  // create timer queries
+  virtual std::shared_ptr<TimestampQuery> generateTimestampQuery() = 0;
 
   // == create shader programs
   virtual std::shared_ptr<ShaderProgram>
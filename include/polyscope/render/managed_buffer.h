@@ -2,8 +2,12 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <functional>
+#include <list>
+#include <string>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -17,6 +21,51 @@ namespace render {
 // forward declaration
 class ManagedBufferRegistry;
 
+// Memory held by one or more managed buffers, in bytes
+struct ManagedBufferMemoryUsage {
+  size_t hostBytes = 0;        // host-side `data` vectors
+  size_t deviceBytes = 0;      // render attribute/texture buffers
+  size_t indexedViewBytes = 0; // expanded indexed views cached on the render device
+
+  size_t totalDeviceBytes() const { return deviceBytes + indexedViewBytes; }
+  ManagedBufferMemoryUsage& operator+=(const ManagedBufferMemoryUsage& other);
+};
+
+/*
+ * A type-erased base for all ManagedBuffers, used to track the host-side memory of every live buffer so that
+ * options::hostBufferMemoryBudget can be enforced. Buffers are kept in least-recently-used order; a buffer counts as
+ * used whenever its host data is populated or updated.
+ */
+class ManagedBufferBase {
+public:
+  ManagedBufferBase();
+  virtual ~ManagedBufferBase();
+  ManagedBufferBase(const ManagedBufferBase&) = delete;
+  ManagedBufferBase& operator=(const ManagedBufferBase&) = delete;
+
+  // Bytes currently held by the host-side `data` vector
+  virtual size_t hostBufferBytes() = 0;
+
+  // Bytes currently held on the host and device by this buffer
+  virtual ManagedBufferMemoryUsage getMemoryUsage() = 0;
+
+  // Free the host-side `data` vector if its contents can be restored later (by copying back from the render device,
+  // or by recomputing). Returns true if anything was freed.
+  virtual bool evictHostBuffer() = 0;
+
+protected:
+  // Move this buffer to the most-recently-used end of the eviction order
+  void markHostBufferUsed();
+
+private:
+  std::list<ManagedBufferBase*>::iterator lruEntry;
+};
+
+// Free the host-side copies of least-recently-used buffers until the total is under options::hostBufferMemoryBudget.
+// Does nothing if the budget is 0. Called once per frame by the main loop; any references to buffer `data` held by the
+// caller may be invalidated.
+void enforceHostBufferMemoryBudget();
+
 /*
  * This class is a wrapper which sits on top of data buffers in Polyscope, and handles common data-management concerns
  * of:
@@ -34,7 +83,7 @@ class ManagedBufferRegistry;
  * data buffer.
  */
 template <typename T>
-class ManagedBuffer : public virtual WeakReferrable {
+class ManagedBuffer : public virtual WeakReferrable, public ManagedBufferBase {
 public:
   // === Constructors
   // (second variants are advanced versions which allow creation of multi-dimensional texture values)
@@ -67,7 +116,8 @@ public:
   // It is assumed that it never changes length (although this class may clear it to empty).
   //
   // It is possible that data.size() == 0 if the data is lazily computed and has not been computed yet, or if this
-  // host-side buffer is invalidated because it is being updated externally directly on the render device.
+  // host-side buffer is invalidated because it is being updated externally directly on the render device, or if it
+  // was freed to stay within options::hostBufferMemoryBudget. Call ensureHostBufferPopulated() before reading it.
   //
   // External users can write directly for this buffer. The required order of operations for writing to this buffer is:
   //    buff.ensureHostBufferAllocated();
@@ -120,6 +170,13 @@ public:
   // reflecting updates to the render buffer.
   void markHostBufferUpdated();
 
+  // Variants of markHostBufferUpdated() for when only some entries of `data` have changed. Only the changed entries
+  // are re-uploaded to the render buffer, and only the corresponding entries of any indexed views are re-expanded.
+  // The first marks the entries [rangeStart, rangeStart+rangeCount), the second marks an arbitrary list of entries.
+  // As above, one of these MUST be called after writing to `data`.
+  void markHostBufferUpdated(size_t rangeStart, size_t rangeCount);
+  void markHostBufferUpdated(const std::vector<size_t>& updatedInds);
+
   // Get the value at index `i`. It may be dynamically fetched from either the cpu-side `data` member or the render
   // buffer, depending on where the data currently lives.
   // If the data lives only on the device-side render buffer, this function is expensive, so don't call it in a
@@ -128,6 +185,13 @@ public:
   T getValue(size_t indX, size_t indY);              // only valid for 2d texture data
   T getValue(size_t indX, size_t indY, size_t indZ); // only valid for 3d texture data
 
+  // Start copying the data back from the render buffer without waiting for the device, when that is where the data
+  // currently lives (it does nothing otherwise). A later ensureHostBufferPopulated() or getValue() uses the copy,
+  // blocking only if it has not arrived yet. Use this to fetch device-side data a frame ahead of needing it.
+  // hostBufferPrefetchIsReady() is true once the data can be accessed without blocking.
+  void prefetchHostBuffer();
+  bool hostBufferPrefetchIsReady();
+
   // If computeFunc() has already been called to populate the stored data, call it again to recompute the data, and
   // re-fill the buffer if necessary. This function is only meaningful in the case where `dataGetsComputed = true`.
   void recomputeIfPopulated();
@@ -135,11 +199,20 @@ public:
   bool hasData(); // true if there is valid data on either the host or device
   size_t size();  // size of the data (number of entries)
 
+  // A counter which is incremented every time the data is marked as updated (on the host or device). Used to detect
+  // when cached data derived from this buffer has become stale.
+  uint64_t getUpdateCount() const { return updateCount; }
+
   // Is it an attribute, texture1d, texture2d, etc?
   DeviceBufferType getDeviceBufferType();
 
   std::string summaryString(); // for debugging
 
+  // See ManagedBufferBase
+  size_t hostBufferBytes() override;
+  bool evictHostBuffer() override;
+  ManagedBufferMemoryUsage getMemoryUsage() override;
+
   // ========================================================================
   // == Direct access to the GPU (device-side) render attribute buffer
   // ========================================================================
@@ -194,11 +267,33 @@ public:
   std::shared_ptr<render::TextureBuffer> getRenderTextureBuffer();
   void markRenderTextureBufferUpdated();
 
+  // ========================================================================
+  // == Compact device storage
+  // ========================================================================
+
+  // Store the render attribute buffer and its indexed views at reduced precision on the device (see
+  // AttributeStorageFormat), to save device memory and upload bandwidth. The host-side `data` keeps full precision.
+  // Only supported for float-valued attribute buffers. For UNorm16, values are quantized relative to the bounding box
+  // of the data, and any shader reading the buffer must map them back as offset + value * scale, using the values
+  // below.
+  //
+  // If a render buffer has already been created, it is replaced, and any programs using the old buffer must be
+  // re-created (e.g. by calling refresh() on the structure).
+  void setDeviceStorageFormat(AttributeStorageFormat newFormat);
+  AttributeStorageFormat getDeviceStorageFormat() const { return deviceStorageFormat; }
+  glm::vec4 getQuantizationOffset() const { return quantizationLower; }
+  glm::vec4 getQuantizationScale() const { return quantizationUpper - quantizationLower; }
+
 
 protected:
   // == Internal members
 
-  bool hostBufferIsPopulated; // true if the host buffer contains currently-valid data
+  bool hostBufferIsPopulated;     // true if the host buffer contains currently-valid data
+  bool hostBufferEvicted = false; // true if the host buffer was freed by evictHostBuffer() and not since restored
+  uint64_t updateCount = 0;       // see getUpdateCount()
+
+  // A copy of the render buffer started by prefetchHostBuffer(), if any. Dropped whenever the data changes.
+  std::shared_ptr<render::ReadbackRequest> pendingReadback;
 
   std::shared_ptr<render::AttributeBuffer> renderAttributeBuffer;
   std::shared_ptr<render::TextureBuffer> renderTextureBuffer;
@@ -211,16 +306,39 @@ protected:
   uint32_t sizeY = 0; // holds 0 if texture dim < 2
   uint32_t sizeZ = 0; // holds 0 if texture dim < 3
 
+  // For compact device storage
+  AttributeStorageFormat deviceStorageFormat = AttributeStorageFormat::Float32;
+  glm::vec4 quantizationLower{0., 0., 0., 0.};
+  glm::vec4 quantizationUpper{1., 1., 1., 1.};
+  bool quantizationBoundsValid = false;
+  void updateQuantizationBounds();                                      // recompute the bounds from `data`
+  void configureDeviceStorage(render::AttributeBuffer& deviceBuffer); // apply the format and bounds to a buffer
+
 
   // == Internal representation of indexed views
   // NOTE: this seems like a problem, we are storing pointers as keys in a cache. Here, it works out because if the
   // key ptr becomes invalid, the value weak_ptr must also be invalid, and we check that before dereferencing the
   // key.
-  std::vector<std::tuple<render::ManagedBuffer<uint32_t>*, std::weak_ptr<render::AttributeBuffer>>>
-      existingIndexedViews;
+  struct IndexedView {
+    render::ManagedBuffer<uint32_t>* indices;
+    std::weak_ptr<render::AttributeBuffer> viewBuffer;
+
+    // The inverse of the index map, in compressed-row form. The view entries which read from data[i] are
+    // inverseInds[inverseStart[i]] ... inverseInds[inverseStart[i+1]-1]. Built lazily on the first partial update, and
+    // rebuilt if the index buffer changes (as detected via its update count).
+    std::vector<size_t> inverseStart;
+    std::vector<uint32_t> inverseInds;
+    uint64_t inverseIndicesUpdateCount = INVALID_IND_64;
+  };
+  std::vector<IndexedView> existingIndexedViews;
   void updateIndexedViews();
+  void updateIndexedViews(const std::vector<std::array<size_t, 2>>& dirtyRanges);
+  void ensureIndexedViewInverse(IndexedView& view);
   void removeDeletedIndexedViews();
 
+  // Shared implementation of the partial markHostBufferUpdated() variants. The ranges are [start, end) pairs.
+  void markHostBufferRangesUpdated(std::vector<std::array<size_t, 2>> dirtyRanges);
+
   // == Internal helper functions
 
   void invalidateHostBuffer();
@@ -232,8 +350,10 @@ protected:
   CanonicalDataSource currentCanonicalDataSource();
 
   // Manage the program which copies indexed data from the renderBuffer to the indexed views
+  // (used when the canonical data lives on the device, to avoid reading it back to the host)
+  bool canUseBufferIndexCopyProgram();
   void ensureHaveBufferIndexCopyProgram();
-  void invokeBufferIndexCopyProgram();
+  void invokeBufferIndexCopyProgram(ManagedBuffer<uint32_t>& indices, std::shared_ptr<render::AttributeBuffer> target);
   std::shared_ptr<render::ShaderProgram> bufferIndexCopyProgram;
 };
 
@@ -251,6 +371,9 @@ public:
   ManagedBuffer<T>& getManagedBuffer(std::string name);
   bool hasManagedBuffer(std::string name);
 
+  // append a (name, usage) entry for each buffer
+  void appendMemoryUsage(std::vector<std::tuple<std::string, ManagedBufferMemoryUsage>>& usage);
+
   // internal helper for template things
   static ManagedBufferMap<T>& getManagedBufferMapRef(ManagedBufferRegistry* r);
 
@@ -281,6 +404,10 @@ public:
   template <typename T>
   void addManagedBuffer(ManagedBuffer<T>* buffer);
 
+  // memory held by the buffers in this registry, either as a (name, usage) entry for each buffer, or as a total
+  std::vector<std::tuple<std::string, ManagedBufferMemoryUsage>> getManagedBufferMemoryUsageByBuffer();
+  ManagedBufferMemoryUsage getManagedBufferMemoryUsage();
+
   // clang-format off
   ManagedBufferMap<float>        managedBufferMap_float;
   ManagedBufferMap<double>       managedBufferMap_double;
@@ -72,5 +72,12 @@ bool ManagedBufferMap<T>::hasManagedBuffer(std::string name) {
   return false;
 }
 
+template <typename T>
+void ManagedBufferMap<T>::appendMemoryUsage(std::vector<std::tuple<std::string, ManagedBufferMemoryUsage>>& usage) {
+  for (ManagedBuffer<T>* buff : allBuffers) {
+    usage.emplace_back(buff->name, buff->getMemoryUsage());
+  }
+}
+
 } // namespace render
 } // namespace polyscope
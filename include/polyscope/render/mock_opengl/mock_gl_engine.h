@@ -14,6 +14,28 @@ namespace polyscope {
 namespace render {
 namespace backend_openGL_mock {
 
+// Readbacks complete immediately, holding whatever the blocking query would have returned
+class GLReadbackRequest : public ReadbackRequest {
+public:
+  GLReadbackRequest(std::vector<unsigned char> bytes_);
+  bool isReady() override { return true; }
+
+protected:
+  void complete() override;
+  std::vector<unsigned char> pendingBytes;
+};
+
+// (the mock engine uses the time on the host)
+class GLTimestampQuery : public TimestampQuery {
+public:
+  void record() override;
+  bool isReady() override { return true; }
+  uint64_t getNanoseconds() override { return nanoseconds; }
+
+private:
+  uint64_t nanoseconds = 0;
+};
+
 class GLAttributeBuffer : public AttributeBuffer {
 public:
   GLAttributeBuffer(RenderDataType dataType_, int arrayCount_);
@@ -42,6 +64,26 @@ public:
   void setData(const std::vector<std::array<glm::vec3, 3>>& data) override;
   void setData(const std::vector<std::array<glm::vec3, 4>>& data) override;
 
+  // Update a subset of the entries
+  // clang-format off
+  void setDataRange(const std::vector<glm::vec2>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::vec3>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::vec4>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<float>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<double>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<int32_t>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::ivec2>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::ivec3>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::ivec4>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<uint32_t>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::uvec2>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::uvec3>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::uvec4>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<std::array<glm::vec3, 2>>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<std::array<glm::vec3, 3>>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<std::array<glm::vec3, 4>>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  // clang-format on
+
   // get data at a single index from the buffer
   float getData_float(size_t ind) override;
   double getData_double(size_t ind) override;
@@ -72,17 +114,28 @@ public:
   std::vector<glm::uvec3> getDataRange_uvec3(size_t ind, size_t count) override;
   std::vector<glm::uvec4> getDataRange_uvec4(size_t ind, size_t count) override;
 
+  std::shared_ptr<ReadbackRequest> getDataRangeAsync(size_t ind, size_t count) override;
+
   uint32_t getNativeBufferID() override;
 
+  // Write source[indices[i]] to entry i of this buffer, emulating the transform feedback index copy
+  void gatherFrom(GLAttributeBuffer& source, GLAttributeBuffer& indices);
+
 protected:
 private:
   void checkType(RenderDataType targetType);
   void checkArray(int arrayCount);
 
+  // The mock keeps a copy of the buffer contents, so that readback returns what was written
+  std::vector<unsigned char> contents;
+
   // internal implementation helpers
   template <typename T>
   void setData_helper(const std::vector<T>& data);
 
+  template <typename T>
+  void setDataRange_helper(const std::vector<T>& data, size_t dataStart, size_t bufferStart, size_t count);
+
   template <typename T>
   T getData_helper(size_t ind);
 
@@ -190,8 +243,12 @@ public:
   // Query pixels
   std::vector<unsigned char> readBuffer() override;
   std::array<float, 4> readFloat4(int xPos, int yPos) override;
+  std::vector<std::array<float, 4>> readFloat4Block(int xStart, int yStart, int sizeX, int sizeY) override;
   float readDepth(int xPos, int yPos) override;
   void blitTo(FrameBuffer* other) override;
+  std::shared_ptr<ReadbackRequest> readFloat4Async(int xPos, int yPos) override;
+  std::shared_ptr<ReadbackRequest> readDepthAsync(int xPos, int yPos) override;
+  std::shared_ptr<ReadbackRequest> readBufferAsync() override;
 
   // Getters
   uint32_t getNativeBufferID() override;
@@ -302,6 +359,13 @@ public:
   // Indices
   void setInstanceCount(uint32_t instanceCount) override;
 
+  // Draw ranges
+  void setDrawRanges(const std::vector<std::array<uint32_t, 2>>& ranges) override;
+  void clearDrawRanges() override;
+
+  // Transform feedback
+  void setTransformFeedbackBuffer(std::shared_ptr<AttributeBuffer> externalBuffer) override;
+
   // Textures
   bool hasTexture(std::string name) override;
   bool textureIsSet(std::string name) override;
@@ -409,6 +473,8 @@ public:
                                                      unsigned int sizeY_) override;
   // create frame buffers
   std::shared_ptr<FrameBuffer> generateFrameBuffer(unsigned int sizeX_, unsigned int sizeY_) override;
+  // create timer queries
+  std::shared_ptr<TimestampQuery> generateTimestampQuery() override;
 
   // general flexible interface
   std::shared_ptr<ShaderProgram>
@@ -41,6 +41,40 @@ typedef GLint UniformLocation;
 typedef GLint AttributeLocation;
 typedef GLint TextureLocation;
 
+// Reads back through a pixel pack buffer, with a fence to detect when the copy has finished. The constructor leaves
+// the pack buffer bound to GL_PIXEL_PACK_BUFFER; issue the copy in to it, then call insertFence().
+class GLReadbackRequest : public ReadbackRequest {
+public:
+  GLReadbackRequest(size_t sizeInBytes);
+  ~GLReadbackRequest() override;
+
+  void insertFence();
+  bool isReady() override;
+  VertexBufferHandle getPackBufferHandle() const { return packBuffer; }
+
+protected:
+  void complete() override;
+
+private:
+  VertexBufferHandle packBuffer = 0;
+  GLsync fence = nullptr;
+  void release();
+};
+
+class GLTimestampQuery : public TimestampQuery {
+public:
+  GLTimestampQuery();
+  ~GLTimestampQuery() override;
+
+  void record() override;
+  bool isReady() override;
+  uint64_t getNanoseconds() override;
+
+private:
+  GLuint handle = 0;
+  bool recorded = false;
+};
+
 class GLAttributeBuffer : public AttributeBuffer {
 public:
   GLAttributeBuffer(RenderDataType dataType_, int arrayCount_);
@@ -70,6 +104,26 @@ public:
   void setData(const std::vector<std::array<glm::vec3, 3>>& data) override;
   void setData(const std::vector<std::array<glm::vec3, 4>>& data) override;
 
+  // Update a subset of the entries
+  // clang-format off
+  void setDataRange(const std::vector<glm::vec2>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::vec3>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::vec4>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<float>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<double>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<int32_t>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::ivec2>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::ivec3>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::ivec4>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<uint32_t>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::uvec2>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::uvec3>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<glm::uvec4>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<std::array<glm::vec3, 2>>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<std::array<glm::vec3, 3>>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  void setDataRange(const std::vector<std::array<glm::vec3, 4>>& data, size_t dataStart, size_t bufferStart, size_t count) override;
+  // clang-format on
+
   // get data at a single index from the buffer
   float getData_float(size_t ind) override;
   double getData_double(size_t ind) override;
@@ -100,6 +154,8 @@ public:
   std::vector<glm::uvec3> getDataRange_uvec3(size_t ind, size_t count) override;
   std::vector<glm::uvec4> getDataRange_uvec4(size_t ind, size_t count) override;
 
+  std::shared_ptr<ReadbackRequest> getDataRangeAsync(size_t ind, size_t count) override;
+
   uint32_t getNativeBufferID() override;
 
 protected:
@@ -115,6 +171,9 @@ private:
   template <typename T>
   void setData_helper(const std::vector<T>& data);
 
+  template <typename T>
+  void setDataRange_helper(const std::vector<T>& data, size_t dataStart, size_t bufferStart, size_t count);
+
   template <typename T>
   T getData_helper(size_t ind);
 
@@ -227,8 +286,12 @@ public:
   // Query pixels
   std::vector<unsigned char> readBuffer() override;
   std::array<float, 4> readFloat4(int xPos, int yPos) override;
+  std::vector<std::array<float, 4>> readFloat4Block(int xStart, int yStart, int sizeX, int sizeY) override;
   float readDepth(int xPos, int yPos) override;
   void blitTo(FrameBuffer* other) override;
+  std::shared_ptr<ReadbackRequest> readFloat4Async(int xPos, int yPos) override;
+  std::shared_ptr<ReadbackRequest> readDepthAsync(int xPos, int yPos) override;
+  std::shared_ptr<ReadbackRequest> readBufferAsync() override;
 
   // Getters
   FrameBufferHandle getHandle() const { return handle; }
@@ -346,6 +409,13 @@ public:
   // Instancing
   void setInstanceCount(uint32_t instanceCount) override;
 
+  // Draw ranges
+  void setDrawRanges(const std::vector<std::array<uint32_t, 2>>& ranges) override;
+  void clearDrawRanges() override;
+
+  // Transform feedback
+  void setTransformFeedbackBuffer(std::shared_ptr<AttributeBuffer> externalBuffer) override;
+
   // Textures
   bool hasTexture(std::string name) override;
   bool textureIsSet(std::string name) override;
@@ -392,6 +462,10 @@ public:
   // High-level control
   void checkError(bool fatal = false) override;
 
+  // The engine skips binds which would not change the GL state. Call this after anything outside the engine (like
+  // ImGui) may have changed the bound program, vertex array, or textures.
+  void invalidateBoundState();
+
   std::vector<unsigned char> readDisplayBuffer() override;
 
   // Manage render state
@@ -427,6 +501,8 @@ public:
                                                      unsigned int sizeY_) override;
   // create frame buffers
   std::shared_ptr<FrameBuffer> generateFrameBuffer(unsigned int sizeX_, unsigned int sizeY_) override;
+  // create timer queries
+  std::shared_ptr<TimestampQuery> generateTimestampQuery() override;
 
   // general flexible interface
   std::shared_ptr<ShaderProgram>
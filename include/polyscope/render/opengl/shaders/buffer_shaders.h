@@ -0,0 +1,30 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include "polyscope/render/opengl/gl_shaders.h"
+
+namespace polyscope {
+namespace render {
+namespace backend_openGL3 {
+
+// High level pipeline
+extern const ShaderStageSpecification BUFFER_INDEX_COPY_VERT_SHADER;
+
+// Rules
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_FLOAT;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_VEC2;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_VEC3;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_VEC4;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_INT;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_IVEC2;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_IVEC3;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_IVEC4;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_UINT;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_UVEC2;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_UVEC3;
+extern const ShaderReplacementRule BUFFER_INDEX_COPY_UVEC4;
+
+} // namespace backend_openGL3
+} // namespace render
+} // namespace polyscope
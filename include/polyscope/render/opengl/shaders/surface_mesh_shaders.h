@@ -11,6 +11,9 @@ namespace backend_openGL3 {
 // High level pipeline
 extern const ShaderStageSpecification FLEX_MESH_VERT_SHADER;
 extern const ShaderStageSpecification FLEX_MESH_FRAG_SHADER;
+extern const ShaderStageSpecification FLEX_MESH_INDEXED_VERT_SHADER;
+extern const ShaderStageSpecification FLEX_MESH_INDEXED_FRAG_SHADER;
+extern const ShaderStageSpecification INSTANCED_MESH_VERT_SHADER;
 
 // Minimal mesh renders
 extern const ShaderStageSpecification SIMPLE_MESH_VERT_SHADER;
@@ -35,7 +38,14 @@ extern const ShaderReplacementRule MESH_PROPAGATE_HALFEDGE_VALUE;
 extern const ShaderReplacementRule MESH_PROPAGATE_CULLPOS;
 extern const ShaderReplacementRule MESH_PROPAGATE_PICK;
 extern const ShaderReplacementRule MESH_PROPAGATE_PICK_SIMPLE;
+extern const ShaderReplacementRule MESH_PROPAGATE_PICK_SIMPLE_FROM_INDS;
 extern const ShaderReplacementRule MESH_PROPAGATE_TYPE_AND_BASECOLOR2_SHADE;
+extern const ShaderReplacementRule MESH_INDEXED_FACE_NORMAL;
+extern const ShaderReplacementRule MESH_INDEXED_PROPAGATE_CULLPOS;
+extern const ShaderReplacementRule MESH_INDEXED_WIREFRAME;
+extern const ShaderReplacementRule MESH_INSTANCED_COLOR;
+extern const ShaderReplacementRule MESH_INSTANCED_PROPAGATE_CULLPOS;
+extern const ShaderReplacementRule MESH_INSTANCED_PROPAGATE_PICK;
 
 
 } // namespace backend_openGL3
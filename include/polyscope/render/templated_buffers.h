@@ -29,6 +29,11 @@ T getAttributeBufferData(AttributeBuffer& buff, size_t ind);
 template <typename T>
 std::vector<T> getAttributeBufferDataRange(AttributeBuffer& buff, size_t ind, size_t count);
 
+// Interpret the bytes from an asynchronous readback of a buffer as a templated type
+// (see AttributeBuffer::getDataRangeAsync(), compact storage must already be expanded with decodeReadback())
+template <typename T>
+std::vector<T> attributeBufferDataFromBytes(const std::vector<unsigned char>& bytes);
+
 
 // ==========================================================
 // === Texture buffers
@@ -9,12 +9,19 @@ namespace polyscope {
 struct ScreenshotOptions {
   bool transparentBackground = true;
   bool includeUI = false;
+  bool async = false; // don't wait for the image to be read back; the file is written on a later frame (see below)
 };
 
 // Save a screenshot to a file
 void screenshot(const ScreenshotOptions& options = {}); // automatic file names like `screenshot_000000.png`
 void screenshot(std::string filename, const ScreenshotOptions& options = {});
 
+// Screenshots taken with `async = true` are written once their image has been read back from the render device, which
+// is checked every frame. Useful to record frames without stalling the render loop. flushScreenshots() waits for and
+// writes all pending screenshots immediately.
+void processPendingScreenshots(); // write any pending screenshots which are ready (called automatically each frame)
+void flushScreenshots();
+
 // Save a screenshot to a buffer
 std::vector<unsigned char> screenshotToBuffer(const ScreenshotOptions& options = {});
 
@@ -43,9 +43,15 @@ public:
   virtual void drawPick() override;
   virtual void drawPickDelayed() override;
   virtual void updateObjectSpaceBounds() override;
+  virtual bool ensureCullingBoundsCurrent() override;
   virtual std::string typeName() override;
   virtual void refresh() override;
 
+  // Ray casting
+  virtual RayCastResult rayCast(glm::vec3 origin, glm::vec3 dir, float tMin, float tMax) override;
+  virtual bool canRayCastPick() override;
+  virtual uint64_t rayCastPickIndex(const RayCastResult& hit) override;
+
   // === Geometry members
   render::ManagedBuffer<glm::vec3> vertices;
   render::ManagedBuffer<glm::uvec3> faces;
@@ -93,10 +99,18 @@ public:
 
 
 private:
+  uint64_t boundsPositionsUpdateCount = INVALID_IND_64; // update count of the positions the bounds are from
+
   // Storage for the managed buffers above. You should generally interact with this directly through them.
   std::vector<glm::vec3> verticesData;
   std::vector<glm::uvec3> facesData;
 
+  // The faces reordered to draw efficiently, used if options::optimizeMeshDrawOrder is set. The order is computed
+  // when the faces change, but not when only the vertices move.
+  std::vector<glm::uvec3> drawFacesData;
+  render::ManagedBuffer<glm::uvec3> drawFaces;
+  void computeDrawFaces();
+
   // === Visualization parameters
   PersistentValue<glm::vec3> surfaceColor;
   PersistentValue<std::string> material;
@@ -119,6 +133,12 @@ private:
   // == Picking related things
   size_t pickStart;
   glm::vec3 pickColor;
+
+  // == Ray casting
+  TriangleBVH bvh;
+  uint64_t bvhVerticesUpdateCount = 0; // update count of vertices when the BVH was built
+  uint64_t bvhFacesUpdateCount = 0;    // update count of faces when the BVH was built
+  void ensureHaveBVH();                // (re)builds if the geometry has changed
 };
 
 
@@ -38,6 +38,7 @@ void SimpleTriangleMesh::update(const V& newPositions, const F& newFaces) {
 
   faces.data = standardizeVectorArray<glm::uvec3, 3>(newFaces);
   faces.markHostBufferUpdated();
+  drawFaces.recomputeIfPopulated();
 }
 
 // Shorthand to get a mesh from polyscope
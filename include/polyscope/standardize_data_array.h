@@ -5,6 +5,7 @@
 #include "polyscope/messages.h"
 #include "polyscope/utilities.h"
 
+#include <cstring>
 #include <type_traits>
 #include <vector>
 
@@ -224,6 +225,81 @@ size_t adaptorF_size(const T& inputData) {
 }
 
 
+// =================================================
+// ============ contiguous storage adapator
+// =================================================
+
+// Adaptor to check whether an array type which exposes a data() pointer actually stores its entries contiguously
+// behind that pointer, so they can be block-copied rather than visited one at a time.
+//
+// The result is a function `bool adaptorF_isContiguous(const T& inputData)`.
+//
+// The following hierarchy of strategies will be attempted, with decreasing precedence:
+//   - the .innerStride() member function (like Eigen views), which must be 1
+//   - otherwise, assume storage is contiguous (std::vector, std::array, etc)
+
+
+// Highest priority: check T.innerStride()
+template <class T, 
+  /* condition: has .innerStride() method which returns something that can be cast to size_t */
+  typename C1 = typename std::enable_if<std::is_same<decltype((size_t)(std::declval<T>()).innerStride()), size_t>::value>::type>
+
+bool adaptorF_isContiguousImpl(PreferenceT<1>, const T& inputData) {
+  return inputData.innerStride() == 1;
+}
+
+// Fall-through case: anything else with a data() pointer is assumed to be contiguous
+template <class T>
+bool adaptorF_isContiguousImpl(PreferenceT<0>, const T& inputData) {
+  return true;
+}
+
+// General version, which will attempt to substitute in to the variants above
+template <class T>
+bool adaptorF_isContiguous(const T& inputData) {
+  return adaptorF_isContiguousImpl(PreferenceT<1>{}, inputData);
+}
+
+
+// Adaptor to check whether the elements of an array type may be visited from several threads at once. Only inputs with
+// contiguous storage behind a data() pointer (std::vector, std::array, Eigen vectors, etc) qualify. User-defined
+// adaptors and arbitrary bracket or callable accessors are not assumed to be safe to call concurrently.
+//
+// The result is a function `bool adaptorF_canVisitInParallel(const T& inputData)`.
+
+// Highest priority: anything with a data() pointer, if it is contiguous
+template <class T,
+  /* condition: has .data() method which returns a pointer */
+  typename C1 = typename std::enable_if<std::is_pointer<decltype((std::declval<T>()).data())>::value>::type>
+
+bool adaptorF_canVisitInParallelImpl(PreferenceT<1>, const T& inputData) {
+  return adaptorF_isContiguous(inputData);
+}
+
+// Fall-through case: visit serially
+template <class T>
+bool adaptorF_canVisitInParallelImpl(PreferenceT<0>, const T& inputData) {
+  return false;
+}
+
+// General version, which will attempt to substitute in to the variants above
+template <class T>
+bool adaptorF_canVisitInParallel(const T& inputData) {
+  return adaptorF_canVisitInParallelImpl(PreferenceT<1>{}, inputData);
+}
+
+// Call func(iChunk, iStart, iEnd) over [0, count), split across threads with parallelForChunks() if `parallel` is
+// set, or as a single chunk on the calling thread otherwise.
+template <class F>
+void adaptorF_forChunks(bool parallel, size_t count, F&& func) {
+  if (parallel) {
+    parallelForChunks(count, func);
+  } else {
+    func(static_cast<size_t>(0), static_cast<size_t>(0), count);
+  }
+}
+
+
 // =================================================
 // ============ array access adapator
 // =================================================
@@ -240,8 +316,12 @@ size_t adaptorF_size(const T& inputData) {
 // but that would require that array types be random-accessible. By going to a std::vector, we open the door to
 // non-random-accessible input types like iterables.
 //
+// Elementwise conversions of large contiguous arrays and raw pointers are split across threads with
+// parallelForChunks(). Everything else is converted serially, see adaptorF_canVisitInParallel().
+//
 // The following hierarchy of strategies will be attempted, with decreasing precedence:
 // - user-defined adaptorF_custom_convertToStdVector()
+// - contiguous storage of exactly S behind a data() pointer (like std::vector<S>), which is block-copied
 // - bracket access
 // - callable (parenthesis) access
 // - iterable (begin() and end())
@@ -259,7 +339,7 @@ template <class T, class S,
   /* condition: user defined function exists and returns something that can be bracket-indexed to get an S */
   typename C1 = typename std::enable_if< std::is_same<decltype((S)adaptorF_custom_convertToStdVector(std::declval<T>())[0]), S>::value>::type>
 
-void adaptorF_convertToStdVectorImpl(PreferenceT<5>, const T& inputData, std::vector<S>& out) {
+void adaptorF_convertToStdVectorImpl(PreferenceT<6>, const T& inputData, std::vector<S>& out) {
   auto userVec = adaptorF_custom_convertToStdVector(inputData);
 
   // If the user-provided function returns something else, try to convert it to a std::vector<S>.
@@ -274,6 +354,25 @@ void adaptorF_convertToStdVectorImpl(PreferenceT<5>, const T& inputData, std::ve
   }
 }
 
+// Next: contiguous storage of exactly the requested type (std::vector<S>, std::array<S,N>, Eigen vectors, etc)
+template <class T, class S,
+  /* condition: input has a data() method which returns a pointer to S */
+  typename C1 = typename std::enable_if<std::is_same<typename std::remove_cv<typename std::remove_pointer<decltype((std::declval<T>()).data())>::type>::type, S>::value>::type>
+
+void adaptorF_convertToStdVectorImpl(PreferenceT<5>, const T& inputData, std::vector<S>& dataOut) {
+
+  // Strided views (like an Eigen::Map with an inner stride) have a data() pointer, but can't be block-copied. Send
+  // them to the elementwise strategies below.
+  if (!adaptorF_isContiguous(inputData)) {
+    adaptorF_convertToStdVectorImpl<T, S>(PreferenceT<4>{}, inputData, dataOut);
+    return;
+  }
+
+  size_t dataSize = adaptorF_size(inputData);
+  const S* dataPtr = inputData.data();
+  dataOut.assign(dataPtr, dataPtr + dataSize);
+}
+
 // Next: any bracket access operator
 template <class T, class S,
   /* condition: input can be bracket-indexed to get an S */
@@ -282,9 +381,11 @@ template <class T, class S,
 void adaptorF_convertToStdVectorImpl(PreferenceT<4>, const T& inputData, std::vector<S>& dataOut) {
   size_t dataSize = adaptorF_size(inputData);
   dataOut.resize(dataSize);
-  for (size_t i = 0; i < dataSize; i++) {
-    dataOut[i] = inputData[i];
-  }
+  adaptorF_forChunks(adaptorF_canVisitInParallel(inputData), dataSize, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      dataOut[i] = inputData[i];
+    }
+  });
 }
 
 
@@ -330,12 +431,23 @@ template <class T, class S,
 void adaptorF_convertToStdVectorImpl(PreferenceT<1>, const T& inputData, std::vector<S>& dataOut) {
 
   size_t dataSize = adaptorF_size(inputData);
-  dataOut.resize(dataSize);
   auto* dataPtr = std::get<0>(inputData);
 
-  for (size_t i = 0; i < dataSize; i++) {
-    dataOut[i] = dataPtr[i];
+  // If the pointer is already to S, this is a block copy
+  typedef typename std::remove_cv<typename std::remove_reference<decltype(*dataPtr)>::type>::type P;
+  if (std::is_same<P, S>::value) {
+    dataOut.assign(dataPtr, dataPtr + dataSize);
+    return;
   }
+
+  // (a plain loop over raw pointers, so narrowing conversions like double --> float get vectorized)
+  dataOut.resize(dataSize);
+  S* outPtr = dataOut.data();
+  parallelForChunks(dataSize, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      outPtr[i] = static_cast<S>(dataPtr[i]);
+    }
+  });
 }
 
 
@@ -352,7 +464,7 @@ void adaptorF_convertToStdVectorImpl(PreferenceT<0>, const T& inputData, std::ve
 // General version, which will attempt to substitute in to the variants above
 template <class S, class T>
 void adaptorF_convertToStdVector(const T& inputData, std::vector<S>& dataOut) {
-  adaptorF_convertToStdVectorImpl<T, S>(PreferenceT<5>{}, inputData, dataOut);
+  adaptorF_convertToStdVectorImpl<T, S>(PreferenceT<6>{}, inputData, dataOut);
 }
 
 
@@ -582,6 +694,7 @@ S adaptorF_accessVector3Value(const T& inVal) {
 // The following hierarchy of strategies will be attempted, with decreasing precedence:
 //   - any user defined function
 //          std::vector<std::array<F, D>> adaptorF_custom_convertArrayOfVectorToStdVector(const YOUR_TYPE& inputData);
+//   - contiguous storage of exactly O behind a data() pointer (like std::vector<O>), which is block-copied
 //   - dense callable (parenthesis) access (like T(i,j))
 //   - double bracket access (like T[i][j])
 //   - outer type bracket accessbile, inner anything convertible to Vector2/3
@@ -604,7 +717,7 @@ template <
     typename C1 = typename std::enable_if<std::is_same< 
                                           decltype((typename InnerType<O>::type)(adaptorF_custom_convertArrayOfVectorToStdVector(std::declval<T>()))[0][0]), 
                                           typename InnerType<O>::type>::value>::type>
-std::vector<O> adaptorF_convertArrayOfVectorToStdVectorImpl(PreferenceT<9>, const T& inputData) {
+std::vector<O> adaptorF_convertArrayOfVectorToStdVectorImpl(PreferenceT<10>, const T& inputData) {
 
   // should be std::vector<std::array<SCALAR,D>>
   auto userArr = adaptorF_custom_convertArrayOfVectorToStdVector(inputData);
@@ -621,6 +734,23 @@ std::vector<O> adaptorF_convertArrayOfVectorToStdVectorImpl(PreferenceT<9>, cons
   return dataOut;
 }
 
+// Next: contiguous storage of exactly the requested vector type (std::vector<glm::vec3>, etc)
+template <class O, unsigned int D, class T,
+    /* condition: input has a data() method which returns a pointer to O */
+    typename C1 = typename std::enable_if<std::is_same<typename std::remove_cv<typename std::remove_pointer<decltype((std::declval<T>()).data())>::type>::type, O>::value>::type>
+
+std::vector<O> adaptorF_convertArrayOfVectorToStdVectorImpl(PreferenceT<9>, const T& inputData) {
+
+  // Strided views can't be block-copied, send them to the elementwise strategies below.
+  if (!adaptorF_isContiguous(inputData)) {
+    return adaptorF_convertArrayOfVectorToStdVectorImpl<O, D, T>(PreferenceT<8>{}, inputData);
+  }
+
+  size_t dataSize = adaptorF_size(inputData);
+  const O* dataPtr = inputData.data();
+  return std::vector<O>(dataPtr, dataPtr + dataSize);
+}
+
 // Next: any dense callable (parenthesis) access operator
 template <class O, unsigned int D, class T,
     /* condition: input can be called with two integer arguments to get something that can be cast to the inner type of O */
@@ -650,11 +780,13 @@ template <class O, unsigned int D, class T,
 std::vector<O> adaptorF_convertArrayOfVectorToStdVectorImpl(PreferenceT<7>, const T& inputData) {
   size_t dataSize = adaptorF_size(inputData);
   std::vector<O> dataOut(dataSize);
-  for (size_t i = 0; i < dataSize; i++) {
-    for (size_t j = 0; j < D; j++) {
-      dataOut[i][j] = inputData[i][j];
+  adaptorF_forChunks(adaptorF_canVisitInParallel(inputData), dataSize, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      for (size_t j = 0; j < D; j++) {
+        dataOut[i][j] = inputData[i][j];
+      }
     }
-  }
+  });
   return dataOut;
 }
 
@@ -675,11 +807,13 @@ template <class O, unsigned int D, class T,
 std::vector<O> adaptorF_convertArrayOfVectorToStdVectorImpl(PreferenceT<6>, const T& inputData) {
   size_t dataSize = adaptorF_size(inputData);
   std::vector<O> dataOut(dataSize);
-  for (size_t i = 0; i < dataSize; i++) {
-    dataOut[i][0] = adaptorF_accessVector3Value<C_RES, 0>(inputData[i]);
-    dataOut[i][1] = adaptorF_accessVector3Value<C_RES, 1>(inputData[i]);
-    dataOut[i][2] = adaptorF_accessVector3Value<C_RES, 2>(inputData[i]);
-  }
+  adaptorF_forChunks(adaptorF_canVisitInParallel(inputData), dataSize, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      dataOut[i][0] = adaptorF_accessVector3Value<C_RES, 0>(inputData[i]);
+      dataOut[i][1] = adaptorF_accessVector3Value<C_RES, 1>(inputData[i]);
+      dataOut[i][2] = adaptorF_accessVector3Value<C_RES, 2>(inputData[i]);
+    }
+  });
   return dataOut;
 }
 
@@ -699,10 +833,12 @@ template <class O, unsigned int D, class T,
 std::vector<O> adaptorF_convertArrayOfVectorToStdVectorImpl(PreferenceT<5>, const T& inputData) {
   size_t dataSize = adaptorF_size(inputData);
   std::vector<O> dataOut(dataSize);
-  for (size_t i = 0; i < dataSize; i++) {
-    dataOut[i][0] = adaptorF_accessVector2Value<C_RES, 0>(inputData[i]);
-    dataOut[i][1] = adaptorF_accessVector2Value<C_RES, 1>(inputData[i]);
-  }
+  adaptorF_forChunks(adaptorF_canVisitInParallel(inputData), dataSize, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      dataOut[i][0] = adaptorF_accessVector2Value<C_RES, 0>(inputData[i]);
+      dataOut[i][1] = adaptorF_accessVector2Value<C_RES, 1>(inputData[i]);
+    }
+  });
   return dataOut;
 }
 
@@ -787,6 +923,30 @@ std::vector<O> adaptorF_convertArrayOfVectorToStdVectorImpl(PreferenceT<2>, cons
   return dataOut;
 }
 
+// Helper for the tuple case below: copy D*size flat scalars in to size vectors. If the output vector type is tightly
+// packed with the same scalar type as the input, the whole buffer is copied as a single block.
+template <class O, unsigned int D, class P,
+    /* condition: the input scalar type matches the inner type of O */
+    typename C1 = typename std::enable_if<std::is_same<typename std::remove_cv<P>::type, typename std::remove_cv<typename InnerType<O>::type>::type>::value>::type,
+    /* condition: O holds exactly D scalars and nothing else */
+    typename C2 = typename std::enable_if<sizeof(O) == D * sizeof(P) && std::is_trivially_copyable<O>::value>::type>
+
+void adaptorF_copyFlatVectorDataImpl(PreferenceT<1>, P* dataPtr, size_t dataSize, std::vector<O>& dataOut) {
+  if (dataSize == 0) return;
+  std::memcpy(&dataOut[0], dataPtr, dataSize * sizeof(O));
+}
+
+template <class O, unsigned int D, class P>
+void adaptorF_copyFlatVectorDataImpl(PreferenceT<0>, P* dataPtr, size_t dataSize, std::vector<O>& dataOut) {
+  parallelForChunks(dataSize, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      for (size_t j = 0; j < D; j++) {
+        dataOut[i][j] = dataPtr[D * i + j];
+      }
+    }
+  });
+}
+
 // Next: tuple {data_ptr, size} (size is number of vector entries, so ptr should point to D*size valid scalar entries)
 template <class O, unsigned int D, class T,
     /* condition: first entry of input can be dereferenced to get a type castable to the scalar type O */
@@ -801,12 +961,7 @@ std::vector<O> adaptorF_convertArrayOfVectorToStdVectorImpl(PreferenceT<1>, cons
   auto* dataPtr = std::get<0>(inputData);
 
   std::vector<O> dataOut(dataSize);
-
-  for (size_t i = 0; i < dataSize; i++) {
-    for (size_t j = 0; j < D; j++) {
-      dataOut[i][j] = dataPtr[D * i + j];
-    }
-  }
+  adaptorF_copyFlatVectorDataImpl<O, D>(PreferenceT<1>{}, dataPtr, dataSize, dataOut);
 
   return dataOut;
 }
@@ -828,7 +983,7 @@ std::vector<O> adaptorF_convertArrayOfVectorToStdVectorImpl(PreferenceT<0>, cons
 // General version, which will attempt to substitute in to the variants above
 template <class O, unsigned int D, class T>
 std::vector<O> adaptorF_convertArrayOfVectorToStdVector(const T& inputData) {
-  return adaptorF_convertArrayOfVectorToStdVectorImpl<O, D, T>(PreferenceT<9>{}, inputData);
+  return adaptorF_convertArrayOfVectorToStdVectorImpl<O, D, T>(PreferenceT<10>{}, inputData);
 }
 
 
@@ -863,6 +1018,48 @@ inline void adaptorF_custom_convertNestedArrayToStdVector(void* dont_use) {
   // dummy function
 }
 
+// Helper for the recursive unpacking strategies below: convertRow(i, rowOut) fills rowOut with the entries of the i'th
+// inner array. If `parallel` is set, each chunk of rows is gathered in to its own buffer concurrently, then the chunks
+// are concatenated.
+template <class S, class I, class F>
+std::tuple<std::vector<S>, std::vector<I>> adaptorF_gatherNestedRows(bool parallel, size_t outerSize, F&& convertRow) {
+
+  size_t nChunks = parallel ? parallelChunkCount(outerSize) : 1;
+  std::vector<std::vector<S>> chunkData(nChunks);
+  std::vector<std::vector<size_t>> chunkRowEnds(nChunks); // relative to the start of the chunk
+
+  adaptorF_forChunks(parallel, outerSize, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    std::vector<S> tempVec;
+    for (size_t i = iStart; i < iEnd; i++) {
+      convertRow(i, tempVec);
+      chunkData[iChunk].insert(chunkData[iChunk].end(), tempVec.begin(), tempVec.end());
+      chunkRowEnds[iChunk].push_back(chunkData[iChunk].size());
+    }
+  });
+
+  std::tuple<std::vector<S>, std::vector<I>> outTuple;
+  std::vector<S>& dataOut = std::get<0>(outTuple);
+  std::vector<I>& dataStartOut = std::get<1>(outTuple);
+  dataStartOut.resize(outerSize + 1);
+  dataStartOut[0] = 0;
+
+  size_t iRow = 1;
+  for (size_t iChunk = 0; iChunk < nChunks; iChunk++) {
+    size_t chunkOffset = dataOut.size();
+    for (size_t rowEnd : chunkRowEnds[iChunk]) {
+      dataStartOut[iRow] = chunkOffset + rowEnd;
+      iRow++;
+    }
+    if (nChunks == 1) {
+      dataOut = std::move(chunkData[iChunk]);
+    } else {
+      dataOut.insert(dataOut.end(), chunkData[iChunk].begin(), chunkData[iChunk].end());
+    }
+  }
+
+  return outTuple;
+}
+
 // Highest priority: user-specified function
 template <class S, class I, class T,
     /* condition: user function must be return a tuple of vectors with the compatible type (techincally this just checks for bracket-indexible-thing */
@@ -941,23 +1138,13 @@ std::tuple<std::vector<S>, std::vector<I>>
 adaptorF_convertNestedArrayToStdVectorImpl(PreferenceT<4>, const T& inputData) {
 
   size_t outerSize = adaptorF_size(inputData);
-  
-  std::tuple<std::vector<S>, std::vector<I>> outTuple;
-  std::vector<S>& dataOut = std::get<0>(outTuple);
-  std::vector<I>& dataStartOut = std::get<1>(outTuple);
-  dataStartOut.resize(outerSize+1);
 
-  std::vector<S> tempVec;
+  // both the outer array and the inner arrays must be safe to visit concurrently
+  bool parallel = outerSize > 0 && adaptorF_canVisitInParallel(inputData) && adaptorF_canVisitInParallel(inputData[0]);
 
-  for (size_t i = 0; i < outerSize; i++) {
-    adaptorF_convertToStdVector<S>(inputData[i], tempVec);
-    for(auto& s : tempVec) {
-      dataOut.push_back(s);
-    }
-    dataStartOut[i+1] = dataOut.size();
-  }
-
-  return outTuple;
+  return adaptorF_gatherNestedRows<S, I>(parallel, outerSize, [&](size_t i, std::vector<S>& rowOut) {
+    adaptorF_convertToStdVector<S>(inputData[i], rowOut);
+  });
 }
 
 // Next: recusive unpacking with paren
@@ -972,23 +1159,10 @@ std::tuple<std::vector<S>, std::vector<I>>
 adaptorF_convertNestedArrayToStdVectorImpl(PreferenceT<3>, const T& inputData) {
 
   size_t outerSize = adaptorF_size(inputData);
-  
-  std::tuple<std::vector<S>, std::vector<I>> outTuple;
-  std::vector<S>& dataOut = std::get<0>(outTuple);
-  std::vector<I>& dataStartOut = std::get<1>(outTuple);
-  dataStartOut.resize(outerSize+1);
-  
-  std::vector<S> tempVec;
 
-  for (size_t i = 0; i < outerSize; i++) {
-    adaptorF_convertToStdVector<S>(inputData(i), tempVec);
-    for(auto& s : tempVec) {
-      dataOut.push_back(s);
-    }
-    dataStartOut[i+1] = dataOut.size();
-  }
-
-  return outTuple;
+  return adaptorF_gatherNestedRows<S, I>(false, outerSize, [&](size_t i, std::vector<S>& rowOut) {
+    adaptorF_convertToStdVector<S>(inputData(i), rowOut);
+  });
 }
 
 
@@ -1056,9 +1230,12 @@ adaptorF_convertNestedArrayToStdVectorImpl(PreferenceT<1>, const T& inputData) {
   
   dataStartOut[0] = 0;
 
-  for (size_t i = 0; i < outerSize * innerSize; i++) {
-    dataOut[i] = dataPtr[i];
-  }
+  S* outPtr = dataOut.data();
+  parallelForChunks(outerSize * innerSize, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      outPtr[i] = static_cast<S>(dataPtr[i]);
+    }
+  });
   for (size_t i = 1; i <= outerSize; i++) {
       dataStartOut[i] = i * innerSize;
   }
@@ -1173,6 +1350,12 @@ std::vector<D> standardizeArray(const T& inputData) {
   return out;
 }
 
+// If the input is already a temporary std::vector of the right type, adopt its storage rather than copying.
+template <class D>
+std::vector<D> standardizeArray(std::vector<D>&& inputData) {
+  return std::move(inputData);
+}
+
 // Convert an array of vector types
 // class O: output inner vector type to put the result in. Will be bracket-indexed.
 //          (Polyscope pretty much always uses glm::vec2/3, std::vector<>, or std::array<>)
@@ -1183,6 +1366,12 @@ std::vector<O> standardizeVectorArray(const T& inputData) {
   return adaptorF_convertArrayOfVectorToStdVector<O, D, T>(inputData);
 }
 
+// If the input is already a temporary std::vector of the right type, adopt its storage rather than copying.
+template <class O, unsigned int D>
+std::vector<O> standardizeVectorArray(std::vector<O>&& inputData) {
+  return std::move(inputData);
+}
+
 // Convert a nested array where the inner types have variable length.
 // class S: innermost scalar type for output
 // class T: input nested array type
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -9,6 +10,7 @@
 
 #include "glm/glm.hpp"
 
+#include "polyscope/bvh.h"
 #include "polyscope/floating_quantity.h"
 #include "polyscope/persistent_value.h"
 #include "polyscope/pick.h"
@@ -84,6 +86,26 @@ public:
   // Helpers to add rendering rules
   std::vector<std::string> addStructureRules(std::vector<std::string> initRules);
 
+  // ====================================================================
+  // ==== Ray casting ===================================================
+  // ====================================================================
+
+  // Find the nearest hit of the world-space ray origin + t * dir with t in [tMin, tMax], on the CPU (see rayCast() in
+  // pick.h). The default implementation never hits anything.
+  virtual RayCastResult rayCast(glm::vec3 origin, glm::vec3 dir, float tMin, float tMax);
+
+  // True if a ray cast gives the same pick result as the pick buffer currently would, so pick queries may skip
+  // rendering it (see options::pickWithRayCast). Structures which return true must also implement rayCastPickIndex().
+  virtual bool canRayCastPick();
+
+  // The local pick index which the pick buffer would have given for a hit from rayCast()
+  virtual uint64_t rayCastPickIndex(const RayCastResult& hit);
+
+  // The local pick indices of the elements whose positions lie in the region, whether or not they are visible, in
+  // sorted order. Used for region selections which include occluded elements. The default implementation selects
+  // nothing.
+  virtual std::vector<uint64_t> pickIndicesInRegion(const PickRegion& region);
+
   // ====================================================================
   // ==== ImGui UI elements =============================================
   // ====================================================================
@@ -119,6 +141,14 @@ public:
   float lengthScale();                            // get characteristic length
   virtual bool hasExtents();                      // bounding box and length scale are only meaningful if true
 
+  // = Culling
+  // Drawing the structure can be skipped if its bounding box, padded by getCullingPadding(), is entirely outside the
+  // view frustum of a view-projection matrix, or entirely on the removed side of a slice plane which applies to it.
+  // Both are always false if options::enableCulling is false.
+  bool isCulledByFrustum(const glm::mat4& viewProjMat);
+  bool isCulledBySlicePlanes();
+  virtual float getCullingPadding(); // how far outside the bounding box the structure (or its quantities) may draw
+
   // ====================================================================
   // ==== Enabling, Selection, and Groups ===============================
   // ====================================================================
@@ -173,6 +203,9 @@ public:
   void removeAllQuantities();
   void setAllQuantitiesEnabled(bool newEnabled);
 
+  // Memory held by the managed buffers of this structure, optionally including those of all of its quantities
+  render::ManagedBufferMemoryUsage getMemoryUsage(bool includeQuantities = true);
+
   // Maintain a _dominant_ quantity
   // If non-null, a special quantity of which only one can be drawn for the structure. Handles common case of a surface
   // color, e.g. color of a mesh or point cloud. The dominant quantity must always be enabled.
@@ -282,6 +315,30 @@ protected:
   std::tuple<glm::vec3, glm::vec3> objectSpaceBoundingBox;
   float objectSpaceLengthScale;
   virtual void updateObjectSpaceBounds() = 0;
+
+  // The corners of the world-space box tested by culling. Returns false if there is no meaningful box, in which case
+  // the structure is never culled.
+  bool getCullingBoxCorners(std::array<glm::vec3, 8>& corners);
+
+  // Positions may be updated without a refresh(), leaving objectSpaceBoundingBox stale. Structures whose bounds come
+  // from a buffer of positions override this to recompute the bounds once the buffer has changed, before they are used
+  // for culling. Returns false if the bounds are not known yet, in which case the structure is not culled.
+  virtual bool ensureCullingBoundsCurrent();
+
+  // Implements the above for bounds computed from the given positions, as of the update count boundsUpdateCount (which
+  // updateObjectSpaceBounds() should set). Positions which were updated on the device are copied back in the
+  // background rather than stalling the frame.
+  bool ensureBoundsCurrentWith(render::ManagedBuffer<glm::vec3>& positions, uint64_t boundsUpdateCount);
+
+  // Helper for rayCast() implementations: cast the ray against a BVH in the object space of the structure, clipped to
+  // the slice planes which apply to it. On a hit, fills in the structure, position, and distance of the result.
+  TriangleRayHit rayCastTriangles(const TriangleBVH& bvh, glm::vec3 origin, glm::vec3 dir, float tMin, float tMax,
+                                  bool cullBackfaces, RayCastResult& result);
+
+  // Helper for pickIndicesInRegion() implementations: the indices pickIndStart + i of the object-space positions[i]
+  // which are inside the region, and not removed by the slice planes which apply to the structure.
+  std::vector<uint64_t> pickIndicesOfPositionsInRegion(const std::vector<glm::vec3>& positions, uint64_t pickIndStart,
+                                                       const PickRegion& region);
 };
 
 
@@ -2,12 +2,16 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "polyscope/affine_remapper.h"
 #include "polyscope/color_management.h"
+#include "polyscope/mesh_simplification.h"
+#include "polyscope/mesh_topology.h"
+#include "polyscope/meshlets.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/render/engine.h"
 #include "polyscope/render/managed_buffer.h"
@@ -61,14 +65,15 @@ public:
   // initializes members
   SurfaceMesh(std::string name);
 
-  // From flattened list
-  SurfaceMesh(std::string name, const std::vector<glm::vec3>& vertexPositions,
-              const std::vector<uint32_t>& faceIndsEntries, const std::vector<uint32_t>& faceIndsStart);
+  // From flattened list (takes ownership of the arrays, pass temporaries to avoid a copy)
+  SurfaceMesh(std::string name, std::vector<glm::vec3> vertexPositions, std::vector<uint32_t> faceIndsEntries,
+              std::vector<uint32_t> faceIndsStart);
 
   // Construct from a nested face list
   SurfaceMesh(std::string name, const std::vector<glm::vec3>& vertexPositions,
               const std::vector<std::vector<size_t>>& faceIndices);
 
+  ~SurfaceMesh();
 
   // Build the imgui display
   virtual void buildCustomUI() override;
@@ -81,13 +86,23 @@ public:
   virtual void drawPick() override;
   virtual void drawPickDelayed() override;
   virtual void updateObjectSpaceBounds() override;
+  virtual bool ensureCullingBoundsCurrent() override;
   virtual std::string typeName() override;
   virtual void refresh() override;
 
+  // Ray casting
+  virtual RayCastResult rayCast(glm::vec3 origin, glm::vec3 dir, float tMin, float tMax) override;
+  virtual bool canRayCastPick() override;
+  virtual uint64_t rayCastPickIndex(const RayCastResult& hit) override;
+  virtual std::vector<uint64_t> pickIndicesInRegion(const PickRegion& region) override;
+
   // Mesh connectivity
   // (end users probably should not mess with theses)
   std::vector<uint32_t> faceIndsStart;
   std::vector<uint32_t> faceIndsEntries;
+  // index of the first triangle of each face in the triangulation, the last entry is the total [nFaces+1]
+  // (the faces are not necessarily laid out in order, see options::optimizeMeshDrawOrder)
+  std::vector<uint32_t> faceTriangleStart;
 
   // == Geometric quantities
   // (actually, these are wrappers around the private raw data members, but external users should interact with these
@@ -106,9 +121,13 @@ public:
   render::ManagedBuffer<uint32_t> triangleAllHalfedgeInds; // on triangulated mesh, all 3 [3 * 3 * nTriFace]
   render::ManagedBuffer<uint32_t> triangleAllCornerInds;   // on triangulated mesh, all 3 [3 * 3 * nTriFace]
 
-  // internal triangle data for rendering
-  render::ManagedBuffer<glm::vec3> baryCoord;  // on the split, triangulated mesh [3 * nTriFace]
-  render::ManagedBuffer<glm::vec3> edgeIsReal; // on the split, triangulated mesh [3 * nTriFace]
+  // internal per-triangle data for rendering, stored in rows of 2D textures (padded to fill the last row) and
+  // looked up by triangle index in shaders
+  render::ManagedBuffer<glm::vec3> triangleFaceNormals;     // on triangulated mesh [nTriFace]
+  render::ManagedBuffer<glm::vec3> triangleFaceCenters;     // on triangulated mesh [nTriFace]
+  render::ManagedBuffer<glm::vec3> triangleCornerPositions; // on triangulated mesh [3 * nTriFace]
+  render::ManagedBuffer<float> triangleEdgeFlags;           // on triangulated mesh [nTriFace], real edges as bits
+  render::ManagedBuffer<glm::vec4> trianglePickInds;        // on triangulated mesh [nTriFace], 3 vertices then face
 
   // other internally-computed geometry
   render::ManagedBuffer<glm::vec3> faceNormals;
@@ -249,7 +268,12 @@ public:
   void ensureHaveManifoldConnectivity();
   // Halfedges are implicitly indexed in order on the triangulated face list
   // (note that this may not match the halfedge perm that the user specifies)
-  std::vector<size_t> twinHalfedge; // for halfedge i, the index of a twin halfedge
+  std::vector<size_t> twinHalfedge; // for halfedge i (of the triangulation), the index of a twin halfedge
+
+  // = Vertex-face adjacency
+  // Not necessarily populated by default. Call ensureHaveVertexFaceAdjacency() to be sure it is populated.
+  void ensureHaveVertexFaceAdjacency();
+  VertexFaceAdjacency vertexFaceAdjacency; // the faces incident on each vertex (of the polygon mesh)
 
   static const std::string structureTypeName;
 
@@ -288,14 +312,42 @@ public:
   SurfaceMesh* setSelectionMode(MeshSelectionMode newMode);
   MeshSelectionMode getSelectionMode();
 
+  // Indexed rendering: draw via an index buffer over shared per-vertex data, rather than expanding all data to each
+  // triangle corner. Uses much less memory for large meshes. Quantities which are not defined on vertices are still
+  // drawn from expanded data, as is picking.
+  SurfaceMesh* setIndexedRendering(bool newVal);
+  bool getIndexedRendering();
+
+  // Meshlet culling: split the triangles in to meshlets of ~128 consecutive triangles, and each frame skip drawing
+  // those which are outside the view, cut away by slice planes, or (when back faces are culled) entirely back-facing.
+  // Useful for very large meshes of which only part is visible at a time. Has no effect on the surface itself while
+  // indexed rendering is used.
+  SurfaceMesh* setMeshletCulling(bool newVal);
+  bool getMeshletCulling();
+
+  // Level of detail: build a hierarchy of simplified versions of the mesh, and each frame draw the coarsest one whose
+  // error projects to at most levelOfDetailPixelError pixels on screen (or several times that while the camera is
+  // moving). The simplified meshes reuse the original vertices, so vertex quantities are drawn on them directly;
+  // other quantities, and picking, always use the full mesh. Implies indexed rendering.
+  SurfaceMesh* setLevelOfDetail(bool newVal);
+  bool getLevelOfDetail();
+  SurfaceMesh* setLevelOfDetailPixelError(float newVal);
+  float getLevelOfDetailPixelError();
+  // If true (the default), the hierarchy is built on a background thread, and the full mesh is drawn until it is done
+  SurfaceMesh* setLevelOfDetailBackgroundBuild(bool newVal);
+  bool getLevelOfDetailBackgroundBuild();
+  size_t getCurrentLevelOfDetail(); // the level drawn in the last frame, 0 is the full mesh
+
   // == Rendering helpers used by quantities
 
   // void fillGeometryBuffers(render::ShaderProgram& p);
   std::vector<std::string> addSurfaceMeshRules(std::vector<std::string> initRules, bool withMesh = true,
-                                               bool withSurfaceShade = true);
+                                               bool withSurfaceShade = true, bool indexed = false);
+  bool usingIndexedRendering(); // true if indexed rendering is enabled and supported by the current settings
   void setMeshGeometryAttributes(render::ShaderProgram& p);
   void setMeshPickAttributes(render::ShaderProgram& p);
   void setSurfaceMeshUniforms(render::ShaderProgram& p);
+  void prepareMeshDraw(render::ShaderProgram& p); // call before drawing the mesh triangles, applies culling and LOD
 
 
   // === ~DANGER~ experimental/unsupported functions
@@ -308,6 +360,8 @@ public:
 
 
 private:
+  uint64_t boundsPositionsUpdateCount = INVALID_IND_64; // update count of the positions the bounds are from
+
   // == Mesh geometry buffers
   // Storage for the managed buffers above. You should generally interact with these through the managed buffers, not
   // these members.
@@ -326,9 +380,12 @@ private:
   std::vector<uint32_t> triangleAllHalfedgeIndsData; // index of the corresponding original halfedge
   std::vector<uint32_t> triangleAllCornerIndsData;   // index of the corresponding original corner
 
-  // internal triangle data for rendering, defined per corner of the triangulated mesh
-  std::vector<glm::vec3> baryCoordData;  // always triangulated
-  std::vector<glm::vec3> edgeIsRealData; // always triangulated
+  // internal per-triangle data for rendering
+  std::vector<glm::vec3> triangleFaceNormalsData;
+  std::vector<glm::vec3> triangleFaceCentersData;
+  std::vector<glm::vec3> triangleCornerPositionsData;
+  std::vector<float> triangleEdgeFlagsData;
+  std::vector<glm::vec4> trianglePickIndsData;
 
   // other internally-computed geometry
   std::vector<glm::vec3> faceNormalsData;
@@ -360,6 +417,10 @@ private:
   PersistentValue<glm::vec3> backFaceColor;
   PersistentValue<MeshShadeStyle> shadeStyle;
   PersistentValue<MeshSelectionMode> selectionMode;
+  PersistentValue<bool> indexedRendering;
+  PersistentValue<bool> meshletCulling;
+  PersistentValue<bool> levelOfDetail;
+  PersistentValue<float> levelOfDetailPixelError;
 
   // Do setup work related to drawing, including allocating openGL data
   void prepare();
@@ -379,7 +440,31 @@ private:
   void computeEdgeLengths();
   void computeDefaultFaceTangentBasisX();
   void computeDefaultFaceTangentBasisY();
+  void computeTriangleFaceNormals();
+  void computeTriangleFaceCenters();
+  void computeTriangleCornerPositions();
+  void computeTriangleEdgeFlags();
+  void computeTrianglePickInds();
   void countEdges();
+  void checkTriangular(std::string errorMessage); // throws with the message if any face is not a triangle
+
+  // triangleVertexInds, but with the triangles in face order rather than draw order. Connectivity is derived from this,
+  // so that edge and halfedge numbering does not depend on options::optimizeMeshDrawOrder.
+  std::vector<uint32_t> faceOrderedTriangleVertexInds();
+
+  // The geometric quantities above are all computed by one fused, multithreaded pass over the faces (and then the
+  // vertices). The compute functions for each buffer request just their own quantity, while
+  // recomputeGeometryIfPopulated() requests every quantity in use at once.
+  struct GeometryComputeSet {
+    bool faceNormals = false;
+    bool faceCenters = false;
+    bool faceAreas = false;
+    bool vertexNormals = false;
+    bool vertexAreas = false;
+    bool defaultFaceTangentBasisX = false;
+    bool defaultFaceTangentBasisY = false;
+  };
+  void computeGeometry(const GeometryComputeSet& computeSet);
 
   // Picking-related
   // Order of indexing: vertexPositions, faces, edges, halfedges
@@ -404,6 +489,10 @@ private:
   std::shared_ptr<render::ShaderProgram> program;
   std::shared_ptr<render::ShaderProgram> pickProgram;
   bool usingSimplePick = false;
+  bool usingShaderPickInds = false; // simple picking, with the pick colors computed in the shader
+  bool wantsSimplePick();           // true if only vertices and faces need to be picked
+  float getVertexPickRadius();      // for simple picking, how close to a vertex (in barycentric coords) picks it
+  void updatePickIndStarts();       // sets the local pick index starts above
 
 
   // === Helper functions
@@ -411,6 +500,55 @@ private:
   void initializeMeshTriangulation();
   void recomputeGeometryIfPopulated();
 
+  // Meshlet culling
+  std::vector<Meshlet> meshlets;
+  uint64_t meshletsPositionsUpdateCount = 0; // update count of vertexPositions when the meshlets were built
+  std::vector<std::array<uint32_t, 2>> meshletDrawRanges; // visible ranges of triangle corners for this frame
+  void ensureHaveMeshlets();                               // (re)builds if the positions have changed
+  void updateMeshletDrawRanges();                          // cull against the current view
+
+  // Ray casting
+  TriangleBVH bvh;
+  uint64_t bvhPositionsUpdateCount = 0; // update count of vertexPositions when the BVH was built
+  uint64_t bvhIndicesUpdateCount = 0;   // update count of triangleVertexInds when the BVH was built
+  void ensureHaveBVH();                 // (re)builds if the geometry has changed
+  void setMeshGeometryAttributesIndexed(render::ShaderProgram& p);
+  void setMeshTriangleBuffersIndexed(render::ShaderProgram& p); // index & per-triangle data of the current level
+
+  // Level of detail
+  struct LevelOfDetail {
+    LevelOfDetail(const std::vector<glm::vec3>& vertexPositions, const SimplifiedMeshLevel& level);
+    float error;
+
+    std::vector<uint32_t> triangleVertexIndsData;
+    std::vector<glm::vec3> triangleFaceNormalsData;
+    std::vector<glm::vec3> triangleFaceCentersData;
+    std::vector<glm::vec3> triangleCornerPositionsData;
+    std::vector<float> triangleEdgeFlagsData;
+
+    // the same as the corresponding buffers of the mesh, but for the simplified triangles
+    render::ManagedBuffer<uint32_t> triangleVertexInds;
+    render::ManagedBuffer<glm::vec3> triangleFaceNormals;
+    render::ManagedBuffer<glm::vec3> triangleFaceCenters;
+    render::ManagedBuffer<glm::vec3> triangleCornerPositions;
+    render::ManagedBuffer<float> triangleEdgeFlags;
+  };
+  // A background build runs on a detached thread, which shares this with the mesh. If the mesh goes away (or the
+  // build is no longer wanted) it sets cancelled, and the thread drops its result when it finishes.
+  struct LevelOfDetailBuild {
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> finished{false};
+    std::vector<SimplifiedMeshLevel> levels; // only read once finished is set
+    uint64_t positionsUpdateCount;           // update count of vertexPositions for the build
+  };
+  bool levelOfDetailBackgroundBuild = true;
+  std::vector<std::unique_ptr<LevelOfDetail>> levelsOfDetail;   // increasingly coarse, not including the full mesh
+  uint64_t levelsOfDetailPositionsUpdateCount = INVALID_IND_64; // update count of vertexPositions for the levels
+  std::shared_ptr<LevelOfDetailBuild> levelOfDetailBuild;       // in-progress background build, if any
+  size_t currentLevelOfDetail = 0;                              // 0 is the full mesh, i is levelsOfDetail[i-1]
+  void updateLevelOfDetail(); // (re)build the hierarchy if the positions have changed, and choose the current level
+  void cancelLevelOfDetailBuild();
+
   glm::vec2 projectToScreenSpace(glm::vec3 coord);
 
 
@@ -446,6 +584,9 @@ private:
 // Register functions
 template <class V, class F>
 SurfaceMesh* registerSurfaceMesh(std::string name, const V& vertexPositions, const F& faceIndices);
+// (a temporary std::vector<glm::vec3> has its storage adopted rather than copied)
+template <class F>
+SurfaceMesh* registerSurfaceMesh(std::string name, std::vector<glm::vec3>&& vertexPositions, const F& faceIndices);
 template <class V, class F>
 SurfaceMesh* registerSurfaceMesh2D(std::string name, const V& vertexPositions, const F& faceIndices);
 
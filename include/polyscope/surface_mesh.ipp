@@ -10,6 +10,10 @@ namespace polyscope {
 // Shorthand to add a mesh to polyscope
 template <class V, class F>
 SurfaceMesh* registerSurfaceMesh(std::string name, const V& vertexPositions, const F& faceIndices) {
+  return registerSurfaceMesh(name, standardizeVectorArray<glm::vec3, 3>(vertexPositions), faceIndices);
+}
+template <class F>
+SurfaceMesh* registerSurfaceMesh(std::string name, std::vector<glm::vec3>&& vertexPositions, const F& faceIndices) {
   checkInitialized();
 
   std::tuple<std::vector<uint32_t>, std::vector<uint32_t>> nestedListTup =
@@ -19,7 +23,7 @@ SurfaceMesh* registerSurfaceMesh(std::string name, const V& vertexPositions, con
   std::vector<uint32_t>& faceIndsStart = std::get<1>(nestedListTup);
 
   SurfaceMesh* s =
-      new SurfaceMesh(name, standardizeVectorArray<glm::vec3, 3>(vertexPositions), faceIndsEntries, faceIndsStart);
+      new SurfaceMesh(name, std::move(vertexPositions), std::move(faceIndsEntries), std::move(faceIndsStart));
 
   bool success = registerStructure(s);
   if (!success) {
@@ -0,0 +1,167 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include "polyscope/color_management.h"
+#include "polyscope/persistent_value.h"
+#include "polyscope/polyscope.h"
+#include "polyscope/render/engine.h"
+#include "polyscope/render/managed_buffer.h"
+#include "polyscope/structure.h"
+#include "polyscope/surface_mesh.h"
+#include "polyscope/types.h"
+#include "polyscope/weak_handle.h"
+
+#include <vector>
+
+namespace polyscope {
+
+// Forward declare
+class SurfaceMeshInstances;
+
+struct SurfaceMeshInstancesPickResult {
+  size_t instanceIndex;    // which instance did we click
+  MeshElement elementType; // which kind of element did we click (vertex or face)
+  int64_t index;           // index of the clicked element in the base mesh
+};
+
+// Many copies of a SurfaceMesh, each with its own transform, drawn with a single instanced draw call. The instances
+// share all of the geometry buffers of the base mesh, so they follow any changes to it. Each transform maps the object
+// space of the base mesh in to the object space of this structure (the base mesh's own transform is not applied).
+class SurfaceMeshInstances : public Structure {
+public:
+  // === Member functions ===
+
+  // Construct a new instances structure. perInstanceColors may be empty, to use a single surface color.
+  SurfaceMeshInstances(std::string name, SurfaceMesh& baseMesh, std::vector<glm::mat4> transforms,
+                       std::vector<glm::vec3> perInstanceColors);
+
+  // === Overrides
+
+  // Build the imgui display
+  virtual void buildCustomUI() override;
+  virtual void buildCustomOptionsUI() override;
+  virtual void buildPickUI(const PickResult& result) override;
+
+  // Standard structure overrides
+  virtual void draw() override;
+  virtual void drawDelayed() override;
+  virtual void drawPick() override;
+  virtual void drawPickDelayed() override;
+  virtual void updateObjectSpaceBounds() override;
+  virtual bool ensureCullingBoundsCurrent() override;
+  virtual std::string typeName() override;
+  virtual void refresh() override;
+
+  // === Geometry members
+
+  // per-instance data, stored in rows of 2D textures (padded to fill the last row) and looked up by instance index
+  render::ManagedBuffer<glm::vec4> instanceTransforms; // the 4 columns of each transform [4 * nInstances]
+  render::ManagedBuffer<glm::vec3> instanceColors;     // [nInstances], or empty if there are no per-instance colors
+
+  size_t nInstances() { return nInstancesCount; }
+  bool hasBaseMesh(); // false if the base mesh has been removed, in which case nothing is drawn
+  SurfaceMesh& getBaseMesh();
+
+  // === Mutate
+
+  void updateInstanceTransforms(const std::vector<glm::mat4>& newTransforms);
+
+  template <class C>
+  void updateInstanceColors(const C& newColors);
+
+  // Misc data
+  static const std::string structureTypeName;
+
+  // get data related to picking/selection
+  SurfaceMeshInstancesPickResult interpretPickResult(const PickResult& result);
+
+  // === Get/set visualization parameters
+
+  // set the base color of the surface, used if there are no per-instance colors
+  SurfaceMeshInstances* setSurfaceColor(glm::vec3 newVal);
+  glm::vec3 getSurfaceColor();
+
+  // Material
+  SurfaceMeshInstances* setMaterial(std::string name);
+  std::string getMaterial();
+
+  // Backface color
+  SurfaceMeshInstances* setBackFaceColor(glm::vec3 val);
+  glm::vec3 getBackFaceColor();
+
+  // Backface policy
+  SurfaceMeshInstances* setBackFacePolicy(BackFacePolicy newPolicy);
+  BackFacePolicy getBackFacePolicy();
+
+  // Color of edges
+  SurfaceMeshInstances* setEdgeColor(glm::vec3 val);
+  glm::vec3 getEdgeColor();
+
+  // Width of edges
+  SurfaceMeshInstances* setEdgeWidth(double newVal);
+  double getEdgeWidth();
+
+  // Rendering helpers
+  void setInstancesUniforms(render::ShaderProgram& p, bool withSurfaceShade = true);
+  void setInstancesGeometryAttributes(render::ShaderProgram& p);
+  std::vector<std::string> addInstancesRules(std::vector<std::string> initRules, bool withSurfaceShade = true);
+
+private:
+  uint64_t boundsPositionsUpdateCount = INVALID_IND_64; // update count of the base mesh positions the bounds are from
+
+  WeakHandle<SurfaceMesh> baseMesh;
+  size_t nInstancesCount;
+
+  // Storage for the managed buffers above. You should generally interact with this directly through them.
+  std::vector<glm::vec4> instanceTransformsData;
+  std::vector<glm::vec3> instanceColorsData;
+
+  // === Visualization parameters
+  PersistentValue<glm::vec3> surfaceColor;
+  PersistentValue<std::string> material;
+  PersistentValue<BackFacePolicy> backFacePolicy;
+  PersistentValue<glm::vec3> backFaceColor;
+  PersistentValue<glm::vec3> edgeColor;
+  PersistentValue<float> edgeWidth;
+
+  // Drawing related things
+  // if nullptr, prepare() (resp. preparePick()) needs to be called
+  std::shared_ptr<render::ShaderProgram> program;
+  std::shared_ptr<render::ShaderProgram> pickProgram;
+  MeshShadeStyle preparedShadeStyle; // shading of the base mesh when the program was prepared
+
+  // === Helpers
+  // Do setup work related to drawing, including allocating openGL data
+  void ensureRenderProgramPrepared();
+  void ensurePickProgramPrepared();
+  void fillInstanceTransforms(const std::vector<glm::mat4>& transforms);
+  void fillInstanceColors(const std::vector<glm::vec3>& colors);
+
+  // == Picking related things
+  // Each instance gets a run of pick indices, with the vertices then the faces of the base mesh. The pick colors of
+  // the base mesh elements are shared by all instances, and offset by the start of each instance's run in the shader.
+  size_t pickStart;
+  size_t pickIndsPerInstance;
+  std::vector<glm::vec3> instancePickColorsData;
+  render::ManagedBuffer<glm::vec3> instancePickColors; // the first pick index of each instance [nInstances]
+};
+
+
+// Shorthand to add instances of a surface mesh to polyscope
+SurfaceMeshInstances* registerSurfaceMeshInstances(std::string name, SurfaceMesh* baseMesh,
+                                                   const std::vector<glm::mat4>& transforms);
+template <class C>
+SurfaceMeshInstances* registerSurfaceMeshInstances(std::string name, SurfaceMesh* baseMesh,
+                                                   const std::vector<glm::mat4>& transforms,
+                                                   const C& perInstanceColors);
+
+// Shorthand to get instances of a surface mesh from polyscope
+inline SurfaceMeshInstances* getSurfaceMeshInstances(std::string name = "");
+inline bool hasSurfaceMeshInstances(std::string name = "");
+inline void removeSurfaceMeshInstances(std::string name = "", bool errorIfAbsent = false);
+
+
+} // namespace polyscope
+
+#include "polyscope/surface_mesh_instances.ipp"
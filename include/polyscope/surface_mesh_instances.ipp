@@ -0,0 +1,46 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/standardize_data_array.h"
+#include "polyscope/utilities.h"
+
+namespace polyscope {
+
+template <class C>
+SurfaceMeshInstances* registerSurfaceMeshInstances(std::string name, SurfaceMesh* baseMesh,
+                                                   const std::vector<glm::mat4>& transforms,
+                                                   const C& perInstanceColors) {
+  checkInitialized();
+
+  if (baseMesh == nullptr) exception("registerSurfaceMeshInstances: base mesh must not be null");
+  validateSize(perInstanceColors, transforms.size(), "perInstanceColors");
+
+  SurfaceMeshInstances* s = new SurfaceMeshInstances(name, *baseMesh, transforms,
+                                                     standardizeVectorArray<glm::vec3, 3>(perInstanceColors));
+
+  bool success = registerStructure(s);
+  if (!success) {
+    safeDelete(s);
+  }
+
+  return s;
+}
+
+template <class C>
+void SurfaceMeshInstances::updateInstanceColors(const C& newColors) {
+  validateSize(newColors, nInstances(), "newColors");
+  fillInstanceColors(standardizeVectorArray<glm::vec3, 3>(newColors));
+  refresh(); // the shaders change if there were no colors before
+}
+
+// Shorthand to get instances from polyscope
+inline SurfaceMeshInstances* getSurfaceMeshInstances(std::string name) {
+  return dynamic_cast<SurfaceMeshInstances*>(getStructure(SurfaceMeshInstances::structureTypeName, name));
+}
+inline bool hasSurfaceMeshInstances(std::string name) {
+  return hasStructure(SurfaceMeshInstances::structureTypeName, name);
+}
+inline void removeSurfaceMeshInstances(std::string name, bool errorIfAbsent) {
+  removeStructure(SurfaceMeshInstances::structureTypeName, name, errorIfAbsent);
+}
+
+} // namespace polyscope
@@ -41,6 +41,7 @@ public:
   virtual void buildCustomUI() override;
   virtual void refresh() override;
   virtual std::string niceName() override;
+  virtual float getCullingPadding() override;
   virtual void buildVertexInfoGUI(size_t vInd) override;
 };
 
@@ -56,6 +57,7 @@ public:
   virtual void buildCustomUI() override;
   virtual void refresh() override;
   virtual std::string niceName() override;
+  virtual float getCullingPadding() override;
   virtual void buildFaceInfoGUI(size_t fInd) override;
 };
 
@@ -72,6 +74,7 @@ public:
   virtual void buildCustomUI() override;
   virtual void refresh() override;
   virtual std::string niceName() override;
+  virtual float getCullingPadding() override;
   void buildFaceInfoGUI(size_t fInd) override;
 };
 
@@ -90,6 +93,7 @@ public:
 
   virtual void refresh() override;
   virtual std::string niceName() override;
+  virtual float getCullingPadding() override;
   void buildVertexInfoGUI(size_t vInd) override;
 };
 
@@ -106,6 +110,7 @@ public:
   virtual void buildCustomUI() override;
   virtual void refresh() override;
   virtual std::string niceName() override;
+  virtual float getCullingPadding() override;
 
   std::vector<float> oneForm;
   std::vector<char> canonicalOrientation;
@@ -3,16 +3,20 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <complex>
 #include <cstdint>
 #include <cstdio>
+#include <exception>
 #include <iomanip>
 #include <iostream>
 #include <memory>
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -49,6 +53,9 @@ void validateName(const std::string& name);
 // Print large integers in a user-friendly way (like "37.5B")
 std::string prettyPrintCount(size_t count);
 
+// Print a size in bytes in a user-friendly way (like "12.3 MB")
+std::string prettyPrintBytes(size_t bytes);
+
 // Printf to a std::string
 template <typename... Args>
 std::string str_printf(const std::string& format, Args... args) {
@@ -134,6 +141,61 @@ std::vector<T> gather(const std::vector<T>& input, const std::vector<uint32_t>&
   return result;
 }
 
+// Dimensions of a 2D texture which holds nEntries values in row-major order. Per-element data for rendering is stored
+// this way since there are generally more entries than the maximum size of a 1D texture.
+std::array<uint32_t, 2> dataTextureSize2D(size_t nEntries);
+
+
+// === Parallelism
+
+// Loops shorter than this many iterations per thread are run serially by parallelForChunks(), since starting threads
+// would cost more than it saves.
+const size_t PARALLEL_MIN_CHUNK_SIZE = 1 << 16;
+
+// The number of chunks parallelForChunks() will split a loop of this length in to
+inline size_t parallelChunkCount(size_t count) {
+  size_t nThreads = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(1));
+  size_t nChunksForSize = (count + PARALLEL_MIN_CHUNK_SIZE - 1) / PARALLEL_MIN_CHUNK_SIZE;
+  return std::max(std::min(nThreads, nChunksForSize), static_cast<size_t>(1));
+}
+
+// Split the range [0, count) in to contiguous chunks, and call func(iChunk, iStart, iEnd) on each chunk concurrently.
+// Chunks are ordered, and there are exactly parallelChunkCount(count) of them (some may be empty). Small ranges are
+// run as a single chunk on the calling thread. Any exception thrown by func is rethrown on the calling thread.
+template <typename F>
+void parallelForChunks(size_t count, F&& func) {
+  size_t nChunks = parallelChunkCount(count);
+  if (nChunks == 1) {
+    func(static_cast<size_t>(0), static_cast<size_t>(0), count);
+    return;
+  }
+
+  size_t chunkSize = (count + nChunks - 1) / nChunks;
+  std::vector<std::exception_ptr> chunkExceptions(nChunks);
+  auto runChunk = [&](size_t iChunk) {
+    size_t iStart = std::min(iChunk * chunkSize, count);
+    size_t iEnd = std::min(iStart + chunkSize, count);
+    try {
+      func(iChunk, iStart, iEnd);
+    } catch (...) {
+      chunkExceptions[iChunk] = std::current_exception();
+    }
+  };
+
+  // the calling thread takes the first chunk
+  std::vector<std::thread> workers;
+  for (size_t iChunk = 1; iChunk < nChunks; iChunk++) {
+    workers.emplace_back(runChunk, iChunk);
+  }
+  runChunk(0);
+  for (std::thread& w : workers) {
+    w.join();
+  }
+
+  for (std::exception_ptr& e : chunkExceptions) {
+    if (e) std::rethrow_exception(e);
+  }
+}
 
 // === Random number generation
 extern std::mt19937 util_mersenne_twister; // deterministically seeded on startup
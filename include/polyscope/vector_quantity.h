@@ -10,6 +10,8 @@
 #include "polyscope/scaled_value.h"
 #include "polyscope/types.h"
 
+#include <limits>
+
 
 namespace polyscope {
 
@@ -29,6 +31,9 @@ public:
   // Build the ImGUI UIs for vectors
   void buildVectorUI();
 
+  // How far the vectors may reach from their roots, see Quantity::getCullingPadding()
+  float getVectorCullingPadding();
+
   // === Members
   QuantityT& quantity;
 
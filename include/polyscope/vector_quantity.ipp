@@ -91,6 +91,15 @@ double VectorQuantityBase<QuantityT>::getVectorRadius() {
   return vectorRadius.get().asAbsolute();
 }
 
+template <typename QuantityT>
+float VectorQuantityBase<QuantityT>::getVectorCullingPadding() {
+  // With a manually-set range, vectors longer than the range are not bounded by the length scale
+  if (vectorLengthRangeManuallySet || vectorLengthRange < 0.) return std::numeric_limits<float>::infinity();
+
+  float maxLength = (vectorType == VectorType::AMBIENT) ? vectorLengthRange : vectorLengthMult.get().asAbsolute();
+  return maxLength + vectorRadius.get().asAbsolute();
+}
+
 template <typename QuantityT>
 QuantityT* VectorQuantityBase<QuantityT>::setVectorColor(glm::vec3 color) {
   vectorColor = color;
@@ -152,6 +161,11 @@ void VectorQuantity<QuantityT>::drawVectors() {
   this->vectorProgram->setUniform("u_invProjMatrix", glm::value_ptr(Pinv));
   this->vectorProgram->setUniform("u_viewport", render::engine->getCurrentViewport());
 
+  if (vectorRoots.getDeviceStorageFormat() == AttributeStorageFormat::UNorm16) {
+    this->vectorProgram->setUniform("u_positionQuantizationOffset", glm::vec3(vectorRoots.getQuantizationOffset()));
+    this->vectorProgram->setUniform("u_positionQuantizationScale", glm::vec3(vectorRoots.getQuantizationScale()));
+  }
+
   this->vectorProgram->draw();
 }
 
@@ -163,6 +177,9 @@ void VectorQuantity<QuantityT>::createProgram() {
   if (this->quantity.parent.wantsCullPosition()) {
     rules.push_back("VECTOR_CULLPOS_FROM_TAIL");
   }
+  if (vectorRoots.getDeviceStorageFormat() == AttributeStorageFormat::UNorm16) {
+    rules.push_back("POSITION_QUANTIZED");
+  }
 
 
   // Create the vectorProgram to draw this quantity
@@ -167,6 +167,8 @@ bool getWindowResizable();
 glm::vec3 screenCoordsToWorldRay(glm::vec2 screenCoords);
 glm::vec3 bufferIndsToWorldRay(glm::ivec2 bufferInds);
 glm::vec3 screenCoordsAndDepthToWorldPosition(glm::vec2 screenCoords, float clipDepth);
+glm::vec3 screenCoordsAndDepthToWorldPosition(glm::vec2 screenCoords, float clipDepth, const glm::mat4& viewMat,
+                                              const glm::mat4& projMat); // for a camera other than the current one
 
 // Get and set camera from json string
 std::string getViewAsJson();
@@ -57,9 +57,15 @@ public:
   virtual void drawPick() override;
   virtual void drawPickDelayed() override;
   virtual void updateObjectSpaceBounds() override;
+  virtual bool ensureCullingBoundsCurrent() override;
   virtual std::string typeName() override;
   virtual void refresh() override;
 
+  // Ray casting, against the exterior faces of the mesh
+  virtual RayCastResult rayCast(glm::vec3 origin, glm::vec3 dir, float tMin, float tMax) override;
+  virtual bool canRayCastPick() override;
+  virtual uint64_t rayCastPickIndex(const RayCastResult& hit) override;
+
   // == Geometric quantities
   // (actually, these are wrappers around the private raw data members, but external users should interact with these
   // wrappers)
@@ -73,9 +79,8 @@ public:
   render::ManagedBuffer<uint32_t> triangleCellInds;   // on the split, triangulated mesh [3 * nTriFace]
 
   // internal triangle data for rendering
-  render::ManagedBuffer<glm::vec3> baryCoord;  // on the split, triangulated mesh [3 * nTriFace]
-  render::ManagedBuffer<glm::vec3> edgeIsReal; // on the split, triangulated mesh [3 * nTriFace]
-  render::ManagedBuffer<float> faceType;       // on the split, triangulated mesh [3 * nTriFace]
+  render::ManagedBuffer<float> faceType;          // on the split, triangulated mesh [3 * nTriFace]
+  render::ManagedBuffer<float> triangleEdgeFlags; // on the split, triangulated mesh [nTriFace], 2D texture
 
   // other internally-computed geometry
   render::ManagedBuffer<glm::vec3> faceNormals;
@@ -183,6 +188,8 @@ public:
 
 
 private:
+  uint64_t boundsPositionsUpdateCount = INVALID_IND_64; // update count of the positions the bounds are from
+
   // == Mesh geometry buffers
   // Storage for the managed buffers above. You should generally interact with these through the managed buffers, not
   // these members.
@@ -196,9 +203,8 @@ private:
   std::vector<uint32_t> triangleCellIndsData;   // to the split, triangulated mesh
 
   // internal triangle data for rendering
-  std::vector<glm::vec3> baryCoordData;
-  std::vector<glm::vec3> edgeIsRealData;
   std::vector<float> faceTypeData;
+  std::vector<float> triangleEdgeFlagsData;
 
   // other internally-computed geometry
   std::vector<glm::vec3> faceNormalsData;
@@ -227,9 +233,17 @@ private:
   // Within each set, uses the implicit ordering from the mesh data structure
   // These starts are LOCAL indices, indexing elements only with the mesh
   size_t cellPickIndStart;
+  float getVertexPickRadius(); // how close to a vertex (in barycentric coords) picks it, rather than the cell
   void buildVertexInfoGui(size_t vInd);
   void buildCellInfoGUI(size_t cInd);
 
+  // Ray casting
+  TriangleBVH bvh;
+  std::vector<uint32_t> bvhTriangles;   // the triangle of the triangulation for each triangle in the BVH
+  uint64_t bvhPositionsUpdateCount = 0; // update count of vertexPositions when the BVH was built
+  uint64_t bvhIndicesUpdateCount = 0;   // update count of triangleVertexInds when the BVH was built
+  void ensureHaveBVH();                 // (re)builds if the geometry has changed
+
   /// == Compute indices & geometry data
   void computeFaceNormals();
   void computeCellCenters();
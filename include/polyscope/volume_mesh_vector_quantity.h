@@ -39,6 +39,7 @@ public:
   virtual void buildCustomUI() override;
   virtual void refresh() override;
   virtual std::string niceName() override;
+  virtual float getCullingPadding() override;
   virtual void buildVertexInfoGUI(size_t vInd) override;
 };
 
@@ -55,6 +56,7 @@ public:
   virtual void buildCustomUI() override;
   virtual void refresh() override;
   virtual std::string niceName() override;
+  virtual float getCullingPadding() override;
   virtual void buildCellInfoGUI(size_t cInd) override;
 };
 
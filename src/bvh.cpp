@@ -0,0 +1,388 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/bvh.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace polyscope {
+
+namespace {
+
+const size_t SAH_BIN_COUNT = 16;
+const size_t MAX_LEAF_SIZE = 8; // larger nodes are always split
+
+struct Bounds {
+  glm::vec3 min{std::numeric_limits<float>::infinity()};
+  glm::vec3 max{-std::numeric_limits<float>::infinity()};
+
+  void expand(const glm::vec3& p) {
+    min = glm::min(min, p);
+    max = glm::max(max, p);
+  }
+  void expand(const Bounds& b) {
+    min = glm::min(min, b.min);
+    max = glm::max(max, b.max);
+  }
+  float halfArea() const {
+    glm::vec3 d = max - min;
+    if (!(d.x >= 0.f && d.y >= 0.f && d.z >= 0.f)) return 0.f; // empty
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+  }
+};
+
+struct Bin {
+  size_t count = 0;
+  Bounds bounds;
+};
+using AxisBins = std::array<std::array<Bin, SAH_BIN_COUNT>, 3>;
+
+bool rayIntersectsBox(const glm::vec3& bboxMin, const glm::vec3& bboxMax, const glm::vec3& origin,
+                      const glm::vec3& invDir, float tMin, float tMax, float& tEntry) {
+  glm::vec3 t0 = (bboxMin - origin) * invDir;
+  glm::vec3 t1 = (bboxMax - origin) * invDir;
+  glm::vec3 tNear = glm::min(t0, t1);
+  glm::vec3 tFar = glm::max(t0, t1);
+  tEntry = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, tMin));
+  float tExit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+  return tEntry <= tExit * (1.f + 1e-6f); // (conservative, so rays through box corners are not lost to rounding)
+}
+
+// Möller-Trumbore intersection
+bool rayIntersectsTriangle(const glm::vec3* corners, const glm::vec3& origin, const glm::vec3& dir,
+                           RayCastFaceCull cull, float& t, glm::vec3& baryCoords) {
+  glm::vec3 e1 = corners[1] - corners[0];
+  glm::vec3 e2 = corners[2] - corners[0];
+  glm::vec3 p = glm::cross(dir, e2);
+  float det = glm::dot(e1, p); // positive if the ray approaches the front side
+
+  if (det == 0.f) return false;
+  if (cull == RayCastFaceCull::Back && det < 0.f) return false;
+  if (cull == RayCastFaceCull::Front && det > 0.f) return false;
+
+  float invDet = 1.f / det;
+  glm::vec3 s = origin - corners[0];
+  float u = glm::dot(s, p) * invDet;
+  if (u < 0.f || u > 1.f) return false;
+  glm::vec3 q = glm::cross(s, e1);
+  float v = glm::dot(dir, q) * invDet;
+  if (v < 0.f || u + v > 1.f) return false;
+
+  t = glm::dot(e2, q) * invDet;
+  baryCoords = glm::vec3{1.f - u - v, u, v};
+  return true;
+}
+
+} // namespace
+
+struct TriangleBVH::Builder {
+  const std::vector<Bounds>& triangleBounds;
+  const std::vector<glm::vec3>& centroids;
+  std::vector<uint32_t>& order;
+
+  // A subtree which is left to be built later, rooted at nodes[nodeInd] over order[begin] to order[end]
+  struct Task {
+    size_t nodeInd;
+    size_t begin;
+    size_t end;
+  };
+
+  // Bounds of the triangles and of their centroids over a range of the order
+  void computeRangeBounds(size_t begin, size_t end, bool parallel, Bounds& nodeBounds, Bounds& centroidBounds) {
+    auto accumulate = [&](size_t iStart, size_t iEnd, Bounds& nodeB, Bounds& centroidB) {
+      for (size_t i = iStart; i < iEnd; i++) {
+        nodeB.expand(triangleBounds[order[i]]);
+        centroidB.expand(centroids[order[i]]);
+      }
+    };
+
+    nodeBounds = Bounds();
+    centroidBounds = Bounds();
+    if (!parallel) {
+      accumulate(begin, end, nodeBounds, centroidBounds);
+      return;
+    }
+
+    size_t count = end - begin;
+    std::vector<Bounds> chunkNodeBounds(parallelChunkCount(count));
+    std::vector<Bounds> chunkCentroidBounds(parallelChunkCount(count));
+    parallelForChunks(count, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+      accumulate(begin + iStart, begin + iEnd, chunkNodeBounds[iChunk], chunkCentroidBounds[iChunk]);
+    });
+    for (size_t iChunk = 0; iChunk < chunkNodeBounds.size(); iChunk++) {
+      nodeBounds.expand(chunkNodeBounds[iChunk]);
+      centroidBounds.expand(chunkCentroidBounds[iChunk]);
+    }
+  }
+
+  // Partition a range of the order with the best binned SAH split, returning the start of the second half. Returns
+  // begin if the range should be a leaf.
+  size_t split(size_t begin, size_t end, const Bounds& nodeBounds, const Bounds& centroidBounds, bool parallel) {
+    size_t count = end - begin;
+    if (count <= 1) return begin;
+
+    glm::vec3 binScale;
+    for (int k = 0; k < 3; k++) {
+      float extent = centroidBounds.max[k] - centroidBounds.min[k];
+      binScale[k] = extent > 0.f ? static_cast<float>(SAH_BIN_COUNT) / extent : 0.f;
+    }
+    auto binInd = [&](const glm::vec3& c, int k) {
+      float f = (c[k] - centroidBounds.min[k]) * binScale[k];
+      return f > 0.f ? std::min(static_cast<size_t>(f), SAH_BIN_COUNT - 1) : static_cast<size_t>(0); // (NaN -> 0)
+    };
+
+    // Sort the triangles in to bins along each axis
+    auto accumulate = [&](size_t iStart, size_t iEnd, AxisBins& bins) {
+      for (size_t i = iStart; i < iEnd; i++) {
+        uint32_t iT = order[i];
+        for (int k = 0; k < 3; k++) {
+          Bin& bin = bins[k][binInd(centroids[iT], k)];
+          bin.count++;
+          bin.bounds.expand(triangleBounds[iT]);
+        }
+      }
+    };
+    AxisBins bins;
+    if (parallel) {
+      std::vector<AxisBins> chunkBins(parallelChunkCount(count));
+      parallelForChunks(count, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+        accumulate(begin + iStart, begin + iEnd, chunkBins[iChunk]);
+      });
+      for (const AxisBins& c : chunkBins) {
+        for (int k = 0; k < 3; k++) {
+          for (size_t b = 0; b < SAH_BIN_COUNT; b++) {
+            bins[k][b].count += c[k][b].count;
+            bins[k][b].bounds.expand(c[k][b].bounds);
+          }
+        }
+      }
+    } else {
+      accumulate(begin, end, bins);
+    }
+
+    // Sweep the bins to find the cheapest split, as (cost of the children) / (area of this node)
+    float nodeArea = nodeBounds.halfArea();
+    float bestCost = std::numeric_limits<float>::infinity();
+    int bestAxis = -1;
+    size_t bestBin = 0;
+    for (int k = 0; k < 3; k++) {
+      if (binScale[k] == 0.f) continue;
+
+      std::array<float, SAH_BIN_COUNT> rightCost;
+      Bounds rightBounds;
+      size_t rightCount = 0;
+      for (size_t b = SAH_BIN_COUNT - 1; b > 0; b--) {
+        rightBounds.expand(bins[k][b].bounds);
+        rightCount += bins[k][b].count;
+        rightCost[b] = rightBounds.halfArea() * static_cast<float>(rightCount);
+      }
+
+      Bounds leftBounds;
+      size_t leftCount = 0;
+      for (size_t b = 0; b + 1 < SAH_BIN_COUNT; b++) {
+        leftBounds.expand(bins[k][b].bounds);
+        leftCount += bins[k][b].count;
+        if (leftCount == 0 || leftCount == count) continue;
+        float cost = leftBounds.halfArea() * static_cast<float>(leftCount) + rightCost[b + 1];
+        if (cost < bestCost) {
+          bestCost = cost;
+          bestAxis = k;
+          bestBin = b;
+        }
+      }
+    }
+
+    if (bestAxis == -1) {
+      // All of the centroids coincide, so there is no spatial split. Split the range in half if it is too big.
+      return count <= MAX_LEAF_SIZE ? begin : begin + count / 2;
+    }
+
+    // Leaves cost one intersection test per triangle, interior nodes one box test and then the children
+    if (count <= MAX_LEAF_SIZE && nodeArea > 0.f && 1.f + bestCost / nodeArea >= static_cast<float>(count)) {
+      return begin;
+    }
+
+    auto middle = std::partition(order.begin() + begin, order.begin() + end,
+                                 [&](uint32_t iT) { return binInd(centroids[iT], bestAxis) <= bestBin; });
+    return static_cast<size_t>(middle - order.begin());
+  }
+
+  // Build the subtree rooted at nodes[rootInd] over a range of the order. If tasks is non-null, ranges of at most
+  // taskSize triangles are not built, but added to the task list.
+  void buildSubtree(std::vector<Node>& nodes, size_t rootInd, size_t begin, size_t end, bool parallel,
+                    std::vector<Task>* tasks, size_t taskSize) {
+    std::vector<Task> stack{Task{rootInd, begin, end}};
+    while (!stack.empty()) {
+      Task curr = stack.back();
+      stack.pop_back();
+
+      Bounds nodeBounds, centroidBounds;
+      computeRangeBounds(curr.begin, curr.end, parallel, nodeBounds, centroidBounds);
+      nodes[curr.nodeInd].bboxMin = nodeBounds.min;
+      nodes[curr.nodeInd].bboxMax = nodeBounds.max;
+
+      if (tasks != nullptr && curr.end - curr.begin <= taskSize) {
+        tasks->push_back(curr);
+        continue;
+      }
+
+      size_t middle = split(curr.begin, curr.end, nodeBounds, centroidBounds, parallel);
+      if (middle == curr.begin || middle == curr.end) {
+        nodes[curr.nodeInd].first = static_cast<uint32_t>(curr.begin);
+        nodes[curr.nodeInd].count = static_cast<uint32_t>(curr.end - curr.begin);
+        continue;
+      }
+
+      size_t childInd = nodes.size();
+      nodes.resize(nodes.size() + 2);
+      nodes[curr.nodeInd].first = static_cast<uint32_t>(childInd);
+      nodes[curr.nodeInd].count = 0;
+      stack.push_back(Task{childInd + 1, middle, curr.end});
+      stack.push_back(Task{childInd, curr.begin, middle});
+    }
+  }
+};
+
+void TriangleBVH::build(const std::vector<glm::vec3>& vertexPositions,
+                        const std::vector<uint32_t>& triangleVertexInds) {
+  clear();
+
+  // Per-triangle bounds and centroids
+  size_t nInputTriangles = triangleVertexInds.size() / 3;
+  std::vector<Bounds> triangleBounds(nInputTriangles);
+  std::vector<glm::vec3> centroids(nInputTriangles);
+  std::vector<char> triangleValid(nInputTriangles, false);
+  parallelForChunks(nInputTriangles, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iT = iStart; iT < iEnd; iT++) {
+      bool valid = true;
+      for (size_t k = 0; k < 3; k++) {
+        uint32_t iV = triangleVertexInds[3 * iT + k];
+        if (iV >= vertexPositions.size()) {
+          valid = false;
+          break;
+        }
+        triangleBounds[iT].expand(vertexPositions[iV]);
+      }
+      triangleValid[iT] = valid;
+      centroids[iT] = 0.5f * (triangleBounds[iT].min + triangleBounds[iT].max);
+    }
+  });
+
+  std::vector<uint32_t> order;
+  order.reserve(nInputTriangles);
+  for (size_t iT = 0; iT < nInputTriangles; iT++) {
+    if (triangleValid[iT]) order.push_back(static_cast<uint32_t>(iT));
+  }
+  size_t nValid = order.size();
+
+  Builder builder{triangleBounds, centroids, order};
+  nodes.reserve(2 * nValid);
+  nodes.resize(1);
+  size_t nChunks = parallelChunkCount(nValid);
+  if (nChunks == 1) {
+    builder.buildSubtree(nodes, 0, 0, nValid, false, nullptr, 0);
+  } else {
+
+    // Build the top of the tree, until the remaining subtrees are small enough that there are a few per thread
+    std::vector<Builder::Task> tasks;
+    size_t taskSize = (nValid + 4 * nChunks - 1) / (4 * nChunks);
+    builder.buildSubtree(nodes, 0, 0, nValid, true, &tasks, taskSize);
+
+    // Build the subtrees in parallel, each in to its own list of nodes. The tasks are disjoint ranges of the order, so
+    // each chunk of the order takes the tasks which begin within it.
+    std::vector<std::vector<Node>> taskNodes(tasks.size());
+    parallelForChunks(nValid, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+      for (size_t i = 0; i < tasks.size(); i++) {
+        if (tasks[i].begin < iStart || tasks[i].begin >= iEnd) continue;
+        taskNodes[i].resize(1);
+        builder.buildSubtree(taskNodes[i], 0, tasks[i].begin, tasks[i].end, false, nullptr, 0);
+      }
+    });
+
+    // Splice the subtrees in, with each root replacing the placeholder node for its task
+    for (size_t i = 0; i < tasks.size(); i++) {
+      size_t offset = nodes.size() - 1; // node j > 0 of the subtree goes to offset + j
+      for (size_t j = 0; j < taskNodes[i].size(); j++) {
+        Node node = taskNodes[i][j];
+        if (node.count == 0) node.first += static_cast<uint32_t>(offset);
+        if (j == 0) {
+          nodes[tasks[i].nodeInd] = node;
+        } else {
+          nodes.push_back(node);
+        }
+      }
+    }
+  }
+
+  // Copy the triangles in to leaf order
+  triangleCorners.resize(3 * nValid);
+  parallelForChunks(nValid, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      for (size_t k = 0; k < 3; k++) {
+        triangleCorners[3 * i + k] = vertexPositions[triangleVertexInds[3 * order[i] + k]];
+      }
+    }
+  });
+  triangleOrder = std::move(order);
+  built = true;
+}
+
+void TriangleBVH::clear() {
+  built = false;
+  nodes.clear();
+  triangleOrder.clear();
+  triangleCorners.clear();
+}
+
+TriangleRayHit TriangleBVH::rayCast(glm::vec3 origin, glm::vec3 dir, float tMin, float tMax,
+                                    RayCastFaceCull cull) const {
+  TriangleRayHit hit;
+  if (triangleOrder.empty()) return hit;
+
+  glm::vec3 invDir = 1.f / dir;
+  float tEntry;
+  if (!rayIntersectsBox(nodes[0].bboxMin, nodes[0].bboxMax, origin, invDir, tMin, tMax, tEntry)) return hit;
+
+  // Depth-first, visiting the nearer child first so that far subtrees can usually be skipped
+  std::vector<std::pair<uint32_t, float>> stack{{0, tEntry}};
+  while (!stack.empty()) {
+    std::pair<uint32_t, float> curr = stack.back();
+    stack.pop_back();
+    if (curr.second > tMax) continue; // a closer hit was found since this was pushed
+    const Node& node = nodes[curr.first];
+
+    if (node.count > 0) {
+      for (size_t i = node.first; i < node.first + node.count; i++) {
+        float t;
+        glm::vec3 baryCoords;
+        if (rayIntersectsTriangle(&triangleCorners[3 * i], origin, dir, cull, t, baryCoords) && t >= tMin &&
+            t <= tMax) {
+          tMax = t;
+          hit.isHit = true;
+          hit.triangle = triangleOrder[i];
+          hit.t = t;
+          hit.baryCoords = baryCoords;
+        }
+      }
+      continue;
+    }
+
+    float tEntryA, tEntryB;
+    const Node& childA = nodes[node.first];
+    const Node& childB = nodes[node.first + 1];
+    bool hitA = rayIntersectsBox(childA.bboxMin, childA.bboxMax, origin, invDir, tMin, tMax, tEntryA);
+    bool hitB = rayIntersectsBox(childB.bboxMin, childB.bboxMax, origin, invDir, tMin, tMax, tEntryB);
+    if (hitA && hitB && tEntryB < tEntryA) {
+      stack.emplace_back(node.first, tEntryA);
+      stack.emplace_back(node.first + 1, tEntryB);
+    } else {
+      if (hitB) stack.emplace_back(node.first + 1, tEntryB);
+      if (hitA) stack.emplace_back(node.first, tEntryA);
+    }
+  }
+
+  return hit;
+}
+
+} // namespace polyscope
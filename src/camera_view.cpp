@@ -16,6 +16,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <limits>
 
 namespace polyscope {
 
@@ -260,7 +261,6 @@ void CameraView::fillCameraWidgetGeometry(render::ShaderProgram* nodeProgram, re
 
     std::vector<glm::vec3> positions;
     std::vector<glm::vec3> normals;
-    std::vector<glm::vec3> bcoord;
     std::vector<glm::vec3> cullPos;
 
     auto addPolygon = [&](std::vector<glm::vec3> vertices) {
@@ -283,11 +283,6 @@ void CameraView::fillCameraWidgetGeometry(render::ShaderProgram* nodeProgram, re
         normals.push_back(faceN);
         normals.push_back(faceN);
 
-        // Bary coords
-        bcoord.push_back(glm::vec3{1., 0., 0.});
-        bcoord.push_back(glm::vec3{0., 1., 0.});
-        bcoord.push_back(glm::vec3{0., 0., 1.});
-
         // Cull position
         cullPos.push_back(root);
         cullPos.push_back(root);
@@ -309,7 +304,6 @@ void CameraView::fillCameraWidgetGeometry(render::ShaderProgram* nodeProgram, re
       // // this is not actually used, but it only gets optimized out on some platforms, not all
       pickFrameProgram->setAttribute("a_vertexNormals", normals);
     }
-    pickFrameProgram->setAttribute("a_barycoord", bcoord);
 
     size_t nFaces = 7;
     std::vector<glm::vec3> faceColor(3 * nFaces, pickColor);
@@ -439,6 +433,9 @@ void CameraView::updateObjectSpaceBounds() {
   objectSpaceLengthScale = 0.;
 }
 
+// The bounding box is just the root, the widget and images are drawn around it. Never cull cameras.
+float CameraView::getCullingPadding() { return std::numeric_limits<float>::infinity(); }
+
 
 std::string CameraView::typeName() { return structureTypeName; }
 
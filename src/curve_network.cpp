@@ -11,6 +11,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <limits>
 
 namespace polyscope {
 
@@ -412,6 +413,17 @@ void CurveNetwork::refresh() {
 
 void CurveNetwork::recomputeGeometryIfPopulated() { edgeCenters.recomputeIfPopulated(); }
 
+std::vector<uint64_t> CurveNetwork::pickIndicesInRegion(const PickRegion& region) {
+
+  // Nodes, then edges by their centers
+  nodePositions.ensureHostBufferPopulated();
+  edgeCenters.ensureHostBufferPopulated();
+  std::vector<uint64_t> inds = pickIndicesOfPositionsInRegion(nodePositions.data, 0, region);
+  std::vector<uint64_t> edgeInds = pickIndicesOfPositionsInRegion(edgeCenters.data, nNodes(), region);
+  inds.insert(inds.end(), edgeInds.begin(), edgeInds.end());
+  return inds;
+}
+
 void CurveNetwork::buildPickUI(const PickResult& rawResult) {
 
   CurveNetworkPickResult result = interpretPickResult(rawResult);
@@ -531,8 +543,13 @@ void CurveNetwork::buildCustomOptionsUI() {
   }
 }
 
+bool CurveNetwork::ensureCullingBoundsCurrent() {
+  return ensureBoundsCurrentWith(nodePositions, boundsPositionsUpdateCount);
+}
+
 void CurveNetwork::updateObjectSpaceBounds() {
   nodePositions.ensureHostBufferPopulated();
+  boundsPositionsUpdateCount = nodePositions.getUpdateCount();
 
   // bounding box
   glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
@@ -640,6 +657,15 @@ CurveNetwork* CurveNetwork::setMaterial(std::string m) {
 }
 std::string CurveNetwork::getMaterial() { return material.get(); }
 
+float CurveNetwork::getCullingPadding() {
+  // (radii from a quantity which is not rescaled could be anything)
+  if ((nodeRadiusQuantityName != "" && !nodeRadiusQuantityAutoscale) ||
+      (edgeRadiusQuantityName != "" && !edgeRadiusQuantityAutoscale)) {
+    return std::numeric_limits<float>::infinity();
+  }
+  return std::max(Structure::getCullingPadding(), getRadius());
+}
+
 std::string CurveNetwork::typeName() { return structureTypeName; }
 
 // === Quantities
@@ -59,6 +59,8 @@ void CurveNetworkNodeVectorQuantity::buildNodeInfoGUI(size_t iV) {
 
 std::string CurveNetworkNodeVectorQuantity::niceName() { return name + " (node vector)"; }
 
+float CurveNetworkNodeVectorQuantity::getCullingPadding() { return getVectorCullingPadding(); }
+
 // ========================================================
 // ==========            Edge Vector             ==========
 // ========================================================
@@ -100,4 +102,6 @@ void CurveNetworkEdgeVectorQuantity::buildEdgeInfoGUI(size_t iF) {
 
 std::string CurveNetworkEdgeVectorQuantity::niceName() { return name + " (edge vector)"; }
 
+float CurveNetworkEdgeVectorQuantity::getCullingPadding() { return getVectorCullingPadding(); }
+
 } // namespace polyscope
@@ -8,6 +8,8 @@
 #include "polyscope/floating_quantity.h"
 #include "polyscope/structure.h"
 
+#include <limits>
+
 namespace polyscope {
 
 void FloatingQuantity::buildUI() {
@@ -29,4 +31,6 @@ void FloatingQuantity::buildUI() {
   }
 }
 
+float FloatingQuantity::getCullingPadding() { return std::numeric_limits<float>::infinity(); }
+
 } // namespace polyscope
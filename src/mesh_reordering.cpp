@@ -0,0 +1,239 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/mesh_reordering.h"
+
+#include "polyscope/messages.h"
+#include "polyscope/utilities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace polyscope {
+
+namespace {
+
+// Spread the low 10 bits of v out to every third bit
+uint32_t expandMortonBits(uint32_t v) {
+  v = (v * 0x00010001u) & 0xFF0000FFu;
+  v = (v * 0x00000101u) & 0x0F00F00Fu;
+  v = (v * 0x00000011u) & 0xC30C30C3u;
+  v = (v * 0x00000005u) & 0x49249249u;
+  return v;
+}
+
+// === Forsyth vertex cache optimization
+// (https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html, with the constants suggested there)
+
+const size_t VERTEX_CACHE_SIZE = 32;
+
+float vertexCacheScore(int cachePos, uint32_t remainingFaces) {
+  if (remainingFaces == 0) return -1.f; // the vertex will never be used again
+
+  float score = 0.f;
+  if (cachePos >= 0) {
+    if (cachePos < 3) {
+      // the vertices of the face just drawn get a fixed score, so the order does not degenerate in to strips
+      score = 0.75f;
+    } else {
+      float scaler = 1.f / static_cast<float>(VERTEX_CACHE_SIZE - 3);
+      score = std::pow(1.f - static_cast<float>(cachePos - 3) * scaler, 1.5f);
+    }
+  }
+
+  // boost vertices with only a few faces left, so they get finished off rather than leaving lone faces behind
+  score += 2.f / std::sqrt(static_cast<float>(remainingFaces));
+  return score;
+}
+
+// Reorder a block of faces in place
+void optimizeVertexCacheOrder(const std::vector<uint32_t>& faceStart, const std::vector<uint32_t>& faceVertexInds,
+                              uint32_t* faces, size_t nBlockFaces) {
+
+  // The corners of each face in the block
+  std::vector<uint32_t> cornerStart(nBlockFaces + 1, 0);
+  for (size_t i = 0; i < nBlockFaces; i++) {
+    cornerStart[i + 1] = cornerStart[i] + faceStart[faces[i] + 1] - faceStart[faces[i]];
+  }
+  size_t nCorners = cornerStart.back();
+
+  // Sort the corners by vertex to find the distinct vertices, and the faces on each
+  std::vector<std::pair<uint32_t, uint32_t>> cornerVertices(nCorners); // (vertex, corner)
+  std::vector<uint32_t> cornerFace(nCorners);
+  for (size_t i = 0; i < nBlockFaces; i++) {
+    for (uint32_t c = cornerStart[i]; c < cornerStart[i + 1]; c++) {
+      cornerVertices[c] = std::make_pair(faceVertexInds[faceStart[faces[i]] + c - cornerStart[i]], c);
+      cornerFace[c] = static_cast<uint32_t>(i);
+    }
+  }
+  std::sort(cornerVertices.begin(), cornerVertices.end());
+
+  std::vector<uint32_t> cornerLocalVertex(nCorners);
+  std::vector<uint32_t> vertexStart;
+  std::vector<uint32_t> vertexFaces(nCorners);
+  for (size_t k = 0; k < nCorners; k++) {
+    if (k == 0 || cornerVertices[k].first != cornerVertices[k - 1].first) {
+      vertexStart.push_back(static_cast<uint32_t>(k));
+    }
+    cornerLocalVertex[cornerVertices[k].second] = static_cast<uint32_t>(vertexStart.size() - 1);
+    vertexFaces[k] = cornerFace[cornerVertices[k].second];
+  }
+  size_t nVertices = vertexStart.size();
+  vertexStart.push_back(static_cast<uint32_t>(nCorners));
+  cornerVertices = std::vector<std::pair<uint32_t, uint32_t>>();
+
+  std::vector<uint32_t> remainingFaces(nVertices);
+  std::vector<int> cachePos(nVertices, -1);
+  std::vector<float> vertexScore(nVertices);
+  std::vector<size_t> lastFaceStamp(nVertices, INVALID_IND);
+  for (size_t iV = 0; iV < nVertices; iV++) {
+    remainingFaces[iV] = vertexStart[iV + 1] - vertexStart[iV];
+    vertexScore[iV] = vertexCacheScore(-1, remainingFaces[iV]);
+  }
+
+  auto faceScore = [&](size_t i) {
+    float score = 0.f;
+    for (uint32_t c = cornerStart[i]; c < cornerStart[i + 1]; c++) score += vertexScore[cornerLocalVertex[c]];
+    return score;
+  };
+
+  // start from the best face overall
+  std::vector<char> faceAdded(nBlockFaces, false);
+  size_t bestFace = 0;
+  float bestScore = -std::numeric_limits<float>::infinity();
+  for (size_t i = 0; i < nBlockFaces; i++) {
+    float score = faceScore(i);
+    if (score > bestScore) {
+      bestScore = score;
+      bestFace = i;
+    }
+  }
+
+  std::vector<uint32_t> newOrder;
+  newOrder.reserve(nBlockFaces);
+  std::vector<uint32_t> cache, newCache;
+  size_t nextUnadded = 0;
+  while (newOrder.size() < nBlockFaces) {
+
+    // If no face touches the cache, fall back on the next one in the Morton order, which is at least nearby
+    if (bestFace == INVALID_IND) {
+      while (faceAdded[nextUnadded]) nextUnadded++;
+      bestFace = nextUnadded;
+    }
+
+    faceAdded[bestFace] = true;
+    newOrder.push_back(faces[bestFace]);
+
+    // Its vertices move to the front of the cache, the rest of the cache shifts back
+    newCache.clear();
+    for (uint32_t c = cornerStart[bestFace]; c < cornerStart[bestFace + 1]; c++) {
+      uint32_t iV = cornerLocalVertex[c];
+      remainingFaces[iV]--;
+      if (lastFaceStamp[iV] != bestFace) {
+        lastFaceStamp[iV] = bestFace;
+        newCache.push_back(iV);
+      }
+    }
+    for (uint32_t iV : cache) {
+      if (lastFaceStamp[iV] != bestFace) newCache.push_back(iV);
+    }
+    for (size_t i = 0; i < newCache.size(); i++) {
+      uint32_t iV = newCache[i];
+      cachePos[iV] = (i < VERTEX_CACHE_SIZE) ? static_cast<int>(i) : -1;
+      vertexScore[iV] = vertexCacheScore(cachePos[iV], remainingFaces[iV]);
+    }
+    if (newCache.size() > VERTEX_CACHE_SIZE) newCache.resize(VERTEX_CACHE_SIZE);
+    std::swap(cache, newCache);
+
+    // The next face is the best one touching the cache
+    bestFace = INVALID_IND;
+    bestScore = -std::numeric_limits<float>::infinity();
+    for (uint32_t iV : cache) {
+      for (uint32_t k = vertexStart[iV]; k < vertexStart[iV + 1]; k++) {
+        uint32_t i = vertexFaces[k];
+        if (faceAdded[i]) continue;
+        float score = faceScore(i);
+        if (score > bestScore) {
+          bestScore = score;
+          bestFace = i;
+        }
+      }
+    }
+  }
+
+  std::copy(newOrder.begin(), newOrder.end(), faces);
+}
+
+} // namespace
+
+std::vector<uint32_t> computeFaceDrawOrder(const std::vector<glm::vec3>& vertexPositions,
+                                           const std::vector<uint32_t>& faceStart,
+                                           const std::vector<uint32_t>& faceVertexInds, size_t blockSize) {
+
+  if (blockSize == 0) exception("computeFaceDrawOrder: blockSize must be positive");
+
+  size_t nFaces = faceStart.empty() ? 0 : faceStart.size() - 1;
+  std::vector<uint32_t> order(nFaces);
+  if (nFaces == 0 || vertexPositions.empty()) {
+    for (size_t iF = 0; iF < nFaces; iF++) order[iF] = static_cast<uint32_t>(iF);
+    return order;
+  }
+
+  // Quantize the face centers to a 1024^3 grid over the bounding box
+  glm::vec3 bboxMin = vertexPositions[0];
+  glm::vec3 bboxMax = vertexPositions[0];
+  for (const glm::vec3& p : vertexPositions) {
+    bboxMin = glm::min(bboxMin, p);
+    bboxMax = glm::max(bboxMax, p);
+  }
+  glm::vec3 gridScale;
+  for (int k = 0; k < 3; k++) {
+    float extent = bboxMax[k] - bboxMin[k];
+    gridScale[k] = (extent > 0.f && std::isfinite(extent)) ? 1023.f / extent : 0.f;
+  }
+
+  // Sort the faces along the Morton curve
+  std::vector<std::pair<uint32_t, uint32_t>> faceCodes(nFaces);
+  parallelForChunks(nFaces, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iF = iStart; iF < iEnd; iF++) {
+      size_t D = faceStart[iF + 1] - faceStart[iF];
+      glm::vec3 center{0., 0., 0.};
+      for (size_t j = 0; j < D; j++) center += vertexPositions[faceVertexInds[faceStart[iF] + j]];
+      if (D > 0) center /= static_cast<float>(D);
+
+      uint32_t code = 0;
+      for (int k = 0; k < 3; k++) {
+        float c = (center[k] - bboxMin[k]) * gridScale[k];
+        c = (c > 0.f) ? std::min(c, 1023.f) : 0.f; // (also catches NaNs)
+        code |= expandMortonBits(static_cast<uint32_t>(c)) << k;
+      }
+      faceCodes[iF] = std::make_pair(code, static_cast<uint32_t>(iF));
+    }
+  });
+  std::sort(faceCodes.begin(), faceCodes.end());
+  for (size_t i = 0; i < nFaces; i++) order[i] = faceCodes[i].second;
+  faceCodes = std::vector<std::pair<uint32_t, uint32_t>>();
+
+  // Optimize each block for the vertex cache. The chunks of faces don't line up with the blocks, so each chunk takes
+  // the blocks which start within it.
+  parallelForChunks(nFaces, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t blockStart = (iStart + blockSize - 1) / blockSize * blockSize; blockStart < iEnd;
+         blockStart += blockSize) {
+      size_t blockCount = std::min(blockSize, nFaces - blockStart);
+      optimizeVertexCacheOrder(faceStart, faceVertexInds, &order[blockStart], blockCount);
+    }
+  });
+
+  return order;
+}
+
+std::vector<uint32_t> computeTriangleDrawOrder(const std::vector<glm::vec3>& vertexPositions,
+                                               const std::vector<uint32_t>& triangleVertexInds, size_t blockSize) {
+  size_t nTriangles = triangleVertexInds.size() / 3;
+  std::vector<uint32_t> triangleStart(nTriangles + 1);
+  for (size_t iT = 0; iT <= nTriangles; iT++) triangleStart[iT] = static_cast<uint32_t>(3 * iT);
+  return computeFaceDrawOrder(vertexPositions, triangleStart, triangleVertexInds, blockSize);
+}
+
+} // namespace polyscope
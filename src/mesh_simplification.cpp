@@ -0,0 +1,211 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/mesh_simplification.h"
+
+#include "polyscope/mesh_topology.h"
+#include "polyscope/utilities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace polyscope {
+
+namespace {
+
+// A symmetric 4x4 quadric error matrix, evaluating the weighted sum of squared distances to a set of planes
+struct Quadric {
+  double a00 = 0, a01 = 0, a02 = 0, a03 = 0, a11 = 0, a12 = 0, a13 = 0, a22 = 0, a23 = 0, a33 = 0;
+
+  // Add the plane dot(n, p) + d = 0, with weight w
+  void addPlane(glm::dvec3 n, double d, double w) {
+    a00 += w * n.x * n.x;
+    a01 += w * n.x * n.y;
+    a02 += w * n.x * n.z;
+    a03 += w * n.x * d;
+    a11 += w * n.y * n.y;
+    a12 += w * n.y * n.z;
+    a13 += w * n.y * d;
+    a22 += w * n.z * n.z;
+    a23 += w * n.z * d;
+    a33 += w * d * d;
+  }
+
+  double evaluate(glm::dvec3 p) const {
+    return a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z +
+           2. * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z) + 2. * (a03 * p.x + a13 * p.y + a23 * p.z) + a33;
+  }
+};
+
+const uint64_t CELL_COORD_BITS = 21;
+const uint64_t CELL_COORD_MAX = (static_cast<uint64_t>(1) << CELL_COORD_BITS) - 1;
+
+// Merge the vertices of the mesh within each grid cell, and return the triangles which survive
+std::vector<uint32_t> simplifyByClustering(const std::vector<glm::vec3>& vertexPositions,
+                                           const std::vector<uint32_t>& triangleVertexInds, glm::vec3 gridOrigin,
+                                           float cellSize) {
+
+  size_t nVertices = vertexPositions.size();
+  size_t nTriangles = triangleVertexInds.size() / 3;
+
+  // The triangles incident on each vertex. Vertices which are not used by any triangle (including those merged away
+  // in an earlier level) have none, and are ignored.
+  std::vector<uint32_t> triangleStart(nTriangles + 1);
+  for (size_t iT = 0; iT <= nTriangles; iT++) triangleStart[iT] = static_cast<uint32_t>(3 * iT);
+  VertexFaceAdjacency adjacency = buildVertexFaceAdjacency(triangleStart, triangleVertexInds, nVertices);
+  triangleStart = std::vector<uint32_t>();
+
+  // Sort the vertices by their grid cell, so each cell is a contiguous run
+  std::vector<std::pair<uint64_t, uint32_t>> cellVertices;
+  for (size_t iV = 0; iV < nVertices; iV++) {
+    if (adjacency.vertexStart[iV + 1] > adjacency.vertexStart[iV]) {
+      cellVertices.emplace_back(0, static_cast<uint32_t>(iV));
+    }
+  }
+  parallelForChunks(cellVertices.size(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      glm::vec3 cellCoord = glm::floor((vertexPositions[cellVertices[i].second] - gridOrigin) / cellSize);
+      uint64_t key = 0;
+      for (int k = 0; k < 3; k++) {
+        uint64_t c = static_cast<uint64_t>(std::min(std::max(cellCoord[k], 0.f), static_cast<float>(CELL_COORD_MAX)));
+        key |= c << (k * CELL_COORD_BITS);
+      }
+      cellVertices[i].first = key;
+    }
+  });
+  std::sort(cellVertices.begin(), cellVertices.end());
+
+  std::vector<size_t> cellStart;
+  for (size_t i = 0; i < cellVertices.size(); i++) {
+    if (i == 0 || cellVertices[i].first != cellVertices[i - 1].first) cellStart.push_back(i);
+  }
+  cellStart.push_back(cellVertices.size());
+  size_t nCells = cellStart.size() - 1;
+
+  // Within each cell, pick the vertex with the lowest error with respect to all of the planes of the incident
+  // triangles, weighted by area
+  std::vector<uint32_t> representative(nVertices, INVALID_IND_32);
+  parallelForChunks(nCells, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iCell = iStart; iCell < iEnd; iCell++) {
+
+      Quadric q;
+      for (size_t i = cellStart[iCell]; i < cellStart[iCell + 1]; i++) {
+        uint32_t iV = cellVertices[i].second;
+        for (size_t j = adjacency.vertexStart[iV]; j < adjacency.vertexStart[iV + 1]; j++) {
+          size_t iT = adjacency.faceInds[j];
+          glm::dvec3 pA = vertexPositions[triangleVertexInds[3 * iT + 0]];
+          glm::dvec3 pB = vertexPositions[triangleVertexInds[3 * iT + 1]];
+          glm::dvec3 pC = vertexPositions[triangleVertexInds[3 * iT + 2]];
+          glm::dvec3 n = glm::cross(pB - pA, pC - pA);
+          double len = glm::length(n);
+          if (!(len > 0.)) continue;
+          n /= len;
+          q.addPlane(n, -glm::dot(n, pA), 0.5 * len);
+        }
+      }
+
+      uint32_t bestV = cellVertices[cellStart[iCell]].second;
+      double bestErr = std::numeric_limits<double>::infinity();
+      for (size_t i = cellStart[iCell]; i < cellStart[iCell + 1]; i++) {
+        uint32_t iV = cellVertices[i].second;
+        double err = q.evaluate(glm::dvec3(vertexPositions[iV]));
+        if (err < bestErr) {
+          bestErr = err;
+          bestV = iV;
+        }
+      }
+
+      for (size_t i = cellStart[iCell]; i < cellStart[iCell + 1]; i++) {
+        representative[cellVertices[i].second] = bestV;
+      }
+    }
+  });
+
+  // Re-emit the triangles on the representatives, dropping those which collapsed
+  std::vector<size_t> chunkTriangleStart(parallelChunkCount(nTriangles) + 1, 0);
+  auto triangleSurvives = [&](size_t iT) {
+    uint32_t vA = representative[triangleVertexInds[3 * iT + 0]];
+    uint32_t vB = representative[triangleVertexInds[3 * iT + 1]];
+    uint32_t vC = representative[triangleVertexInds[3 * iT + 2]];
+    return vA != vB && vB != vC && vC != vA;
+  };
+  parallelForChunks(nTriangles, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    size_t count = 0;
+    for (size_t iT = iStart; iT < iEnd; iT++) {
+      if (triangleSurvives(iT)) count++;
+    }
+    chunkTriangleStart[iChunk + 1] = count;
+  });
+  for (size_t iChunk = 1; iChunk < chunkTriangleStart.size(); iChunk++) {
+    chunkTriangleStart[iChunk] += chunkTriangleStart[iChunk - 1];
+  }
+
+  std::vector<uint32_t> simplifiedInds(3 * chunkTriangleStart.back());
+  parallelForChunks(nTriangles, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    size_t iOut = chunkTriangleStart[iChunk];
+    for (size_t iT = iStart; iT < iEnd; iT++) {
+      if (!triangleSurvives(iT)) continue;
+      for (size_t k = 0; k < 3; k++) {
+        simplifiedInds[3 * iOut + k] = representative[triangleVertexInds[3 * iT + k]];
+      }
+      iOut++;
+    }
+  });
+
+  return simplifiedInds;
+}
+
+} // namespace
+
+std::vector<SimplifiedMeshLevel> buildSimplifiedMeshHierarchy(const std::vector<glm::vec3>& vertexPositions,
+                                                              const std::vector<uint32_t>& triangleVertexInds,
+                                                              size_t minTriangles, size_t maxLevels,
+                                                              const std::atomic<bool>* cancel) {
+
+  std::vector<SimplifiedMeshLevel> levels;
+  if (triangleVertexInds.size() / 3 <= minTriangles || vertexPositions.empty()) return levels;
+
+  // The grid covers the bounding box of the mesh
+  glm::vec3 bboxMin = vertexPositions[0];
+  glm::vec3 bboxMax = vertexPositions[0];
+  for (const glm::vec3& p : vertexPositions) {
+    bboxMin = glm::min(bboxMin, p);
+    bboxMax = glm::max(bboxMax, p);
+  }
+  glm::vec3 extent = bboxMax - bboxMin;
+  float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+  if (!(maxExtent > 0.f) || !std::isfinite(maxExtent)) return levels;
+
+  // Start with about half as many cells along each axis as vertices along the side of a square grid mesh, so the
+  // first level has about a quarter of the vertices. Each level doubles the cell width. Since the grids are nested,
+  // every original vertex always lies in the same cell as the vertex it was eventually merged in to, which bounds
+  // the error of every level by the diagonal of its cells.
+  double initialResolution = std::max(1., std::sqrt(static_cast<double>(vertexPositions.size())) / 2.);
+  initialResolution = std::min(initialResolution, static_cast<double>(CELL_COORD_MAX));
+  float cellSize = maxExtent / static_cast<float>(initialResolution);
+
+  levels.reserve(maxLevels); // currentInds points in to the last level
+  const std::vector<uint32_t>* currentInds = &triangleVertexInds;
+  while (levels.size() < maxLevels && currentInds->size() / 3 > minTriangles && cellSize < 2.f * maxExtent) {
+    if (cancel && cancel->load()) return std::vector<SimplifiedMeshLevel>();
+
+    std::vector<uint32_t> simplifiedInds = simplifyByClustering(vertexPositions, *currentInds, bboxMin, cellSize);
+    if (simplifiedInds.empty()) break; // everything collapsed, coarser grids can't do better
+
+    // only keep levels which are a meaningful reduction, otherwise just try a coarser grid
+    if (simplifiedInds.size() < 0.9 * currentInds->size()) {
+      SimplifiedMeshLevel level;
+      level.error = std::sqrt(3.f) * cellSize;
+      level.triangleVertexInds = std::move(simplifiedInds);
+      levels.push_back(std::move(level));
+      currentInds = &levels.back().triangleVertexInds;
+    }
+
+    cellSize *= 2.f;
+  }
+
+  return levels;
+}
+
+} // namespace polyscope
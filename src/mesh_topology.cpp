@@ -0,0 +1,205 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/mesh_topology.h"
+
+#include "polyscope/messages.h"
+#include "polyscope/utilities.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace polyscope {
+
+EdgeTopology buildEdgeTopology(const std::vector<uint32_t>& triangleVertexInds, size_t nVertices, bool computeTwins) {
+
+  if (triangleVertexInds.size() % 3 != 0) {
+    exception("edge topology: triangle vertex index list must have a multiple of 3 entries");
+  }
+  size_t nHalfedges = triangleVertexInds.size();
+  if (nHalfedges >= INVALID_IND_32) {
+    exception("edge topology: too many halfedges, indices must fit in 32 bits");
+  }
+
+  // The endpoints of a halfedge, as (smaller, larger)
+  auto halfedgeEndpoints = [&](size_t iHe) -> std::pair<uint32_t, uint32_t> {
+    size_t iF = iHe / 3;
+    size_t j = iHe % 3;
+    uint32_t vA = triangleVertexInds[iHe];
+    uint32_t vB = triangleVertexInds[3 * iF + ((j + 1) % 3)];
+    return std::make_pair(std::min(vA, vB), std::max(vA, vB));
+  };
+
+  // == Bucket the halfedges by their smaller vertex
+
+  // Count the size of each bucket
+  std::unique_ptr<std::atomic<uint32_t>[]> bucketCursor(new std::atomic<uint32_t>[nVertices]);
+  parallelForChunks(nVertices, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iV = iStart; iV < iEnd; iV++) {
+      bucketCursor[iV].store(0, std::memory_order_relaxed);
+    }
+  });
+  parallelForChunks(nHalfedges, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iHe = iStart; iHe < iEnd; iHe++) {
+      std::pair<uint32_t, uint32_t> endpoints = halfedgeEndpoints(iHe);
+      if (endpoints.second >= nVertices) {
+        exception("edge topology: vertex index " + std::to_string(endpoints.second) + " is out of bounds for " +
+                  std::to_string(nVertices) + " vertices");
+      }
+      bucketCursor[endpoints.first].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  // Lay out the buckets contiguously
+  std::vector<uint32_t> bucketStart(nVertices + 1);
+  uint32_t bucketSum = 0;
+  for (size_t iV = 0; iV < nVertices; iV++) {
+    bucketStart[iV] = bucketSum;
+    bucketSum += bucketCursor[iV].load(std::memory_order_relaxed);
+    bucketCursor[iV].store(bucketStart[iV], std::memory_order_relaxed);
+  }
+  bucketStart[nVertices] = bucketSum;
+
+  // Scatter a packed (larger vertex, halfedge) key for each halfedge in to its bucket
+  std::vector<uint64_t> keys(nHalfedges);
+  parallelForChunks(nHalfedges, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iHe = iStart; iHe < iEnd; iHe++) {
+      std::pair<uint32_t, uint32_t> endpoints = halfedgeEndpoints(iHe);
+      uint32_t pos = bucketCursor[endpoints.first].fetch_add(1, std::memory_order_relaxed);
+      keys[pos] = (static_cast<uint64_t>(endpoints.second) << 32) | static_cast<uint64_t>(iHe);
+    }
+  });
+  bucketCursor.reset();
+
+  // == Sort each bucket. Runs of equal larger vertex are the halfedges of one edge, in halfedge order.
+
+  EdgeTopology topology;
+  topology.halfedgeEdge.resize(nHalfedges);
+  if (computeTwins) topology.halfedgeTwin.resize(nHalfedges);
+  std::vector<uint32_t> firstHalfedge(nHalfedges); // for each halfedge, the first halfedge along its edge
+
+  auto keyVertex = [](uint64_t key) -> uint32_t { return static_cast<uint32_t>(key >> 32); };
+  auto keyHalfedge = [](uint64_t key) -> uint32_t { return static_cast<uint32_t>(key & 0xFFFFFFFF); };
+
+  parallelForChunks(nVertices, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iV = iStart; iV < iEnd; iV++) {
+      uint64_t* bucketBegin = keys.data() + bucketStart[iV];
+      uint64_t* bucketEnd = keys.data() + bucketStart[iV + 1];
+      std::sort(bucketBegin, bucketEnd);
+
+      uint64_t* runBegin = bucketBegin;
+      while (runBegin != bucketEnd) {
+        uint64_t* runEnd = runBegin + 1;
+        while (runEnd != bucketEnd && keyVertex(*runEnd) == keyVertex(*runBegin)) runEnd++;
+
+        uint32_t first = keyHalfedge(*runBegin);
+        for (uint64_t* k = runBegin; k != runEnd; k++) {
+          firstHalfedge[keyHalfedge(*k)] = first;
+        }
+
+        if (computeTwins) {
+          topology.halfedgeTwin[first] = (runEnd - runBegin > 1) ? keyHalfedge(runBegin[1]) : INVALID_IND_32;
+          for (uint64_t* k = runBegin + 1; k != runEnd; k++) {
+            topology.halfedgeTwin[keyHalfedge(*k)] = first;
+          }
+        }
+
+        runBegin = runEnd;
+      }
+    }
+  });
+  keys = std::vector<uint64_t>();
+
+  // == Number the edges in the order of their first halfedge
+
+  // Count the edges which start in each chunk, then scan to get the first index in each chunk
+  std::vector<size_t> chunkEdgeStart(parallelChunkCount(nHalfedges) + 1, 0);
+  parallelForChunks(nHalfedges, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    size_t count = 0;
+    for (size_t iHe = iStart; iHe < iEnd; iHe++) {
+      if (firstHalfedge[iHe] == iHe) count++;
+    }
+    chunkEdgeStart[iChunk + 1] = count;
+  });
+  for (size_t iChunk = 1; iChunk < chunkEdgeStart.size(); iChunk++) {
+    chunkEdgeStart[iChunk] += chunkEdgeStart[iChunk - 1];
+  }
+  topology.nEdges = chunkEdgeStart.back();
+
+  parallelForChunks(nHalfedges, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    uint32_t iEdge = static_cast<uint32_t>(chunkEdgeStart[iChunk]);
+    for (size_t iHe = iStart; iHe < iEnd; iHe++) {
+      if (firstHalfedge[iHe] == iHe) topology.halfedgeEdge[iHe] = iEdge++;
+    }
+  });
+
+  // Every other halfedge takes the index from the first halfedge along its edge (which are all assigned above)
+  parallelForChunks(nHalfedges, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iHe = iStart; iHe < iEnd; iHe++) {
+      uint32_t first = firstHalfedge[iHe];
+      if (first != iHe) topology.halfedgeEdge[iHe] = topology.halfedgeEdge[first];
+    }
+  });
+
+  return topology;
+}
+
+VertexFaceAdjacency buildVertexFaceAdjacency(const std::vector<uint32_t>& faceIndsStart,
+                                             const std::vector<uint32_t>& faceIndsEntries, size_t nVertices) {
+
+  if (faceIndsEntries.size() >= INVALID_IND_32) {
+    exception("vertex face adjacency: too many face entries, indices must fit in 32 bits");
+  }
+  size_t nFaces = faceIndsStart.empty() ? 0 : faceIndsStart.size() - 1;
+
+  // Count the faces incident on each vertex
+  std::unique_ptr<std::atomic<uint32_t>[]> vertexCursor(new std::atomic<uint32_t>[nVertices]);
+  parallelForChunks(nVertices, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iV = iStart; iV < iEnd; iV++) {
+      vertexCursor[iV].store(0, std::memory_order_relaxed);
+    }
+  });
+  parallelForChunks(faceIndsEntries.size(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      uint32_t iV = faceIndsEntries[i];
+      if (iV >= nVertices) {
+        exception("vertex face adjacency: vertex index " + std::to_string(iV) + " is out of bounds for " +
+                  std::to_string(nVertices) + " vertices");
+      }
+      vertexCursor[iV].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  VertexFaceAdjacency adjacency;
+  adjacency.vertexStart.resize(nVertices + 1);
+  uint32_t sum = 0;
+  for (size_t iV = 0; iV < nVertices; iV++) {
+    adjacency.vertexStart[iV] = sum;
+    sum += vertexCursor[iV].load(std::memory_order_relaxed);
+    vertexCursor[iV].store(adjacency.vertexStart[iV], std::memory_order_relaxed);
+  }
+  adjacency.vertexStart[nVertices] = sum;
+
+  // Scatter the faces, then sort each vertex's list so the order does not depend on the threading
+  adjacency.faceInds.resize(sum);
+  parallelForChunks(nFaces, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iF = iStart; iF < iEnd; iF++) {
+      for (size_t i = faceIndsStart[iF]; i < faceIndsStart[iF + 1]; i++) {
+        uint32_t pos = vertexCursor[faceIndsEntries[i]].fetch_add(1, std::memory_order_relaxed);
+        adjacency.faceInds[pos] = static_cast<uint32_t>(iF);
+      }
+    }
+  });
+  vertexCursor.reset();
+
+  parallelForChunks(nVertices, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iV = iStart; iV < iEnd; iV++) {
+      std::sort(adjacency.faceInds.begin() + adjacency.vertexStart[iV],
+                adjacency.faceInds.begin() + adjacency.vertexStart[iV + 1]);
+    }
+  });
+
+  return adjacency;
+}
+
+} // namespace polyscope
@@ -0,0 +1,174 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/meshlets.h"
+
+#include "polyscope/messages.h"
+#include "polyscope/utilities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace polyscope {
+
+namespace {
+
+// Normalize a plane so its normal has unit length. Degenerate planes (e.g. the far plane of an infinite projection)
+// become a plane which every point passes.
+glm::vec4 normalizePlane(glm::vec4 plane) {
+  float len = glm::length(glm::vec3(plane));
+  if (!(len > 0.f) || !std::isfinite(len)) return glm::vec4{0.f, 0.f, 0.f, 1.f};
+  return plane / len;
+}
+
+} // namespace
+
+std::vector<Meshlet> buildMeshlets(const std::vector<glm::vec3>& vertexPositions,
+                                   const std::vector<uint32_t>& triangleVertexInds, size_t trianglesPerMeshlet) {
+
+  if (trianglesPerMeshlet == 0) exception("meshlets: trianglesPerMeshlet must be positive");
+
+  size_t nTriangles = triangleVertexInds.size() / 3;
+  size_t nMeshlets = (nTriangles + trianglesPerMeshlet - 1) / trianglesPerMeshlet;
+  std::vector<Meshlet> meshlets(nMeshlets);
+
+  parallelForChunks(nMeshlets, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iM = iStart; iM < iEnd; iM++) {
+      Meshlet& m = meshlets[iM];
+      size_t triStart = iM * trianglesPerMeshlet;
+      size_t triEnd = std::min(triStart + trianglesPerMeshlet, nTriangles);
+      m.triangleStart = static_cast<uint32_t>(triStart);
+      m.triangleCount = static_cast<uint32_t>(triEnd - triStart);
+
+      // Bounding sphere about the center of the bounding box
+      glm::vec3 bboxMin{std::numeric_limits<float>::infinity()};
+      glm::vec3 bboxMax{-std::numeric_limits<float>::infinity()};
+      for (size_t i = 3 * triStart; i < 3 * triEnd; i++) {
+        glm::vec3 p = vertexPositions[triangleVertexInds[i]];
+        bboxMin = glm::min(bboxMin, p);
+        bboxMax = glm::max(bboxMax, p);
+      }
+      m.center = 0.5f * (bboxMin + bboxMax);
+      float radius2 = 0.f;
+      for (size_t i = 3 * triStart; i < 3 * triEnd; i++) {
+        glm::vec3 d = vertexPositions[triangleVertexInds[i]] - m.center;
+        radius2 = std::max(radius2, glm::dot(d, d));
+      }
+      m.radius = std::sqrt(radius2);
+
+      // Normal cone about the average normal
+      glm::vec3 normalSum{0.f, 0.f, 0.f};
+      for (size_t iT = triStart; iT < triEnd; iT++) {
+        glm::vec3 pA = vertexPositions[triangleVertexInds[3 * iT + 0]];
+        glm::vec3 pB = vertexPositions[triangleVertexInds[3 * iT + 1]];
+        glm::vec3 pC = vertexPositions[triangleVertexInds[3 * iT + 2]];
+        glm::vec3 n = glm::cross(pB - pA, pC - pA);
+        float len = glm::length(n);
+        if (len > 0.f) normalSum += n / len;
+      }
+      float sumLen = glm::length(normalSum);
+      m.coneAxis = (sumLen > 0.f) ? normalSum / sumLen : glm::vec3{0.f, 0.f, 1.f};
+      float minDot = (sumLen > 0.f) ? 1.f : -1.f;
+      for (size_t iT = triStart; iT < triEnd && sumLen > 0.f; iT++) {
+        glm::vec3 pA = vertexPositions[triangleVertexInds[3 * iT + 0]];
+        glm::vec3 pB = vertexPositions[triangleVertexInds[3 * iT + 1]];
+        glm::vec3 pC = vertexPositions[triangleVertexInds[3 * iT + 2]];
+        glm::vec3 n = glm::cross(pB - pA, pC - pA);
+        float len = glm::length(n);
+        if (len > 0.f) minDot = std::min(minDot, glm::dot(n / len, m.coneAxis));
+      }
+
+      // a cone wider than ~85 degrees could only ever cull from a narrow range of views, don't bother
+      m.coneCutoff = (minDot > 0.1f) ? std::sqrt(1.f - minDot * minDot) : 1.f;
+    }
+  });
+
+  return meshlets;
+}
+
+MeshletCullView buildMeshletCullView(const glm::mat4& modelMat, const glm::mat4& viewMat, const glm::mat4& projMat,
+                                     bool orthographic,
+                                     const std::vector<std::array<glm::vec3, 2>>& worldSlicePlanes,
+                                     bool cullBackfaces) {
+  MeshletCullView cullView;
+
+  // Frustum planes from the rows of the full object-to-clip matrix (Gribb & Hartmann)
+  glm::mat4 clipMat = projMat * viewMat * modelMat;
+  glm::vec4 row0{clipMat[0][0], clipMat[1][0], clipMat[2][0], clipMat[3][0]};
+  glm::vec4 row1{clipMat[0][1], clipMat[1][1], clipMat[2][1], clipMat[3][1]};
+  glm::vec4 row2{clipMat[0][2], clipMat[1][2], clipMat[2][2], clipMat[3][2]};
+  glm::vec4 row3{clipMat[0][3], clipMat[1][3], clipMat[2][3], clipMat[3][3]};
+  cullView.frustumPlanes[0] = normalizePlane(row3 + row0);
+  cullView.frustumPlanes[1] = normalizePlane(row3 - row0);
+  cullView.frustumPlanes[2] = normalizePlane(row3 + row1);
+  cullView.frustumPlanes[3] = normalizePlane(row3 - row1);
+  cullView.frustumPlanes[4] = normalizePlane(row3 + row2);
+  cullView.frustumPlanes[5] = normalizePlane(row3 - row2);
+
+  // Slice planes keep the points p with dot(p - center, normal) >= 0 in world space
+  glm::mat3 linearPart(modelMat);
+  glm::vec3 translation(modelMat[3]);
+  for (const std::array<glm::vec3, 2>& plane : worldSlicePlanes) {
+    glm::vec3 center = plane[0];
+    glm::vec3 normal = plane[1];
+    if (!std::isfinite(glm::dot(center, normal))) continue; // disabled planes are pushed to infinity
+    glm::vec3 objNormal = glm::transpose(linearPart) * normal;
+    cullView.clipPlanes.push_back(normalizePlane(glm::vec4(objNormal, glm::dot(normal, translation - center))));
+  }
+
+  // Camera, for the normal cones
+  cullView.cullBackfaces = cullBackfaces;
+  cullView.orthographic = orthographic;
+  glm::mat4 invModelView = glm::inverse(viewMat * modelMat);
+  cullView.cameraPosition = glm::vec3(invModelView * glm::vec4(0.f, 0.f, 0.f, 1.f));
+  cullView.viewDirection = glm::normalize(glm::vec3(invModelView * glm::vec4(0.f, 0.f, -1.f, 0.f)));
+
+  return cullView;
+}
+
+std::vector<std::array<uint32_t, 2>> cullMeshlets(const std::vector<Meshlet>& meshlets, const MeshletCullView& view) {
+
+  std::vector<char> isVisible(meshlets.size());
+  parallelForChunks(meshlets.size(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iM = iStart; iM < iEnd; iM++) {
+      const Meshlet& m = meshlets[iM];
+      bool visible = true;
+
+      for (const glm::vec4& plane : view.frustumPlanes) {
+        if (glm::dot(glm::vec3(plane), m.center) + plane.w < -m.radius) visible = false;
+      }
+      for (const glm::vec4& plane : view.clipPlanes) {
+        if (glm::dot(glm::vec3(plane), m.center) + plane.w < -m.radius) visible = false;
+      }
+
+      // all triangles face away from the camera
+      if (visible && view.cullBackfaces && m.coneCutoff < 1.f) {
+        if (view.orthographic) {
+          if (glm::dot(view.viewDirection, m.coneAxis) >= m.coneCutoff) visible = false;
+        } else {
+          glm::vec3 toCenter = m.center - view.cameraPosition;
+          if (glm::dot(toCenter, m.coneAxis) >= m.coneCutoff * glm::length(toCenter) + m.radius) visible = false;
+        }
+      }
+
+      isVisible[iM] = visible;
+    }
+  });
+
+  // Compact the visible meshlets in to ranges of corners, merging neighbors
+  std::vector<std::array<uint32_t, 2>> ranges;
+  for (size_t iM = 0; iM < meshlets.size(); iM++) {
+    if (!isVisible[iM]) continue;
+    uint32_t start = 3 * meshlets[iM].triangleStart;
+    uint32_t count = 3 * meshlets[iM].triangleCount;
+    if (!ranges.empty() && ranges.back()[0] + ranges.back()[1] == start) {
+      ranges.back()[1] += count;
+    } else {
+      ranges.push_back({start, count});
+    }
+  }
+
+  return ranges;
+}
+
+} // namespace polyscope
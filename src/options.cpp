@@ -12,6 +12,7 @@ std::string printPrefix = "[polyscope] ";
 bool allowHeadlessBackends = false;
 bool errorsThrowExceptions = false;
 bool debugDrawPickBuffer = false;
+bool enableProfiler = false;
 int maxFPS = 60;
 #ifdef _WIN32
 // set the default vsync to false on windows, to workaround an glfw errors from an alleged driver bug
@@ -24,6 +25,7 @@ LimitFPSMode frameTickLimitFPSMode = LimitFPSMode::SkipFramesToHitTarget;
 bool usePrefsFile = true;
 bool initializeWithDefaultStructures = true;
 bool alwaysRedraw = false;
+bool enableCulling = true;
 bool autocenterStructures = false;
 bool autoscaleStructures = false;
 bool automaticallyComputeSceneExtents = true;
@@ -57,6 +59,13 @@ int ssaaFactor = 1;
 TransparencyMode transparencyMode = TransparencyMode::None;
 int transparencyRenderPasses = 8;
 
+// Meshes
+bool optimizeMeshDrawOrder = false;
+
+// Picking
+bool pickWithRayCast = false;
+bool regionSelectionIncludesOccluded = false;
+
 // === Advanced ImGui configuration
 
 bool buildGui = true;
@@ -71,6 +80,7 @@ std::function<std::tuple<ImFont*, ImFont*>(ImFontAtlas*)> prepareImGuiFontsCallb
 
 // Backend and low-level options
 int eglDeviceIndex = -1; // means "try all of them"
+size_t hostBufferMemoryBudget = 0; // means "no limit"
 
 // enabled by default in debug mode
 #ifndef NDEBUG
@@ -4,9 +4,16 @@
 
 #include "polyscope/polyscope.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <map>
+#include <set>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace polyscope {
 
@@ -16,24 +23,20 @@ PickResult pickAtScreenCoords(glm::vec2 screenCoords) {
   return pickAtBufferInds(bufferInds);
 }
 
-PickResult pickAtBufferInds(glm::ivec2 bufferInds) {
-  PickResult result;
-
-  // Query the pick buffer
-  // (this necessarily renders to pickFrameBuffer)
-  std::tuple<Structure*, Quantity*, uint64_t> rawPickResult = pick::evaluatePickQueryFull(bufferInds.x, bufferInds.y);
+namespace {
 
-  // Query the depth buffer populated above
-  render::FrameBuffer* pickFramebuffer = render::engine->pickFramebuffer.get();
-  float clipDepth = pickFramebuffer->readDepth(bufferInds.x, view::bufferHeight - bufferInds.y);
+// Transcribe the values read from the pick buffers into a result
+PickResult pickResultFromBuffers(glm::ivec2 bufferInds, std::tuple<Structure*, Quantity*, uint64_t> rawPickResult,
+                                 float clipDepth, const glm::mat4& viewMat, const glm::mat4& projMat) {
+  PickResult result;
 
-  // Transcribe result into return tuple
   result.structure = std::get<0>(rawPickResult);
   result.quantity = std::get<1>(rawPickResult);
   result.bufferInds = bufferInds;
   result.screenCoords = view::bufferIndsToScreenCoords(bufferInds);
-  result.position = view::screenCoordsAndDepthToWorldPosition(result.screenCoords, clipDepth);
-  result.depth = glm::length(result.position - view::getCameraWorldPosition());
+  result.position = view::screenCoordsAndDepthToWorldPosition(result.screenCoords, clipDepth, viewMat, projMat);
+  glm::vec3 cameraWorldPosition = glm::vec3(glm::inverse(viewMat) * glm::vec4(0., 0., 0., 1.));
+  result.depth = glm::length(result.position - cameraWorldPosition);
 
 
   // null-initialize, might be overwritten below
@@ -61,6 +64,315 @@ PickResult pickAtBufferInds(glm::ivec2 bufferInds) {
   return result;
 }
 
+// True if every enabled structure can answer pick queries with a ray cast (see options::pickWithRayCast)
+bool sceneCanRayCastPick() {
+  for (auto& cat : state::structures) {
+    for (auto& x : cat.second) {
+      Structure& s = *x.second;
+      if (!s.isEnabled()) continue;
+      if (!s.canRayCastPick()) return false;
+
+      // floating quantities like render images may draw to the pick buffer too
+      for (auto& q : s.floatingQuantities) {
+        if (q.second->isEnabled()) return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Answer a pick query with a ray cast through the center of the pixel, from the near plane to the far plane, rather
+// than rendering the pick buffer
+PickResult rayCastPickAtBufferInds(glm::ivec2 bufferInds, const glm::mat4& viewMat, const glm::mat4& projMat) {
+
+  std::tuple<Structure*, Quantity*, uint64_t> rawPickResult{nullptr, nullptr, 0};
+  float clipDepth = 1.;
+  RayCastResult hit;
+
+  if (bufferInds.x >= 0 && bufferInds.x < view::bufferWidth && bufferInds.y >= 0 &&
+      bufferInds.y < view::bufferHeight) {
+    glm::vec4 viewport = {0., 0., view::bufferWidth, view::bufferHeight};
+    glm::vec2 windowPos{bufferInds.x + 0.5, view::bufferHeight - bufferInds.y + 0.5};
+    glm::vec3 nearPos = glm::unProject(glm::vec3{windowPos, 0.}, viewMat, projMat, viewport);
+    glm::vec3 farPos = glm::unProject(glm::vec3{windowPos, 1.}, viewMat, projMat, viewport);
+
+    hit = rayCast(nearPos, farPos - nearPos, glm::length(farPos - nearPos));
+    if (hit.isHit) {
+      rawPickResult = std::make_tuple(hit.structure, nullptr, hit.structure->rayCastPickIndex(hit));
+      clipDepth = glm::project(hit.position, viewMat, projMat, viewport).z;
+    }
+  }
+
+  PickResult result = pickResultFromBuffers(bufferInds, rawPickResult, clipDepth, viewMat, projMat);
+  if (hit.isHit) {
+    // use the exact position rather than the one recovered from the depth
+    glm::vec3 cameraWorldPosition = glm::vec3(glm::inverse(viewMat) * glm::vec4(0., 0., 0., 1.));
+    result.position = hit.position;
+    result.depth = glm::length(result.position - cameraWorldPosition);
+  }
+  return result;
+}
+
+} // namespace
+
+RayCastResult rayCast(glm::vec3 origin, glm::vec3 dir, float maxDistance) {
+
+  RayCastResult result;
+  if (glm::length(dir) == 0.) return result;
+  dir = glm::normalize(dir);
+
+  // Keep the nearest hit, and only search closer than it in the remaining structures
+  for (auto& cat : state::structures) {
+    for (auto& x : cat.second) {
+      if (!x.second->isEnabled()) continue;
+      float tMax = result.isHit ? result.distance : maxDistance;
+      RayCastResult structureResult = x.second->rayCast(origin, dir, 0., tMax);
+      if (structureResult.isHit && structureResult.distance <= tMax) {
+        result = structureResult;
+      }
+    }
+  }
+
+  return result;
+}
+
+PickResult pickAtBufferInds(glm::ivec2 bufferInds) {
+
+  if (options::pickWithRayCast && sceneCanRayCastPick()) {
+    return rayCastPickAtBufferInds(bufferInds, view::getCameraViewMatrix(), view::getCameraPerspectiveMatrix());
+  }
+
+  // Query the pick buffer
+  // (this necessarily renders to pickFrameBuffer)
+  std::tuple<Structure*, Quantity*, uint64_t> rawPickResult = pick::evaluatePickQueryFull(bufferInds.x, bufferInds.y);
+
+  // Query the depth buffer populated above
+  render::FrameBuffer* pickFramebuffer = render::engine->pickFramebuffer.get();
+  float clipDepth = pickFramebuffer->readDepth(bufferInds.x, view::bufferHeight - bufferInds.y);
+
+  return pickResultFromBuffers(bufferInds, rawPickResult, clipDepth, view::getCameraViewMatrix(),
+                               view::getCameraPerspectiveMatrix());
+}
+
+// == Asynchronous picking
+
+std::shared_ptr<PickQuery> pickAtScreenCoordsAsync(glm::vec2 screenCoords) {
+  glm::ivec2 bufferInds = view::screenCoordsToBufferIndsVec(screenCoords);
+  return pickAtBufferIndsAsync(bufferInds);
+}
+
+std::shared_ptr<PickQuery> pickAtBufferIndsAsync(glm::ivec2 bufferInds) {
+  std::shared_ptr<PickQuery> query = std::make_shared<PickQuery>();
+  query->bufferInds = bufferInds;
+  query->viewMat = view::getCameraViewMatrix();
+  query->projMat = view::getCameraPerspectiveMatrix();
+
+  // Ray cast picks are answered immediately
+  if (options::pickWithRayCast && sceneCanRayCastPick()) {
+    query->result = rayCastPickAtBufferInds(bufferInds, query->viewMat, query->projMat);
+    query->resultReady = true;
+    return query;
+  }
+
+  // Render the pick buffer now, but only queue the reads
+  if (pick::renderPickBuffer(bufferInds.x, bufferInds.y)) {
+    render::FrameBuffer* pickFramebuffer = render::engine->pickFramebuffer.get();
+    int yFlip = view::bufferHeight - bufferInds.y;
+    query->colorReadback = pickFramebuffer->readFloat4Async(bufferInds.x, yFlip);
+    query->depthReadback = pickFramebuffer->readDepthAsync(bufferInds.x, yFlip);
+  }
+  query->pickRangeAllocationID = state::globalContext.nextPickRangeAllocationID;
+
+  return query;
+}
+
+bool PickQuery::isReady() {
+  if (resultReady || !colorReadback) return true;
+  return colorReadback->isReady() && depthReadback->isReady();
+}
+
+PickResult PickQuery::getResult() {
+  if (resultReady) return result;
+
+  // if nothing was read (the query was outside of the buffer), treat it as a miss
+  std::tuple<Structure*, Quantity*, uint64_t> rawPickResult{nullptr, nullptr, 0};
+  float clipDepth = 1.;
+
+  if (colorReadback) {
+    std::array<float, 4> color;
+    std::memcpy(&color, &colorReadback->getBytes().front(), sizeof(color));
+    std::memcpy(&clipDepth, &depthReadback->getBytes().front(), sizeof(clipDepth));
+    uint64_t globalInd = pick::vecToInd(glm::vec3{color[0], color[1], color[2]});
+
+    // If the range holding the index was released since the pick buffer was rendered, the index may now belong to
+    // something else which reused it. Treat that as a miss rather than report the wrong element.
+    if (pick::pickIndexAllocatedBefore(globalInd, pickRangeAllocationID)) {
+      rawPickResult = pick::globalIndexToLocal(globalInd);
+    }
+  }
+
+  result = pickResultFromBuffers(bufferInds, rawPickResult, clipDepth, viewMat, projMat);
+  resultReady = true;
+  colorReadback.reset();
+  depthReadback.reset();
+  return result;
+}
+
+// == Region selection
+
+bool PickRegion::containsBufferPoint(glm::vec2 bufferCoords) const {
+  if (bufferCoords.x < bboxMin.x || bufferCoords.x > bboxMax.x || bufferCoords.y < bboxMin.y ||
+      bufferCoords.y > bboxMax.y) {
+    return false;
+  }
+  if (lasso.empty()) return true;
+
+  // Even-odd rule: count the lasso edges crossed by a ray to the left of the point
+  bool inside = false;
+  for (size_t i = 0, j = lasso.size() - 1; i < lasso.size(); j = i++) {
+    const glm::vec2& a = lasso[i];
+    const glm::vec2& b = lasso[j];
+    if ((a.y > bufferCoords.y) != (b.y > bufferCoords.y)) {
+      float xCross = a.x + (bufferCoords.y - a.y) / (b.y - a.y) * (b.x - a.x);
+      if (bufferCoords.x < xCross) inside = !inside;
+    }
+  }
+  return inside;
+}
+
+bool PickRegion::containsWorldPoint(glm::vec3 worldPos) const {
+  glm::vec4 clipPos = viewProjMat * glm::vec4(worldPos, 1.);
+  if (!(clipPos.w > 0.) || std::abs(clipPos.z) > clipPos.w) return false; // behind the camera, or outside near/far
+  glm::vec2 ndcPos = glm::vec2(clipPos.x, clipPos.y) / clipPos.w;
+  glm::vec2 bufferCoords{(ndcPos.x + 1.f) * 0.5f * bufferSize.x, (1.f - ndcPos.y) * 0.5f * bufferSize.y};
+  return containsBufferPoint(bufferCoords);
+}
+
+namespace {
+
+PickRegion pickRegionFromScreenCoords(const std::vector<glm::vec2>& screenPoints, bool isLasso) {
+  PickRegion region;
+  region.viewProjMat = view::getCameraPerspectiveMatrix() * view::getCameraViewMatrix();
+  region.bufferSize = glm::vec2{view::bufferWidth, view::bufferHeight};
+
+  glm::vec2 screenToBuffer{static_cast<float>(view::bufferWidth) / view::windowWidth,
+                           static_cast<float>(view::bufferHeight) / view::windowHeight};
+  region.bboxMin = glm::vec2{1., 1.} * std::numeric_limits<float>::infinity();
+  region.bboxMax = -glm::vec2{1., 1.} * std::numeric_limits<float>::infinity();
+  for (glm::vec2 p : screenPoints) {
+    glm::vec2 bufferCoords = p * screenToBuffer;
+    region.bboxMin = glm::min(region.bboxMin, bufferCoords);
+    region.bboxMax = glm::max(region.bboxMax, bufferCoords);
+    if (isLasso) region.lasso.push_back(bufferCoords);
+  }
+  return region;
+}
+
+RegionPickResult regionPickResultFor(Structure* structure, Quantity* quantity) {
+  RegionPickResult result;
+  result.structure = structure;
+  result.quantity = quantity;
+  result.structureHandle = structure->getWeakHandle<Structure>();
+  result.structureType = structure->subtypeName;
+  result.structureName = structure->name;
+  if (quantity != nullptr) {
+    result.quantityName = quantity->name;
+  }
+  return result;
+}
+
+// Shared logic for the rectangle and lasso selections
+std::vector<RegionPickResult> pickInRegion(const PickRegion& region, bool includeOccluded) {
+
+  // The pixels which might have their centers in the region
+  int xStart = std::max(static_cast<int>(std::floor(region.bboxMin.x)), 0);
+  int yStart = std::max(static_cast<int>(std::floor(region.bboxMin.y)), 0);
+  int xEnd = std::min(static_cast<int>(std::ceil(region.bboxMax.x)), view::bufferWidth);
+  int yEnd = std::min(static_cast<int>(std::ceil(region.bboxMax.y)), view::bufferHeight);
+
+  std::vector<uint64_t> globalInds;
+  if (xStart < xEnd && yStart < yEnd && pick::renderPickBuffer(xStart, yStart)) {
+
+    // Read the whole block at once. The rows of the framebuffer run bottom to top.
+    size_t sizeX = xEnd - xStart;
+    size_t sizeY = yEnd - yStart;
+    render::FrameBuffer* pickFramebuffer = render::engine->pickFramebuffer.get();
+    std::vector<std::array<float, 4>> pixels =
+        pickFramebuffer->readFloat4Block(xStart, view::bufferHeight - yEnd, sizeX, sizeY);
+
+    // Decode the pixels inside the region, deduplicating within each chunk
+    std::vector<std::vector<uint64_t>> chunkInds(parallelChunkCount(pixels.size()));
+    parallelForChunks(pixels.size(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+      std::vector<uint64_t>& inds = chunkInds[iChunk];
+      for (size_t i = iStart; i < iEnd; i++) {
+        glm::vec2 pixelCenter{xStart + (i % sizeX) + 0.5, yEnd - 1 - (i / sizeX) + 0.5};
+        if (!region.containsBufferPoint(pixelCenter)) continue;
+        uint64_t globalInd = pick::vecToInd(glm::vec3{pixels[i][0], pixels[i][1], pixels[i][2]});
+        if (globalInd != 0) inds.push_back(globalInd);
+      }
+      std::sort(inds.begin(), inds.end());
+      inds.erase(std::unique(inds.begin(), inds.end()), inds.end());
+    });
+    for (const std::vector<uint64_t>& inds : chunkInds) {
+      globalInds.insert(globalInds.end(), inds.begin(), inds.end());
+    }
+    std::sort(globalInds.begin(), globalInds.end());
+    globalInds.erase(std::unique(globalInds.begin(), globalInds.end()), globalInds.end());
+  }
+
+  // The indices of each structure or quantity are contiguous, so in sorted order they are grouped together
+  std::vector<RegionPickResult> results;
+  for (uint64_t globalInd : globalInds) {
+    std::tuple<Structure*, Quantity*, uint64_t> localPick = pick::globalIndexToLocal(globalInd);
+    Structure* structure = std::get<0>(localPick);
+    Quantity* quantity = std::get<1>(localPick);
+    if (structure == nullptr) continue;
+    if (results.empty() || results.back().structure != structure || results.back().quantity != quantity) {
+      results.push_back(regionPickResultFor(structure, quantity));
+    }
+    results.back().localIndices.push_back(std::get<2>(localPick));
+  }
+
+  if (includeOccluded) {
+    for (auto& cat : state::structures) {
+      for (auto& x : cat.second) {
+        Structure* structure = x.second.get();
+        if (!structure->isEnabled()) continue;
+        std::vector<uint64_t> inds = structure->pickIndicesInRegion(region);
+        if (inds.empty()) continue;
+
+        // Merge with the visible elements of the structure, if there were any
+        size_t iResult = 0;
+        while (iResult < results.size() &&
+               !(results[iResult].structure == structure && results[iResult].quantity == nullptr)) {
+          iResult++;
+        }
+        if (iResult == results.size()) {
+          results.push_back(regionPickResultFor(structure, nullptr));
+        }
+        std::vector<uint64_t>& localInds = results[iResult].localIndices;
+        localInds.insert(localInds.end(), inds.begin(), inds.end());
+        std::sort(localInds.begin(), localInds.end());
+        localInds.erase(std::unique(localInds.begin(), localInds.end()), localInds.end());
+      }
+    }
+  }
+
+  return results;
+}
+
+} // namespace
+
+std::vector<RegionPickResult> pickInScreenRectangle(glm::vec2 screenCornerA, glm::vec2 screenCornerB,
+                                                    bool includeOccluded) {
+  return pickInRegion(pickRegionFromScreenCoords({screenCornerA, screenCornerB}, false), includeOccluded);
+}
+
+std::vector<RegionPickResult> pickInScreenLasso(const std::vector<glm::vec2>& screenPolygon, bool includeOccluded) {
+  if (screenPolygon.size() < 3) return std::vector<RegionPickResult>();
+  return pickInRegion(pickRegionFromScreenCoords(screenPolygon, true), includeOccluded);
+}
+
 // == Manage stateful picking
 
 void resetSelection() {
@@ -74,8 +386,23 @@ void resetSelectionIfStructure(Structure* s) {
   if (state::globalContext.haveSelectionVal && state::globalContext.currSelectionPickResult.structure == s) {
     resetSelection();
   }
+
+  std::vector<RegionPickResult>& regionSelection = state::globalContext.regionSelection;
+  regionSelection.erase(std::remove_if(regionSelection.begin(), regionSelection.end(),
+                                       [&](const RegionPickResult& r) { return r.structure == s; }),
+                        regionSelection.end());
+}
+
+std::vector<RegionPickResult> getRegionSelection() { return state::globalContext.regionSelection; }
+
+void setRegionSelection(std::vector<RegionPickResult> newSelection) {
+  state::globalContext.regionSelection = newSelection;
 }
 
+void resetRegionSelection() { state::globalContext.regionSelection.clear(); }
+
+bool haveRegionSelection() { return !state::globalContext.regionSelection.empty(); }
+
 PickResult getSelection() { return state::globalContext.currSelectionPickResult; }
 
 void setSelection(PickResult newPick) {
@@ -93,6 +420,55 @@ namespace pick {
 // == Set up picking
 namespace {
 
+// Released ranges are coalesced with their free neighbors, and a free range that reaches the top of the allocated
+// indices is dropped by lowering nextPickBufferInd, so the indices in use stay compact.
+void addFreePickRange(uint64_t start, uint64_t end) {
+  std::map<uint64_t, uint64_t>& freeRanges = state::globalContext.freePickRanges;
+  std::set<std::pair<uint64_t, uint64_t>>& freeBySize = state::globalContext.freePickRangesBySize;
+
+  // merge with the free range after it
+  std::map<uint64_t, uint64_t>::iterator next = freeRanges.find(end);
+  if (next != freeRanges.end()) {
+    end = next->second;
+    freeBySize.erase(std::make_pair(next->second - next->first, next->first));
+    freeRanges.erase(next);
+  }
+
+  // merge with the free range before it
+  std::map<uint64_t, uint64_t>::iterator prev = freeRanges.lower_bound(start);
+  if (prev != freeRanges.begin()) {
+    prev--;
+    if (prev->second == start) {
+      start = prev->first;
+      freeBySize.erase(std::make_pair(prev->second - prev->first, prev->first));
+      freeRanges.erase(prev);
+    }
+  }
+
+  if (end == state::globalContext.nextPickBufferInd) {
+    state::globalContext.nextPickBufferInd = start;
+    return;
+  }
+  freeRanges[start] = end;
+  freeBySize.insert(std::make_pair(end - start, start));
+}
+
+void releasePickBufferRangeStartingAt(uint64_t start) {
+  std::map<uint64_t, PickBufferRange>::iterator it = state::globalContext.pickRanges.find(start);
+  if (it == state::globalContext.pickRanges.end()) return;
+  uint64_t end = it->second.end;
+  state::globalContext.pickRanges.erase(it);
+  addFreePickRange(start, end);
+  invalidatePickBuffer();
+}
+
+void releaseStructurePickBufferRange(Structure* structure) {
+  std::unordered_map<Structure*, uint64_t>::iterator it = state::globalContext.structurePickRangeStarts.find(structure);
+  if (it == state::globalContext.structurePickRangeStarts.end()) return;
+  releasePickBufferRangeStartingAt(it->second);
+  state::globalContext.structurePickRangeStarts.erase(it);
+}
+
 // helper sharing logic for both cases below
 uint64_t requestPickBufferRange(Structure* requestingStructure, Quantity* requestingQuantity, uint64_t count) {
 
@@ -101,33 +477,67 @@ uint64_t requestPickBufferRange(Structure* requestingStructure, Quantity* reques
     throw std::logic_error("only one of the requestPickBufferRange() pointers should be null, not both");
   }
 
-  // Check if we can satisfy the request
-  uint64_t maxPickInd = std::numeric_limits<uint64_t>::max();
+  // A structure or quantity re-preparing its pick data is done with its old range
+  if (requestingStructure != nullptr) {
+    releaseStructurePickBufferRange(requestingStructure);
+  }
+  if (requestingQuantity != nullptr) {
+    releasePickBufferRange(requestingQuantity);
+  }
+
+  // Empty requests still get an index, so every range has a distinct start
+  count = std::max(count, static_cast<uint64_t>(1));
+
+  // Take the smallest released range which is big enough, if there is one
+  uint64_t ret;
+  std::set<std::pair<uint64_t, uint64_t>>& freeBySize = state::globalContext.freePickRangesBySize;
+  std::set<std::pair<uint64_t, uint64_t>>::iterator fit = freeBySize.lower_bound(std::make_pair(count, uint64_t(0)));
+  if (fit != freeBySize.end()) {
+    ret = fit->second;
+    uint64_t freeEnd = ret + fit->first;
+    freeBySize.erase(fit);
+    state::globalContext.freePickRanges.erase(ret);
+    if (ret + count < freeEnd) {
+      state::globalContext.freePickRanges[ret + count] = freeEnd;
+      freeBySize.insert(std::make_pair(freeEnd - (ret + count), ret + count));
+    }
+  } else {
+
+    // Otherwise, allocate at the end. Check if we can satisfy the request
+    uint64_t maxPickInd = std::numeric_limits<uint64_t>::max();
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wshift-count-overflow"
-  if (bitsForPickPacking < 22) {
-    uint64_t bitMax = 1ULL << (bitsForPickPacking * 3);
-    if (bitMax < maxPickInd) {
-      maxPickInd = bitMax;
+    if (bitsForPickPacking < 22) {
+      uint64_t bitMax = 1ULL << (bitsForPickPacking * 3);
+      if (bitMax < maxPickInd) {
+        maxPickInd = bitMax;
+      }
     }
-  }
 #pragma GCC diagnostic pop
 
-  if (count > maxPickInd || maxPickInd - count < state::globalContext.nextPickBufferInd) {
-    exception("Wow, you sure do have a lot of stuff, Polyscope can't even count it all. (Ran out of indices while "
-              "enumerating structure elements for pick buffer.)");
+    if (count > maxPickInd || maxPickInd - count < state::globalContext.nextPickBufferInd) {
+      exception("Wow, you sure do have a lot of stuff, Polyscope can't even count it all. (Ran out of indices while "
+                "enumerating structure elements for pick buffer.)");
+    }
+
+    ret = state::globalContext.nextPickBufferInd;
+    state::globalContext.nextPickBufferInd += count;
   }
 
-  uint64_t ret = state::globalContext.nextPickBufferInd;
-  state::globalContext.nextPickBufferInd += count;
+  PickBufferRange range;
+  range.end = ret + count;
+  range.structure = requestingStructure;
+  range.quantity = requestingQuantity;
+  range.allocationID = state::globalContext.nextPickRangeAllocationID++;
   if (requestingStructure != nullptr) {
-    state::globalContext.structureRanges[requestingStructure] =
-        std::make_tuple(ret, state::globalContext.nextPickBufferInd);
+    state::globalContext.structurePickRangeStarts[requestingStructure] = ret;
   }
   if (requestingQuantity != nullptr) {
-    state::globalContext.quantityRanges[requestingQuantity] =
-        std::make_tuple(ret, state::globalContext.nextPickBufferInd);
+    range.structure = &requestingQuantity->parent;
+    state::globalContext.quantityPickRangeStarts[requestingQuantity] = ret;
   }
+  state::globalContext.pickRanges[ret] = range;
+  invalidatePickBuffer();
   return ret;
 }
 } // namespace
@@ -140,42 +550,52 @@ uint64_t requestPickBufferRange(Quantity* requestingQuantity, uint64_t count) {
   return requestPickBufferRange(nullptr, requestingQuantity, count);
 }
 
-// == Helpers
-
-std::tuple<Structure*, Quantity*, uint64_t> globalIndexToLocal(uint64_t globalInd) {
-
-  // ONEDAY: this could be asymptotically better if we cared
-
-  // Loop through the ranges that we have allocated to find the one corresponding to this structure.
-  for (const auto& x : state::globalContext.structureRanges) {
+void releasePickBufferRange(Quantity* quantity) {
+  std::unordered_map<Quantity*, uint64_t>::iterator it = state::globalContext.quantityPickRangeStarts.find(quantity);
+  if (it == state::globalContext.quantityPickRangeStarts.end()) return;
+  releasePickBufferRangeStartingAt(it->second);
+  state::globalContext.quantityPickRangeStarts.erase(it);
+}
 
-    Structure* structure = x.first;
-    uint64_t rangeStart = std::get<0>(x.second);
-    uint64_t rangeEnd = std::get<1>(x.second);
+void releasePickBufferRanges(Structure* structure) {
+  releaseStructurePickBufferRange(structure);
 
-    if (globalInd >= rangeStart && globalInd < rangeEnd) {
-      return {structure, nullptr, globalInd - rangeStart};
+  // Also release the ranges of its quantities
+  std::vector<Quantity*> quantities;
+  for (const auto& x : state::globalContext.quantityPickRangeStarts) {
+    if (state::globalContext.pickRanges.at(x.second).structure == structure) {
+      quantities.push_back(x.first);
     }
   }
+  for (Quantity* q : quantities) {
+    releasePickBufferRange(q);
+  }
+}
 
+// == Helpers
 
-  // Look through quantity ranges
-  for (const auto& x : state::globalContext.quantityRanges) {
-
-    Quantity* quantity = x.first;
-    uint64_t rangeStart = std::get<0>(x.second);
-    uint64_t rangeEnd = std::get<1>(x.second);
-
-    if (globalInd >= rangeStart && globalInd < rangeEnd) {
-
-      // look up the structure that goes with this quantity
-      Structure* structure = &quantity->parent;
+std::tuple<Structure*, Quantity*, uint64_t> globalIndexToLocal(uint64_t globalInd) {
 
-      return {structure, quantity, globalInd - rangeStart};
-    }
+  // Find the last range starting at or before the index, and check that the index is inside it
+  const std::map<uint64_t, PickBufferRange>& ranges = state::globalContext.pickRanges;
+  std::map<uint64_t, PickBufferRange>::const_iterator it = ranges.upper_bound(globalInd);
+  if (it == ranges.begin()) {
+    return {nullptr, nullptr, 0};
+  }
+  it--;
+  if (globalInd >= it->second.end) {
+    return {nullptr, nullptr, 0};
   }
 
-  return {nullptr, nullptr, 0};
+  return {it->second.structure, it->second.quantity, globalInd - it->first};
+}
+
+bool pickIndexAllocatedBefore(uint64_t globalInd, uint64_t allocationID) {
+  const std::map<uint64_t, PickBufferRange>& ranges = state::globalContext.pickRanges;
+  std::map<uint64_t, PickBufferRange>::const_iterator it = ranges.upper_bound(globalInd);
+  if (it == ranges.begin()) return false;
+  it--;
+  return globalInd < it->second.end && it->second.allocationID < allocationID;
 }
 
 uint64_t localIndexToGlobal(std::tuple<Structure*, Quantity*, uint64_t> localPick) {
@@ -185,18 +605,14 @@ uint64_t localIndexToGlobal(std::tuple<Structure*, Quantity*, uint64_t> localPic
 
   if (structurePtr == nullptr && quantityPtr == nullptr) return 0;
 
-  if (state::globalContext.structureRanges.find(structurePtr) != state::globalContext.structureRanges.end()) {
-    std::tuple<uint64_t, uint64_t> range = state::globalContext.structureRanges[structurePtr];
-    uint64_t rangeStart = std::get<0>(range);
-    uint64_t rangeEnd = std::get<1>(range);
-    return rangeStart + localInd;
+  if (state::globalContext.structurePickRangeStarts.find(structurePtr) !=
+      state::globalContext.structurePickRangeStarts.end()) {
+    return state::globalContext.structurePickRangeStarts[structurePtr] + localInd;
   }
 
-  if (state::globalContext.quantityRanges.find(quantityPtr) != state::globalContext.quantityRanges.end()) {
-    std::tuple<uint64_t, uint64_t> range = state::globalContext.quantityRanges[quantityPtr];
-    uint64_t rangeStart = std::get<0>(range);
-    uint64_t rangeEnd = std::get<1>(range);
-    return rangeStart + localInd;
+  if (state::globalContext.quantityPickRangeStarts.find(quantityPtr) !=
+      state::globalContext.quantityPickRangeStarts.end()) {
+    return state::globalContext.quantityPickRangeStarts[quantityPtr] + localInd;
   }
 
   exception("structure/quantity does not match any allocated pick range");
@@ -212,44 +628,72 @@ std::pair<Structure*, uint64_t> pickAtScreenCoords(glm::vec2 screenCoords) {
 
 std::pair<Structure*, uint64_t> pickAtBufferCoords(int xPos, int yPos) { return evaluatePickQuery(xPos, yPos); }
 
-std::tuple<Structure*, Quantity*, uint64_t> evaluatePickQueryFull(int xPos, int yPos) {
+bool renderPickBuffer(int xPos, int yPos) {
 
   // NOTE: hack used for debugging: if xPos == yPos == -1 we do a pick render but do not query the value.
 
   // Be sure not to pick outside of buffer
   if (xPos < -1 || xPos >= view::bufferWidth || yPos < -1 || yPos >= view::bufferHeight) {
-    return {nullptr, nullptr, 0};
+    return false;
   }
 
   render::FrameBuffer* pickFramebuffer = render::engine->pickFramebuffer.get();
 
+  // If nothing has changed since the last render, the buffer still holds the right values
+  glm::mat4 viewMat = view::getCameraViewMatrix();
+  glm::mat4 projMat = view::getCameraPerspectiveMatrix();
+  if (state::globalContext.pickBufferValid && !options::alwaysRedraw &&
+      state::globalContext.pickBufferFramebufferID == pickFramebuffer->getUniqueID() &&
+      pickFramebuffer->getSizeX() == static_cast<unsigned int>(view::bufferWidth) &&
+      pickFramebuffer->getSizeY() == static_cast<unsigned int>(view::bufferHeight) &&
+      state::globalContext.pickBufferViewMat == viewMat && state::globalContext.pickBufferProjMat == projMat) {
+    return xPos != -1 && yPos != -1;
+  }
+
   render::engine->setDepthMode(DepthMode::Less);
   render::engine->setBlendMode(BlendMode::Disable);
 
   pickFramebuffer->resize(view::bufferWidth, view::bufferHeight);
   pickFramebuffer->setViewport(0, 0, view::bufferWidth, view::bufferHeight);
   pickFramebuffer->clearColor = glm::vec3{0., 0., 0.};
-  if (!pickFramebuffer->bindForRendering()) return {nullptr, nullptr, 0};
+  if (!pickFramebuffer->bindForRendering()) return false;
   pickFramebuffer->clear();
 
-  // Render pick buffer
+  // Render pick buffer, skipping structures which are culled in this view
+  glm::mat4 viewProjMat = projMat * viewMat;
+  std::vector<Structure*> pickStructures;
   for (auto& cat : state::structures) {
     for (auto& x : cat.second) {
-      x.second->drawPick();
+      Structure& s = *x.second;
+      if (s.isEnabled() && (s.isCulledBySlicePlanes() || s.isCulledByFrustum(viewProjMat))) continue;
+      pickStructures.push_back(&s);
     }
   }
-  for (auto& catMap : state::structures) {
-    for (auto& s : catMap.second) {
-      s.second->drawPickDelayed();
-    }
+  for (Structure* s : pickStructures) {
+    s->drawPick();
   }
+  for (Structure* s : pickStructures) {
+    s->drawPickDelayed();
+  }
+
+  state::globalContext.pickBufferValid = true;
+  state::globalContext.pickBufferFramebufferID = pickFramebuffer->getUniqueID();
+  state::globalContext.pickBufferViewMat = viewMat;
+  state::globalContext.pickBufferProjMat = projMat;
 
+  return xPos != -1 && yPos != -1;
+}
+
+void invalidatePickBuffer() { state::globalContext.pickBufferValid = false; }
 
-  if (xPos == -1 || yPos == -1) {
+std::tuple<Structure*, Quantity*, uint64_t> evaluatePickQueryFull(int xPos, int yPos) {
+
+  if (!renderPickBuffer(xPos, yPos)) {
     return {nullptr, nullptr, 0};
   }
 
   // Read from the pick buffer
+  render::FrameBuffer* pickFramebuffer = render::engine->pickFramebuffer.get();
   std::array<float, 4> result = pickFramebuffer->readFloat4(xPos, view::bufferHeight - yPos);
   uint64_t globalInd = pick::vecToInd(glm::vec3{result[0], result[1], result[2]});
 
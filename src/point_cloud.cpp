@@ -30,12 +30,14 @@ PointCloud::PointCloud(std::string name, std::vector<glm::vec3> points_)
       pointRenderMode(uniquePrefix() + "pointRenderMode", "sphere"),
       pointColor(uniquePrefix() + "pointColor", getNextUniqueColor()),
       pointRadius(uniquePrefix() + "pointRadius", relativeValue(0.005)),
-      material(uniquePrefix() + "material", "clay")
+      material(uniquePrefix() + "material", "clay"),
+      compactStorage(uniquePrefix() + "compactStorage", false)
 // clang-format on
 {
   points.checkInvalidValues();
   cullWholeElements.setPassive(true);
   updateObjectSpaceBounds();
+  updateDeviceStorageFormats();
 }
 
 // Helper to set uniforms
@@ -62,6 +64,11 @@ void PointCloud::setPointCloudUniforms(render::ShaderProgram& p) {
 
     p.setUniform("u_pointRadius", pointRadius.get().asAbsolute() / scalarQScale);
   }
+
+  if (points.getDeviceStorageFormat() == AttributeStorageFormat::UNorm16) {
+    p.setUniform("u_positionQuantizationOffset", glm::vec3(points.getQuantizationOffset()));
+    p.setUniform("u_positionQuantizationScale", glm::vec3(points.getQuantizationScale()));
+  }
 }
 
 void PointCloud::draw() {
@@ -261,6 +268,9 @@ std::vector<std::string> PointCloud::addPointCloudRules(std::vector<std::string>
     if (transparencyQuantityName != "") {
       initRules.push_back("SPHERE_PROPAGATE_VALUEALPHA");
     }
+    if (points.getDeviceStorageFormat() == AttributeStorageFormat::UNorm16) {
+      initRules.push_back("POSITION_QUANTIZED");
+    }
   }
   return initRules;
 }
@@ -281,6 +291,11 @@ PointCloudScalarQuantity& PointCloud::resolvePointRadiusQuantity() {
   return *sizeScalarQ;
 }
 
+std::vector<uint64_t> PointCloud::pickIndicesInRegion(const PickRegion& region) {
+  points.ensureHostBufferPopulated();
+  return pickIndicesOfPositionsInRegion(points.data, 0, region);
+}
+
 void PointCloud::buildPickUI(const PickResult& rawResult) {
 
   PointCloudPickResult result = interpretPickResult(rawResult);
@@ -380,8 +395,11 @@ void PointCloud::buildCustomOptionsUI() {
   }
 }
 
+bool PointCloud::ensureCullingBoundsCurrent() { return ensureBoundsCurrentWith(points, boundsPositionsUpdateCount); }
+
 void PointCloud::updateObjectSpaceBounds() {
   points.ensureHostBufferPopulated();
+  boundsPositionsUpdateCount = points.getUpdateCount();
 
   // bounding box
   glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
@@ -401,6 +419,12 @@ void PointCloud::updateObjectSpaceBounds() {
   objectSpaceLengthScale = 2 * std::sqrt(lengthScale);
 }
 
+float PointCloud::getCullingPadding() {
+  // (radii from a quantity which is not rescaled could be anything)
+  if (pointRadiusQuantityName != "" && !pointRadiusQuantityAutoscale) return std::numeric_limits<float>::infinity();
+  return std::max(Structure::getCullingPadding(), static_cast<float>(getPointRadius()));
+}
+
 
 std::string PointCloud::typeName() { return structureTypeName; }
 
@@ -559,6 +583,23 @@ PointCloud* PointCloud::setMaterial(std::string m) {
 }
 std::string PointCloud::getMaterial() { return material.get(); }
 
+PointCloud* PointCloud::setCompactStorage(bool newVal) {
+  compactStorage = newVal;
+  updateDeviceStorageFormats();
+  refresh(); // programs must be rebuilt to use the new buffers
+  requestRedraw();
+  return this;
+}
+bool PointCloud::getCompactStorage() { return compactStorage.get(); }
+
+void PointCloud::updateDeviceStorageFormats() {
+  points.setDeviceStorageFormat(getCompactStorage() ? AttributeStorageFormat::UNorm16 : AttributeStorageFormat::Float32);
+  for (auto& x : quantities) {
+    PointCloudScalarQuantity* scalarQ = dynamic_cast<PointCloudScalarQuantity*>(x.second.get());
+    if (scalarQ) scalarQ->updateDeviceStorageFormat();
+  }
+}
+
 PointCloud* PointCloud::setPointRadius(double newVal, bool isRelative) {
   pointRadius = ScaledValue<float>(newVal, isRelative);
   polyscope::requestRedraw();
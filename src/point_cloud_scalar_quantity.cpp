@@ -11,7 +11,9 @@ namespace polyscope {
 
 PointCloudScalarQuantity::PointCloudScalarQuantity(std::string name, const std::vector<float>& values_,
                                                    PointCloud& pointCloud_, DataType dataType_)
-    : PointCloudQuantity(name, pointCloud_, true), ScalarQuantity(*this, values_, dataType_) {}
+    : PointCloudQuantity(name, pointCloud_, true), ScalarQuantity(*this, values_, dataType_) {
+  updateDeviceStorageFormat();
+}
 
 void PointCloudScalarQuantity::draw() {
   if (!isEnabled()) return;
@@ -87,6 +89,16 @@ void PointCloudScalarQuantity::buildPickUI(size_t ind) {
 }
 
 
+void PointCloudScalarQuantity::updateDeviceStorageFormat() {
+  // categorical labels are left at full precision, half floats cannot represent large integer labels exactly
+  bool useHalf = parent.getCompactStorage() && dataType != DataType::CATEGORICAL;
+  AttributeStorageFormat newFormat = useHalf ? AttributeStorageFormat::Float16 : AttributeStorageFormat::Float32;
+  if (values.getDeviceStorageFormat() != newFormat) {
+    values.setDeviceStorageFormat(newFormat);
+    pointProgram.reset();
+  }
+}
+
 std::string PointCloudScalarQuantity::niceName() { return name + " (scalar)"; }
 
 } // namespace polyscope
@@ -48,4 +48,6 @@ void PointCloudVectorQuantity::buildPickUI(size_t ind) {
 
 std::string PointCloudVectorQuantity::niceName() { return name + " (vector)"; }
 
+float PointCloudVectorQuantity::getCullingPadding() { return getVectorCullingPadding(); }
+
 } // namespace polyscope
@@ -14,7 +14,9 @@
 #include "polyscope/imgui_config.h"
 #include "polyscope/options.h"
 #include "polyscope/pick.h"
+#include "polyscope/profiler.h"
 #include "polyscope/render/engine.h"
+#include "polyscope/render/managed_buffer.h"
 #include "polyscope/utilities.h"
 #include "polyscope/view.h"
 
@@ -413,15 +415,64 @@ void frameTick() {
   frameTickStack--;
 }
 
-void requestRedraw() { redrawNextFrame = true; }
+void requestRedraw() {
+  redrawNextFrame = true;
+  pick::invalidatePickBuffer();
+}
 bool redrawRequested() { return redrawNextFrame; }
 
+namespace {
+
+glm::mat4 currentViewProjMat() { return view::getCameraPerspectiveMatrix() * view::getCameraViewMatrix(); }
+
+// Find the enabled structures which can be skipped when rendering the current view
+void cullStructures() {
+  state::globalContext.culledStructures.clear();
+  state::globalContext.cullingStructuresTested = 0;
+  state::globalContext.cullingCulledByFrustum = 0;
+  state::globalContext.cullingCulledBySlicePlanes = 0;
+  state::globalContext.cullingViewProjMat = currentViewProjMat();
+  state::globalContext.cullingPassValid = true;
+  if (!options::enableCulling) return;
+
+  profiler::ScopedTimer timer("culling");
+  for (auto& catMap : state::structures) {
+    for (auto& s : catMap.second) {
+      if (!s.second->isEnabled()) continue;
+      state::globalContext.cullingStructuresTested++;
+      if (s.second->isCulledBySlicePlanes()) {
+        state::globalContext.cullingCulledBySlicePlanes++;
+        state::globalContext.culledStructures.insert(s.second.get());
+      } else if (s.second->isCulledByFrustum(state::globalContext.cullingViewProjMat)) {
+        state::globalContext.cullingCulledByFrustum++;
+        state::globalContext.culledStructures.insert(s.second.get());
+      }
+    }
+  }
+}
+
+// Can drawing the structure be skipped in the current view? The result of the culling pass is used if it was run for
+// this view. Other views (like the ground plane's reflection and shadow) test the structure directly.
+bool isCulledInCurrentView(Structure& s, const glm::mat4& viewProjMat) {
+  if (!options::enableCulling || !s.isEnabled()) return false;
+  if (state::globalContext.cullingPassValid && viewProjMat == state::globalContext.cullingViewProjMat) {
+    return state::globalContext.culledStructures.find(&s) != state::globalContext.culledStructures.end();
+  }
+  return s.isCulledBySlicePlanes() || s.isCulledByFrustum(viewProjMat);
+}
+
+} // namespace
+
 void drawStructures() {
+  profiler::ScopedTimer timer("draw structures");
+  glm::mat4 viewProjMat = currentViewProjMat();
 
   // Draw all off the structures registered with polyscope
 
   for (auto& catMap : state::structures) {
     for (auto& s : catMap.second) {
+      if (isCulledInCurrentView(*s.second, viewProjMat)) continue;
+      profiler::ScopedTimer structureTimer("draw", s.second->name);
       s.second->draw();
     }
   }
@@ -433,10 +484,14 @@ void drawStructures() {
 }
 
 void drawStructuresDelayed() {
+  profiler::ScopedTimer timer("draw structures delayed");
+  glm::mat4 viewProjMat = currentViewProjMat();
+
   // "delayed" drawing allows structures to render things which should be rendered after most of the scene has been
   // drawn
   for (auto& catMap : state::structures) {
     for (auto& s : catMap.second) {
+      if (isCulledInCurrentView(*s.second, viewProjMat)) continue;
       s.second->drawDelayed();
     }
   }
@@ -447,10 +502,27 @@ namespace {
 float dragDistSinceLastRelease = 0.0;
 
 // State for delayed pick selection
+// (the pick is read back asynchronously while we wait to see if the click becomes a double-click)
 bool pendingPickActive = false;
-PickResult pendingPickResult;
+std::shared_ptr<PickQuery> pendingPickQuery;
 float pendingPickTime = 0.0f;
 
+// State for a region selection being dragged out: the two corners of a rectangle, or the points of a lasso
+bool regionSelectActive = false;
+bool regionSelectIsLasso = false;
+std::vector<glm::vec2> regionSelectPoints;
+
+// Drop any in-progress pick or region selection. The pending pick holds a readback, so this must happen before the
+// render engine is shut down.
+void resetPendingSelection() {
+  pendingPickActive = false;
+  pendingPickQuery.reset();
+  pendingPickTime = 0.0f;
+  regionSelectActive = false;
+  regionSelectIsLasso = false;
+  regionSelectPoints.clear();
+}
+
 void processInputEvents() {
   ImGuiIO& io = ImGui::GetIO();
 
@@ -518,6 +590,7 @@ void processInputEvents() {
           bool isRotate = dragLeft && !io.KeyShift && !io.KeyCtrl;
           bool isTranslate = (dragLeft && io.KeyShift && !io.KeyCtrl) || dragRight;
           bool isDragZoom = dragLeft && io.KeyShift && io.KeyCtrl;
+          bool isRegionSelect = dragLeft && !io.KeyShift && io.KeyCtrl;
 
           if (isDragZoom) {
             view::processZoom(dragDelta.y * 5);
@@ -533,6 +606,18 @@ void processInputEvents() {
           if (isTranslate) {
             view::processTranslate(dragDelta);
           }
+          if (isRegionSelect) {
+            glm::vec2 currPos{io.MousePos.x, io.MousePos.y};
+            if (!regionSelectActive) {
+              regionSelectActive = true;
+              regionSelectIsLasso = io.KeyAlt;
+              regionSelectPoints = {glm::vec2{io.MouseClickedPos[0].x, io.MouseClickedPos[0].y}, currPos};
+            } else if (!regionSelectIsLasso) {
+              regionSelectPoints.back() = currPos;
+            } else if (glm::length(currPos - regionSelectPoints.back()) >= 2.) {
+              regionSelectPoints.push_back(currPos);
+            }
+          }
         }
       }
 
@@ -551,7 +636,8 @@ void processInputEvents() {
           float pickDelaySec = ImGui::GetIO().MouseDoubleClickTime + 0.05f; // 50ms margin for safety
           if (haveSelection() || elapsedSec >= pickDelaySec) {
             // enough time has passed, apply the pending pick
-            setSelection(pendingPickResult);
+            setSelection(pendingPickQuery->getResult());
+            pendingPickQuery.reset();
             pendingPickActive = false;
           }
         }
@@ -561,9 +647,8 @@ void processInputEvents() {
           // don't pick at the end of a long drag
           if (dragDistSinceLastRelease < dragIgnoreThreshold) {
             glm::vec2 screenCoords{io.MousePos.x, io.MousePos.y};
-            PickResult pickResult = pickAtScreenCoords(screenCoords);
             // queue the pick for delayed application
-            pendingPickResult = pickResult;
+            pendingPickQuery = pickAtScreenCoordsAsync(screenCoords);
             pendingPickTime = ImGui::GetTime();
             pendingPickActive = true;
           }
@@ -573,6 +658,7 @@ void processInputEvents() {
         if (!anyModifierHeld && io.MouseReleased[1]) {
           if (dragDistSinceLastRelease < dragIgnoreThreshold) {
             resetSelection();
+            resetRegionSelection();
           }
           dragDistSinceLastRelease = 0.0;
           pendingPickActive = false;
@@ -590,6 +676,33 @@ void processInputEvents() {
     }
   }
 
+  // Draw the region selection while it is dragged out, and apply it when released
+  if (regionSelectActive) {
+    ImDrawList* drawList = ImGui::GetForegroundDrawList();
+    ImU32 regionColor = IM_COL32(255, 255, 255, 200);
+    if (regionSelectIsLasso) {
+      std::vector<ImVec2> lassoPoints;
+      for (glm::vec2 p : regionSelectPoints) lassoPoints.push_back(ImVec2(p.x, p.y));
+      drawList->AddPolyline(&lassoPoints.front(), static_cast<int>(lassoPoints.size()), regionColor, ImDrawFlags_Closed,
+                            1.5f);
+    } else {
+      drawList->AddRect(ImVec2(regionSelectPoints[0].x, regionSelectPoints[0].y),
+                        ImVec2(regionSelectPoints[1].x, regionSelectPoints[1].y), regionColor, 0.f, ImDrawFlags_None,
+                        1.5f);
+    }
+
+    if (io.MouseReleased[0]) {
+      if (regionSelectIsLasso) {
+        setRegionSelection(pickInScreenLasso(regionSelectPoints, options::regionSelectionIncludesOccluded));
+      } else {
+        setRegionSelection(pickInScreenRectangle(regionSelectPoints[0], regionSelectPoints[1],
+                                                 options::regionSelectionIncludesOccluded));
+      }
+      regionSelectActive = false;
+      regionSelectPoints.clear();
+    }
+  }
+
   // Reset the drag distance after any release
   if (io.MouseReleased[0]) {
     dragDistSinceLastRelease = 0.0;
@@ -609,6 +722,8 @@ void renderSlicePlanes() {
 }
 
 void renderScene() {
+  profiler::ScopedTimer timer("render scene");
+  state::globalContext.cullingPassValid = false;
 
   render::engine->applyTransparencySettings();
 
@@ -623,6 +738,9 @@ void renderScene() {
 
   if (!options::renderScene) return;
 
+  // Skip structures which are out of view in all of the passes below
+  cullStructures();
+
   if (render::engine->getTransparencyMode() == TransparencyMode::Pretty) {
     // Special depth peeling case: multiple render passes
     // We will perform several "peeled" rounds of rendering in to the usual scene buffer. After each, we will manually
@@ -640,6 +758,7 @@ void renderScene() {
 
 
     for (int iPass = 0; iPass < options::transparencyRenderPasses; iPass++) {
+      profiler::ScopedTimer passTimer("depth peel pass");
 
       render::engine->bindSceneBuffer();
       render::engine->clearSceneBuffer();
@@ -683,6 +802,8 @@ void renderScene() {
 
     render::engine->sceneBuffer->blitTo(render::engine->sceneBufferFinal.get());
   }
+
+  state::globalContext.cullingPassValid = false;
 }
 
 void renderSceneToScreen() {
@@ -745,6 +866,61 @@ void userGuiEnd() {
   ImGui::PopID();
 }
 
+void buildMemoryUsageText(const render::ManagedBufferMemoryUsage& usage) {
+  ImGui::Text("host: %s  device: %s  indexed views: %s", prettyPrintBytes(usage.hostBytes).c_str(),
+              prettyPrintBytes(usage.deviceBytes).c_str(), prettyPrintBytes(usage.indexedViewBytes).c_str());
+}
+
+// List each buffer in the registry on its own line
+void buildManagedBufferMemoryUsageList(render::ManagedBufferRegistry& registry) {
+  for (std::tuple<std::string, render::ManagedBufferMemoryUsage>& entry :
+       registry.getManagedBufferMemoryUsageByBuffer()) {
+
+    // buffer names are prefixed by their owner, strip that off for display
+    std::string bufferName = std::get<0>(entry);
+    size_t prefixEnd = bufferName.rfind('#');
+    if (prefixEnd != std::string::npos) bufferName = bufferName.substr(prefixEnd + 1);
+
+    ImGui::TextUnformatted(bufferName.c_str());
+    ImGui::Indent();
+    buildMemoryUsageText(std::get<1>(entry));
+    ImGui::Unindent();
+  }
+}
+
+void buildMemoryUsageGui() {
+
+  buildMemoryUsageText(getMemoryUsage());
+
+  for (auto& cat : state::structures) {
+    for (auto& x : cat.second) {
+      Structure& s = *x.second;
+      render::ManagedBufferMemoryUsage structureUsage = s.getMemoryUsage();
+
+      std::string label = cat.first + " " + x.first + " (" + prettyPrintBytes(structureUsage.hostBytes) + " host, " +
+                          prettyPrintBytes(structureUsage.totalDeviceBytes()) + " device)";
+      if (ImGui::TreeNode((label + "##memory").c_str())) {
+
+        buildManagedBufferMemoryUsageList(s);
+
+        auto buildQuantityNode = [&](Quantity& q) {
+          render::ManagedBufferMemoryUsage quantityUsage = q.getManagedBufferMemoryUsage();
+          std::string qLabel = q.name + " (" + prettyPrintBytes(quantityUsage.hostBytes) + " host, " +
+                               prettyPrintBytes(quantityUsage.totalDeviceBytes()) + " device)";
+          if (ImGui::TreeNode((qLabel + "##memory").c_str())) {
+            buildManagedBufferMemoryUsageList(q);
+            ImGui::TreePop();
+          }
+        };
+        for (auto& q : s.quantities) buildQuantityNode(*q.second);
+        for (auto& q : s.floatingQuantities) buildQuantityNode(*q.second);
+
+        ImGui::TreePop();
+      }
+    }
+  }
+}
+
 } // namespace
 
 void buildPolyscopeGui() {
@@ -765,6 +941,7 @@ void buildPolyscopeGui() {
     ScreenshotOptions options;
     options.transparentBackground = options::screenshotTransparency;
     options.includeUI = options::screenshotWithImGuiUI;
+    options.async = true;
     screenshot(options);
   }
   ImGui::SameLine();
@@ -879,6 +1056,20 @@ void buildPolyscopeGui() {
 
     ImGui::EndDisabled();
 
+    if (ImGui::Checkbox("cull structures", &options::enableCulling)) requestRedraw();
+    CullingStats cullingStats = getCullingStats();
+    ImGui::SameLine();
+    ImGui::Text("(%d of %d culled)",
+                static_cast<int>(cullingStats.culledByFrustum + cullingStats.culledBySlicePlanes),
+                static_cast<int>(cullingStats.structuresTested));
+
+    ImGui::TreePop();
+  }
+
+  // Memory usage tree
+  ImGui::SetNextItemOpen(false, ImGuiCond_FirstUseEver);
+  if (ImGui::TreeNode("Memory")) {
+    buildMemoryUsageGui();
     ImGui::TreePop();
   }
 
@@ -890,6 +1081,7 @@ void buildPolyscopeGui() {
     }
     ImGui::Checkbox("Show pick buffer", &options::debugDrawPickBuffer);
     ImGui::Checkbox("Always redraw", &options::alwaysRedraw);
+    ImGui::Checkbox("Profiler", &options::enableProfiler);
 
     static bool showDebugTextures = false;
     ImGui::Checkbox("Show debug textures", &showDebugTextures);
@@ -1016,6 +1208,30 @@ void buildPickGui() {
     internal::lastRightSideFreeY += internal::imguiStackMargin + ImGui::GetWindowHeight();
     ImGui::End();
   }
+
+  if (haveRegionSelection()) {
+
+    ImGui::SetNextWindowPos(ImVec2(view::windowWidth - (internal::rightWindowsWidth + internal::imguiStackMargin),
+                                   internal::lastRightSideFreeY + internal::imguiStackMargin));
+    ImGui::SetNextWindowSize(ImVec2(internal::rightWindowsWidth, 0.));
+
+    ImGui::Begin("Region Selection", nullptr);
+
+    for (const RegionPickResult& r : state::globalContext.regionSelection) {
+      std::string label = r.structureType + ": " + r.structureName;
+      if (r.quantityName != "") label += " / " + r.quantityName;
+      long long int nSelected = static_cast<long long int>(r.localIndices.size());
+      ImGui::Text("%s  (%lld selected)", label.c_str(), nSelected);
+    }
+    ImGui::Checkbox("include occluded", &options::regionSelectionIncludesOccluded);
+    if (ImGui::Button("Clear")) {
+      resetRegionSelection();
+    }
+
+    internal::rightWindowsWidth = ImGui::GetWindowWidth();
+    internal::lastRightSideFreeY += internal::imguiStackMargin + ImGui::GetWindowHeight();
+    ImGui::End();
+  }
 }
 
 void buildUserGuiAndInvokeCallback() {
@@ -1050,6 +1266,9 @@ void buildUserGuiAndInvokeCallback() {
 }
 
 void draw(bool withUI, bool withContextCallback) {
+  profiler::beginFrame();
+  profiler::ScopedTimer frameTimer("frame");
+
   processLazyProperties();
 
   // Update buffer and context
@@ -1069,6 +1288,7 @@ void draw(bool withUI, bool withContextCallback) {
 
   // Build the GUI components
   if (withUI) {
+    profiler::ScopedTimer timer("build UI");
     if (contextStack.back().drawDefaultUI) {
 
       // Note: It is important to build the user GUI first, because it is likely that callbacks there will modify
@@ -1082,6 +1302,7 @@ void draw(bool withUI, bool withContextCallback) {
           buildStructureGui();
           buildPickGui();
         }
+        profiler::buildProfilerGui();
 
         for (WeakHandle<Widget> wHandle : state::widgets) {
           if (wHandle.isValid()) {
@@ -1121,6 +1342,7 @@ void draw(bool withUI, bool withContextCallback) {
     }
 
     render::engine->bindDisplay();
+    profiler::ScopedTimer timer("render UI");
     render::engine->ImGuiRender();
   }
 }
@@ -1144,6 +1366,12 @@ void mainLoopIteration() {
   // Rendering
   draw();
   render::engine->swapDisplayBuffers();
+
+  // Write any screenshots whose readback has arrived
+  processPendingScreenshots();
+
+  // Free host-side buffer copies if we are over the memory budget
+  render::enforceHostBufferMemoryBudget();
 }
 
 void show(size_t forFrames) {
@@ -1232,6 +1460,9 @@ void shutdown(bool allowMidFrameShutdown) {
     writePrefsFile();
   }
 
+  flushScreenshots();
+  profiler::clearFrames();
+  resetPendingSelection();
   removeEverything();
 
   // Shut down the render engine
@@ -1352,6 +1583,7 @@ void removeStructure(std::string type, std::string name, bool errorIfAbsent) {
     g.second->removeChildStructure(*s);
   }
   resetSelectionIfStructure(s);
+  pick::releasePickBufferRanges(s);
   sMap.erase(s->name);
   updateStructureExtents();
   return;
@@ -1477,6 +1709,7 @@ void refresh() {
 }
 
 void processLazyProperties() {
+  profiler::ScopedTimer timer("process lazy properties");
 
   // Note: This function essentially represents lazy software design, and it's an ugly and error-prone part of the
   // system. The reason for it that some settings require action on a change (e..g re-drawing the scene), but we want to
@@ -1551,6 +1784,24 @@ void processLazyPropertiesOutsideOfImGui() {
   }
 }
 
+render::ManagedBufferMemoryUsage getMemoryUsage() {
+  render::ManagedBufferMemoryUsage usage;
+  for (auto& cat : state::structures) {
+    for (auto& x : cat.second) {
+      usage += x.second->getMemoryUsage();
+    }
+  }
+  return usage;
+}
+
+CullingStats getCullingStats() {
+  CullingStats stats;
+  stats.structuresTested = state::globalContext.cullingStructuresTested;
+  stats.culledByFrustum = state::globalContext.cullingCulledByFrustum;
+  stats.culledBySlicePlanes = state::globalContext.cullingCulledBySlicePlanes;
+  return stats;
+}
+
 void updateStructureExtents() {
 
   if (!options::automaticallyComputeSceneExtents) {
@@ -0,0 +1,335 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/profiler.h"
+
+#include "polyscope/options.h"
+#include "polyscope/polyscope.h"
+#include "polyscope/render/engine.h"
+
+#include "imgui.h"
+
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+
+namespace polyscope {
+namespace profiler {
+
+namespace {
+
+const size_t MAX_RETAINED_FRAMES = 240;
+
+struct TimerEvent {
+  std::string name;
+  int depth = 0;
+  bool finished = false;
+  uint64_t cpuStart = 0; // nanoseconds, on the host clock
+  uint64_t cpuEnd = 0;
+
+  // The queries are released to the pool once they are read back
+  std::shared_ptr<render::TimestampQuery> gpuStartQuery;
+  std::shared_ptr<render::TimestampQuery> gpuEndQuery;
+  bool hasGPUTime = false;
+  uint64_t gpuStart = 0; // nanoseconds, on the device clock
+  uint64_t gpuEnd = 0;
+};
+
+struct Frame {
+  size_t ind;
+  std::vector<TimerEvent> events;
+  bool gpuResolved = false; // true once all of the GPU times have been read back
+};
+
+std::deque<Frame> frames; // oldest first
+size_t nextFrameInd = 0;
+bool recording = false; // is the last frame being recorded?
+int timerDepth = 0;     // count of active timers
+
+// Queries which have been read back, and can be recorded again
+std::vector<std::shared_ptr<render::TimestampQuery>> queryPool;
+
+uint64_t hostNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::shared_ptr<render::TimestampQuery> recordTimestampQuery() {
+  if (render::engine == nullptr) return nullptr;
+
+  std::shared_ptr<render::TimestampQuery> query;
+  if (queryPool.empty()) {
+    query = render::engine->generateTimestampQuery();
+  } else {
+    query = queryPool.back();
+    queryPool.pop_back();
+  }
+  query->record();
+  return query;
+}
+
+// Read back the GPU times of any frames which are available. The device completes commands in order, so this stops at
+// the first frame which is not ready.
+void resolveFrames() {
+  for (Frame& frame : frames) {
+    if (frame.gpuResolved) continue;
+
+    for (TimerEvent& e : frame.events) {
+      if (e.gpuStartQuery && !e.gpuStartQuery->isReady()) return;
+      if (e.gpuEndQuery && !e.gpuEndQuery->isReady()) return;
+    }
+
+    for (TimerEvent& e : frame.events) {
+      if (e.gpuStartQuery && e.gpuEndQuery) {
+        e.gpuStart = e.gpuStartQuery->getNanoseconds();
+        e.gpuEnd = e.gpuEndQuery->getNanoseconds();
+        e.hasGPUTime = true;
+      }
+      if (e.gpuStartQuery) queryPool.push_back(e.gpuStartQuery);
+      if (e.gpuEndQuery) queryPool.push_back(e.gpuEndQuery);
+      e.gpuStartQuery.reset();
+      e.gpuEndQuery.reset();
+    }
+    frame.gpuResolved = true;
+  }
+}
+
+double nanosecondsToMs(uint64_t start, uint64_t end) { return 1e-6 * static_cast<double>(end - start); }
+
+} // namespace
+
+ScopedTimer::ScopedTimer(const char* name) {
+  if (!options::enableProfiler || !recording) return;
+  begin(name);
+}
+
+ScopedTimer::ScopedTimer(const char* label, const std::string& detail) {
+  if (!options::enableProfiler || !recording) return;
+  begin(std::string(label) + ": " + detail);
+}
+
+void ScopedTimer::begin(std::string name) {
+  Frame& frame = frames.back();
+  active = true;
+  frameInd = frame.ind;
+  eventInd = frame.events.size();
+
+  frame.events.emplace_back();
+  TimerEvent& e = frame.events.back();
+  e.name = std::move(name);
+  e.depth = timerDepth;
+  timerDepth++;
+
+  e.cpuStart = hostNanoseconds();
+  e.gpuStartQuery = recordTimestampQuery();
+}
+
+ScopedTimer::~ScopedTimer() {
+  if (!active) return;
+  timerDepth--;
+
+  // the frame may have been discarded while the timer was running
+  if (frames.empty() || frames.back().ind != frameInd) return;
+
+  TimerEvent& e = frames.back().events[eventInd];
+  e.gpuEndQuery = recordTimestampQuery();
+  e.cpuEnd = hostNanoseconds();
+  e.finished = true;
+}
+
+std::vector<TimerStats> getTimerStats() {
+  std::vector<TimerStats> stats;
+  std::map<std::string, size_t> statsInd;
+
+  std::vector<double> frameCPUMs, frameGPUMs;
+  std::vector<char> frameSeen;
+  for (const Frame& frame : frames) {
+    if (timerDepth > 0 && &frame == &frames.back()) continue; // the frame is still being drawn
+
+    // Total up each timer over the frame
+    std::fill(frameCPUMs.begin(), frameCPUMs.end(), 0.);
+    std::fill(frameGPUMs.begin(), frameGPUMs.end(), 0.);
+    std::fill(frameSeen.begin(), frameSeen.end(), false);
+    for (const TimerEvent& e : frame.events) {
+      if (!e.finished) continue;
+
+      size_t iStat;
+      auto it = statsInd.find(e.name);
+      if (it == statsInd.end()) {
+        iStat = stats.size();
+        statsInd[e.name] = iStat;
+        stats.emplace_back();
+        stats.back().name = e.name;
+        stats.back().depth = e.depth;
+        frameCPUMs.push_back(0.);
+        frameGPUMs.push_back(0.);
+        frameSeen.push_back(false);
+      } else {
+        iStat = it->second;
+      }
+
+      frameSeen[iStat] = true;
+      frameCPUMs[iStat] += nanosecondsToMs(e.cpuStart, e.cpuEnd);
+      if (e.hasGPUTime) frameGPUMs[iStat] += nanosecondsToMs(e.gpuStart, e.gpuEnd);
+    }
+
+    for (size_t iStat = 0; iStat < stats.size(); iStat++) {
+      if (!frameSeen[iStat]) continue;
+      TimerStats& s = stats[iStat];
+      s.frameCount++;
+      s.meanCPUMs += frameCPUMs[iStat];
+      s.maxCPUMs = std::max(s.maxCPUMs, frameCPUMs[iStat]);
+      if (frame.gpuResolved) {
+        s.gpuFrameCount++;
+        s.meanGPUMs += frameGPUMs[iStat];
+        s.maxGPUMs = std::max(s.maxGPUMs, frameGPUMs[iStat]);
+      }
+    }
+  }
+
+  for (TimerStats& s : stats) {
+    if (s.frameCount > 0) s.meanCPUMs /= s.frameCount;
+    if (s.gpuFrameCount > 0) s.meanGPUMs /= s.gpuFrameCount;
+  }
+
+  return stats;
+}
+
+size_t getRetainedFrameCount() { return frames.size(); }
+
+void clearFrames() {
+  // (queries which are still pending are simply deleted along with the frames)
+  frames.clear();
+  queryPool.clear();
+  recording = false; // resumes with the next frame
+}
+
+void writeChromeTrace(std::string filename) {
+  using json = nlohmann::json;
+
+  json events = json::array();
+  events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", 1}, {"args", {{"name", "CPU"}}}});
+  events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", 2}, {"args", {{"name", "GPU"}}}});
+
+  // Times are written in microseconds, relative to the start of the first event
+  uint64_t origin = 0;
+  for (const Frame& frame : frames) {
+    if (!frame.events.empty()) {
+      origin = frame.events.front().cpuStart;
+      break;
+    }
+  }
+  auto toMicroseconds = [](double nanoseconds) { return 1e-3 * nanoseconds; };
+
+  for (const Frame& frame : frames) {
+    double gpuOffset = 0.; // maps the device clock on to the host clock, for this frame
+    bool haveGPUOffset = false;
+
+    for (const TimerEvent& e : frame.events) {
+      if (!e.finished) continue;
+
+      events.push_back({{"name", e.name},
+                        {"cat", "cpu"},
+                        {"ph", "X"},
+                        {"ts", toMicroseconds(static_cast<double>(e.cpuStart - origin))},
+                        {"dur", toMicroseconds(static_cast<double>(e.cpuEnd - e.cpuStart))},
+                        {"pid", 1},
+                        {"tid", 1},
+                        {"args", {{"frame", frame.ind}}}});
+
+      if (!e.hasGPUTime) continue;
+      if (!haveGPUOffset) {
+        gpuOffset = static_cast<double>(e.cpuStart - origin) - static_cast<double>(e.gpuStart);
+        haveGPUOffset = true;
+      }
+      events.push_back({{"name", e.name},
+                        {"cat", "gpu"},
+                        {"ph", "X"},
+                        {"ts", toMicroseconds(static_cast<double>(e.gpuStart) + gpuOffset)},
+                        {"dur", toMicroseconds(static_cast<double>(e.gpuEnd - e.gpuStart))},
+                        {"pid", 1},
+                        {"tid", 2},
+                        {"args", {{"frame", frame.ind}}}});
+    }
+  }
+
+  json trace = {{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+
+  std::ofstream outFile(filename);
+  if (!outFile) {
+    exception("could not open file for writing: " + filename);
+    return;
+  }
+  outFile << trace.dump() << std::endl;
+}
+
+void beginFrame() {
+  if (timerDepth > 0) return; // nested in another frame
+
+  recording = options::enableProfiler;
+  if (!recording) return;
+
+  resolveFrames();
+
+  frames.emplace_back();
+  frames.back().ind = nextFrameInd;
+  nextFrameInd++;
+
+  // Drop the oldest frames. If their GPU times were never read back, the queries are deleted rather than reused.
+  while (frames.size() > MAX_RETAINED_FRAMES) {
+    frames.pop_front();
+  }
+}
+
+void buildProfilerGui() {
+  if (!options::enableProfiler) return;
+
+  ImGui::SetNextWindowSize(ImVec2(500 * options::uiScale, 400 * options::uiScale), ImGuiCond_FirstUseEver);
+  if (ImGui::Begin("Profiler", &options::enableProfiler)) {
+
+    std::vector<TimerStats> stats = getTimerStats();
+
+    ImGui::Text("%d frames", static_cast<int>(getRetainedFrameCount()));
+    ImGui::SameLine();
+    if (ImGui::Button("Clear")) {
+      clearFrames();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Write Chrome trace")) {
+      writeChromeTrace("polyscope_trace.json");
+    }
+
+    ImGui::Columns(3);
+    ImGui::SetColumnWidth(0, ImGui::GetWindowWidth() / 2);
+    ImGui::TextUnformatted("timer");
+    ImGui::NextColumn();
+    ImGui::TextUnformatted("CPU ms (mean / max)");
+    ImGui::NextColumn();
+    ImGui::TextUnformatted("GPU ms (mean / max)");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (const TimerStats& s : stats) {
+      ImGui::TextUnformatted((std::string(2 * s.depth, ' ') + s.name).c_str());
+      ImGui::NextColumn();
+      ImGui::Text("%.3f / %.3f", s.meanCPUMs, s.maxCPUMs);
+      ImGui::NextColumn();
+      if (s.gpuFrameCount > 0) {
+        ImGui::Text("%.3f / %.3f", s.meanGPUMs, s.maxGPUMs);
+      } else {
+        ImGui::TextUnformatted("-");
+      }
+      ImGui::NextColumn();
+    }
+
+    ImGui::Columns(1);
+  }
+  ImGui::End();
+}
+
+} // namespace profiler
+} // namespace polyscope
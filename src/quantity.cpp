@@ -83,4 +83,6 @@ std::string Quantity::niceName() { return name; }
 
 std::string Quantity::uniquePrefix() { return parent.uniquePrefix() + name + "#"; }
 
+float Quantity::getCullingPadding() { return 0.; }
+
 } // namespace polyscope
@@ -3,6 +3,10 @@
 
 #include "polyscope/render/engine.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include "polyscope/polyscope.h"
 #include "polyscope/render/colormap_defs.h"
 #include "polyscope/render/material_defs.h"
@@ -172,13 +176,184 @@ std::string deviceBufferTypeName(const DeviceBufferType& d) {
   return "";
 }
 
+std::string attributeStorageFormatName(const AttributeStorageFormat& f) {
+  switch (f) {
+  case AttributeStorageFormat::Float32:
+    return "Float32";
+  case AttributeStorageFormat::Float16:
+    return "Float16";
+  case AttributeStorageFormat::UNorm16:
+    return "UNorm16";
+  }
+  return "";
+}
+
 namespace render {
 
+namespace {
+
+// Convert to an IEEE half-precision float, rounding to nearest. Values too large to represent are clamped to the
+// largest finite half, rather than becoming infinite.
+uint16_t floatToHalf(float val) {
+  uint32_t bits;
+  std::memcpy(&bits, &val, sizeof(float));
+
+  uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+  uint32_t absBits = bits & 0x7FFFFFFFu;
+
+  if (absBits >= 0x7F800000u) { // inf or nan
+    return sign | (absBits > 0x7F800000u ? 0x7E00u : 0x7BFFu);
+  }
+  if (absBits >= 0x477FF000u) { // rounds to >= 65520, out of range
+    return sign | 0x7BFFu;
+  }
+  if (absBits < 0x38800000u) { // subnormal half (or zero)
+    float absVal;
+    std::memcpy(&absVal, &absBits, sizeof(float));
+    return sign | static_cast<uint16_t>(std::lround(absVal * 16777216.f)); // in units of 2^-24
+  }
+
+  // normal half: rebias the exponent and round the mantissa to nearest-even
+  uint32_t rebiased = absBits - 0x38000000u;
+  uint32_t rounded = rebiased + 0x0FFFu + ((rebiased >> 13) & 1u);
+  return sign | static_cast<uint16_t>(rounded >> 13);
+}
+
+float halfToFloat(uint16_t val) {
+  uint32_t sign = static_cast<uint32_t>(val & 0x8000u) << 16;
+  uint32_t exponent = (val >> 10) & 0x1Fu;
+  uint32_t mantissa = val & 0x3FFu;
+
+  float result;
+  if (exponent == 0) { // zero or subnormal
+    result = std::ldexp(static_cast<float>(mantissa), -24);
+    if (sign) result = -result;
+    return result;
+  }
+
+  uint32_t bits;
+  if (exponent == 0x1F) { // inf or nan
+    bits = sign | 0x7F800000u | (mantissa << 13);
+  } else {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  std::memcpy(&result, &bits, sizeof(float));
+  return result;
+}
+
+} // namespace
+
 AttributeBuffer::AttributeBuffer(RenderDataType dataType_, int arrayCount_)
     : dataType(dataType_), arrayCount(arrayCount_), uniqueID(render::engine->getNextUniqueID()) {}
 
 AttributeBuffer::~AttributeBuffer() {}
 
+void AttributeBuffer::setStorageFormat(AttributeStorageFormat newFormat) {
+  if (newFormat == storageFormat) return;
+
+  if (isSet()) {
+    exception("attribute buffer storage format must be set before setting data");
+  }
+
+  if (newFormat != AttributeStorageFormat::Float32) {
+    bool isFloatType = dataType == RenderDataType::Float || dataType == RenderDataType::Vector2Float ||
+                       dataType == RenderDataType::Vector3Float || dataType == RenderDataType::Vector4Float;
+    if (!isFloatType || arrayCount != 1) {
+      exception("attribute buffer of type " + renderDataTypeName(dataType) + " does not support storage format " +
+                attributeStorageFormatName(newFormat));
+    }
+  }
+
+  storageFormat = newFormat;
+}
+
+void AttributeBuffer::setQuantizationBounds(glm::vec4 lower, glm::vec4 upper) {
+  quantizationLower = lower;
+  quantizationUpper = upper;
+}
+
+int64_t AttributeBuffer::getStoredEntrySizeInBytes() const {
+  if (storageFormat == AttributeStorageFormat::Float32) {
+    return sizeInBytes(dataType) * getArrayCount();
+  }
+  // one 16-bit value for each float component
+  return (sizeInBytes(dataType) / 4) * 2;
+}
+
+std::vector<uint16_t> AttributeBuffer::encodeCompactStorage(const float* values, size_t count) const {
+  std::vector<uint16_t> stored(count);
+  size_t nComponents = sizeInBytes(dataType) / 4;
+
+  switch (storageFormat) {
+  case AttributeStorageFormat::Float32:
+    exception("attribute buffer does not use compact storage");
+    break;
+  case AttributeStorageFormat::Float16:
+    for (size_t i = 0; i < count; i++) {
+      stored[i] = floatToHalf(values[i]);
+    }
+    break;
+  case AttributeStorageFormat::UNorm16:
+    for (size_t i = 0; i < count; i++) {
+      size_t iComp = i % nComponents;
+      float extent = quantizationUpper[iComp] - quantizationLower[iComp];
+      float t = extent > 0. ? (values[i] - quantizationLower[iComp]) / extent : 0.f;
+      t = std::min(std::max(t, 0.f), 1.f);
+      if (!(t == t)) t = 0.f; // nan
+      stored[i] = static_cast<uint16_t>(std::lround(t * 65535.f));
+    }
+    break;
+  }
+
+  return stored;
+}
+
+void AttributeBuffer::decodeCompactStorage(const uint16_t* stored, size_t count, float* values) const {
+  size_t nComponents = sizeInBytes(dataType) / 4;
+
+  switch (storageFormat) {
+  case AttributeStorageFormat::Float32:
+    exception("attribute buffer does not use compact storage");
+    break;
+  case AttributeStorageFormat::Float16:
+    for (size_t i = 0; i < count; i++) {
+      values[i] = halfToFloat(stored[i]);
+    }
+    break;
+  case AttributeStorageFormat::UNorm16:
+    for (size_t i = 0; i < count; i++) {
+      size_t iComp = i % nComponents;
+      float extent = quantizationUpper[iComp] - quantizationLower[iComp];
+      values[i] = quantizationLower[iComp] + (stored[i] / 65535.f) * extent;
+    }
+    break;
+  }
+}
+
+std::vector<unsigned char> AttributeBuffer::decodeReadback(const std::vector<unsigned char>& stored) const {
+  if (storageFormat == AttributeStorageFormat::Float32) {
+    return stored;
+  }
+
+  size_t nValues = stored.size() / sizeof(uint16_t);
+  std::vector<uint16_t> storedValues(nValues);
+  if (nValues > 0) std::memcpy(&storedValues.front(), &stored.front(), nValues * sizeof(uint16_t));
+
+  std::vector<unsigned char> decoded(nValues * sizeof(float));
+  if (nValues > 0) decodeCompactStorage(storedValues.data(), nValues, reinterpret_cast<float*>(&decoded.front()));
+  return decoded;
+}
+
+ReadbackRequest::ReadbackRequest(size_t sizeInBytes_) : sizeInBytes(sizeInBytes_) {}
+
+const std::vector<unsigned char>& ReadbackRequest::getBytes() {
+  if (!completed) {
+    complete();
+    completed = true;
+  }
+  return bytes;
+}
+
 TextureBuffer::TextureBuffer(int dim_, TextureFormat format_, unsigned int sizeX_, unsigned int sizeY_,
                              unsigned int sizeZ_)
     : dim(dim_), format(format_), sizeX(sizeX_), sizeY(sizeY_), sizeZ(sizeZ_),
@@ -277,7 +452,7 @@ ShaderProgram::ShaderProgram(DrawMode dm) : drawMode(dm), uniqueID(render::engin
 
   drawMode = dm;
   if (dm == DrawMode::IndexedLines || dm == DrawMode::IndexedLineStrip || dm == DrawMode::IndexedLineStripAdjacency ||
-      dm == DrawMode::IndexedTriangles) {
+      dm == DrawMode::IndexedTriangles || dm == DrawMode::IndexedPointsTransformFeedback) {
     useIndex = true;
   }
 
@@ -3,6 +3,7 @@
 #include "polyscope/render/ground_plane.h"
 
 #include "polyscope/polyscope.h"
+#include "polyscope/profiler.h"
 #include "polyscope/render/engine.h"
 #include "polyscope/render/material_defs.h"
 
@@ -188,6 +189,7 @@ void GroundPlane::draw(bool isRedraw) {
   if (options::groundPlaneMode == GroundPlaneMode::None) {
     return;
   }
+  profiler::ScopedTimer timer("ground plane");
 
   // don't draw ground in planar mode
   if (view::style == view::NavigateStyle::Planar) return;
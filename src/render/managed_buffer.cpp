@@ -1,6 +1,11 @@
 // Copyright 2018-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
 
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <list>
+#include <type_traits>
 #include <vector>
 
 #include "polyscope/render/managed_buffer.h"
@@ -8,6 +13,7 @@
 #include "polyscope/check_invalid_values.h"
 #include "polyscope/internal.h"
 #include "polyscope/messages.h"
+#include "polyscope/options.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/render/engine.h"
 #include "polyscope/render/templated_buffers.h"
@@ -15,6 +21,130 @@
 namespace polyscope {
 namespace render {
 
+namespace {
+
+// When uploading partial updates, dirty ranges which are separated by fewer than this many entries get merged in to a
+// single upload. Re-uploading a few unchanged entries is much cheaper than issuing many tiny copies.
+const size_t dirtyRangeMergeGap = 64;
+
+// If more than this fraction of a buffer is dirty, just re-upload the whole thing.
+const double dirtyRangeFullUpdateFraction = 0.5;
+
+// Sort a list of [start, end) ranges and merge any which overlap or are separated by at most `mergeGap` entries.
+void mergeDirtyRanges(std::vector<std::array<size_t, 2>>& ranges, size_t mergeGap) {
+  if (ranges.empty()) return;
+
+  std::sort(ranges.begin(), ranges.end());
+
+  size_t iOut = 0;
+  for (size_t i = 1; i < ranges.size(); i++) {
+    if (ranges[i][0] <= ranges[iOut][1] + mergeGap) {
+      ranges[iOut][1] = std::max(ranges[iOut][1], ranges[i][1]);
+    } else {
+      iOut++;
+      ranges[iOut] = ranges[i];
+    }
+  }
+  ranges.resize(iOut + 1);
+}
+
+size_t totalRangeSize(const std::vector<std::array<size_t, 2>>& ranges) {
+  size_t total = 0;
+  for (const std::array<size_t, 2>& r : ranges) {
+    total += r[1] - r[0];
+  }
+  return total;
+}
+
+// Access to the float components of buffer types which support compact device storage (nComponents == 0 for types
+// which do not)
+template <typename T>
+struct CompactStorageTraits {
+  static const size_t nComponents = 0;
+  static float component(const T&, size_t) { return 0.f; }
+};
+template <>
+struct CompactStorageTraits<float> {
+  static const size_t nComponents = 1;
+  static float component(const float& v, size_t) { return v; }
+};
+template <>
+struct CompactStorageTraits<double> {
+  static const size_t nComponents = 1;
+  static float component(const double& v, size_t) { return static_cast<float>(v); }
+};
+template <>
+struct CompactStorageTraits<glm::vec2> {
+  static const size_t nComponents = 2;
+  static float component(const glm::vec2& v, size_t i) { return v[i]; }
+};
+template <>
+struct CompactStorageTraits<glm::vec3> {
+  static const size_t nComponents = 3;
+  static float component(const glm::vec3& v, size_t i) { return v[i]; }
+};
+template <>
+struct CompactStorageTraits<glm::vec4> {
+  static const size_t nComponents = 4;
+  static float component(const glm::vec4& v, size_t i) { return v[i]; }
+};
+
+// Whether the device holds buffers of this type exactly as they are on the host. Doubles are narrowed to floats on
+// upload, so a device copy of them cannot stand in for the host data.
+template <typename T>
+struct DeviceStorageIsExact : std::true_type {};
+template <>
+struct DeviceStorageIsExact<double> : std::false_type {};
+
+// All live managed buffers, least-recently-used first.
+// NOTE: this is intentionally allocated once and never freed, so that buffers which are destroyed during static
+// destruction can still safely remove themselves.
+std::list<ManagedBufferBase*>& allManagedBuffersLRU() {
+  static std::list<ManagedBufferBase*>* buffers = new std::list<ManagedBufferBase*>();
+  return *buffers;
+}
+
+} // namespace
+
+ManagedBufferMemoryUsage& ManagedBufferMemoryUsage::operator+=(const ManagedBufferMemoryUsage& other) {
+  hostBytes += other.hostBytes;
+  deviceBytes += other.deviceBytes;
+  indexedViewBytes += other.indexedViewBytes;
+  return *this;
+}
+
+ManagedBufferBase::ManagedBufferBase() {
+  std::list<ManagedBufferBase*>& lru = allManagedBuffersLRU();
+  lruEntry = lru.insert(lru.end(), this);
+}
+
+ManagedBufferBase::~ManagedBufferBase() { allManagedBuffersLRU().erase(lruEntry); }
+
+void ManagedBufferBase::markHostBufferUsed() {
+  std::list<ManagedBufferBase*>& lru = allManagedBuffersLRU();
+  lru.splice(lru.end(), lru, lruEntry);
+}
+
+void enforceHostBufferMemoryBudget() {
+  if (options::hostBufferMemoryBudget == 0) return;
+
+  std::list<ManagedBufferBase*>& lru = allManagedBuffersLRU();
+
+  size_t totalBytes = 0;
+  for (ManagedBufferBase* buff : lru) {
+    totalBytes += buff->hostBufferBytes();
+  }
+
+  // Walk from least- to most-recently used, evicting as we go. Buffers which cannot currently be evicted are skipped.
+  for (ManagedBufferBase* buff : lru) {
+    if (totalBytes <= options::hostBufferMemoryBudget) break;
+    size_t buffBytes = buff->hostBufferBytes();
+    if (buffBytes > 0 && buff->evictHostBuffer()) {
+      totalBytes -= buffBytes;
+    }
+  }
+}
+
 template <typename T>
 ManagedBuffer<T>::ManagedBuffer(ManagedBufferRegistry* registry_, const std::string& name_, std::vector<T>& data_)
     : name(name_), uniqueID(internal::getNextUniqueID()), registry(registry_), data(data_), dataGetsComputed(false),
@@ -81,6 +211,8 @@ std::array<uint32_t, 3> ManagedBuffer<T>::getTextureSize() const {
 template <typename T>
 void ManagedBuffer<T>::ensureHostBufferPopulated() {
 
+  markHostBufferUsed();
+
   switch (currentCanonicalDataSource()) {
   case CanonicalDataSource::HostData:
     // good to go, nothing needs to be done
@@ -98,6 +230,14 @@ void ManagedBuffer<T>::ensureHostBufferPopulated() {
     if (deviceBufferTypeIsTexture()) {
       if (!renderTextureBuffer) exception("render buffer should be allocated but isn't");
 
+      if (hostBufferEvicted && dataGetsComputed) {
+        // we only ever evict textures which can be recomputed, do that rather than copying back
+        computeFunc();
+        hostBufferIsPopulated = true;
+        hostBufferEvicted = false;
+        break;
+      }
+
       // copy the data back from the renderBuffer
       // TODO not implemented yet
       exception("copy-back from texture not implemented yet");
@@ -105,8 +245,19 @@ void ManagedBuffer<T>::ensureHostBufferPopulated() {
       // sanity check
       if (!renderAttributeBuffer) exception("render buffer should be allocated but isn't");
 
-      // copy the data back from the renderBuffer
-      data = getAttributeBufferDataRange<T>(*renderAttributeBuffer, 0, renderAttributeBuffer->getDataSize());
+      // copy the data back from the renderBuffer, using the prefetched copy if there is one
+      if (pendingReadback) {
+        data = attributeBufferDataFromBytes<T>(renderAttributeBuffer->decodeReadback(pendingReadback->getBytes()));
+        pendingReadback.reset();
+      } else {
+        data = getAttributeBufferDataRange<T>(*renderAttributeBuffer, 0, renderAttributeBuffer->getDataSize());
+      }
+
+      // if the host data was only evicted (rather than updated on the device), the copy is valid again
+      if (hostBufferEvicted) {
+        hostBufferIsPopulated = true;
+        hostBufferEvicted = false;
+      }
     }
 
     break;
@@ -127,9 +278,19 @@ std::vector<T>& ManagedBuffer<T>::getPopulatedHostBufferRef() {
 template <typename T>
 void ManagedBuffer<T>::markHostBufferUpdated() {
   hostBufferIsPopulated = true;
+  hostBufferEvicted = false;
+  pendingReadback.reset();
+  updateCount++;
+  markHostBufferUsed();
+
+  // Quantized storage is relative to the bounds of the data, which might have changed
+  if (deviceStorageFormat == AttributeStorageFormat::UNorm16) {
+    updateQuantizationBounds();
+  }
 
   // If the data is stored in the device-side buffers, update it as needed
   if (renderAttributeBuffer) {
+    configureDeviceStorage(*renderAttributeBuffer);
     renderAttributeBuffer->setData(data);
     requestRedraw();
   }
@@ -145,6 +306,65 @@ void ManagedBuffer<T>::markHostBufferUpdated() {
   }
 }
 
+template <typename T>
+void ManagedBuffer<T>::markHostBufferUpdated(size_t rangeStart, size_t rangeCount) {
+  std::vector<std::array<size_t, 2>> dirtyRanges;
+  dirtyRanges.push_back({rangeStart, rangeStart + rangeCount});
+  markHostBufferRangesUpdated(std::move(dirtyRanges));
+}
+
+template <typename T>
+void ManagedBuffer<T>::markHostBufferUpdated(const std::vector<size_t>& updatedInds) {
+  std::vector<std::array<size_t, 2>> dirtyRanges;
+  dirtyRanges.reserve(updatedInds.size());
+  for (size_t ind : updatedInds) {
+    dirtyRanges.push_back({ind, ind + 1});
+  }
+  markHostBufferRangesUpdated(std::move(dirtyRanges));
+}
+
+template <typename T>
+void ManagedBuffer<T>::markHostBufferRangesUpdated(std::vector<std::array<size_t, 2>> dirtyRanges) {
+
+  // Textures do not support partial updates, and quantized data may need new bounds. Fall back on updating everything.
+  if (deviceBufferType != DeviceBufferType::Attribute || deviceStorageFormat == AttributeStorageFormat::UNorm16) {
+    markHostBufferUpdated();
+    return;
+  }
+
+  pendingReadback.reset();
+
+  for (const std::array<size_t, 2>& r : dirtyRanges) {
+    if (r[0] > r[1] || r[1] > data.size()) {
+      exception("ManagedBuffer " + name + " marked range [" + std::to_string(r[0]) + "," + std::to_string(r[1]) +
+                ") as updated, which is out of bounds for data of size " + std::to_string(data.size()));
+    }
+  }
+
+  hostBufferIsPopulated = true;
+  hostBufferEvicted = false;
+  updateCount++;
+  markHostBufferUsed();
+
+  mergeDirtyRanges(dirtyRanges, dirtyRangeMergeGap);
+  if (dirtyRanges.empty()) return;
+
+  // If the data is stored in the device-side buffers, update it as needed
+  if (renderAttributeBuffer) {
+    bool sizeMatches = static_cast<size_t>(renderAttributeBuffer->getDataSize()) == data.size();
+    if (sizeMatches && totalRangeSize(dirtyRanges) < dirtyRangeFullUpdateFraction * data.size()) {
+      for (const std::array<size_t, 2>& r : dirtyRanges) {
+        renderAttributeBuffer->setDataRange(data, r[0], r[0], r[1] - r[0]);
+      }
+    } else {
+      renderAttributeBuffer->setData(data);
+    }
+  }
+
+  updateIndexedViews(dirtyRanges);
+  requestRedraw();
+}
+
 template <typename T>
 T ManagedBuffer<T>::getValue(size_t ind) {
 
@@ -176,6 +396,12 @@ T ManagedBuffer<T>::getValue(size_t ind) {
     if (static_cast<int64_t>(ind) >= renderAttributeBuffer->getDataSize())
       exception("out of bounds access in ManagedBuffer " + name + " getValue(" + std::to_string(ind) + ")");
 
+    // if a prefetched copy has arrived, read from that rather than issuing a new blocking read
+    if (pendingReadback && pendingReadback->isReady()) {
+      ensureHostBufferPopulated();
+      return data[ind];
+    }
+
     T val = getAttributeBufferData<T>(*renderAttributeBuffer, ind);
     return val;
     break;
@@ -184,6 +410,23 @@ T ManagedBuffer<T>::getValue(size_t ind) {
   return T(); // dummy return
 }
 
+template <typename T>
+void ManagedBuffer<T>::prefetchHostBuffer() {
+  if (currentCanonicalDataSource() != CanonicalDataSource::RenderBuffer) return;
+  if (deviceBufferTypeIsTexture()) return; // texture readback is not supported, see ensureHostBufferPopulated()
+  if (pendingReadback) return;
+  if (!renderAttributeBuffer) exception("render buffer should be allocated but isn't");
+
+  pendingReadback = renderAttributeBuffer->getDataRangeAsync(
+      0, renderAttributeBuffer->getDataSize() * renderAttributeBuffer->getArrayCount());
+}
+
+template <typename T>
+bool ManagedBuffer<T>::hostBufferPrefetchIsReady() {
+  if (currentCanonicalDataSource() != CanonicalDataSource::RenderBuffer) return true;
+  return pendingReadback && pendingReadback->isReady();
+}
+
 template <typename T>
 T ManagedBuffer<T>::getValue(size_t indX, size_t indY) {
   checkDeviceBufferTypeIs(DeviceBufferType::Texture2d);
@@ -283,6 +526,123 @@ std::string ManagedBuffer<T>::summaryString() {
 }
 
 
+template <typename T>
+void ManagedBuffer<T>::setDeviceStorageFormat(AttributeStorageFormat newFormat) {
+  checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
+  if (newFormat == deviceStorageFormat) return;
+
+  if (newFormat != AttributeStorageFormat::Float32 && CompactStorageTraits<T>::nComponents == 0) {
+    exception("ManagedBuffer " + name + " does not support storage format " + attributeStorageFormatName(newFormat));
+  }
+
+  // Existing device buffers are stored in the old format, so discard them. Make sure the host copy is valid first.
+  if (renderAttributeBuffer) {
+    ensureHostBufferPopulated();
+    hostBufferIsPopulated = true;
+    hostBufferEvicted = false;
+  }
+  renderAttributeBuffer.reset();
+  existingIndexedViews.clear();
+
+  deviceStorageFormat = newFormat;
+  quantizationBoundsValid = false;
+  requestRedraw();
+}
+
+template <typename T>
+void ManagedBuffer<T>::updateQuantizationBounds() {
+  const size_t nComp = CompactStorageTraits<T>::nComponents;
+  const float inf = std::numeric_limits<float>::infinity();
+
+  // compute the bounds of each chunk in parallel, then combine
+  std::vector<glm::vec4> chunkLower(parallelChunkCount(data.size()), glm::vec4{inf, inf, inf, inf});
+  std::vector<glm::vec4> chunkUpper(chunkLower.size(), glm::vec4{-inf, -inf, -inf, -inf});
+  parallelForChunks(data.size(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      for (size_t iC = 0; iC < nComp; iC++) {
+        float val = CompactStorageTraits<T>::component(data[i], iC);
+        if (!std::isfinite(val)) continue;
+        chunkLower[iChunk][iC] = std::min(chunkLower[iChunk][iC], val);
+        chunkUpper[iChunk][iC] = std::max(chunkUpper[iChunk][iC], val);
+      }
+    }
+  });
+
+  quantizationLower = glm::vec4{0., 0., 0., 0.};
+  quantizationUpper = glm::vec4{1., 1., 1., 1.};
+  for (size_t iC = 0; iC < nComp; iC++) {
+    float lower = inf;
+    float upper = -inf;
+    for (size_t iChunk = 0; iChunk < chunkLower.size(); iChunk++) {
+      lower = std::min(lower, chunkLower[iChunk][iC]);
+      upper = std::max(upper, chunkUpper[iChunk][iC]);
+    }
+    if (lower <= upper) { // false if there were no finite values
+      quantizationLower[iC] = lower;
+      quantizationUpper[iC] = upper;
+    }
+  }
+
+  quantizationBoundsValid = true;
+}
+
+template <typename T>
+void ManagedBuffer<T>::configureDeviceStorage(render::AttributeBuffer& deviceBuffer) {
+  if (deviceStorageFormat == AttributeStorageFormat::UNorm16 && !quantizationBoundsValid) {
+    updateQuantizationBounds();
+  }
+  deviceBuffer.setStorageFormat(deviceStorageFormat);
+  deviceBuffer.setQuantizationBounds(quantizationLower, quantizationUpper);
+}
+
+template <typename T>
+size_t ManagedBuffer<T>::hostBufferBytes() {
+  return data.capacity() * sizeof(T);
+}
+
+template <typename T>
+ManagedBufferMemoryUsage ManagedBuffer<T>::getMemoryUsage() {
+  ManagedBufferMemoryUsage usage;
+
+  usage.hostBytes = hostBufferBytes();
+
+  if (renderAttributeBuffer) {
+    usage.deviceBytes += static_cast<size_t>(renderAttributeBuffer->getDataSizeInBytes());
+  }
+  if (renderTextureBuffer) {
+    usage.deviceBytes += static_cast<size_t>(renderTextureBuffer->getSizeInBytes());
+  }
+
+  for (IndexedView& view : existingIndexedViews) {
+    std::shared_ptr<render::AttributeBuffer> viewBufferPtr = view.viewBuffer.lock();
+    if (viewBufferPtr) {
+      usage.indexedViewBytes += static_cast<size_t>(viewBufferPtr->getDataSizeInBytes());
+    }
+  }
+
+  return usage;
+}
+
+template <typename T>
+bool ManagedBuffer<T>::evictHostBuffer() {
+
+  // only evict if the host data is valid and the device holds an identical copy we can restore from
+  if (!hostBufferIsPopulated) return false;
+  if (!DeviceStorageIsExact<T>::value) return false;                        // the device copy has a narrower type
+  if (deviceStorageFormat != AttributeStorageFormat::Float32) return false; // the device copy has reduced precision
+  if (deviceBufferTypeIsTexture()) {
+    // copy-back from textures is not supported, so we can only evict textures which can be recomputed
+    if (!renderTextureBuffer || !dataGetsComputed) return false;
+  } else {
+    if (!renderAttributeBuffer || static_cast<size_t>(renderAttributeBuffer->getDataSize()) != data.size()) return false;
+  }
+
+  hostBufferIsPopulated = false;
+  hostBufferEvicted = true;
+  std::vector<T>().swap(data); // actually release the memory, unlike clear()
+  return true;
+}
+
 template <typename T>
 void ManagedBuffer<T>::recomputeIfPopulated() {
   if (!dataGetsComputed) { // sanity check
@@ -306,6 +666,7 @@ std::shared_ptr<render::AttributeBuffer> ManagedBuffer<T>::getRenderAttributeBuf
   if (!renderAttributeBuffer) {
     ensureHostBufferPopulated(); // warning: the order of these matters because of how hostBufferPopulated works
     renderAttributeBuffer = generateAttributeBuffer<T>(render::engine);
+    configureDeviceStorage(*renderAttributeBuffer);
     renderAttributeBuffer->setData(data);
   }
   return renderAttributeBuffer;
@@ -346,6 +707,7 @@ void ManagedBuffer<T>::markRenderAttributeBufferUpdated() {
   checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
 
   invalidateHostBuffer();
+  updateCount++;
   updateIndexedViews();
   requestRedraw();
 }
@@ -355,6 +717,7 @@ void ManagedBuffer<T>::markRenderTextureBufferUpdated() {
   checkDeviceBufferTypeIsTexture();
 
   invalidateHostBuffer();
+  updateCount++;
   requestRedraw();
 }
 
@@ -366,15 +729,14 @@ ManagedBuffer<T>::getIndexedRenderAttributeBuffer(ManagedBuffer<uint32_t>& indic
   removeDeletedIndexedViews(); // periodic filtering
 
   // Check if we have already created this indexed view, and if so just return it
-  for (std::tuple<render::ManagedBuffer<uint32_t>*, std::weak_ptr<render::AttributeBuffer>>& existingViewTup :
-       existingIndexedViews) {
+  for (IndexedView& existingView : existingIndexedViews) {
 
     // both the cache-key source index ptr and the view buffer ptr must still be alive (and the index must match)
     // note that we can't verify that the index buffer is still alive, you will just get memory errors here if it
     // has been deleted
-    std::shared_ptr<render::AttributeBuffer> viewBufferPtr = std::get<1>(existingViewTup).lock();
+    std::shared_ptr<render::AttributeBuffer> viewBufferPtr = existingView.viewBuffer.lock();
     if (viewBufferPtr) {
-      render::ManagedBuffer<uint32_t>& indexBufferCand = *(std::get<0>(existingViewTup));
+      render::ManagedBuffer<uint32_t>& indexBufferCand = *existingView.indices;
       if (indexBufferCand.uniqueID == indices.uniqueID) {
         return viewBufferPtr;
       }
@@ -384,10 +746,14 @@ ManagedBuffer<T>::getIndexedRenderAttributeBuffer(ManagedBuffer<uint32_t>& indic
   // We don't have it. Create a new one and return that.
   ensureHostBufferPopulated();
   std::shared_ptr<render::AttributeBuffer> newBuffer = generateAttributeBuffer<T>(render::engine);
+  configureDeviceStorage(*newBuffer);
   indices.ensureHostBufferPopulated();
   std::vector<T> expandData = gather(data, indices.data);
   newBuffer->setData(expandData); // initially populate
-  existingIndexedViews.emplace_back(&indices, newBuffer);
+  IndexedView newView;
+  newView.indices = &indices;
+  newView.viewBuffer = newBuffer;
+  existingIndexedViews.push_back(std::move(newView));
 
   return newBuffer;
 }
@@ -406,46 +772,148 @@ void ManagedBuffer<T>::updateIndexedViews() {
 
   removeDeletedIndexedViews(); // periodic filtering
 
-  for (std::tuple<render::ManagedBuffer<uint32_t>*, std::weak_ptr<render::AttributeBuffer>>& existingViewTup :
-       existingIndexedViews) {
+  // If the data currently lives only on the device, expand it there rather than reading it back
+  bool copyOnDevice = !existingIndexedViews.empty() && canUseBufferIndexCopyProgram();
 
-    std::shared_ptr<render::AttributeBuffer> viewBufferPtr = std::get<1>(existingViewTup).lock();
+  for (IndexedView& existingView : existingIndexedViews) {
+
+    std::shared_ptr<render::AttributeBuffer> viewBufferPtr = existingView.viewBuffer.lock();
     if (!viewBufferPtr) continue; // skip if it has been deleted (will be removed eventually)
 
     // note: index buffer must still be alive here. we can't check it, you will just get memory errors
     // if it has been deleted
-    render::ManagedBuffer<uint32_t>& indices = *std::get<0>(existingViewTup);
+    render::ManagedBuffer<uint32_t>& indices = *existingView.indices;
     render::AttributeBuffer& viewBuffer = *viewBufferPtr;
 
+    if (copyOnDevice && static_cast<size_t>(viewBuffer.getDataSize()) == indices.size()) {
+      invokeBufferIndexCopyProgram(indices, viewBufferPtr);
+      continue;
+    }
+
     // apply the indexing and set the data
+    ensureHostBufferPopulated();
     indices.ensureHostBufferPopulated();
     std::vector<T> expandData = gather(data, indices.data);
+    configureDeviceStorage(viewBuffer);
     viewBuffer.setData(expandData);
+  }
+
+  requestRedraw();
+}
+
+template <typename T>
+void ManagedBuffer<T>::updateIndexedViews(const std::vector<std::array<size_t, 2>>& dirtyRanges) {
+  checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
+
+  removeDeletedIndexedViews(); // periodic filtering
+
+  for (IndexedView& existingView : existingIndexedViews) {
 
-    // TODO fornow, only CPU-side updating is supported. Add direct GPU-side support using the bufferIndexCopyProgram
-    // below.
+    std::shared_ptr<render::AttributeBuffer> viewBufferPtr = existingView.viewBuffer.lock();
+    if (!viewBufferPtr) continue; // skip if it has been deleted (will be removed eventually)
+
+    // note: index buffer must still be alive here. we can't check it, you will just get memory errors
+    // if it has been deleted
+    render::ManagedBuffer<uint32_t>& indices = *existingView.indices;
+    render::AttributeBuffer& viewBuffer = *viewBufferPtr;
+    indices.ensureHostBufferPopulated();
+    const std::vector<uint32_t>& inds = indices.data;
+
+    // Fall back on a full update in cases where the view is not a simple index expansion of matching size
+    if (inds.empty() || static_cast<size_t>(viewBuffer.getDataSize()) != inds.size() ||
+        inds.size() > std::numeric_limits<uint32_t>::max()) {
+      std::vector<T> expandData = gather(data, inds);
+      viewBuffer.setData(expandData);
+      continue;
+    }
+
+    ensureIndexedViewInverse(existingView);
+
+    // Collect the view entries which read from any dirty entry of the data
+    std::vector<uint32_t> dirtyViewInds;
+    for (const std::array<size_t, 2>& r : dirtyRanges) {
+      dirtyViewInds.insert(dirtyViewInds.end(), existingView.inverseInds.begin() + existingView.inverseStart[r[0]],
+                           existingView.inverseInds.begin() + existingView.inverseStart[r[1]]);
+    }
+
+    if (dirtyViewInds.size() >= dirtyRangeFullUpdateFraction * inds.size()) {
+      std::vector<T> expandData = gather(data, inds);
+      viewBuffer.setData(expandData);
+      continue;
+    }
+
+    // Coalesce in to ranges of the view, and re-expand just those ranges.
+    // (it is fine if a merged range covers some view entries that did not change, they just get rewritten with the
+    // same value)
+    std::vector<std::array<size_t, 2>> viewRanges;
+    viewRanges.reserve(dirtyViewInds.size());
+    for (uint32_t i : dirtyViewInds) {
+      viewRanges.push_back({i, static_cast<size_t>(i) + 1});
+    }
+    mergeDirtyRanges(viewRanges, dirtyRangeMergeGap);
+
+    std::vector<T> expandData;
+    for (const std::array<size_t, 2>& r : viewRanges) {
+      expandData.resize(r[1] - r[0]);
+      for (size_t i = r[0]; i < r[1]; i++) {
+        expandData[i - r[0]] = data[inds[i]];
+      }
+      viewBuffer.setDataRange(expandData, 0, r[0], expandData.size());
+    }
   }
 
   requestRedraw();
 }
 
+template <typename T>
+void ManagedBuffer<T>::ensureIndexedViewInverse(IndexedView& view) {
+
+  render::ManagedBuffer<uint32_t>& indices = *view.indices;
+  const std::vector<uint32_t>& inds = indices.data;
+
+  // Check if the existing inverse is still valid
+  if (view.inverseIndicesUpdateCount == indices.getUpdateCount() && view.inverseStart.size() == data.size() + 1 &&
+      view.inverseInds.size() == inds.size()) {
+    return;
+  }
+
+  // Build the inverse map via a counting sort
+  view.inverseStart.assign(data.size() + 1, 0);
+  for (uint32_t ind : inds) {
+    if (ind >= data.size()) {
+      exception("ManagedBuffer " + name + " has indexed view with out of bounds index " + std::to_string(ind));
+    }
+    view.inverseStart[ind + 1]++;
+  }
+  for (size_t i = 0; i < data.size(); i++) {
+    view.inverseStart[i + 1] += view.inverseStart[i];
+  }
+
+  std::vector<size_t> fillPos(view.inverseStart.begin(), view.inverseStart.end() - 1);
+  view.inverseInds.resize(inds.size());
+  for (size_t i = 0; i < inds.size(); i++) {
+    view.inverseInds[fillPos[inds[i]]++] = static_cast<uint32_t>(i);
+  }
+
+  view.inverseIndicesUpdateCount = indices.getUpdateCount();
+}
+
 template <typename T>
 void ManagedBuffer<T>::removeDeletedIndexedViews() {
   checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
 
   // "erase-remove idiom"
   // (remove list entries for which the view weak_ptr has .expired() == true)
-  existingIndexedViews.erase(
-      std::remove_if(
-          existingIndexedViews.begin(), existingIndexedViews.end(),
-          [](const std::tuple<render::ManagedBuffer<uint32_t>*, std::weak_ptr<render::AttributeBuffer>>& entry)
-              -> bool { return std::get<1>(entry).expired(); }),
-      existingIndexedViews.end());
+  existingIndexedViews.erase(std::remove_if(existingIndexedViews.begin(), existingIndexedViews.end(),
+                                            [](const IndexedView& entry) -> bool { return entry.viewBuffer.expired(); }),
+                             existingIndexedViews.end());
 }
 
 template <typename T>
 void ManagedBuffer<T>::invalidateHostBuffer() {
   hostBufferIsPopulated = false;
+  hostBufferEvicted = false;
+  pendingReadback.reset();
   data.clear();
 }
 
@@ -495,6 +963,22 @@ typename ManagedBuffer<T>::CanonicalDataSource ManagedBuffer<T>::currentCanonica
 }
 
 
+template <typename T>
+bool ManagedBuffer<T>::canUseBufferIndexCopyProgram() {
+  // only worthwhile if the host copy would otherwise need to be read back
+  if (currentCanonicalDataSource() != CanonicalDataSource::RenderBuffer) return false;
+  if (!renderAttributeBuffer) return false;
+
+  // the copy program would write full-precision floats
+  if (deviceStorageFormat != AttributeStorageFormat::Float32) return false;
+
+  // transform feedback captures a single output variable, array-valued data is not supported
+  if (renderAttributeBuffer->getArrayCount() != 1) return false;
+  if (renderAttributeBuffer->getType() == RenderDataType::Matrix44Float) return false;
+
+  return true;
+}
+
 template <typename T>
 void ManagedBuffer<T>::ensureHaveBufferIndexCopyProgram() {
   if (bufferIndexCopyProgram) return;
@@ -502,12 +986,38 @@ void ManagedBuffer<T>::ensureHaveBufferIndexCopyProgram() {
   // sanity check
   if (!renderAttributeBuffer) exception("ManagedBuffer " + name + " asked to copy indices, but has no buffers");
 
-  // TODO allocate the transform feedback program
+  std::string typeRule;
+  switch (renderAttributeBuffer->getType()) {
+  // clang-format off
+  case RenderDataType::Float:         typeRule = "BUFFER_INDEX_COPY_FLOAT"; break;
+  case RenderDataType::Vector2Float:  typeRule = "BUFFER_INDEX_COPY_VEC2"; break;
+  case RenderDataType::Vector3Float:  typeRule = "BUFFER_INDEX_COPY_VEC3"; break;
+  case RenderDataType::Vector4Float:  typeRule = "BUFFER_INDEX_COPY_VEC4"; break;
+  case RenderDataType::Int:           typeRule = "BUFFER_INDEX_COPY_INT"; break;
+  case RenderDataType::Vector2Int:    typeRule = "BUFFER_INDEX_COPY_IVEC2"; break;
+  case RenderDataType::Vector3Int:    typeRule = "BUFFER_INDEX_COPY_IVEC3"; break;
+  case RenderDataType::Vector4Int:    typeRule = "BUFFER_INDEX_COPY_IVEC4"; break;
+  case RenderDataType::UInt:          typeRule = "BUFFER_INDEX_COPY_UINT"; break;
+  case RenderDataType::Vector2UInt:   typeRule = "BUFFER_INDEX_COPY_UVEC2"; break;
+  case RenderDataType::Vector3UInt:   typeRule = "BUFFER_INDEX_COPY_UVEC3"; break;
+  case RenderDataType::Vector4UInt:   typeRule = "BUFFER_INDEX_COPY_UVEC4"; break;
+  case RenderDataType::Matrix44Float:
+    exception("ManagedBuffer " + name + " has a data type which cannot be copied on the device");
+    break;
+  // clang-format on
+  }
+
+  bufferIndexCopyProgram =
+      render::engine->requestShader("BUFFER_INDEX_COPY", {typeRule}, render::ShaderReplacementDefaults::Process);
+  bufferIndexCopyProgram->setAttribute("a_value", renderAttributeBuffer);
 }
 
 template <typename T>
-void ManagedBuffer<T>::invokeBufferIndexCopyProgram() {
+void ManagedBuffer<T>::invokeBufferIndexCopyProgram(ManagedBuffer<uint32_t>& indices,
+                                                    std::shared_ptr<render::AttributeBuffer> target) {
   ensureHaveBufferIndexCopyProgram();
+  bufferIndexCopyProgram->setIndex(indices.getRenderAttributeBuffer());
+  bufferIndexCopyProgram->setTransformFeedbackBuffer(target);
   bufferIndexCopyProgram->draw();
 }
 
@@ -543,6 +1053,38 @@ std::tuple<bool, ManagedBufferType> ManagedBufferRegistry::hasManagedBufferType(
   return std::make_tuple(false, ManagedBufferType::Float);
 }
 
+std::vector<std::tuple<std::string, ManagedBufferMemoryUsage>>
+ManagedBufferRegistry::getManagedBufferMemoryUsageByBuffer() {
+  std::vector<std::tuple<std::string, ManagedBufferMemoryUsage>> usage;
+
+  managedBufferMap_float.appendMemoryUsage(usage);
+  managedBufferMap_double.appendMemoryUsage(usage);
+  managedBufferMap_vec2.appendMemoryUsage(usage);
+  managedBufferMap_vec3.appendMemoryUsage(usage);
+  managedBufferMap_vec4.appendMemoryUsage(usage);
+  managedBufferMap_arr2vec3.appendMemoryUsage(usage);
+  managedBufferMap_arr3vec3.appendMemoryUsage(usage);
+  managedBufferMap_arr4vec3.appendMemoryUsage(usage);
+  managedBufferMap_int32.appendMemoryUsage(usage);
+  managedBufferMap_ivec2.appendMemoryUsage(usage);
+  managedBufferMap_ivec3.appendMemoryUsage(usage);
+  managedBufferMap_ivec4.appendMemoryUsage(usage);
+  managedBufferMap_uint32.appendMemoryUsage(usage);
+  managedBufferMap_uvec2.appendMemoryUsage(usage);
+  managedBufferMap_uvec3.appendMemoryUsage(usage);
+  managedBufferMap_uvec4.appendMemoryUsage(usage);
+
+  return usage;
+}
+
+ManagedBufferMemoryUsage ManagedBufferRegistry::getManagedBufferMemoryUsage() {
+  ManagedBufferMemoryUsage total;
+  for (std::tuple<std::string, ManagedBufferMemoryUsage>& entry : getManagedBufferMemoryUsageByBuffer()) {
+    total += std::get<1>(entry);
+  }
+  return total;
+}
+
 // === Explicit template instantiation for the supported types
 
 // Attribute versions
@@ -15,6 +15,7 @@
 
 // all the shaders
 #include "polyscope/render/opengl/shaders/common.h"
+#include "polyscope/render/opengl/shaders/buffer_shaders.h"
 #include "polyscope/render/opengl/shaders/cylinder_shaders.h"
 #include "polyscope/render/opengl/shaders/gizmo_shaders.h"
 #include "polyscope/render/opengl/shaders/grid_shaders.h"
@@ -32,6 +33,9 @@
 
 #include "stb_image.h"
 
+#include <chrono>
+#include <cstring>
+
 namespace polyscope {
 namespace render {
 namespace backend_openGL_mock {
@@ -47,6 +51,25 @@ void initializeRenderEngine() {
 
 void checkGLError(bool fatal = true) {}
 
+// =============================================================
+// ==================== Readback request =======================
+// =============================================================
+
+GLReadbackRequest::GLReadbackRequest(std::vector<unsigned char> bytes_)
+    : ReadbackRequest(bytes_.size()), pendingBytes(bytes_) {}
+
+void GLReadbackRequest::complete() { bytes = pendingBytes; }
+
+// =============================================================
+// ==================== Timestamp query ========================
+// =============================================================
+
+void GLTimestampQuery::record() {
+  nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+}
+
 // =============================================================
 // =================== Attribute buffer ========================
 // =============================================================
@@ -87,6 +110,8 @@ void GLAttributeBuffer::setData_helper(const std::vector<T>& data) {
 
   // do the actual copy
   dataSize = data.size();
+  if (contents.size() < bufferSize * sizeof(T)) contents.resize(bufferSize * sizeof(T));
+  if (!data.empty()) std::memcpy(contents.data(), data.data(), data.size() * sizeof(T));
 
   checkGLError();
 }
@@ -174,6 +199,127 @@ void GLAttributeBuffer::setData(const std::vector<glm::uvec4>& data) {
   setData_helper(data);
 }
 
+// === set ranges of values
+
+template <typename T>
+void GLAttributeBuffer::setDataRange_helper(const std::vector<T>& data, size_t dataStart, size_t bufferStart,
+                                            size_t count) {
+  if (!isSet() || bufferStart + count > static_cast<size_t>(getDataSize())) exception("bad setDataRange");
+  if (dataStart + count > data.size()) exception("bad setDataRange");
+  bind();
+
+  if (count > 0) std::memcpy(contents.data() + bufferStart * sizeof(T), data.data() + dataStart, count * sizeof(T));
+
+  checkGLError();
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::vec2>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector2Float);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::vec3>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3Float);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::vec4>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector4Float);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<float>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Float);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<double>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Float);
+  if (dataStart + count > data.size()) exception("bad setDataRange");
+
+  // Convert the input range to floats
+  std::vector<float> floatData(count);
+  for (size_t i = 0; i < count; i++) {
+    floatData[i] = static_cast<float>(data[dataStart + i]);
+  }
+
+  setDataRange_helper(floatData, 0, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<int32_t>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Int);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::ivec2>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector2Int);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::ivec3>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3Int);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::ivec4>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector4Int);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<uint32_t>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::UInt);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::uvec2>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector2UInt);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::uvec3>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3UInt);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::uvec4>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector4UInt);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<std::array<glm::vec3, 2>>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3Float);
+  checkArray(2);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<std::array<glm::vec3, 3>>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3Float);
+  checkArray(3);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<std::array<glm::vec3, 4>>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3Float);
+  checkArray(4);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
 
 // === get single data values
 
@@ -182,6 +328,7 @@ T GLAttributeBuffer::getData_helper(size_t ind) {
   if (!isSet() || ind >= static_cast<size_t>(getDataSize() * getArrayCount())) exception("bad getData");
   bind();
   T readValue{};
+  std::memcpy(&readValue, contents.data() + ind * sizeof(T), sizeof(T));
   return readValue;
 }
 
@@ -244,6 +391,7 @@ std::vector<T> GLAttributeBuffer::getDataRange_helper(size_t start, size_t count
   if (!isSet() || start + count > static_cast<size_t>(getDataSize() * getArrayCount())) exception("bad getData");
   bind();
   std::vector<T> readValues(count);
+  if (count > 0) std::memcpy(readValues.data(), contents.data() + start * sizeof(T), count * sizeof(T));
   return readValues;
 }
 
@@ -306,6 +454,28 @@ std::vector<glm::uvec4> GLAttributeBuffer::getDataRange_uvec4(size_t start, size
   return getDataRange_helper<glm::uvec4>(start, count);
 }
 
+std::shared_ptr<ReadbackRequest> GLAttributeBuffer::getDataRangeAsync(size_t start, size_t count) {
+  if (!isSet() || start + count > static_cast<size_t>(getDataSize() * getArrayCount())) exception("bad getData");
+  size_t elementBytes = getStoredEntrySizeInBytes() / getArrayCount();
+  std::vector<unsigned char> bytes(count * elementBytes);
+  if (getStorageFormat() == AttributeStorageFormat::Float32 && !bytes.empty()) {
+    std::memcpy(bytes.data(), contents.data() + start * elementBytes, bytes.size());
+  }
+  return std::make_shared<GLReadbackRequest>(bytes);
+}
+
+void GLAttributeBuffer::gatherFrom(GLAttributeBuffer& source, GLAttributeBuffer& indices) {
+  if (indices.getType() != RenderDataType::UInt) exception("gatherFrom() expects uint32 indices");
+  size_t entryBytes = sizeInBytes(source.getType()) * source.getArrayCount();
+  size_t count = static_cast<size_t>(indices.getDataSize());
+  if (static_cast<size_t>(getDataSize()) < count) exception("gatherFrom() target is too small");
+  for (size_t i = 0; i < count; i++) {
+    uint32_t ind = indices.getData_helper<uint32_t>(i);
+    if (static_cast<int64_t>(ind) >= source.getDataSize()) exception("gatherFrom() index out of bounds");
+    std::memcpy(contents.data() + i * entryBytes, source.contents.data() + ind * entryBytes, entryBytes);
+  }
+}
+
 
 uint32_t GLAttributeBuffer::getNativeBufferID() { return 777; }
 
@@ -687,6 +857,14 @@ std::array<float, 4> GLFrameBuffer::readFloat4(int xPos, int yPos) {
   return result;
 }
 
+std::vector<std::array<float, 4>> GLFrameBuffer::readFloat4Block(int xStart, int yStart, int sizeX, int sizeY) {
+  // Read from the buffer
+  std::array<float, 4> pixel = {1., 2., 3., 4.};
+  std::vector<std::array<float, 4>> result(static_cast<size_t>(sizeX) * sizeY, pixel);
+
+  return result;
+}
+
 float GLFrameBuffer::readDepth(int xPos, int yPos) {
   // Read from the buffer
   float result = 0.5;
@@ -706,6 +884,24 @@ std::vector<unsigned char> GLFrameBuffer::readBuffer() {
   return buff;
 }
 
+std::shared_ptr<ReadbackRequest> GLFrameBuffer::readFloat4Async(int xPos, int yPos) {
+  std::array<float, 4> result = readFloat4(xPos, yPos);
+  std::vector<unsigned char> bytes(sizeof(result));
+  std::memcpy(&bytes.front(), &result, sizeof(result));
+  return std::make_shared<GLReadbackRequest>(bytes);
+}
+
+std::shared_ptr<ReadbackRequest> GLFrameBuffer::readDepthAsync(int xPos, int yPos) {
+  float result = readDepth(xPos, yPos);
+  std::vector<unsigned char> bytes(sizeof(result));
+  std::memcpy(&bytes.front(), &result, sizeof(result));
+  return std::make_shared<GLReadbackRequest>(bytes);
+}
+
+std::shared_ptr<ReadbackRequest> GLFrameBuffer::readBufferAsync() {
+  return std::make_shared<GLReadbackRequest>(readBuffer());
+}
+
 void GLFrameBuffer::blitTo(FrameBuffer* targetIn) {
 
   // it _better_ be a GL buffer
@@ -1628,6 +1824,18 @@ void GLShaderProgram::validateData() {
       throw std::invalid_argument("Must set instance count to use instanced drawing");
     }
   }
+
+  // Check transform feedback (if applicable)
+  if (drawMode == DrawMode::IndexedPointsTransformFeedback) {
+    if (!transformFeedbackBuffer) {
+      throw std::invalid_argument("Must set transform feedback buffer to use transform feedback drawing");
+    }
+    if (transformFeedbackBuffer->getDataSize() < static_cast<int64_t>(drawDataLength)) {
+      throw std::invalid_argument("Transform feedback buffer is too small. It has size " +
+                                  std::to_string(transformFeedbackBuffer->getDataSize()) + " but " +
+                                  std::to_string(drawDataLength) + " entries will be captured");
+    }
+  }
 }
 
 void GLShaderProgram::setPrimitiveRestartIndex(unsigned int restartIndex_) {
@@ -1640,6 +1848,37 @@ void GLShaderProgram::setPrimitiveRestartIndex(unsigned int restartIndex_) {
 
 void GLShaderProgram::setInstanceCount(uint32_t instanceCount_) { instanceCount = instanceCount_; }
 
+void GLShaderProgram::setDrawRanges(const std::vector<std::array<uint32_t, 2>>& ranges) {
+  if (drawMode != DrawMode::Triangles && drawMode != DrawMode::IndexedTriangles) {
+    exception("setDrawRanges() called, but draw mode does not support draw ranges.");
+  }
+  for (const std::array<uint32_t, 2>& range : ranges) {
+    if (static_cast<uint64_t>(range[0]) + range[1] > drawDataLength) {
+      exception("setDrawRanges() range [" + std::to_string(range[0]) + ", " + std::to_string(range[0] + range[1]) +
+                ") is out of bounds for draw data of length " + std::to_string(drawDataLength));
+    }
+  }
+  useDrawRanges = true;
+  drawRanges = ranges;
+}
+
+void GLShaderProgram::clearDrawRanges() {
+  useDrawRanges = false;
+  drawRanges.clear();
+}
+
+void GLShaderProgram::setTransformFeedbackBuffer(std::shared_ptr<AttributeBuffer> externalBuffer) {
+  if (drawMode != DrawMode::IndexedPointsTransformFeedback) {
+    exception("setTransformFeedbackBuffer() called, but draw mode does not use transform feedback.");
+  }
+
+  // cast to the engine type (booooooo)
+  std::shared_ptr<GLAttributeBuffer> engineExtBuff = std::dynamic_pointer_cast<GLAttributeBuffer>(externalBuffer);
+  if (!engineExtBuff) throw std::invalid_argument("transform feedback external buffer engine type cast failed");
+
+  transformFeedbackBuffer = engineExtBuff;
+}
+
 void GLShaderProgram::activateTextures() {
   for (GLShaderTexture& t : textures) {
     // Point the uniform at this texture
@@ -1659,6 +1898,8 @@ void GLShaderProgram::activateTextures() {
 void GLShaderProgram::draw() {
   validateData();
 
+  if (useDrawRanges && drawRanges.empty()) return; // everything has been culled
+
   if (usePrimitiveRestart) {
   }
 
@@ -1689,6 +1930,16 @@ void GLShaderProgram::draw() {
     break;
   case DrawMode::TriangleStripInstanced:
     break;
+  case DrawMode::IndexedPointsTransformFeedback: {
+    // emulate the capture so device-side index copies produce real data
+    for (GLShaderAttribute& a : attributes) {
+      if (a.name != "a_value" || !a.buff) continue;
+      std::shared_ptr<GLAttributeBuffer> target = std::dynamic_pointer_cast<GLAttributeBuffer>(transformFeedbackBuffer);
+      std::shared_ptr<GLAttributeBuffer> indices = std::dynamic_pointer_cast<GLAttributeBuffer>(indexBuffer);
+      if (target && indices) target->gatherFrom(*a.buff, *indices);
+    }
+    break;
+  }
   }
 
   if (usePrimitiveRestart) {
@@ -1973,6 +2224,10 @@ std::shared_ptr<FrameBuffer> MockGLEngine::generateFrameBuffer(unsigned int size
   return std::shared_ptr<FrameBuffer>(newF);
 }
 
+std::shared_ptr<TimestampQuery> MockGLEngine::generateTimestampQuery() {
+  return std::make_shared<GLTimestampQuery>();
+}
+
 std::string MockGLEngine::programKeyFromRules(const std::string& programName, const std::vector<std::string>& rules,
                                               ShaderReplacementDefaults defaults) {
 
@@ -2127,7 +2382,8 @@ void MockGLEngine::populateDefaultShadersAndRules() {
 
   // == Load general base shaders
   registerShaderProgram("MESH", {FLEX_MESH_VERT_SHADER, FLEX_MESH_FRAG_SHADER}, DrawMode::Triangles);
-  registerShaderProgram("INDEXED_MESH", {FLEX_MESH_VERT_SHADER, FLEX_MESH_FRAG_SHADER}, DrawMode::IndexedTriangles);
+  registerShaderProgram("INDEXED_MESH", {FLEX_MESH_INDEXED_VERT_SHADER, FLEX_MESH_INDEXED_FRAG_SHADER}, DrawMode::IndexedTriangles);
+  registerShaderProgram("INSTANCED_MESH", {INSTANCED_MESH_VERT_SHADER, FLEX_MESH_FRAG_SHADER}, DrawMode::TrianglesInstanced);
   registerShaderProgram("SIMPLE_MESH", {SIMPLE_MESH_VERT_SHADER, SIMPLE_MESH_FRAG_SHADER}, DrawMode::IndexedTriangles);
   registerShaderProgram("SLICE_TETS", {SLICE_TETS_VERT_SHADER, SLICE_TETS_GEOM_SHADER, SLICE_TETS_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("RAYCAST_SPHERE", {FLEX_SPHERE_VERT_SHADER, FLEX_SPHERE_GEOM_SHADER, FLEX_SPHERE_FRAG_SHADER}, DrawMode::Points);
@@ -2158,6 +2414,7 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   registerShaderProgram("SCALAR_TEXTURE_COLORMAP", {TEXTURE_DRAW_VERT_SHADER, SCALAR_TEXTURE_COLORMAP}, DrawMode::Triangles);
   registerShaderProgram("BLUR_RGB", {TEXTURE_DRAW_VERT_SHADER, BLUR_RGB}, DrawMode::Triangles);
   registerShaderProgram("TRANSFORMATION_GIZMO_ROT", {TRANSFORMATION_GIZMO_ROT_VERT, TRANSFORMATION_GIZMO_ROT_FRAG}, DrawMode::Triangles);
+  registerShaderProgram("BUFFER_INDEX_COPY", {BUFFER_INDEX_COPY_VERT_SHADER}, DrawMode::IndexedPointsTransformFeedback);
 
   // === Load rules
 
@@ -2178,6 +2435,7 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("COMPUTE_SHADE_NORMAL_FROM_POSITION", COMPUTE_SHADE_NORMAL_FROM_POSITION);
   registerShaderRule("PREMULTIPLY_LIT_COLOR", PREMULTIPLY_LIT_COLOR);
   registerShaderRule("CULL_POS_FROM_VIEW", CULL_POS_FROM_VIEW);
+  registerShaderRule("POSITION_QUANTIZED", POSITION_QUANTIZED);
   registerShaderRule("PROJ_AND_INV_PROJ_MAT", PROJ_AND_INV_PROJ_MAT);
   registerShaderRule("BUILD_RAY_FOR_FRAGMENT_PERSPECTIVE", BUILD_RAY_FOR_FRAGMENT_PERSPECTIVE);
   registerShaderRule("BUILD_RAY_FOR_FRAGMENT_ORTHOGRAPHIC", BUILD_RAY_FOR_FRAGMENT_ORTHOGRAPHIC);
@@ -2231,8 +2489,15 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("MESH_PROPAGATE_HALFEDGE_VALUE", MESH_PROPAGATE_HALFEDGE_VALUE);
   registerShaderRule("MESH_PROPAGATE_CULLPOS", MESH_PROPAGATE_CULLPOS);
   registerShaderRule("MESH_PROPAGATE_TYPE_AND_BASECOLOR2_SHADE", MESH_PROPAGATE_TYPE_AND_BASECOLOR2_SHADE);
+  registerShaderRule("MESH_INDEXED_FACE_NORMAL", MESH_INDEXED_FACE_NORMAL);
+  registerShaderRule("MESH_INDEXED_PROPAGATE_CULLPOS", MESH_INDEXED_PROPAGATE_CULLPOS);
+  registerShaderRule("MESH_INDEXED_WIREFRAME", MESH_INDEXED_WIREFRAME);
+  registerShaderRule("MESH_INSTANCED_COLOR", MESH_INSTANCED_COLOR);
+  registerShaderRule("MESH_INSTANCED_PROPAGATE_CULLPOS", MESH_INSTANCED_PROPAGATE_CULLPOS);
+  registerShaderRule("MESH_INSTANCED_PROPAGATE_PICK", MESH_INSTANCED_PROPAGATE_PICK);
   registerShaderRule("MESH_PROPAGATE_PICK", MESH_PROPAGATE_PICK);
   registerShaderRule("MESH_PROPAGATE_PICK_SIMPLE", MESH_PROPAGATE_PICK_SIMPLE);
+  registerShaderRule("MESH_PROPAGATE_PICK_SIMPLE_FROM_INDS", MESH_PROPAGATE_PICK_SIMPLE_FROM_INDS);
   
   // volume gridcube things
   registerShaderRule("GRIDCUBE_PROPAGATE_NODE_VALUE", GRIDCUBE_PROPAGATE_NODE_VALUE);
@@ -2278,6 +2543,20 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("SLICE_TETS_VECTOR_COLOR", SLICE_TETS_VECTOR_COLOR);
   registerShaderRule("SLICE_TETS_MESH_WIREFRAME", SLICE_TETS_MESH_WIREFRAME);
 
+  // buffer copies
+  registerShaderRule("BUFFER_INDEX_COPY_FLOAT", BUFFER_INDEX_COPY_FLOAT);
+  registerShaderRule("BUFFER_INDEX_COPY_VEC2", BUFFER_INDEX_COPY_VEC2);
+  registerShaderRule("BUFFER_INDEX_COPY_VEC3", BUFFER_INDEX_COPY_VEC3);
+  registerShaderRule("BUFFER_INDEX_COPY_VEC4", BUFFER_INDEX_COPY_VEC4);
+  registerShaderRule("BUFFER_INDEX_COPY_INT", BUFFER_INDEX_COPY_INT);
+  registerShaderRule("BUFFER_INDEX_COPY_IVEC2", BUFFER_INDEX_COPY_IVEC2);
+  registerShaderRule("BUFFER_INDEX_COPY_IVEC3", BUFFER_INDEX_COPY_IVEC3);
+  registerShaderRule("BUFFER_INDEX_COPY_IVEC4", BUFFER_INDEX_COPY_IVEC4);
+  registerShaderRule("BUFFER_INDEX_COPY_UINT", BUFFER_INDEX_COPY_UINT);
+  registerShaderRule("BUFFER_INDEX_COPY_UVEC2", BUFFER_INDEX_COPY_UVEC2);
+  registerShaderRule("BUFFER_INDEX_COPY_UVEC3", BUFFER_INDEX_COPY_UVEC3);
+  registerShaderRule("BUFFER_INDEX_COPY_UVEC4", BUFFER_INDEX_COPY_UVEC4);
+
   // clang-format on
 };
 
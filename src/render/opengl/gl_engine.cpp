@@ -14,6 +14,7 @@
 
 // all the shaders
 #include "polyscope/render/opengl/shaders/common.h"
+#include "polyscope/render/opengl/shaders/buffer_shaders.h"
 #include "polyscope/render/opengl/shaders/cylinder_shaders.h"
 #include "polyscope/render/opengl/shaders/gizmo_shaders.h"
 #include "polyscope/render/opengl/shaders/grid_shaders.h"
@@ -214,6 +215,200 @@ void printProgramInfoLog(GLuint handle) {
   }
 }
 
+// =============================================================
+// ====================== Bound state ==========================
+// =============================================================
+
+// The program, vertex array, and textures most recently bound by the engine. Draws of many structures with the same
+// compiled program would otherwise repeat the same binds for every draw; these helpers skip any bind which would not
+// change the state. The record is discarded whenever a framebuffer is bound and after ImGui renders, so state changed
+// outside the engine never carries over.
+namespace {
+
+struct BoundState {
+  bool programKnown = false;
+  ProgramHandle program = 0;
+
+  bool vaoKnown = false;
+  AttributeHandle vao = 0;
+
+  bool primitiveRestartKnown = false;
+  bool primitiveRestart = false;
+  bool restartIndexKnown = false;
+  unsigned int restartIndex = 0;
+
+  bool activeUnitKnown = false;
+  unsigned int activeUnit = 0;
+  std::vector<TextureBufferHandle> unitTextures; // 0 means unknown
+};
+BoundState boundState;
+
+void useProgram(ProgramHandle handle) {
+  if (boundState.programKnown && boundState.program == handle) return;
+  glUseProgram(handle);
+  boundState.programKnown = true;
+  boundState.program = handle;
+}
+
+void bindVertexArray(AttributeHandle handle) {
+  if (boundState.vaoKnown && boundState.vao == handle) return;
+  glBindVertexArray(handle);
+  boundState.vaoKnown = true;
+  boundState.vao = handle;
+}
+
+void setPrimitiveRestart(bool enabled, unsigned int restartIndex) {
+  if (!boundState.primitiveRestartKnown || boundState.primitiveRestart != enabled) {
+    if (enabled) {
+      glEnable(GL_PRIMITIVE_RESTART);
+    } else {
+      glDisable(GL_PRIMITIVE_RESTART);
+    }
+    boundState.primitiveRestartKnown = true;
+    boundState.primitiveRestart = enabled;
+  }
+  if (enabled && (!boundState.restartIndexKnown || boundState.restartIndex != restartIndex)) {
+    glPrimitiveRestartIndex(restartIndex);
+    boundState.restartIndexKnown = true;
+    boundState.restartIndex = restartIndex;
+  }
+}
+
+// Binds to the active texture unit
+void bindTexture(GLenum target, TextureBufferHandle handle) {
+  glBindTexture(target, handle);
+  if (!boundState.activeUnitKnown) return;
+  if (boundState.unitTextures.size() <= boundState.activeUnit) {
+    boundState.unitTextures.resize(boundState.activeUnit + 1, 0);
+  }
+  boundState.unitTextures[boundState.activeUnit] = handle;
+}
+
+void bindTextureToUnit(unsigned int unit, GLenum target, TextureBufferHandle handle) {
+  if (unit < boundState.unitTextures.size() && boundState.unitTextures[unit] == handle) return;
+  if (!boundState.activeUnitKnown || boundState.activeUnit != unit) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    boundState.activeUnitKnown = true;
+    boundState.activeUnit = unit;
+  }
+  bindTexture(target, handle);
+}
+
+// Called when objects are deleted, since GL may reuse their handles
+void forgetProgram(ProgramHandle handle) {
+  if (boundState.program == handle) boundState.programKnown = false;
+}
+void forgetVertexArray(AttributeHandle handle) {
+  if (boundState.vao == handle) boundState.vaoKnown = false;
+}
+void forgetTexture(TextureBufferHandle handle) {
+  std::replace(boundState.unitTextures.begin(), boundState.unitTextures.end(), handle, TextureBufferHandle(0));
+}
+
+void invalidateBoundState() {
+  boundState = BoundState();
+
+  // Primitive restart is left on between draws which use it; turn it off for anything drawn outside the engine
+  glDisable(GL_PRIMITIVE_RESTART);
+  boundState.primitiveRestartKnown = true;
+  boundState.primitiveRestart = false;
+}
+
+} // namespace
+
+// =============================================================
+// ==================== Readback request =======================
+// =============================================================
+
+GLReadbackRequest::GLReadbackRequest(size_t sizeInBytes_) : ReadbackRequest(sizeInBytes_) {
+  glGenBuffers(1, &packBuffer);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, packBuffer);
+  glBufferData(GL_PIXEL_PACK_BUFFER, sizeInBytes, nullptr, GL_STREAM_READ);
+  checkGLError();
+}
+
+GLReadbackRequest::~GLReadbackRequest() { release(); }
+
+void GLReadbackRequest::insertFence() {
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glFlush(); // make sure the fence actually gets submitted, so polling it eventually succeeds
+  checkGLError();
+}
+
+bool GLReadbackRequest::isReady() {
+  if (completed) return true;
+  if (fence == nullptr) return false;
+  GLint status = GL_UNSIGNALED;
+  glGetSynciv(fence, GL_SYNC_STATUS, sizeof(GLint), nullptr, &status);
+  return status == GL_SIGNALED;
+}
+
+void GLReadbackRequest::complete() {
+  if (fence == nullptr) exception("readback request completed before the copy was issued");
+
+  // wait for the device, in slices so a lost context does not hang forever
+  const GLuint64 timeoutNanosec = 1000000000; // 1 second
+  GLenum waitResult = GL_TIMEOUT_EXPIRED;
+  for (int iTry = 0; iTry < 10 && waitResult == GL_TIMEOUT_EXPIRED; iTry++) {
+    waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNanosec);
+  }
+  if (waitResult == GL_WAIT_FAILED || waitResult == GL_TIMEOUT_EXPIRED) {
+    exception("OpenGL error: waiting for readback failed");
+  }
+
+  bytes.resize(sizeInBytes);
+  if (sizeInBytes > 0) {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, packBuffer);
+    glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, sizeInBytes, &bytes.front());
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  }
+  checkGLError();
+
+  release();
+}
+
+void GLReadbackRequest::release() {
+  if (fence != nullptr) {
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+  if (packBuffer != 0) {
+    glDeleteBuffers(1, &packBuffer);
+    packBuffer = 0;
+  }
+}
+
+// =============================================================
+// ==================== Timestamp query ========================
+// =============================================================
+
+GLTimestampQuery::GLTimestampQuery() {
+  glGenQueries(1, &handle);
+  checkGLError();
+}
+
+GLTimestampQuery::~GLTimestampQuery() { glDeleteQueries(1, &handle); }
+
+void GLTimestampQuery::record() {
+  // (timestamps rather than GL_TIME_ELAPSED queries, because those cannot be nested)
+  glQueryCounter(handle, GL_TIMESTAMP);
+  recorded = true;
+}
+
+bool GLTimestampQuery::isReady() {
+  if (!recorded) return false;
+  GLint available = 0;
+  glGetQueryObjectiv(handle, GL_QUERY_RESULT_AVAILABLE, &available);
+  return available != 0;
+}
+
+uint64_t GLTimestampQuery::getNanoseconds() {
+  GLuint64 result = 0;
+  glGetQueryObjectui64v(handle, GL_QUERY_RESULT, &result);
+  return result;
+}
+
 // =============================================================
 // =================== Attribute buffer ========================
 // =============================================================
@@ -252,17 +447,24 @@ void GLAttributeBuffer::setData_helper(const std::vector<T>& data) {
   bind();
 
   // allocate if needed
+  size_t entryBytes = getStoredEntrySizeInBytes();
   if (!isSet() || data.size() > bufferSize) {
     setFlag = true;
     uint64_t newSize = data.size();
     newSize = std::max(newSize, 2 * bufferSize); // if we're expanding, at-least double
-    glBufferData(getTarget(), newSize * sizeof(T), NULL, GL_STATIC_DRAW);
+    glBufferData(getTarget(), newSize * entryBytes, NULL, GL_STATIC_DRAW);
     bufferSize = newSize;
   }
 
   // do the actual copy
   dataSize = data.size();
-  glBufferSubData(getTarget(), 0, dataSize * sizeof(T), data.data());
+  if (storageFormat == AttributeStorageFormat::Float32) {
+    glBufferSubData(getTarget(), 0, dataSize * sizeof(T), data.data());
+  } else {
+    std::vector<uint16_t> storedData =
+        encodeCompactStorage(reinterpret_cast<const float*>(data.data()), data.size() * sizeof(T) / sizeof(float));
+    glBufferSubData(getTarget(), 0, dataSize * entryBytes, storedData.data());
+  }
 
   checkGLError();
 }
@@ -351,15 +553,141 @@ void GLAttributeBuffer::setData(const std::vector<glm::uvec4>& data) {
   setData_helper(data);
 }
 
+// === set ranges of values
+
+template <typename T>
+void GLAttributeBuffer::setDataRange_helper(const std::vector<T>& data, size_t dataStart, size_t bufferStart,
+                                            size_t count) {
+  if (!isSet() || bufferStart + count > static_cast<size_t>(getDataSize())) exception("bad setDataRange");
+  if (dataStart + count > data.size()) exception("bad setDataRange");
+  if (count == 0) return;
+  bind();
+
+  if (storageFormat == AttributeStorageFormat::Float32) {
+    glBufferSubData(getTarget(), bufferStart * sizeof(T), count * sizeof(T), &data[dataStart]);
+  } else {
+    size_t entryBytes = getStoredEntrySizeInBytes();
+    std::vector<uint16_t> storedData =
+        encodeCompactStorage(reinterpret_cast<const float*>(&data[dataStart]), count * sizeof(T) / sizeof(float));
+    glBufferSubData(getTarget(), bufferStart * entryBytes, count * entryBytes, storedData.data());
+  }
+
+  checkGLError();
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::vec2>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector2Float);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::vec3>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3Float);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::vec4>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector4Float);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<float>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Float);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<double>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Float);
+  if (dataStart + count > data.size()) exception("bad setDataRange");
+
+  // Convert the input range to floats
+  std::vector<float> floatData(count);
+  for (size_t i = 0; i < count; i++) {
+    floatData[i] = static_cast<float>(data[dataStart + i]);
+  }
+
+  setDataRange_helper(floatData, 0, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<int32_t>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Int);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::ivec2>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector2Int);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::ivec3>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3Int);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::ivec4>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector4Int);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<uint32_t>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::UInt);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::uvec2>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector2UInt);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::uvec3>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3UInt);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<glm::uvec4>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector4UInt);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<std::array<glm::vec3, 2>>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3Float);
+  checkArray(2);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<std::array<glm::vec3, 3>>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3Float);
+  checkArray(3);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
+void GLAttributeBuffer::setDataRange(const std::vector<std::array<glm::vec3, 4>>& data, size_t dataStart, size_t bufferStart,
+                                     size_t count) {
+  checkType(RenderDataType::Vector3Float);
+  checkArray(4);
+  setDataRange_helper(data, dataStart, bufferStart, count);
+}
+
 // === get single data values
 
 template <typename T>
 T GLAttributeBuffer::getData_helper(size_t ind) {
   if (!isSet() || ind >= static_cast<size_t>(getDataSize() * getArrayCount())) exception("bad getData");
-  bind();
-  T readValue;
-  glGetBufferSubData(getTarget(), ind * sizeof(T), sizeof(T), &readValue);
-  return readValue;
+  return getDataRange_helper<T>(ind, 1).front();
 }
 
 float GLAttributeBuffer::getData_float(size_t ind) {
@@ -421,10 +749,41 @@ std::vector<T> GLAttributeBuffer::getDataRange_helper(size_t start, size_t count
   if (!isSet() || start + count > static_cast<size_t>(getDataSize() * getArrayCount())) exception("bad getData");
   bind();
   std::vector<T> readValues(count);
-  glGetBufferSubData(getTarget(), start * sizeof(T), count * sizeof(T), &readValues.front());
+  if (count == 0) return readValues;
+
+  if (storageFormat == AttributeStorageFormat::Float32) {
+    glGetBufferSubData(getTarget(), start * sizeof(T), count * sizeof(T), &readValues.front());
+  } else {
+    size_t entryBytes = getStoredEntrySizeInBytes();
+    size_t nValues = count * sizeof(T) / sizeof(float);
+    std::vector<uint16_t> storedData(nValues);
+    glGetBufferSubData(getTarget(), start * entryBytes, count * entryBytes, &storedData.front());
+    decodeCompactStorage(storedData.data(), nValues, reinterpret_cast<float*>(&readValues.front()));
+  }
+
   return readValues;
 }
 
+std::shared_ptr<ReadbackRequest> GLAttributeBuffer::getDataRangeAsync(size_t start, size_t count) {
+  if (!isSet() || start + count > static_cast<size_t>(getDataSize() * getArrayCount())) exception("bad getData");
+
+  // offsets are in units of one element of the data type, as with getDataRange_*()
+  size_t elementBytes = getStoredEntrySizeInBytes() / getArrayCount();
+  std::shared_ptr<GLReadbackRequest> request = std::make_shared<GLReadbackRequest>(count * elementBytes);
+
+  // copy buffer-to-buffer on the device, which does not stall the pipeline
+  glBindBuffer(GL_COPY_READ_BUFFER, VBOLoc);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, request->getPackBufferHandle());
+  if (count > 0) {
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, start * elementBytes, 0, count * elementBytes);
+  }
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  request->insertFence();
+
+  return request;
+}
+
 std::vector<float> GLAttributeBuffer::getDataRange_float(size_t start, size_t count) {
   if (getType() != RenderDataType::Float) exception("bad getData type");
   return getDataRange_helper<float>(start, count);
@@ -499,7 +858,7 @@ GLTextureBuffer::GLTextureBuffer(TextureFormat format_, unsigned int size1D, con
   glEnable(GL_TEXTURE_1D);
 
   glGenTextures(1, &handle);
-  glBindTexture(GL_TEXTURE_1D, handle);
+  bindTexture(GL_TEXTURE_1D, handle);
   glTexImage1D(GL_TEXTURE_1D, 0, internalFormat(format), size1D, 0, formatF(format), GL_UNSIGNED_BYTE, data);
   checkGLError();
 
@@ -510,7 +869,7 @@ GLTextureBuffer::GLTextureBuffer(TextureFormat format_, unsigned int size1D, con
     : TextureBuffer(1, format_, size1D) {
 
   glGenTextures(1, &handle);
-  glBindTexture(GL_TEXTURE_1D, handle);
+  bindTexture(GL_TEXTURE_1D, handle);
   glTexImage1D(GL_TEXTURE_1D, 0, internalFormat(format), size1D, 0, formatF(format), GL_FLOAT, data);
   checkGLError();
 
@@ -523,7 +882,7 @@ GLTextureBuffer::GLTextureBuffer(TextureFormat format_, unsigned int sizeX_, uns
     : TextureBuffer(2, format_, sizeX_, sizeY_) {
 
   glGenTextures(1, &handle);
-  glBindTexture(GL_TEXTURE_2D, handle);
+  bindTexture(GL_TEXTURE_2D, handle);
   glTexImage2D(GL_TEXTURE_2D, 0, internalFormat(format), sizeX, sizeY, 0, formatF(format), GL_UNSIGNED_BYTE, data);
   checkGLError();
 
@@ -534,7 +893,7 @@ GLTextureBuffer::GLTextureBuffer(TextureFormat format_, unsigned int sizeX_, uns
     : TextureBuffer(2, format_, sizeX_, sizeY_) {
 
   glGenTextures(1, &handle);
-  glBindTexture(GL_TEXTURE_2D, handle);
+  bindTexture(GL_TEXTURE_2D, handle);
   glTexImage2D(GL_TEXTURE_2D, 0, internalFormat(format), sizeX, sizeY, 0, formatF(format), GL_FLOAT, data);
   checkGLError();
 
@@ -547,7 +906,7 @@ GLTextureBuffer::GLTextureBuffer(TextureFormat format_, unsigned int sizeX_, uns
     : TextureBuffer(3, format_, sizeX_, sizeY_, sizeZ_) {
 
   glGenTextures(1, &handle);
-  glBindTexture(GL_TEXTURE_3D, handle);
+  bindTexture(GL_TEXTURE_3D, handle);
   glTexImage3D(GL_TEXTURE_3D, 0, internalFormat(format), sizeX, sizeY, sizeZ, 0, formatF(format), GL_UNSIGNED_BYTE,
                data);
   checkGLError();
@@ -560,14 +919,17 @@ GLTextureBuffer::GLTextureBuffer(TextureFormat format_, unsigned int sizeX_, uns
     : TextureBuffer(3, format_, sizeX_, sizeY_, sizeZ_) {
 
   glGenTextures(1, &handle);
-  glBindTexture(GL_TEXTURE_3D, handle);
+  bindTexture(GL_TEXTURE_3D, handle);
   glTexImage3D(GL_TEXTURE_3D, 0, internalFormat(format), sizeX, sizeY, sizeZ, 0, formatF(format), GL_FLOAT, data);
   checkGLError();
 
   setFilterMode(FilterMode::Nearest);
 }
 
-GLTextureBuffer::~GLTextureBuffer() { glDeleteTextures(1, &handle); }
+GLTextureBuffer::~GLTextureBuffer() {
+  forgetTexture(handle);
+  glDeleteTextures(1, &handle);
+}
 
 void GLTextureBuffer::resize(unsigned int newLen) {
 
@@ -802,7 +1164,7 @@ GLenum GLTextureBuffer::textureType() {
 }
 
 void GLTextureBuffer::bind() {
-  glBindTexture(textureType(), handle);
+  bindTexture(textureType(), handle);
   checkGLError();
 }
 
@@ -858,6 +1220,7 @@ GLFrameBuffer::~GLFrameBuffer() {
 
 void GLFrameBuffer::bind() {
   glBindFramebuffer(GL_FRAMEBUFFER, handle);
+  invalidateBoundState(); // starts a new pass
   checkGLError();
 }
 
@@ -1004,6 +1367,20 @@ std::array<float, 4> GLFrameBuffer::readFloat4(int xPos, int yPos) {
   return result;
 }
 
+std::vector<std::array<float, 4>> GLFrameBuffer::readFloat4Block(int xStart, int yStart, int sizeX, int sizeY) {
+
+  glFlush();
+  glFinish();
+  bind();
+
+  // Read from the buffer
+  std::vector<std::array<float, 4>> result(static_cast<size_t>(sizeX) * sizeY);
+  if (result.empty()) return result;
+  glReadPixels(xStart, yStart, sizeX, sizeY, GL_RGBA, GL_FLOAT, &result.front());
+
+  return result;
+}
+
 float GLFrameBuffer::readDepth(int xPos, int yPos) {
 
   // TODO does no error checking for the case where no depth buffer is attached
@@ -1037,6 +1414,32 @@ std::vector<unsigned char> GLFrameBuffer::readBuffer() {
   return buff;
 }
 
+std::shared_ptr<ReadbackRequest> GLFrameBuffer::readFloat4Async(int xPos, int yPos) {
+  bind();
+  std::shared_ptr<GLReadbackRequest> request = std::make_shared<GLReadbackRequest>(4 * sizeof(float));
+  glReadPixels(xPos, yPos, 1, 1, GL_RGBA, GL_FLOAT, 0); // writes to the bound pack buffer
+  request->insertFence();
+  return request;
+}
+
+std::shared_ptr<ReadbackRequest> GLFrameBuffer::readDepthAsync(int xPos, int yPos) {
+  bind();
+  std::shared_ptr<GLReadbackRequest> request = std::make_shared<GLReadbackRequest>(sizeof(float));
+  glReadPixels(xPos, yPos, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, 0); // writes to the bound pack buffer
+  request->insertFence();
+  return request;
+}
+
+std::shared_ptr<ReadbackRequest> GLFrameBuffer::readBufferAsync() {
+  bind();
+  int w = getSizeX();
+  int h = getSizeY();
+  std::shared_ptr<GLReadbackRequest> request = std::make_shared<GLReadbackRequest>(w * h * 4);
+  glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, 0); // writes to the bound pack buffer
+  request->insertFence();
+  return request;
+}
+
 void GLFrameBuffer::blitTo(FrameBuffer* targetIn) {
 
   // it _better_ be a GL buffer
@@ -1086,7 +1489,10 @@ GLCompiledProgram::GLCompiledProgram(const std::vector<ShaderStageSpecification>
   checkGLError();
 }
 
-GLCompiledProgram::~GLCompiledProgram() { glDeleteProgram(programHandle); }
+GLCompiledProgram::~GLCompiledProgram() {
+  forgetProgram(programHandle);
+  glDeleteProgram(programHandle);
+}
 
 void GLCompiledProgram::compileGLProgram(const std::vector<ShaderStageSpecification>& stages) {
 
@@ -1143,6 +1549,12 @@ void GLCompiledProgram::compileGLProgram(const std::vector<ShaderStageSpecificat
     glAttachShader(programHandle, h);
   }
 
+  // Programs which capture their output must declare the captured variables before linking
+  if (drawMode == DrawMode::IndexedPointsTransformFeedback) {
+    const char* varyings[] = {"a_valueOut"};
+    glTransformFeedbackVaryings(programHandle, 1, varyings, GL_INTERLEAVED_ATTRIBS);
+  }
+
   // Link the program
   glLinkProgram(programHandle);
   if (options::verbosity > 2) {
@@ -1164,7 +1576,7 @@ void GLCompiledProgram::compileGLProgram(const std::vector<ShaderStageSpecificat
 }
 
 void GLCompiledProgram::setDataLocations() {
-  glUseProgram(programHandle);
+  useProgram(programHandle);
 
   // Uniforms
   for (GLShaderUniform& u : uniforms) {
@@ -1187,13 +1599,29 @@ void GLCompiledProgram::setDataLocations() {
   }
 
   // Textures
+
+  // Verify we have enough texture units
+  GLint nAvailTextureUnits;
+  glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &nAvailTextureUnits);
+  if ((int)textures.size() > nAvailTextureUnits) {
+    throw std::invalid_argument("Attempted to load more textures than the number of available texture "
+                                "units (" +
+                                std::to_string(nAvailTextureUnits) + ").");
+  }
+
+  // Units are assigned sequentially, and each sampler is pointed at its unit once here, rather than on every draw. All
+  // programs which share this compiled program inherit the same units.
+  uint32_t iTexture = 0;
   for (GLShaderTexture& t : textures) {
+    t.index = iTexture++;
     t.location = glGetUniformLocation(programHandle, t.name.c_str());
     if (t.location == -1) {
       if (options::verbosity > 3) {
         info("failed to get location for texture " + t.name);
       }
+      continue;
     }
+    glUniform1i(t.location, t.index);
   }
 
   checkGLError();
@@ -1250,34 +1678,19 @@ GLShaderProgram::GLShaderProgram(const std::shared_ptr<GLCompiledProgram>& compi
   glGenVertexArrays(1, &vaoHandle);
   checkGLError();
 
-  createBuffers(); // only handles texture & index things, attributes are lazily created
+  createBuffers(); // only binds the VAO, attributes are lazily created
   checkGLError();
 }
 
-GLShaderProgram::~GLShaderProgram() { glDeleteVertexArrays(1, &vaoHandle); }
+GLShaderProgram::~GLShaderProgram() {
+  forgetVertexArray(vaoHandle);
+  glDeleteVertexArrays(1, &vaoHandle);
+}
 
-void GLShaderProgram::bindVAO() { glBindVertexArray(vaoHandle); }
+void GLShaderProgram::bindVAO() { bindVertexArray(vaoHandle); }
 
 void GLShaderProgram::createBuffers() {
   bindVAO();
-
-  // === Generate textures
-
-  // Verify we have enough texture units
-  GLint nAvailTextureUnits;
-  glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &nAvailTextureUnits);
-  if ((int)textures.size() > nAvailTextureUnits) {
-    throw std::invalid_argument("Attempted to load more textures than the number of available texture "
-                                "units (" +
-                                std::to_string(nAvailTextureUnits) + ").");
-  }
-
-  // Set indices sequentially
-  uint32_t iTexture = 0;
-  for (GLShaderTexture& t : textures) {
-    t.index = iTexture++;
-  }
-
   checkGLError();
 }
 
@@ -1324,6 +1737,20 @@ void GLShaderProgram::assignBufferToVAO(GLShaderAttribute& a) {
   a.buff->bind();
   checkGLError();
 
+  // Compactly-stored buffers hold 16-bit values (always non-array floats), which get converted back to floats
+  // on the device
+  if (a.buff->getStorageFormat() != AttributeStorageFormat::Float32) {
+    GLint nComponents = sizeInBytes(a.type) / sizeof(float);
+    glEnableVertexAttribArray(a.location);
+    if (a.buff->getStorageFormat() == AttributeStorageFormat::Float16) {
+      glVertexAttribPointer(a.location, nComponents, GL_HALF_FLOAT, GL_FALSE, 0, reinterpret_cast<void*>(0));
+    } else {
+      glVertexAttribPointer(a.location, nComponents, GL_UNSIGNED_SHORT, GL_TRUE, 0, reinterpret_cast<void*>(0));
+    }
+    checkGLError();
+    return;
+  }
+
   // Choose the correct type for the buffer
   for (int iArrInd = 0; iArrInd < a.arrayCount; iArrInd++) {
 
@@ -1418,7 +1845,7 @@ bool GLShaderProgram::hasUniform(std::string name) {
 
 // Set an integer
 void GLShaderProgram::setUniform(std::string name, int val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1437,7 +1864,7 @@ void GLShaderProgram::setUniform(std::string name, int val) {
 
 // Set an unsigned integer
 void GLShaderProgram::setUniform(std::string name, unsigned int val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1456,7 +1883,7 @@ void GLShaderProgram::setUniform(std::string name, unsigned int val) {
 
 // Set a float
 void GLShaderProgram::setUniform(std::string name, float val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1475,7 +1902,7 @@ void GLShaderProgram::setUniform(std::string name, float val) {
 
 // Set a double --- WARNING casts down to float
 void GLShaderProgram::setUniform(std::string name, double val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1495,7 +1922,7 @@ void GLShaderProgram::setUniform(std::string name, double val) {
 // Set a 4x4 uniform matrix
 // TODO why do we use a pointer here... makes no sense
 void GLShaderProgram::setUniform(std::string name, float* val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1514,7 +1941,7 @@ void GLShaderProgram::setUniform(std::string name, float* val) {
 
 // Set a vector2 uniform
 void GLShaderProgram::setUniform(std::string name, glm::vec2 val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1533,7 +1960,7 @@ void GLShaderProgram::setUniform(std::string name, glm::vec2 val) {
 
 // Set a vector3 uniform
 void GLShaderProgram::setUniform(std::string name, glm::vec3 val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1552,7 +1979,7 @@ void GLShaderProgram::setUniform(std::string name, glm::vec3 val) {
 
 // Set a vector4 uniform
 void GLShaderProgram::setUniform(std::string name, glm::vec4 val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1571,7 +1998,7 @@ void GLShaderProgram::setUniform(std::string name, glm::vec4 val) {
 
 // Set a vector3 uniform from a float array
 void GLShaderProgram::setUniform(std::string name, std::array<float, 3> val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1590,7 +2017,7 @@ void GLShaderProgram::setUniform(std::string name, std::array<float, 3> val) {
 
 // Set a vec4 uniform
 void GLShaderProgram::setUniform(std::string name, float x, float y, float z, float w) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1609,7 +2036,7 @@ void GLShaderProgram::setUniform(std::string name, float x, float y, float z, fl
 
 // Set a int vector2 uniform
 void GLShaderProgram::setUniform(std::string name, glm::ivec2 val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1628,7 +2055,7 @@ void GLShaderProgram::setUniform(std::string name, glm::ivec2 val) {
 
 // Set a int vector3 uniform
 void GLShaderProgram::setUniform(std::string name, glm::ivec3 val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1647,7 +2074,7 @@ void GLShaderProgram::setUniform(std::string name, glm::ivec3 val) {
 
 // Set a int vector4 uniform
 void GLShaderProgram::setUniform(std::string name, glm::ivec4 val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1666,7 +2093,7 @@ void GLShaderProgram::setUniform(std::string name, glm::ivec4 val) {
 
 // Set a uint vector2 uniform
 void GLShaderProgram::setUniform(std::string name, glm::uvec2 val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1685,7 +2112,7 @@ void GLShaderProgram::setUniform(std::string name, glm::uvec2 val) {
 
 // Set a uint vector3 uniform
 void GLShaderProgram::setUniform(std::string name, glm::uvec3 val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1704,7 +2131,7 @@ void GLShaderProgram::setUniform(std::string name, glm::uvec3 val) {
 
 // Set a uint vector4 uniform
 void GLShaderProgram::setUniform(std::string name, glm::uvec4 val) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   for (GLShaderUniform& u : uniforms) {
     if (u.name == name) {
@@ -1752,7 +2179,7 @@ std::shared_ptr<AttributeBuffer> GLShaderProgram::getAttributeBuffer(std::string
 
 
 void GLShaderProgram::setAttribute(std::string name, const std::vector<glm::vec2>& data) {
-  glBindVertexArray(vaoHandle);
+  bindVertexArray(vaoHandle);
 
   // pass-through to the buffer
   for (GLShaderAttribute& a : attributes) {
@@ -1767,7 +2194,7 @@ void GLShaderProgram::setAttribute(std::string name, const std::vector<glm::vec2
 }
 
 void GLShaderProgram::setAttribute(std::string name, const std::vector<glm::vec3>& data) {
-  glBindVertexArray(vaoHandle); // TODO remove these?
+  bindVertexArray(vaoHandle); // TODO remove these?
 
   // pass-through to the buffer
   for (GLShaderAttribute& a : attributes) {
@@ -1782,7 +2209,7 @@ void GLShaderProgram::setAttribute(std::string name, const std::vector<glm::vec3
 }
 
 void GLShaderProgram::setAttribute(std::string name, const std::vector<glm::vec4>& data) {
-  glBindVertexArray(vaoHandle);
+  bindVertexArray(vaoHandle);
 
   // pass-through to the buffer
   for (GLShaderAttribute& a : attributes) {
@@ -1797,7 +2224,7 @@ void GLShaderProgram::setAttribute(std::string name, const std::vector<glm::vec4
 }
 
 void GLShaderProgram::setAttribute(std::string name, const std::vector<float>& data) {
-  glBindVertexArray(vaoHandle);
+  bindVertexArray(vaoHandle);
 
   // pass-through to the buffer
   for (GLShaderAttribute& a : attributes) {
@@ -1812,7 +2239,7 @@ void GLShaderProgram::setAttribute(std::string name, const std::vector<float>& d
 }
 
 void GLShaderProgram::setAttribute(std::string name, const std::vector<double>& data) {
-  glBindVertexArray(vaoHandle);
+  bindVertexArray(vaoHandle);
 
   // pass-through to the buffer
   for (GLShaderAttribute& a : attributes) {
@@ -1827,7 +2254,7 @@ void GLShaderProgram::setAttribute(std::string name, const std::vector<double>&
 }
 
 void GLShaderProgram::setAttribute(std::string name, const std::vector<int32_t>& data) {
-  glBindVertexArray(vaoHandle);
+  bindVertexArray(vaoHandle);
 
   // pass-through to the buffer
   for (GLShaderAttribute& a : attributes) {
@@ -1842,7 +2269,7 @@ void GLShaderProgram::setAttribute(std::string name, const std::vector<int32_t>&
 }
 
 void GLShaderProgram::setAttribute(std::string name, const std::vector<uint32_t>& data) {
-  glBindVertexArray(vaoHandle);
+  bindVertexArray(vaoHandle);
 
   // pass-through to the buffer
   for (GLShaderAttribute& a : attributes) {
@@ -1857,7 +2284,7 @@ void GLShaderProgram::setAttribute(std::string name, const std::vector<uint32_t>
 }
 
 void GLShaderProgram::setAttribute(std::string name, const std::vector<std::array<glm::vec3, 2>>& data) {
-  glBindVertexArray(vaoHandle);
+  bindVertexArray(vaoHandle);
 
   // pass-through to the buffer
   for (GLShaderAttribute& a : attributes) {
@@ -1873,7 +2300,7 @@ void GLShaderProgram::setAttribute(std::string name, const std::vector<std::arra
 }
 
 void GLShaderProgram::setAttribute(std::string name, const std::vector<std::array<glm::vec3, 3>>& data) {
-  glBindVertexArray(vaoHandle);
+  bindVertexArray(vaoHandle);
 
   // pass-through to the buffer
   for (GLShaderAttribute& a : attributes) {
@@ -1889,7 +2316,7 @@ void GLShaderProgram::setAttribute(std::string name, const std::vector<std::arra
 }
 
 void GLShaderProgram::setAttribute(std::string name, const std::vector<std::array<glm::vec3, 4>>& data) {
-  glBindVertexArray(vaoHandle);
+  bindVertexArray(vaoHandle);
 
   // pass-through to the buffer
   for (GLShaderAttribute& a : attributes) {
@@ -2002,7 +2429,7 @@ void GLShaderProgram::setTexture2D(std::string name, unsigned char* texData, uns
 }
 
 void GLShaderProgram::setTextureFromBuffer(std::string name, TextureBuffer* textureBuffer) {
-  glUseProgram(compiledProgram->getHandle());
+  useProgram(compiledProgram->getHandle());
 
   // Find the right texture
   for (GLShaderTexture& t : textures) {
@@ -2182,6 +2609,18 @@ void GLShaderProgram::validateData() {
       throw std::invalid_argument("Must set instance count to use instanced drawing");
     }
   }
+
+  // Check transform feedback (if applicable)
+  if (drawMode == DrawMode::IndexedPointsTransformFeedback) {
+    if (!transformFeedbackBuffer) {
+      throw std::invalid_argument("Must set transform feedback buffer to use transform feedback drawing");
+    }
+    if (transformFeedbackBuffer->getDataSize() < static_cast<int64_t>(drawDataLength)) {
+      throw std::invalid_argument("Transform feedback buffer is too small. It has size " +
+                                  std::to_string(transformFeedbackBuffer->getDataSize()) + " but " +
+                                  std::to_string(drawDataLength) + " entries will be captured");
+    }
+  }
 }
 
 void GLShaderProgram::setPrimitiveRestartIndex(unsigned int restartIndex_) {
@@ -2194,27 +2633,53 @@ void GLShaderProgram::setPrimitiveRestartIndex(unsigned int restartIndex_) {
 
 void GLShaderProgram::setInstanceCount(uint32_t instanceCount_) { instanceCount = instanceCount_; }
 
+void GLShaderProgram::setDrawRanges(const std::vector<std::array<uint32_t, 2>>& ranges) {
+  if (drawMode != DrawMode::Triangles && drawMode != DrawMode::IndexedTriangles) {
+    exception("setDrawRanges() called, but draw mode does not support draw ranges.");
+  }
+  for (const std::array<uint32_t, 2>& range : ranges) {
+    if (static_cast<uint64_t>(range[0]) + range[1] > drawDataLength) {
+      exception("setDrawRanges() range [" + std::to_string(range[0]) + ", " + std::to_string(range[0] + range[1]) +
+                ") is out of bounds for draw data of length " + std::to_string(drawDataLength));
+    }
+  }
+  useDrawRanges = true;
+  drawRanges = ranges;
+}
+
+void GLShaderProgram::clearDrawRanges() {
+  useDrawRanges = false;
+  drawRanges.clear();
+}
+
+void GLShaderProgram::setTransformFeedbackBuffer(std::shared_ptr<AttributeBuffer> externalBuffer) {
+  if (drawMode != DrawMode::IndexedPointsTransformFeedback) {
+    exception("setTransformFeedbackBuffer() called, but draw mode does not use transform feedback.");
+  }
+
+  // cast to the engine type (booooooo)
+  std::shared_ptr<GLAttributeBuffer> engineExtBuff = std::dynamic_pointer_cast<GLAttributeBuffer>(externalBuffer);
+  if (!engineExtBuff) throw std::invalid_argument("transform feedback external buffer engine type cast failed");
+
+  transformFeedbackBuffer = engineExtBuff;
+}
+
 void GLShaderProgram::activateTextures() {
   for (GLShaderTexture& t : textures) {
     if (t.location == -1) continue;
 
-    glActiveTexture(GL_TEXTURE0 + t.index);
-    t.textureBuffer->bind();
-    glUniform1i(t.location, t.index);
+    bindTextureToUnit(t.index, t.textureBuffer->textureType(), t.textureBuffer->getHandle());
   }
 }
 
 void GLShaderProgram::draw() {
   validateData();
 
-  glUseProgram(compiledProgram->getHandle());
-  glBindVertexArray(vaoHandle);
-
-  if (usePrimitiveRestart) {
-    glEnable(GL_PRIMITIVE_RESTART);
-    glPrimitiveRestartIndex(restartIndex);
-  }
+  if (useDrawRanges && drawRanges.empty()) return; // everything has been culled
 
+  useProgram(compiledProgram->getHandle());
+  bindVertexArray(vaoHandle);
+  setPrimitiveRestart(usePrimitiveRestart, restartIndex);
   activateTextures();
 
   switch (drawMode) {
@@ -2222,7 +2687,17 @@ void GLShaderProgram::draw() {
     glDrawArrays(GL_POINTS, 0, drawDataLength);
     break;
   case DrawMode::Triangles:
-    glDrawArrays(GL_TRIANGLES, 0, drawDataLength);
+    if (useDrawRanges) {
+      std::vector<GLint> starts(drawRanges.size());
+      std::vector<GLsizei> counts(drawRanges.size());
+      for (size_t i = 0; i < drawRanges.size(); i++) {
+        starts[i] = drawRanges[i][0];
+        counts[i] = drawRanges[i][1];
+      }
+      glMultiDrawArrays(GL_TRIANGLES, starts.data(), counts.data(), static_cast<GLsizei>(drawRanges.size()));
+    } else {
+      glDrawArrays(GL_TRIANGLES, 0, drawDataLength);
+    }
     break;
   case DrawMode::Lines:
     glDrawArrays(GL_LINES, 0, drawDataLength);
@@ -2251,7 +2726,18 @@ void GLShaderProgram::draw() {
     break;
   case DrawMode::IndexedTriangles:
     // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexVBO);
-    glDrawElements(GL_TRIANGLES, drawDataLength, GL_UNSIGNED_INT, 0);
+    if (useDrawRanges) {
+      std::vector<GLsizei> counts(drawRanges.size());
+      std::vector<const void*> offsets(drawRanges.size());
+      for (size_t i = 0; i < drawRanges.size(); i++) {
+        counts[i] = drawRanges[i][1];
+        offsets[i] = reinterpret_cast<const void*>(static_cast<size_t>(drawRanges[i][0]) * sizeof(uint32_t));
+      }
+      glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(),
+                          static_cast<GLsizei>(drawRanges.size()));
+    } else {
+      glDrawElements(GL_TRIANGLES, drawDataLength, GL_UNSIGNED_INT, 0);
+    }
     break;
   case DrawMode::TrianglesInstanced:
     glDrawArraysInstanced(GL_TRIANGLES, 0, drawDataLength, instanceCount);
@@ -2259,10 +2745,18 @@ void GLShaderProgram::draw() {
   case DrawMode::TriangleStripInstanced:
     glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, drawDataLength, instanceCount);
     break;
+  case DrawMode::IndexedPointsTransformFeedback: {
+    std::shared_ptr<GLAttributeBuffer> glFeedbackBuff =
+        std::dynamic_pointer_cast<GLAttributeBuffer>(transformFeedbackBuffer);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, glFeedbackBuff->getHandle());
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawElements(GL_POINTS, drawDataLength, GL_UNSIGNED_INT, 0);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    break;
   }
-
-  if (usePrimitiveRestart) {
-    glDisable(GL_PRIMITIVE_RESTART);
   }
 
   checkGLError();
@@ -2273,6 +2767,8 @@ GLEngine::~GLEngine() {}
 
 void GLEngine::checkError(bool fatal) { checkGLError(fatal); }
 
+void GLEngine::invalidateBoundState() { backend_openGL3::invalidateBoundState(); }
+
 std::vector<unsigned char> GLEngine::readDisplayBuffer() {
   // TODO do we need to bind here?
 
@@ -2461,6 +2957,8 @@ std::shared_ptr<FrameBuffer> GLEngine::generateFrameBuffer(unsigned int sizeX_,
   return std::shared_ptr<FrameBuffer>(newF);
 }
 
+std::shared_ptr<TimestampQuery> GLEngine::generateTimestampQuery() { return std::make_shared<GLTimestampQuery>(); }
+
 std::string GLEngine::programKeyFromRules(const std::string& programName, const std::vector<std::string>& rules,
                                           ShaderReplacementDefaults defaults) {
 
@@ -2610,7 +3108,8 @@ void GLEngine::populateDefaultShadersAndRules() {
 
   // == Load general base shaders
   registerShaderProgram("MESH", {FLEX_MESH_VERT_SHADER, FLEX_MESH_FRAG_SHADER}, DrawMode::Triangles);
-  registerShaderProgram("INDEXED_MESH", {FLEX_MESH_VERT_SHADER, FLEX_MESH_FRAG_SHADER}, DrawMode::IndexedTriangles);
+  registerShaderProgram("INDEXED_MESH", {FLEX_MESH_INDEXED_VERT_SHADER, FLEX_MESH_INDEXED_FRAG_SHADER}, DrawMode::IndexedTriangles);
+  registerShaderProgram("INSTANCED_MESH", {INSTANCED_MESH_VERT_SHADER, FLEX_MESH_FRAG_SHADER}, DrawMode::TrianglesInstanced);
   registerShaderProgram("SIMPLE_MESH", {SIMPLE_MESH_VERT_SHADER, SIMPLE_MESH_FRAG_SHADER}, DrawMode::IndexedTriangles);
   registerShaderProgram("SLICE_TETS", {SLICE_TETS_VERT_SHADER, SLICE_TETS_GEOM_SHADER, SLICE_TETS_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("RAYCAST_SPHERE", {FLEX_SPHERE_VERT_SHADER, FLEX_SPHERE_GEOM_SHADER, FLEX_SPHERE_FRAG_SHADER}, DrawMode::Points);
@@ -2641,6 +3140,7 @@ void GLEngine::populateDefaultShadersAndRules() {
   registerShaderProgram("SCALAR_TEXTURE_COLORMAP", {TEXTURE_DRAW_VERT_SHADER, SCALAR_TEXTURE_COLORMAP}, DrawMode::Triangles);
   registerShaderProgram("BLUR_RGB", {TEXTURE_DRAW_VERT_SHADER, BLUR_RGB}, DrawMode::Triangles);
   registerShaderProgram("TRANSFORMATION_GIZMO_ROT", {TRANSFORMATION_GIZMO_ROT_VERT, TRANSFORMATION_GIZMO_ROT_FRAG}, DrawMode::Triangles);
+  registerShaderProgram("BUFFER_INDEX_COPY", {BUFFER_INDEX_COPY_VERT_SHADER}, DrawMode::IndexedPointsTransformFeedback);
 
   // === Load rules
 
@@ -2661,6 +3161,7 @@ void GLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("COMPUTE_SHADE_NORMAL_FROM_POSITION", COMPUTE_SHADE_NORMAL_FROM_POSITION);
   registerShaderRule("PREMULTIPLY_LIT_COLOR", PREMULTIPLY_LIT_COLOR);
   registerShaderRule("CULL_POS_FROM_VIEW", CULL_POS_FROM_VIEW);
+  registerShaderRule("POSITION_QUANTIZED", POSITION_QUANTIZED);
   registerShaderRule("PROJ_AND_INV_PROJ_MAT", PROJ_AND_INV_PROJ_MAT);
   registerShaderRule("BUILD_RAY_FOR_FRAGMENT_PERSPECTIVE", BUILD_RAY_FOR_FRAGMENT_PERSPECTIVE);
   registerShaderRule("BUILD_RAY_FOR_FRAGMENT_ORTHOGRAPHIC", BUILD_RAY_FOR_FRAGMENT_ORTHOGRAPHIC);
@@ -2714,8 +3215,15 @@ void GLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("MESH_PROPAGATE_HALFEDGE_VALUE", MESH_PROPAGATE_HALFEDGE_VALUE);
   registerShaderRule("MESH_PROPAGATE_CULLPOS", MESH_PROPAGATE_CULLPOS);
   registerShaderRule("MESH_PROPAGATE_TYPE_AND_BASECOLOR2_SHADE", MESH_PROPAGATE_TYPE_AND_BASECOLOR2_SHADE);
+  registerShaderRule("MESH_INDEXED_FACE_NORMAL", MESH_INDEXED_FACE_NORMAL);
+  registerShaderRule("MESH_INDEXED_PROPAGATE_CULLPOS", MESH_INDEXED_PROPAGATE_CULLPOS);
+  registerShaderRule("MESH_INDEXED_WIREFRAME", MESH_INDEXED_WIREFRAME);
+  registerShaderRule("MESH_INSTANCED_COLOR", MESH_INSTANCED_COLOR);
+  registerShaderRule("MESH_INSTANCED_PROPAGATE_CULLPOS", MESH_INSTANCED_PROPAGATE_CULLPOS);
+  registerShaderRule("MESH_INSTANCED_PROPAGATE_PICK", MESH_INSTANCED_PROPAGATE_PICK);
   registerShaderRule("MESH_PROPAGATE_PICK", MESH_PROPAGATE_PICK);
   registerShaderRule("MESH_PROPAGATE_PICK_SIMPLE", MESH_PROPAGATE_PICK_SIMPLE);
+  registerShaderRule("MESH_PROPAGATE_PICK_SIMPLE_FROM_INDS", MESH_PROPAGATE_PICK_SIMPLE_FROM_INDS);
 
   // volume gridcube things
   registerShaderRule("GRIDCUBE_PROPAGATE_NODE_VALUE", GRIDCUBE_PROPAGATE_NODE_VALUE);
@@ -2761,6 +3269,20 @@ void GLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("SLICE_TETS_VECTOR_COLOR", SLICE_TETS_VECTOR_COLOR);
   registerShaderRule("SLICE_TETS_MESH_WIREFRAME", SLICE_TETS_MESH_WIREFRAME);
 
+  // buffer copies
+  registerShaderRule("BUFFER_INDEX_COPY_FLOAT", BUFFER_INDEX_COPY_FLOAT);
+  registerShaderRule("BUFFER_INDEX_COPY_VEC2", BUFFER_INDEX_COPY_VEC2);
+  registerShaderRule("BUFFER_INDEX_COPY_VEC3", BUFFER_INDEX_COPY_VEC3);
+  registerShaderRule("BUFFER_INDEX_COPY_VEC4", BUFFER_INDEX_COPY_VEC4);
+  registerShaderRule("BUFFER_INDEX_COPY_INT", BUFFER_INDEX_COPY_INT);
+  registerShaderRule("BUFFER_INDEX_COPY_IVEC2", BUFFER_INDEX_COPY_IVEC2);
+  registerShaderRule("BUFFER_INDEX_COPY_IVEC3", BUFFER_INDEX_COPY_IVEC3);
+  registerShaderRule("BUFFER_INDEX_COPY_IVEC4", BUFFER_INDEX_COPY_IVEC4);
+  registerShaderRule("BUFFER_INDEX_COPY_UINT", BUFFER_INDEX_COPY_UINT);
+  registerShaderRule("BUFFER_INDEX_COPY_UVEC2", BUFFER_INDEX_COPY_UVEC2);
+  registerShaderRule("BUFFER_INDEX_COPY_UVEC3", BUFFER_INDEX_COPY_UVEC3);
+  registerShaderRule("BUFFER_INDEX_COPY_UVEC4", BUFFER_INDEX_COPY_UVEC4);
+
   // clang-format on
 };
 
@@ -548,6 +548,7 @@ void GLEngineEGL::ImGuiNewFrame() {
 void GLEngineEGL::ImGuiRender() {
   ImGui::Render();
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  invalidateBoundState();
   clearResourcesPreservedForImguiFrame();
 }
 
@@ -287,6 +287,7 @@ void GLEngineGLFW::ImGuiNewFrame() {
 void GLEngineGLFW::ImGuiRender() {
   ImGui::Render();
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  invalidateBoundState();
   clearResourcesPreservedForImguiFrame();
 }
 
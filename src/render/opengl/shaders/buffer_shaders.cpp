@@ -0,0 +1,220 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/render/opengl/shaders/buffer_shaders.h"
+
+namespace polyscope {
+namespace render {
+namespace backend_openGL3 {
+
+// clang-format off
+
+// Gathers a_value through an index buffer, writing the result to a_valueOut, which gets captured via transform
+// feedback. One of the BUFFER_INDEX_COPY_* rules below must be used to set the type of the value.
+const ShaderStageSpecification BUFFER_INDEX_COPY_VERT_SHADER =  {
+    
+    ShaderStageType::Vertex,
+    
+    {}, // uniforms
+
+    {}, // attributes (added by rules)
+
+    {}, // textures
+
+    // source
+R"(
+      ${ GLSL_VERSION }$
+
+      ${ VERT_DECLARATIONS }$
+
+      void main()
+      {
+          a_valueOut = a_value;
+      }
+)"
+};
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_FLOAT (
+    /* rule name */ "BUFFER_INDEX_COPY_FLOAT",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in float a_value;
+          out float a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Float},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_VEC2 (
+    /* rule name */ "BUFFER_INDEX_COPY_VEC2",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in vec2 a_value;
+          out vec2 a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Vector2Float},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_VEC3 (
+    /* rule name */ "BUFFER_INDEX_COPY_VEC3",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in vec3 a_value;
+          out vec3 a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Vector3Float},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_VEC4 (
+    /* rule name */ "BUFFER_INDEX_COPY_VEC4",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in vec4 a_value;
+          out vec4 a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Vector4Float},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_INT (
+    /* rule name */ "BUFFER_INDEX_COPY_INT",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in int a_value;
+          flat out int a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Int},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_IVEC2 (
+    /* rule name */ "BUFFER_INDEX_COPY_IVEC2",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in ivec2 a_value;
+          flat out ivec2 a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Vector2Int},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_IVEC3 (
+    /* rule name */ "BUFFER_INDEX_COPY_IVEC3",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in ivec3 a_value;
+          flat out ivec3 a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Vector3Int},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_IVEC4 (
+    /* rule name */ "BUFFER_INDEX_COPY_IVEC4",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in ivec4 a_value;
+          flat out ivec4 a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Vector4Int},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_UINT (
+    /* rule name */ "BUFFER_INDEX_COPY_UINT",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in uint a_value;
+          flat out uint a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::UInt},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_UVEC2 (
+    /* rule name */ "BUFFER_INDEX_COPY_UVEC2",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in uvec2 a_value;
+          flat out uvec2 a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Vector2UInt},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_UVEC3 (
+    /* rule name */ "BUFFER_INDEX_COPY_UVEC3",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in uvec3 a_value;
+          flat out uvec3 a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Vector3UInt},
+    },
+    /* textures */ {}
+);
+
+const ShaderReplacementRule BUFFER_INDEX_COPY_UVEC4 (
+    /* rule name */ "BUFFER_INDEX_COPY_UVEC4",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in uvec4 a_value;
+          flat out uvec4 a_valueOut;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {
+      {"a_value", RenderDataType::Vector4UInt},
+    },
+    /* textures */ {}
+);
+
+// clang-format on
+
+} // namespace backend_openGL3
+} // namespace render
+} // namespace polyscope
@@ -465,6 +465,27 @@ const ShaderReplacementRule CULL_POS_FROM_VIEW (
     /* textures */ {}
 );
 
+// positions stored quantized relative to a bounding box (AttributeStorageFormat::UNorm16) arrive in [0,1], map them
+// back to object space
+const ShaderReplacementRule POSITION_QUANTIZED (
+    /* rule name */ "POSITION_QUANTIZED",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          uniform vec3 u_positionQuantizationOffset;
+          uniform vec3 u_positionQuantizationScale;
+        )"},
+      {"VERT_DECODE_POSITION", R"(
+          position = u_positionQuantizationOffset + position * u_positionQuantizationScale;
+        )"},
+    },
+    /* uniforms */ {
+      {"u_positionQuantizationOffset", RenderDataType::Vector3Float},
+      {"u_positionQuantizationScale", RenderDataType::Vector3Float},
+    },
+    /* attributes */ {},
+    /* textures */ {}
+);
+
 const ShaderReplacementRule BUILD_RAY_FOR_FRAGMENT_PERSPECTIVE(
     /* rule name */ "BUILD_RAY_FOR_FRAGMENT_PERSPECTIVE",
     { /* replacement sources */
@@ -36,7 +36,9 @@ R"(
         
         void main()
         {
-            gl_Position = u_modelView * vec4(a_position, 1.0);
+            vec3 position = a_position;
+            ${ VERT_DECODE_POSITION }$
+            gl_Position = u_modelView * vec4(position, 1.0);
 
             ${ VERT_ASSIGNMENTS }$
         }
@@ -224,7 +226,9 @@ R"(
         
         void main()
         {
-            gl_Position = u_modelView * vec4(a_position, 1.0);
+            vec3 position = a_position;
+            ${ VERT_DECODE_POSITION }$
+            gl_Position = u_modelView * vec4(position, 1.0);
 
             ${ VERT_ASSIGNMENTS }$
         }
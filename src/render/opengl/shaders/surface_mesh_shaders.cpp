@@ -23,7 +23,6 @@ const ShaderStageSpecification FLEX_MESH_VERT_SHADER = {
     {
         {"a_vertexPositions", RenderDataType::Vector3Float},
         {"a_vertexNormals", RenderDataType::Vector3Float},
-        {"a_barycoord", RenderDataType::Vector3Float},
     },
 
     {}, // textures
@@ -39,7 +38,6 @@ R"(
         
         in vec3 a_vertexPositions;
         in vec3 a_vertexNormals;
-        in vec3 a_barycoord;
         out vec3 a_barycoordToFrag;
         out vec3 a_vertexNormalToFrag;
         
@@ -50,7 +48,12 @@ R"(
             gl_Position = u_projMatrix * u_modelView * vec4(a_vertexPositions,1.);
             
             a_vertexNormalToFrag = mat3(u_modelView) * a_vertexNormals;
-            a_barycoordToFrag = a_barycoord;
+
+            // triangles are drawn as consecutive triples of vertices, so the barycentric coordinate of each corner 
+            // follows from its position in the triple
+            int cornerInd = gl_VertexID % 3;
+            vec3 barycoord = vec3(float(cornerInd == 0), float(cornerInd == 1), float(cornerInd == 2));
+            a_barycoordToFrag = barycoord;
 
             ${ VERT_ASSIGNMENTS }$
         }
@@ -112,6 +115,183 @@ R"(
 )"
 };
 
+// Variant of the above for indexed drawing, where vertex data is shared between triangles. Since there are no
+// per-corner attributes, any per-triangle data must be looked up via gl_PrimitiveID in the fragment shader.
+const ShaderStageSpecification FLEX_MESH_INDEXED_VERT_SHADER = {
+
+    ShaderStageType::Vertex,
+
+    // uniforms
+    {
+        {"u_modelView", RenderDataType::Matrix44Float},
+        {"u_projMatrix", RenderDataType::Matrix44Float},
+    }, 
+
+    // attributes
+    {
+        {"a_vertexPositions", RenderDataType::Vector3Float},
+        {"a_vertexNormals", RenderDataType::Vector3Float},
+    },
+
+    {}, // textures
+
+    // source
+R"(
+        ${ GLSL_VERSION }$
+
+        uniform mat4 u_modelView;
+        uniform mat4 u_projMatrix;
+        
+        in vec3 a_vertexPositions;
+        in vec3 a_vertexNormals;
+        out vec3 a_vertexNormalToFrag;
+        out vec3 a_positionToFrag;
+        
+        ${ VERT_DECLARATIONS }$
+        
+        void main()
+        {
+            gl_Position = u_projMatrix * u_modelView * vec4(a_vertexPositions,1.);
+            
+            a_vertexNormalToFrag = mat3(u_modelView) * a_vertexNormals;
+            a_positionToFrag = a_vertexPositions;
+
+            ${ VERT_ASSIGNMENTS }$
+        }
+)"
+};
+
+const ShaderStageSpecification FLEX_MESH_INDEXED_FRAG_SHADER = {
+    
+    ShaderStageType::Fragment,
+    
+    // uniforms
+    {
+    }, 
+
+    { }, // attributes
+    
+    // textures 
+    {
+    },
+ 
+    // source
+R"(
+        ${ GLSL_VERSION }$
+        uniform mat4 u_modelView;
+        in vec3 a_vertexNormalToFrag;
+        in vec3 a_positionToFrag;
+
+        layout(location = 0) out vec4 outputF;
+
+        // index in to a texture which stores per-triangle data in rows
+        ivec2 triangleDataCoord(int ind, ivec2 texSize) {
+          return ivec2(ind % texSize.x, ind / texSize.x);
+        }
+
+        ${ FRAG_DECLARATIONS }$
+
+        void main()
+        {
+           float depth = gl_FragCoord.z;
+           ${ GLOBAL_FRAGMENT_FILTER_PREP }$
+           ${ GLOBAL_FRAGMENT_FILTER }$
+          
+           // Shading
+           vec3 shadeNormal = a_vertexNormalToFrag;
+           ${ GENERATE_SHADE_VALUE }$
+           ${ GENERATE_SHADE_COLOR }$
+           
+           // Handle the wireframe
+           ${ APPLY_WIREFRAME }$
+
+           // Lighting
+           ${ PERTURB_SHADE_NORMAL }$
+           ${ GENERATE_LIT_COLOR }$
+
+           // Set alpha
+           float alphaOut = 1.0;
+           ${ GENERATE_ALPHA }$
+           
+           ${ PERTURB_LIT_COLOR }$
+
+           // Write output
+           litColor *= alphaOut; // premultiplied alpha
+           outputF = vec4(litColor, alphaOut);
+        }
+)"
+};
+
+// Variant of FLEX_MESH_VERT_SHADER which draws many copies of the same mesh. Each instance has its own transform,
+// stored as 4 consecutive texels (the columns) and looked up via gl_InstanceID. Use with FLEX_MESH_FRAG_SHADER.
+const ShaderStageSpecification INSTANCED_MESH_VERT_SHADER = {
+
+    ShaderStageType::Vertex,
+
+    // uniforms
+    {
+        {"u_modelView", RenderDataType::Matrix44Float},
+        {"u_projMatrix", RenderDataType::Matrix44Float},
+    }, 
+
+    // attributes
+    {
+        {"a_vertexPositions", RenderDataType::Vector3Float},
+        {"a_vertexNormals", RenderDataType::Vector3Float},
+    },
+
+    // textures
+    {
+        {"t_instanceTransforms", 2},
+    },
+
+    // source
+R"(
+        ${ GLSL_VERSION }$
+
+        uniform mat4 u_modelView;
+        uniform mat4 u_projMatrix;
+        uniform sampler2D t_instanceTransforms;
+        
+        in vec3 a_vertexPositions;
+        in vec3 a_vertexNormals;
+        out vec3 a_barycoordToFrag;
+        out vec3 a_vertexNormalToFrag;
+
+        // index in to a texture which stores per-instance data in rows
+        ivec2 instanceDataCoord(int ind, ivec2 texSize) {
+          return ivec2(ind % texSize.x, ind / texSize.x);
+        }
+        
+        ${ VERT_DECLARATIONS }$
+        
+        void main()
+        {
+            ivec2 transformTexSize = textureSize(t_instanceTransforms, 0);
+            mat4 instanceTransform = mat4(
+              texelFetch(t_instanceTransforms, instanceDataCoord(4*gl_InstanceID + 0, transformTexSize), 0),
+              texelFetch(t_instanceTransforms, instanceDataCoord(4*gl_InstanceID + 1, transformTexSize), 0),
+              texelFetch(t_instanceTransforms, instanceDataCoord(4*gl_InstanceID + 2, transformTexSize), 0),
+              texelFetch(t_instanceTransforms, instanceDataCoord(4*gl_InstanceID + 3, transformTexSize), 0)
+            );
+            mat4 instanceModelView = u_modelView * instanceTransform;
+
+            gl_Position = u_projMatrix * instanceModelView * vec4(a_vertexPositions,1.);
+            
+            // (assumes the instance transforms do not scale non-uniformly)
+            a_vertexNormalToFrag = mat3(instanceModelView) * a_vertexNormals;
+
+            // triangles are drawn as consecutive triples of vertices, so the barycentric coordinate of each corner 
+            // follows from its position in the triple
+            int cornerInd = gl_VertexID % 3;
+            vec3 barycoord = vec3(float(cornerInd == 0), float(cornerInd == 1), float(cornerInd == 2));
+            a_barycoordToFrag = barycoord;
+
+            ${ VERT_ASSIGNMENTS }$
+        }
+)"
+};
+
 const ShaderStageSpecification SIMPLE_MESH_VERT_SHADER = {
 
     ShaderStageType::Vertex,
@@ -322,26 +502,26 @@ const ShaderReplacementRule MESH_PROPAGATE_VALUE_CORNER_NEAREST (
           // This is a trick to get that behavior, by adjusting the value of the barycoords before
           // interpolation (can be shown to work by considering adding the post-interpolated coordinates 
           // if they match, then doing some algebra to pull it out before interpolation)
-          vec3 boostedBarycoords = a_barycoord;
+          vec3 boostedBarycoords = barycoord;
           if(a_value3.x == a_value3.y) {
-            boostedBarycoords.x += a_barycoord.y;
-            boostedBarycoords.y += a_barycoord.x;
+            boostedBarycoords.x += barycoord.y;
+            boostedBarycoords.y += barycoord.x;
           }
           if(a_value3.y == a_value3.z) {
-            boostedBarycoords.y += a_barycoord.z;
-            boostedBarycoords.z += a_barycoord.y;
+            boostedBarycoords.y += barycoord.z;
+            boostedBarycoords.z += barycoord.y;
           }
           if(a_value3.z == a_value3.x) {
-            boostedBarycoords.z += a_barycoord.x;
-            boostedBarycoords.x += a_barycoord.z;
+            boostedBarycoords.z += barycoord.x;
+            boostedBarycoords.x += barycoord.z;
           }
 
-          // boostedBarycoords.y += a_barycoord.x * float(a_value3.x == a_value3.y);
-          // boostedBarycoords.z += a_barycoord.x * float(a_value3.x == a_value3.z);
-          // boostedBarycoords.x += a_barycoord.y * float(a_value3.y == a_value3.x);
-          // boostedBarycoords.z += a_barycoord.y * float(a_value3.y == a_value3.z);
-          // boostedBarycoords.x += a_barycoord.z * float(a_value3.z == a_value3.x);
-          // boostedBarycoords.y += a_barycoord.z * float(a_value3.z == a_value3.y);
+          // boostedBarycoords.y += barycoord.x * float(a_value3.x == a_value3.y);
+          // boostedBarycoords.z += barycoord.x * float(a_value3.x == a_value3.z);
+          // boostedBarycoords.x += barycoord.y * float(a_value3.y == a_value3.x);
+          // boostedBarycoords.z += barycoord.y * float(a_value3.y == a_value3.z);
+          // boostedBarycoords.x += barycoord.z * float(a_value3.z == a_value3.x);
+          // boostedBarycoords.y += barycoord.z * float(a_value3.z == a_value3.y);
 
           a_boostedBarycoordsToFrag = boostedBarycoords;
         )"},
@@ -490,11 +670,16 @@ const ShaderReplacementRule MESH_WIREFRAME_FROM_BARY(
     /* rule name */ "MESH_WIREFRAME_FROM_BARY",
     { /* replacement sources */
       {"VERT_DECLARATIONS", R"(
-          in vec3 a_edgeIsReal;
+          uniform sampler2D t_triangleEdgeFlags;
           out vec3 a_edgeIsRealToFrag;
         )"},
       {"VERT_ASSIGNMENTS", R"(
-          a_edgeIsRealToFrag = a_edgeIsReal;
+          // edge flags are packed as bits, one texel per triangle
+          int edgeFlagTri = gl_VertexID / 3;
+          ivec2 edgeFlagTexSize = textureSize(t_triangleEdgeFlags, 0);
+          ivec2 edgeFlagCoord = ivec2(edgeFlagTri % edgeFlagTexSize.x, edgeFlagTri / edgeFlagTexSize.x);
+          int edgeFlags = int(texelFetch(t_triangleEdgeFlags, edgeFlagCoord, 0).r + 0.5);
+          a_edgeIsRealToFrag = vec3(edgeFlags & 1, (edgeFlags >> 1) & 1, (edgeFlags >> 2) & 1);
         )"},
       {"FRAG_DECLARATIONS", R"(
           in vec3 a_edgeIsRealToFrag;
@@ -505,12 +690,209 @@ const ShaderReplacementRule MESH_WIREFRAME_FROM_BARY(
       )"},
     },
     /* uniforms */ { },
+    /* attributes */ { },
+    /* textures */ {
+      {"t_triangleEdgeFlags", 2},
+    }
+);
+
+// Per-triangle data for indexed drawing, looked up via gl_PrimitiveID
+
+const ShaderReplacementRule MESH_INDEXED_FACE_NORMAL (
+    /* rule name */ "MESH_INDEXED_FACE_NORMAL",
+    { /* replacement sources */
+      {"FRAG_DECLARATIONS", R"(
+          uniform sampler2D t_triangleFaceNormals;
+        )"},
+      {"GENERATE_SHADE_VALUE", R"(
+          ivec2 faceNormalCoord = triangleDataCoord(gl_PrimitiveID, textureSize(t_triangleFaceNormals, 0));
+          shadeNormal = mat3(u_modelView) * texelFetch(t_triangleFaceNormals, faceNormalCoord, 0).xyz;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {},
+    /* textures */ {
+      {"t_triangleFaceNormals", 2},
+    }
+);
+
+const ShaderReplacementRule MESH_INDEXED_PROPAGATE_CULLPOS (
+    /* rule name */ "MESH_INDEXED_PROPAGATE_CULLPOS",
+    { /* replacement sources */
+      {"FRAG_DECLARATIONS", R"(
+          uniform sampler2D t_triangleFaceCenters;
+        )"},
+      {"GLOBAL_FRAGMENT_FILTER_PREP", R"(
+          ivec2 faceCenterCoord = triangleDataCoord(gl_PrimitiveID, textureSize(t_triangleFaceCenters, 0));
+          vec3 cullPos = vec3(u_modelView * vec4(texelFetch(t_triangleFaceCenters, faceCenterCoord, 0).xyz, 1.));
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {},
+    /* textures */ {
+      {"t_triangleFaceCenters", 2},
+    }
+);
+
+// Recovers barycentric coordinates from the triangle's corner positions, rather than interpolating them from
+// per-corner data. Corner positions are stored as 3 consecutive texels for each triangle.
+const ShaderReplacementRule MESH_INDEXED_WIREFRAME(
+    /* rule name */ "MESH_INDEXED_WIREFRAME",
+    { /* replacement sources */
+      {"FRAG_DECLARATIONS", R"(
+          uniform sampler2D t_triangleCornerPositions;
+          uniform sampler2D t_triangleEdgeFlags;
+
+          vec3 baryCoordsInTriangle(vec3 p, vec3 pA, vec3 pB, vec3 pC) {
+            vec3 e0 = pB - pA;
+            vec3 e1 = pC - pA;
+            vec3 e2 = p - pA;
+            float d00 = dot(e0, e0);
+            float d01 = dot(e0, e1);
+            float d11 = dot(e1, e1);
+            float d20 = dot(e2, e0);
+            float d21 = dot(e2, e1);
+            float denom = d00 * d11 - d01 * d01;
+            float v = (d11 * d20 - d01 * d21) / denom;
+            float w = (d00 * d21 - d01 * d20) / denom;
+            return vec3(1. - v - w, v, w);
+          }
+        )"},
+      {"APPLY_WIREFRAME", R"(
+          ivec2 cornerTexSize = textureSize(t_triangleCornerPositions, 0);
+          vec3 wireframe_pA = texelFetch(t_triangleCornerPositions, triangleDataCoord(3*gl_PrimitiveID + 0, cornerTexSize), 0).xyz;
+          vec3 wireframe_pB = texelFetch(t_triangleCornerPositions, triangleDataCoord(3*gl_PrimitiveID + 1, cornerTexSize), 0).xyz;
+          vec3 wireframe_pC = texelFetch(t_triangleCornerPositions, triangleDataCoord(3*gl_PrimitiveID + 2, cornerTexSize), 0).xyz;
+          vec3 wireframe_UVW = baryCoordsInTriangle(a_positionToFrag, wireframe_pA, wireframe_pB, wireframe_pC);
+          
+          // edge flags are packed as bits
+          ivec2 edgeFlagCoord = triangleDataCoord(gl_PrimitiveID, textureSize(t_triangleEdgeFlags, 0));
+          int wireframe_flags = int(texelFetch(t_triangleEdgeFlags, edgeFlagCoord, 0).r + 0.5);
+          vec3 wireframe_mask = vec3(wireframe_flags & 1, (wireframe_flags >> 1) & 1, (wireframe_flags >> 2) & 1);
+      )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {},
+    /* textures */ {
+      {"t_triangleCornerPositions", 2},
+      {"t_triangleEdgeFlags", 2},
+    }
+);
+
+// Per-instance data for INSTANCED_MESH_VERT_SHADER, looked up via gl_InstanceID
+
+const ShaderReplacementRule MESH_INSTANCED_COLOR (
+    /* rule name */ "MESH_INSTANCED_COLOR",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          uniform sampler2D t_instanceColors;
+          flat out vec3 a_instanceColorToFrag;
+        )"},
+      {"VERT_ASSIGNMENTS", R"(
+          ivec2 instanceColorCoord = instanceDataCoord(gl_InstanceID, textureSize(t_instanceColors, 0));
+          a_instanceColorToFrag = texelFetch(t_instanceColors, instanceColorCoord, 0).xyz;
+        )"},
+      {"FRAG_DECLARATIONS", R"(
+          flat in vec3 a_instanceColorToFrag;
+        )"},
+      {"GENERATE_SHADE_VALUE", R"(
+          vec3 shadeColor = a_instanceColorToFrag;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {},
+    /* textures */ {
+      {"t_instanceColors", 2},
+    }
+);
+
+const ShaderReplacementRule MESH_INSTANCED_PROPAGATE_CULLPOS (
+    /* rule name */ "MESH_INSTANCED_PROPAGATE_CULLPOS",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          in vec3 a_cullPos;
+          out vec3 a_cullPosFrag;
+        )"},
+      {"VERT_ASSIGNMENTS", R"(
+          a_cullPosFrag = vec3(instanceModelView * vec4(a_cullPos, 1.));
+        )"},
+      {"FRAG_DECLARATIONS", R"(
+          in vec3 a_cullPosFrag;
+        )"},
+      {"GLOBAL_FRAGMENT_FILTER_PREP", R"(
+          vec3 cullPos = a_cullPosFrag;
+        )"},
+    },
+    /* uniforms */ {},
     /* attributes */ {
-      {"a_edgeIsReal", RenderDataType::Vector3Float},
+      {"a_cullPos", RenderDataType::Vector3Float},
     },
     /* textures */ {}
 );
 
+// Like MESH_PROPAGATE_PICK_SIMPLE, but the pick colors are of indices within one instance, which are offset by the
+// first index of each instance. Pick colors pack 22 bits of the index in to each channel (see pick.ipp), so this adds
+// channel-by-channel with carries. Every step is exact in single precision.
+const ShaderReplacementRule MESH_INSTANCED_PROPAGATE_PICK (
+    /* rule name */ "MESH_INSTANCED_PROPAGATE_PICK",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          uniform sampler2D t_instancePickColors;
+          in vec3 a_vertexColors[3];
+          in vec3 a_faceColor;
+          flat out vec3 vertexColors[3];
+          flat out vec3 faceColor;
+
+          vec3 addPickColors(vec3 a, vec3 b) {
+            float factor = 4194304.; // 2^22
+            vec3 sum = (a + b) * factor;
+            float carryLow = floor(sum.x / factor);
+            sum.x -= carryLow * factor;
+            sum.y += carryLow;
+            float carryMed = floor(sum.y / factor);
+            sum.y -= carryMed * factor;
+            sum.z += carryMed;
+            return sum / factor;
+          }
+        )"},
+      {"VERT_ASSIGNMENTS", R"(
+          ivec2 instancePickCoord = instanceDataCoord(gl_InstanceID, textureSize(t_instancePickColors, 0));
+          vec3 instancePickColor = texelFetch(t_instancePickColors, instancePickCoord, 0).xyz;
+          for(int i = 0; i < 3; i++) {
+              vertexColors[i] = addPickColors(a_vertexColors[i], instancePickColor);
+          }
+          faceColor = addPickColors(a_faceColor, instancePickColor);
+        )"},
+      {"FRAG_DECLARATIONS", R"(
+          flat in vec3 vertexColors[3];
+          flat in vec3 faceColor;
+          uniform float u_vertPickRadius;
+        )"},
+      {"GENERATE_SHADE_VALUE", R"(
+          vec3 shadeColor = faceColor;
+
+          // Test vertices
+          float nearestRad = 1.0-u_vertPickRadius;
+          for(int i = 0; i < 3; i++) {
+              if(a_barycoordToFrag[i] > nearestRad) {
+                nearestRad = a_barycoordToFrag[i];
+                shadeColor = vertexColors[i];
+              }
+          }
+        )"},
+    },
+    /* uniforms */ {
+      {"u_vertPickRadius", RenderDataType::Float},
+    },
+    /* attributes */ {
+      {"a_vertexColors", RenderDataType::Vector3Float, 3},
+      {"a_faceColor", RenderDataType::Vector3Float},
+    },
+    /* textures */ {
+      {"t_instancePickColors", 2},
+    }
+);
+
 const ShaderReplacementRule MESH_WIREFRAME(
     /* rule name */ "MESH_WIREFRAME",
     { /* replacement sources */
@@ -730,6 +1112,71 @@ const ShaderReplacementRule MESH_PROPAGATE_PICK_SIMPLE ( // this one does faces
     /* textures */ {}
 );
 
+// Like MESH_PROPAGATE_PICK_SIMPLE, but rather than taking pick colors as attributes, computes them from a per-triangle
+// texture of element indices (3 vertices then the face, stored as floats), looked up via gl_VertexID. The indices are
+// converted to pick colors and added to the start of each range channel-by-channel, like pick::indToVec().
+const ShaderReplacementRule MESH_PROPAGATE_PICK_SIMPLE_FROM_INDS (
+    /* rule name */ "MESH_PROPAGATE_PICK_SIMPLE_FROM_INDS",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          uniform sampler2D t_trianglePickInds;
+          uniform vec3 u_vertexPickStart;
+          uniform vec3 u_facePickStart;
+          flat out vec3 vertexColors[3];
+          flat out vec3 faceColor;
+
+          // start + ind, as a pick color. Each step is exact in single precision for ind < 2^24.
+          vec3 offsetPickColor(vec3 start, float ind) {
+            float factor = 4194304.; // 2^22
+            float indHigh = floor(ind / factor);
+            vec3 sum = start * factor + vec3(ind - indHigh * factor, indHigh, 0.);
+            float carryLow = floor(sum.x / factor);
+            sum.x -= carryLow * factor;
+            sum.y += carryLow;
+            float carryMed = floor(sum.y / factor);
+            sum.y -= carryMed * factor;
+            sum.z += carryMed;
+            return sum / factor;
+          }
+        )"},
+      {"VERT_ASSIGNMENTS", R"(
+          int pickTri = gl_VertexID / 3;
+          ivec2 pickTexSize = textureSize(t_trianglePickInds, 0);
+          vec4 pickInds = texelFetch(t_trianglePickInds, ivec2(pickTri % pickTexSize.x, pickTri / pickTexSize.x), 0);
+          for(int i = 0; i < 3; i++) {
+              vertexColors[i] = offsetPickColor(u_vertexPickStart, pickInds[i]);
+          }
+          faceColor = offsetPickColor(u_facePickStart, pickInds.w);
+        )"},
+      {"FRAG_DECLARATIONS", R"(
+          flat in vec3 vertexColors[3];
+          flat in vec3 faceColor;
+          uniform float u_vertPickRadius;
+        )"},
+      {"GENERATE_SHADE_VALUE", R"(
+          vec3 shadeColor = faceColor;
+
+          // Test vertices
+          float nearestRad = 1.0-u_vertPickRadius;
+          for(int i = 0; i < 3; i++) {
+              if(a_barycoordToFrag[i] > nearestRad) {
+                nearestRad = a_barycoordToFrag[i];
+                shadeColor = vertexColors[i];
+              }
+          }
+        )"},
+    },
+    /* uniforms */ {
+      {"u_vertexPickStart", RenderDataType::Vector3Float},
+      {"u_facePickStart", RenderDataType::Vector3Float},
+      {"u_vertPickRadius", RenderDataType::Float},
+    },
+    /* attributes */ {},
+    /* textures */ {
+      {"t_trianglePickInds", 2},
+    }
+);
+
 
 // clang-format on
 
@@ -1,6 +1,7 @@
 // Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
 
 
+#include <cstring>
 #include <vector>
 
 #include "polyscope/render/engine.h"
@@ -313,6 +314,40 @@ std::vector<glm::uvec4> getAttributeBufferDataRange<glm::uvec4>(AttributeBuffer&
   return buff.getDataRange_uvec4(ind, count);
 }
 
+// == Convert readback bytes
+
+template <typename T>
+std::vector<T> attributeBufferDataFromBytes(const std::vector<unsigned char>& bytes) {
+  // the device layout matches the host layout for all types except double, which is stored as float
+  std::vector<T> out(bytes.size() / sizeof(T));
+  if (!out.empty()) std::memcpy(&out.front(), &bytes.front(), out.size() * sizeof(T));
+  return out;
+}
+
+template <>
+std::vector<double> attributeBufferDataFromBytes<double>(const std::vector<unsigned char>& bytes) {
+  std::vector<float> floatValues = attributeBufferDataFromBytes<float>(bytes);
+  return std::vector<double>(floatValues.begin(), floatValues.end());
+}
+
+// clang-format off
+template std::vector<float> attributeBufferDataFromBytes<float>(const std::vector<unsigned char>& bytes);
+template std::vector<glm::vec2> attributeBufferDataFromBytes<glm::vec2>(const std::vector<unsigned char>& bytes);
+template std::vector<glm::vec3> attributeBufferDataFromBytes<glm::vec3>(const std::vector<unsigned char>& bytes);
+template std::vector<glm::vec4> attributeBufferDataFromBytes<glm::vec4>(const std::vector<unsigned char>& bytes);
+template std::vector<std::array<glm::vec3, 2>> attributeBufferDataFromBytes<std::array<glm::vec3, 2>>(const std::vector<unsigned char>& bytes);
+template std::vector<std::array<glm::vec3, 3>> attributeBufferDataFromBytes<std::array<glm::vec3, 3>>(const std::vector<unsigned char>& bytes);
+template std::vector<std::array<glm::vec3, 4>> attributeBufferDataFromBytes<std::array<glm::vec3, 4>>(const std::vector<unsigned char>& bytes);
+template std::vector<int32_t> attributeBufferDataFromBytes<int32_t>(const std::vector<unsigned char>& bytes);
+template std::vector<glm::ivec2> attributeBufferDataFromBytes<glm::ivec2>(const std::vector<unsigned char>& bytes);
+template std::vector<glm::ivec3> attributeBufferDataFromBytes<glm::ivec3>(const std::vector<unsigned char>& bytes);
+template std::vector<glm::ivec4> attributeBufferDataFromBytes<glm::ivec4>(const std::vector<unsigned char>& bytes);
+template std::vector<uint32_t> attributeBufferDataFromBytes<uint32_t>(const std::vector<unsigned char>& bytes);
+template std::vector<glm::uvec2> attributeBufferDataFromBytes<glm::uvec2>(const std::vector<unsigned char>& bytes);
+template std::vector<glm::uvec3> attributeBufferDataFromBytes<glm::uvec3>(const std::vector<unsigned char>& bytes);
+template std::vector<glm::uvec4> attributeBufferDataFromBytes<glm::uvec4>(const std::vector<unsigned char>& bytes);
+// clang-format on
+
 // ==========================================================
 // === Texture buffers
 // ==========================================================
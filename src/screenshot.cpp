@@ -11,7 +11,9 @@
 #include "implot.h"
 
 #include <algorithm>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace polyscope {
 
@@ -25,6 +27,19 @@ size_t screenshotInd = 0;
 // Helper functions
 namespace {
 
+// Screenshots taken with ScreenshotOptions::async, which are waiting for their pixels to be read back
+struct PendingScreenshot {
+  std::string filename;
+  std::shared_ptr<render::ReadbackRequest> readback;
+  int w, h;
+  bool transparentBackground;
+};
+std::vector<PendingScreenshot> pendingScreenshots;
+
+// Don't let too many readbacks pile up if screenshots are taken faster than frames are drawn
+const size_t maxPendingScreenshots = 3;
+
+
 bool hasExtension(std::string str, std::string ext) {
 
   std::transform(str.begin(), str.end(), str.begin(), ::tolower);
@@ -37,13 +52,14 @@ bool hasExtension(std::string str, std::string ext) {
   }
 }
 
-// Helper to actually do the render pass and return the result in a buffer
-std::vector<unsigned char> getRenderInBuffer(const ScreenshotOptions& options = {}) {
+// Helper to do the render pass for a screenshot. The result is left in displayBufferAlt, read it and then call
+// endScreenshotRender(). Returns false if the render could not be performed.
+bool beginScreenshotRender(const ScreenshotOptions& options) {
   checkInitialized();
 
   if (options.includeUI && internal::contextStackSize > 1) {
     error("Screenshot with includeUI=true is not supported within show(). See docs for details and workarounds.");
-    return std::vector<unsigned char>();
+    return false;
   }
 
   render::engine->useAltDisplayBuffer = true;
@@ -122,27 +138,48 @@ std::vector<unsigned char> getRenderInBuffer(const ScreenshotOptions& options =
     requestRedraw();
   }
 
+  return true;
+}
+
+void endScreenshotRender(const ScreenshotOptions& options) {
+  render::engine->useAltDisplayBuffer = false;
+  if (options.transparentBackground) render::engine->lightCopy = false;
+}
+
+void setOpaqueAlpha(std::vector<unsigned char>& buff, int w, int h) {
+  for (int j = 0; j < h; j++) {
+    for (int i = 0; i < w; i++) {
+      int ind = i + j * w;
+      buff[4 * ind + 3] = std::numeric_limits<unsigned char>::max();
+    }
+  }
+}
+
+// Helper to actually do the render pass and return the result in a buffer
+std::vector<unsigned char> getRenderInBuffer(const ScreenshotOptions& options = {}) {
+  if (!beginScreenshotRender(options)) return std::vector<unsigned char>();
+
   // these _should_ always be accurate
   int w = view::bufferWidth;
   int h = view::bufferHeight;
   std::vector<unsigned char> buff = render::engine->displayBufferAlt->readBuffer();
+  endScreenshotRender(options);
 
-  // Set alpha to 1
   if (!options.transparentBackground) {
-    for (int j = 0; j < h; j++) {
-      for (int i = 0; i < w; i++) {
-        int ind = i + j * w;
-        buff[4 * ind + 3] = std::numeric_limits<unsigned char>::max();
-      }
-    }
+    setOpaqueAlpha(buff, w, h);
   }
 
-  render::engine->useAltDisplayBuffer = false;
-  if (options.transparentBackground) render::engine->lightCopy = false;
-
   return buff;
 }
 
+void writePendingScreenshot(PendingScreenshot& pending) {
+  std::vector<unsigned char> buff = pending.readback->getBytes();
+  if (!pending.transparentBackground) {
+    setOpaqueAlpha(buff, pending.w, pending.h);
+  }
+  saveImage(pending.filename, &(buff.front()), pending.w, pending.h, 4);
+}
+
 
 } // namespace
 
@@ -183,6 +220,22 @@ void screenshot(std::string filename, const ScreenshotOptions& options) {
     thisOptions.transparentBackground = false;
   }
 
+  if (thisOptions.async) {
+    // Queue the readback, the file gets written on a later frame
+    if (!beginScreenshotRender(thisOptions)) return;
+    PendingScreenshot pending{filename, render::engine->displayBufferAlt->readBufferAsync(), view::bufferWidth,
+                              view::bufferHeight, thisOptions.transparentBackground};
+    endScreenshotRender(thisOptions);
+    pendingScreenshots.push_back(pending);
+
+    processPendingScreenshots();
+    while (pendingScreenshots.size() > maxPendingScreenshots) {
+      writePendingScreenshot(pendingScreenshots.front());
+      pendingScreenshots.erase(pendingScreenshots.begin());
+    }
+    return;
+  }
+
   std::vector<unsigned char> buff = getRenderInBuffer(thisOptions);
   int w = view::bufferWidth;
   int h = view::bufferHeight;
@@ -191,6 +244,23 @@ void screenshot(std::string filename, const ScreenshotOptions& options) {
   saveImage(filename, &(buff.front()), w, h, 4);
 }
 
+void processPendingScreenshots() {
+  // write them in order, stopping at the first which has not arrived yet
+  size_t nDone = 0;
+  while (nDone < pendingScreenshots.size() && pendingScreenshots[nDone].readback->isReady()) {
+    writePendingScreenshot(pendingScreenshots[nDone]);
+    nDone++;
+  }
+  pendingScreenshots.erase(pendingScreenshots.begin(), pendingScreenshots.begin() + nDone);
+}
+
+void flushScreenshots() {
+  for (PendingScreenshot& pending : pendingScreenshots) {
+    writePendingScreenshot(pending);
+  }
+  pendingScreenshots.clear();
+}
+
 void screenshot(std::string filename, bool transparentBG) {
   ScreenshotOptions options;
   options.transparentBackground = transparentBG;
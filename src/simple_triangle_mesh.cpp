@@ -2,6 +2,7 @@
 
 #include "polyscope/simple_triangle_mesh.h"
 
+#include "polyscope/mesh_reordering.h"
 #include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/render/engine.h"
@@ -25,6 +26,7 @@ SimpleTriangleMesh::SimpleTriangleMesh(std::string name, std::vector<glm::vec3>
       faces(this, uniquePrefix() + "faces", facesData), 
       verticesData(std::move(vertices_)),
       facesData(std::move(faces_)),
+      drawFaces(this, uniquePrefix() + "drawFaces", drawFacesData, std::bind(&SimpleTriangleMesh::computeDrawFaces, this)),
       surfaceColor(uniquePrefix() + "surfaceColor", getNextUniqueColor()),
       material(uniquePrefix() + "material", "clay"),
       backFacePolicy(uniquePrefix() + "backFacePolicy", BackFacePolicy::Different),
@@ -256,7 +258,37 @@ std::vector<std::string> SimpleTriangleMesh::addSimpleTriangleMeshRules(std::vec
 
 void SimpleTriangleMesh::setSimpleTriangleMeshProgramGeometryAttributes(render::ShaderProgram& p) {
   p.setAttribute("a_vertexPositions", vertices.getRenderAttributeBuffer());
-  p.setIndex(faces.getRenderAttributeBuffer());
+  if (options::optimizeMeshDrawOrder) {
+    p.setIndex(drawFaces.getRenderAttributeBuffer());
+  } else {
+    p.setIndex(faces.getRenderAttributeBuffer());
+  }
+}
+
+void SimpleTriangleMesh::computeDrawFaces() {
+
+  vertices.ensureHostBufferPopulated();
+  faces.ensureHostBufferPopulated();
+
+  std::vector<uint32_t> triangleVertexInds(3 * faces.data.size());
+  for (size_t iF = 0; iF < faces.data.size(); iF++) {
+    for (int k = 0; k < 3; k++) {
+      uint32_t iV = faces.data[iF][k];
+      if (iV >= vertices.data.size()) {
+        exception("SimpleTriangleMesh " + name + " has face vertex index " + std::to_string(iV) +
+                  " out of bounds for number of vertices " + std::to_string(vertices.data.size()));
+      }
+      triangleVertexInds[3 * iF + k] = iV;
+    }
+  }
+
+  std::vector<uint32_t> order = computeTriangleDrawOrder(vertices.data, triangleVertexInds);
+  drawFaces.data.resize(faces.data.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    drawFaces.data[i] = faces.data[order[i]];
+  }
+
+  drawFaces.markHostBufferUpdated();
 }
 
 
@@ -267,9 +299,14 @@ void SimpleTriangleMesh::refresh() {
   Structure::refresh(); // call base class version, which refreshes quantities
 }
 
+bool SimpleTriangleMesh::ensureCullingBoundsCurrent() {
+  return ensureBoundsCurrentWith(vertices, boundsPositionsUpdateCount);
+}
+
 void SimpleTriangleMesh::updateObjectSpaceBounds() {
 
   vertices.ensureHostBufferPopulated();
+  boundsPositionsUpdateCount = vertices.getUpdateCount();
 
   // bounding box
   glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
@@ -311,6 +348,42 @@ void SimpleTriangleMesh::buildPickUI(const PickResult& rawResult) {
 }
 
 
+void SimpleTriangleMesh::ensureHaveBVH() {
+  if (bvh.isBuilt() && bvhVerticesUpdateCount == vertices.getUpdateCount() &&
+      bvhFacesUpdateCount == faces.getUpdateCount()) {
+    return;
+  }
+
+  vertices.ensureHostBufferPopulated();
+  faces.ensureHostBufferPopulated();
+  std::vector<uint32_t> triangleVertexInds(3 * faces.data.size());
+  for (size_t iF = 0; iF < faces.data.size(); iF++) {
+    for (size_t k = 0; k < 3; k++) triangleVertexInds[3 * iF + k] = faces.data[iF][k];
+  }
+  bvh.build(vertices.data, triangleVertexInds);
+  bvhVerticesUpdateCount = vertices.getUpdateCount();
+  bvhFacesUpdateCount = faces.getUpdateCount();
+}
+
+RayCastResult SimpleTriangleMesh::rayCast(glm::vec3 origin, glm::vec3 dir, float tMin, float tMax) {
+  RayCastResult result;
+  ensureHaveBVH();
+
+  bool cullBackfaces = backFacePolicy.get() == BackFacePolicy::Cull;
+  TriangleRayHit hit = rayCastTriangles(bvh, origin, dir, tMin, tMax, cullBackfaces, result);
+  if (!hit.isHit) return result;
+
+  result.faceIndex = hit.triangle;
+  for (size_t k = 0; k < 3; k++) result.triangleVertices[k] = faces.data[hit.triangle][k];
+  return result;
+}
+
+bool SimpleTriangleMesh::canRayCastPick() { return true; }
+
+uint64_t SimpleTriangleMesh::rayCastPickIndex(const RayCastResult& hit) {
+  return 0; // the whole structure is picked as one
+}
+
 std::string SimpleTriangleMesh::typeName() { return structureTypeName; }
 
 // === Option getters and setters
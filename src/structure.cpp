@@ -3,6 +3,7 @@
 #include "polyscope/structure.h"
 
 #include "polyscope/floating_quantity.h"
+#include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/quantity.h"
 
@@ -10,6 +11,10 @@
 
 #include "imgui.h"
 
+#include <array>
+#include <cmath>
+#include <limits>
+
 namespace polyscope {
 
 Structure::Structure(std::string name_, std::string subtypeName_)
@@ -251,6 +256,107 @@ void Structure::rescaleToUnit() {
 
 bool Structure::hasExtents() { return true; }
 
+bool Structure::isCulledByFrustum(const glm::mat4& viewProjMat) {
+  std::array<glm::vec3, 8> corners;
+  if (!options::enableCulling || !getCullingBoxCorners(corners)) return false;
+
+  std::array<glm::vec4, 8> clipCorners;
+  for (size_t i = 0; i < 8; i++) {
+    clipCorners[i] = viewProjMat * glm::vec4(corners[i], 1.);
+  }
+
+  // The box is outside of the frustum if all of its corners are outside of the same clip plane
+  for (int k = 0; k < 3; k++) {
+    bool allBelow = true;
+    bool allAbove = true;
+    for (const glm::vec4& c : clipCorners) {
+      if (c[k] >= -c.w) allBelow = false;
+      if (c[k] <= c.w) allAbove = false;
+    }
+    if (allBelow || allAbove) return true;
+  }
+  return false;
+}
+
+bool Structure::isCulledBySlicePlanes() {
+  std::array<glm::vec3, 8> corners;
+  if (!options::enableCulling || !getCullingBoxCorners(corners)) return false;
+
+  for (std::unique_ptr<SlicePlane>& s : state::slicePlanes) {
+    if (!s->getEnabled() || getIgnoreSlicePlane(s->name)) continue;
+    glm::vec3 center = s->getCenter();
+    glm::vec3 normal = s->getNormal();
+    bool allRemoved = true;
+    for (const glm::vec3& c : corners) {
+      if (glm::dot(c - center, normal) >= 0.) allRemoved = false;
+    }
+    if (allRemoved) return true;
+  }
+  return false;
+}
+
+float Structure::getCullingPadding() {
+  float padding = 0.;
+  for (auto& x : quantities) {
+    if (x.second->isEnabled()) padding = std::max(padding, x.second->getCullingPadding());
+  }
+  for (auto& x : floatingQuantities) {
+    if (x.second->isEnabled()) padding = std::max(padding, x.second->getCullingPadding());
+  }
+  return padding;
+}
+
+bool Structure::ensureCullingBoundsCurrent() { return true; }
+
+bool Structure::ensureBoundsCurrentWith(render::ManagedBuffer<glm::vec3>& positions, uint64_t boundsUpdateCount) {
+  if (positions.getUpdateCount() == boundsUpdateCount) return true;
+
+  positions.prefetchHostBuffer();
+  if (!positions.hostBufferPrefetchIsReady()) {
+    requestRedraw(); // check again next frame
+    return false;
+  }
+
+  updateObjectSpaceBounds();
+  return true;
+}
+
+bool Structure::getCullingBoxCorners(std::array<glm::vec3, 8>& corners) {
+  if (!hasExtents() || !ensureCullingBoundsCurrent()) return false;
+
+  // Transform the corners of the object-space box, and take the world-space box around them
+  const glm::mat4& T = objectTransform.get();
+  glm::vec3 objMin = std::get<0>(objectSpaceBoundingBox);
+  glm::vec3 objMax = std::get<1>(objectSpaceBoundingBox);
+  glm::vec3 worldMin{std::numeric_limits<float>::infinity()};
+  glm::vec3 worldMax{-std::numeric_limits<float>::infinity()};
+  for (int i = 0; i < 8; i++) {
+    glm::vec3 c{(i & 1) ? objMax.x : objMin.x, (i & 2) ? objMax.y : objMin.y, (i & 4) ? objMax.z : objMin.z};
+    glm::vec4 ch = T * glm::vec4(c, 1.);
+    glm::vec3 worldC = glm::vec3(ch) / ch.w;
+    worldMin = glm::min(worldMin, worldC);
+    worldMax = glm::max(worldMax, worldC);
+  }
+
+  // Pad the box. Vectors and the like are drawn in object space, so they grow with any scaling in the transform.
+  float transformScale = std::max(std::max(glm::length(glm::vec3(T[0])), glm::length(glm::vec3(T[1]))),
+                                  std::max(glm::length(glm::vec3(T[2])), 1.f));
+  float padding = getCullingPadding() * transformScale;
+  worldMin -= padding;
+  worldMax += padding;
+
+  // (also catches an empty box, and infinite or NaN padding)
+  for (int k = 0; k < 3; k++) {
+    if (!(worldMin[k] <= worldMax[k]) || !std::isfinite(worldMin[k]) || !std::isfinite(worldMax[k])) return false;
+  }
+
+  for (int i = 0; i < 8; i++) {
+    corners[i] = glm::vec3{(i & 1) ? worldMax.x : worldMin.x, (i & 2) ? worldMax.y : worldMin.y,
+                           (i & 4) ? worldMax.z : worldMin.z};
+  }
+  return true;
+}
+
 glm::mat4 Structure::getModelView() { return view::getCameraViewMatrix() * objectTransform.get(); }
 
 std::vector<std::string> Structure::addStructureRules(std::vector<std::string> initRules) {
@@ -315,6 +421,91 @@ void Structure::setStructureUniforms(render::ShaderProgram& p) {
 
 bool Structure::wantsCullPosition() { return render::engine->slicePlanesEnabled() && getCullWholeElements(); }
 
+RayCastResult Structure::rayCast(glm::vec3 origin, glm::vec3 dir, float tMin, float tMax) { return RayCastResult(); }
+
+bool Structure::canRayCastPick() { return false; }
+
+uint64_t Structure::rayCastPickIndex(const RayCastResult& hit) {
+  exception("structure " + name + " does not support picking by ray casting");
+  return 0;
+}
+
+std::vector<uint64_t> Structure::pickIndicesInRegion(const PickRegion& region) { return std::vector<uint64_t>(); }
+
+std::vector<uint64_t> Structure::pickIndicesOfPositionsInRegion(const std::vector<glm::vec3>& positions,
+                                                                uint64_t pickIndStart, const PickRegion& region) {
+
+  std::vector<std::tuple<glm::vec3, glm::vec3>> planes; // center, normal
+  for (std::unique_ptr<SlicePlane>& s : state::slicePlanes) {
+    if (!s->getEnabled() || getIgnoreSlicePlane(s->name)) continue;
+    planes.emplace_back(s->getCenter(), s->getNormal());
+  }
+  glm::mat4 T = objectTransform.get();
+
+  std::vector<std::vector<uint64_t>> chunkInds(parallelChunkCount(positions.size()));
+  parallelForChunks(positions.size(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      glm::vec3 worldPos = glm::vec3(T * glm::vec4(positions[i], 1.));
+      bool isKept = true;
+      for (const std::tuple<glm::vec3, glm::vec3>& plane : planes) {
+        if (glm::dot(worldPos - std::get<0>(plane), std::get<1>(plane)) < 0.) isKept = false;
+      }
+      if (isKept && region.containsWorldPoint(worldPos)) {
+        chunkInds[iChunk].push_back(pickIndStart + i);
+      }
+    }
+  });
+
+  std::vector<uint64_t> inds;
+  for (const std::vector<uint64_t>& c : chunkInds) {
+    inds.insert(inds.end(), c.begin(), c.end());
+  }
+  return inds;
+}
+
+TriangleRayHit Structure::rayCastTriangles(const TriangleBVH& bvh, glm::vec3 origin, glm::vec3 dir, float tMin,
+                                           float tMax, bool cullBackfaces, RayCastResult& result) {
+
+  // Clip the ray to the side of each slice plane which is kept. This matches the per-fragment test in the shaders.
+  for (std::unique_ptr<SlicePlane>& s : state::slicePlanes) {
+    if (!s->getEnabled() || getIgnoreSlicePlane(s->name)) continue;
+    glm::vec3 normal = s->getNormal();
+    float originDist = glm::dot(origin - s->getCenter(), normal);
+    float dirDist = glm::dot(dir, normal);
+    if (dirDist == 0.) {
+      if (originDist < 0.) return TriangleRayHit();
+    } else if (dirDist > 0.) {
+      tMin = std::max(tMin, -originDist / dirDist);
+    } else {
+      tMax = std::min(tMax, -originDist / dirDist);
+    }
+  }
+  if (!(tMin <= tMax)) return TriangleRayHit();
+
+  // Cast in object space, where the parameterization along the ray is the same. A transform which flips orientation
+  // also flips which side of the triangles is the front.
+  glm::mat4 objectTransformInv = glm::inverse(objectTransform.get());
+  glm::vec3 objectOrigin = glm::vec3(objectTransformInv * glm::vec4(origin, 1.));
+  glm::vec3 objectDir = glm::vec3(objectTransformInv * glm::vec4(dir, 0.));
+  RayCastFaceCull cull = RayCastFaceCull::None;
+  if (cullBackfaces) {
+    cull = glm::determinant(objectTransform.get()) < 0. ? RayCastFaceCull::Front : RayCastFaceCull::Back;
+  }
+
+  TriangleRayHit hit = bvh.rayCast(objectOrigin, objectDir, tMin, tMax, cull);
+  if (hit.isHit) {
+    result.isHit = true;
+    result.structure = this;
+    result.structureHandle = getWeakHandle<Structure>();
+    result.structureType = subtypeName;
+    result.structureName = name;
+    result.baryCoords = hit.baryCoords;
+    result.position = origin + hit.t * dir;
+    result.distance = hit.t * glm::length(dir);
+  }
+  return hit;
+}
+
 std::string Structure::uniquePrefix() { return typeName() + "#" + name + "#"; }
 
 void Structure::remove() { removeStructure(typeName(), name); }
@@ -433,11 +624,13 @@ void Structure::removeQuantity(std::string name, bool errorIfAbsent) {
     }
 
     // Delete the quantity
+    pick::releasePickBufferRange(&q);
     quantities.erase(name);
   }
 
   // delete floating quantities
   if (floatingQuantityExists) {
+    pick::releasePickBufferRange(floatingQuantities[name].get());
     floatingQuantities.erase(name);
   }
 }
@@ -486,6 +679,19 @@ void Structure::setAllQuantitiesEnabled(bool newEnabled) {
   }
 }
 
+render::ManagedBufferMemoryUsage Structure::getMemoryUsage(bool includeQuantities) {
+  render::ManagedBufferMemoryUsage usage = getManagedBufferMemoryUsage();
+  if (includeQuantities) {
+    for (auto& x : quantities) {
+      usage += x.second->getManagedBufferMemoryUsage();
+    }
+    for (auto& x : floatingQuantities) {
+      usage += x.second->getManagedBufferMemoryUsage();
+    }
+  }
+  return usage;
+}
+
 void Structure::checkForQuantityWithNameAndDeleteOrError(std::string name, bool allowReplacement) {
 
   // Look for an existing quantity with this name
@@ -24,6 +24,7 @@ void SurfaceColorQuantity::draw() {
   parent.setSurfaceMeshUniforms(*program);
   render::engine->setMaterialUniforms(*program, parent.getMaterial());
 
+  parent.prepareMeshDraw(*program);
   program->draw();
 }
 
@@ -57,12 +58,14 @@ SurfaceVertexColorQuantity::SurfaceVertexColorQuantity(std::string name, Surface
 
 void SurfaceVertexColorQuantity::createProgram() {
   // Create the program to draw this quantity
+  bool indexed = parent.usingIndexedRendering();
+
   // clang-format off
-  program = render::engine->requestShader("MESH", 
+  program = render::engine->requestShader(indexed ? "INDEXED_MESH" : "MESH", 
       render::engine->addMaterialRules(parent.getMaterial(),
         addColorRules(
           parent.addSurfaceMeshRules(
-            {"MESH_PROPAGATE_COLOR", "SHADE_COLOR"}
+            {"MESH_PROPAGATE_COLOR", "SHADE_COLOR"}, true, true, indexed
           )
         )
       )
@@ -70,7 +73,11 @@ void SurfaceVertexColorQuantity::createProgram() {
   // clang-format on
 
   parent.setMeshGeometryAttributes(*program);
-  program->setAttribute("a_color", colors.getIndexedRenderAttributeBuffer(parent.triangleVertexInds));
+  if (indexed) {
+    program->setAttribute("a_color", colors.getRenderAttributeBuffer());
+  } else {
+    program->setAttribute("a_color", colors.getIndexedRenderAttributeBuffer(parent.triangleVertexInds));
+  }
   render::engine->setMaterial(*program, parent.getMaterial());
 }
 
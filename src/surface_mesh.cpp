@@ -2,17 +2,20 @@
 
 #include "polyscope/surface_mesh.h"
 
-#include "polyscope/combining_hash_functions.h"
 #include "polyscope/elementary_geometry.h"
+#include "polyscope/mesh_reordering.h"
+#include "polyscope/mesh_topology.h"
 #include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/render/engine.h"
+#include "polyscope/slice_plane.h"
 
 #include "imgui.h"
 #include "polyscope/types.h"
 #include "polyscope/utilities.h"
 
-#include <unordered_map>
+#include <algorithm>
+#include <thread>
 #include <utility>
 
 namespace polyscope {
@@ -40,9 +43,12 @@ triangleAllEdgeInds(       this, uniquePrefix() + "triangleAllEdgeInds",
 triangleAllHalfedgeInds(   this, uniquePrefix() + "triangleHalfedgeInds",     triangleAllHalfedgeIndsData,    std::bind(&SurfaceMesh::computeTriangleAllHalfedgeInds, this)),
 triangleAllCornerInds(     this, uniquePrefix() + "triangleAllCornerInds",    triangleAllCornerIndsData,      std::bind(&SurfaceMesh::computeTriangleAllCornerInds, this)),
 
-// internal triangle data for rendering
-baryCoord(              this, uniquePrefix() + "baryCoord",           baryCoordData),
-edgeIsReal(             this, uniquePrefix() + "edgeIsReal",          edgeIsRealData),
+// internal per-triangle data for rendering
+triangleFaceNormals(     this, uniquePrefix() + "triangleFaceNormals",      triangleFaceNormalsData,      std::bind(&SurfaceMesh::computeTriangleFaceNormals, this)),
+triangleFaceCenters(     this, uniquePrefix() + "triangleFaceCenters",      triangleFaceCentersData,      std::bind(&SurfaceMesh::computeTriangleFaceCenters, this)),
+triangleCornerPositions( this, uniquePrefix() + "triangleCornerPositions",  triangleCornerPositionsData,  std::bind(&SurfaceMesh::computeTriangleCornerPositions, this)),
+triangleEdgeFlags(       this, uniquePrefix() + "triangleEdgeFlags",        triangleEdgeFlagsData,        std::bind(&SurfaceMesh::computeTriangleEdgeFlags, this)),
+trianglePickInds(        this, uniquePrefix() + "trianglePickInds",         trianglePickIndsData,         std::bind(&SurfaceMesh::computeTrianglePickInds, this)),
 
 // other internally-computed geometry
 faceNormals(            this, uniquePrefix() + "faceNormals",         faceNormalsData,        std::bind(&SurfaceMesh::computeFaceNormals, this)),
@@ -62,18 +68,22 @@ edgeWidth(              uniquePrefix() + "edgeWidth",       0.),
 backFacePolicy(         uniquePrefix() + "backFacePolicy",  BackFacePolicy::Different),
 backFaceColor(          uniquePrefix() + "backFaceColor",   glm::vec3(1.f - surfaceColor.get().r, 1.f - surfaceColor.get().g, 1.f - surfaceColor.get().b)),
 shadeStyle(             uniquePrefix() + "shadeStyle",      MeshShadeStyle::Flat),
-selectionMode(          uniquePrefix() + "selectionMode",   MeshSelectionMode::Auto)
+selectionMode(          uniquePrefix() + "selectionMode",   MeshSelectionMode::Auto),
+indexedRendering(       uniquePrefix() + "indexedRendering", false),
+meshletCulling(         uniquePrefix() + "meshletCulling",  false),
+levelOfDetail(          uniquePrefix() + "levelOfDetail",   false),
+levelOfDetailPixelError(uniquePrefix() + "levelOfDetailPixelError", 1.)
 
 // clang-format on
 {}
 
-SurfaceMesh::SurfaceMesh(std::string name_, const std::vector<glm::vec3>& vertexPositions_,
-                         const std::vector<uint32_t>& faceIndsEntries_, const std::vector<uint32_t>& faceIndsStart_)
+SurfaceMesh::SurfaceMesh(std::string name_, std::vector<glm::vec3> vertexPositions_,
+                         std::vector<uint32_t> faceIndsEntries_, std::vector<uint32_t> faceIndsStart_)
     : SurfaceMesh(name_) {
 
-  vertexPositionsData = vertexPositions_;
-  faceIndsEntries = faceIndsEntries_;
-  faceIndsStart = faceIndsStart_;
+  vertexPositionsData = std::move(vertexPositions_);
+  faceIndsEntries = std::move(faceIndsEntries_);
+  faceIndsStart = std::move(faceIndsStart_);
 
   vertexPositions.checkInvalidValues();
   computeConnectivityData();
@@ -92,6 +102,8 @@ SurfaceMesh::SurfaceMesh(std::string name_, const std::vector<glm::vec3>& vertex
   updateObjectSpaceBounds();
 }
 
+SurfaceMesh::~SurfaceMesh() { cancelLevelOfDetailBuild(); }
+
 void SurfaceMesh::nestedFacesToFlat(const std::vector<std::vector<size_t>>& nestedInds) {
 
   faceIndsStart.clear();
@@ -108,67 +120,84 @@ void SurfaceMesh::nestedFacesToFlat(const std::vector<std::vector<size_t>>& nest
 
 void SurfaceMesh::computeConnectivityData() {
 
-  // some number-of-elements arithmetic
   size_t numFaces = faceIndsStart.size() - 1;
   nCornersCount = faceIndsEntries.size();
-  nFacesTriangulationCount = nCornersCount - 2 * numFaces;
-
-  // fill out these buffers as we construct the triangulation
-  triangleVertexIndsData.clear();
-  triangleVertexIndsData.resize(3 * nFacesTriangulationCount);
-  triangleFaceIndsData.clear();
-  triangleFaceIndsData.resize(3 * nFacesTriangulationCount);
-  baryCoordData.clear();
-  baryCoordData.resize(3 * nFacesTriangulationCount);
-  edgeIsRealData.clear();
-  edgeIsRealData.resize(3 * nFacesTriangulationCount);
 
   // validate the face-vertex indices
-  for (size_t iV : faceIndsEntries) {
-    if (iV >= vertexPositions.size())
-      exception("SurfaceMesh " + name + " has face vertex index " + std::to_string(iV) +
-                " out of bounds for number of vertices " + std::to_string(vertexPositions.size()));
-  }
-
-  // construct the triangualted draw list and all other related data
-  size_t iTriFace = 0;
-  for (size_t iF = 0; iF < numFaces; iF++) {
-    size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
-
-    size_t iStart = faceIndsStart[iF];
-    uint32_t vRoot = faceIndsEntries[iStart];
-
-    // implicitly triangulate from root
-    for (size_t j = 1; (j + 1) < D; j++) {
-      uint32_t vB = faceIndsEntries[iStart + j];
-      uint32_t vC = faceIndsEntries[iStart + ((j + 1) % D)];
-
-      // triangle vertex indices
-      triangleVertexIndsData[3 * iTriFace + 0] = vRoot;
-      triangleVertexIndsData[3 * iTriFace + 1] = vB;
-      triangleVertexIndsData[3 * iTriFace + 2] = vC;
-
-      // triangle face indices
-      for (size_t k = 0; k < 3; k++) triangleFaceIndsData[3 * iTriFace + k] = iF;
-
-      // barycentric coordinates
-      baryCoordData[3 * iTriFace + 0] = glm::vec3{1., 0., 0.};
-      baryCoordData[3 * iTriFace + 1] = glm::vec3{0., 1., 0.};
-      baryCoordData[3 * iTriFace + 2] = glm::vec3{0., 0., 1.};
+  size_t numVertices = vertexPositions.size();
+  parallelForChunks(faceIndsEntries.size(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t i = iStart; i < iEnd; i++) {
+      size_t iV = faceIndsEntries[i];
+      if (iV >= numVertices)
+        exception("SurfaceMesh " + name + " has face vertex index " + std::to_string(iV) +
+                  " out of bounds for number of vertices " + std::to_string(numVertices));
+    }
+  });
+
+  // Optionally draw the faces in a cache-friendly order (see options::optimizeMeshDrawOrder). The triangles of each
+  // face stay together, and everything below just places them at faceTriangleStart[iF].
+  std::vector<uint32_t> faceDrawOrder;
+  if (options::optimizeMeshDrawOrder) {
+    faceDrawOrder = computeFaceDrawOrder(vertexPositions.data, faceIndsStart, faceIndsEntries);
+  }
+  auto drawnFace = [&](size_t i) { return faceDrawOrder.empty() ? i : static_cast<size_t>(faceDrawOrder[i]); };
+
+  // Each face of degree D is fan-triangulated in to D-2 triangles. Lay the triangles out with a prefix sum over the
+  // faces (in draw order), computed as per-chunk counts followed by a scan over the chunks, so every later pass over
+  // the triangulation can fill its output in parallel.
+  faceTriangleStart.resize(numFaces + 1);
+  std::vector<size_t> chunkTriangleStart(parallelChunkCount(numFaces) + 1, 0);
+  parallelForChunks(numFaces, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    size_t count = 0;
+    for (size_t i = iStart; i < iEnd; i++) {
+      size_t iF = drawnFace(i);
+      size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
+      count += (D > 2) ? D - 2 : 0;
+    }
+    chunkTriangleStart[iChunk + 1] = count;
+  });
+  for (size_t iChunk = 1; iChunk < chunkTriangleStart.size(); iChunk++) {
+    chunkTriangleStart[iChunk] += chunkTriangleStart[iChunk - 1];
+  }
+  parallelForChunks(numFaces, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    size_t iTri = chunkTriangleStart[iChunk];
+    for (size_t i = iStart; i < iEnd; i++) {
+      size_t iF = drawnFace(i);
+      faceTriangleStart[iF] = static_cast<uint32_t>(iTri);
+      size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
+      iTri += (D > 2) ? D - 2 : 0;
+    }
+  });
+  faceTriangleStart[numFaces] = static_cast<uint32_t>(chunkTriangleStart.back());
+  nFacesTriangulationCount = chunkTriangleStart.back();
 
-      // internal edges for triangulated polygons
-      glm::vec3 edgeRealV{0., 1., 0.};
-      if (j == 1) {
-        edgeRealV.x = 1.;
-      }
-      if (j + 2 == D) {
-        edgeRealV.z = 1.;
+  // construct the triangulated draw list
+  triangleVertexIndsData.resize(3 * nFacesTriangulationCount);
+  triangleFaceIndsData.resize(3 * nFacesTriangulationCount);
+  parallelForChunks(numFaces, [&](size_t iChunk, size_t iChunkStart, size_t iChunkEnd) {
+    for (size_t iF = iChunkStart; iF < iChunkEnd; iF++) {
+      size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
+      size_t iStart = faceIndsStart[iF];
+      size_t iTriFace = faceTriangleStart[iF];
+      uint32_t vRoot = faceIndsEntries[iStart];
+
+      // implicitly triangulate from root
+      for (size_t j = 1; (j + 1) < D; j++) {
+        uint32_t vB = faceIndsEntries[iStart + j];
+        uint32_t vC = faceIndsEntries[iStart + ((j + 1) % D)];
+
+        // triangle vertex indices
+        triangleVertexIndsData[3 * iTriFace + 0] = vRoot;
+        triangleVertexIndsData[3 * iTriFace + 1] = vB;
+        triangleVertexIndsData[3 * iTriFace + 2] = vC;
+
+        // triangle face indices
+        for (size_t k = 0; k < 3; k++) triangleFaceIndsData[3 * iTriFace + k] = iF;
+
+        iTriFace++;
       }
-      for (size_t k = 0; k < 3; k++) edgeIsRealData[3 * iTriFace + k] = edgeRealV;
-
-      iTriFace++;
     }
-  }
+  });
 
   vertexDataSize = nVertices();
   faceDataSize = nFaces();
@@ -178,8 +207,15 @@ void SurfaceMesh::computeConnectivityData() {
 
   triangleVertexInds.markHostBufferUpdated();
   triangleFaceInds.markHostBufferUpdated();
-  baryCoord.markHostBufferUpdated();
-  edgeIsReal.markHostBufferUpdated();
+
+  // size the textures holding per-triangle data
+  std::array<uint32_t, 2> triTexSize = dataTextureSize2D(nFacesTriangulationCount);
+  std::array<uint32_t, 2> cornerTexSize = dataTextureSize2D(3 * nFacesTriangulationCount);
+  triangleFaceNormals.setTextureSize(triTexSize[0], triTexSize[1]);
+  triangleFaceCenters.setTextureSize(triTexSize[0], triTexSize[1]);
+  triangleCornerPositions.setTextureSize(cornerTexSize[0], cornerTexSize[1]);
+  triangleEdgeFlags.setTextureSize(triTexSize[0], triTexSize[1]);
+  trianglePickInds.setTextureSize(triTexSize[0], triTexSize[1]);
 }
 
 // =================================================
@@ -188,113 +224,75 @@ void SurfaceMesh::computeConnectivityData() {
 
 void SurfaceMesh::computeTriangleAllEdgeInds() {
 
-  // WARNING: logic duplicated in countEdges()
-
   if (edgePerm.empty())
     exception("SurfaceMesh " + name +
               " performed an operation which requires edge indices to be specified, but none have been set. "
               "Call setEdgePermutation().");
 
-  triangleVertexInds.ensureHostBufferPopulated();
-  triangleAllEdgeInds.data.resize(3 * 3 * nFacesTriangulation());
-  halfedgeEdgeCorrespondence.resize(nHalfedges());
-
-  // used to loop over edges
-  std::unordered_map<std::pair<size_t, size_t>, size_t, polyscope::hash_combine::hash<std::pair<size_t, size_t>>>
-      seenEdgeInds;
-
-  auto createEdgeKey = [&](size_t a, size_t b) -> std::pair<size_t, size_t> {
-    return std::make_pair(std::min(a, b), std::max(a, b));
-  };
-
-  size_t psEdgeInd = 0; // polyscope's edge index, iterated according to Polyscope's canonical ordering
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t start = faceIndsStart[iF];
-    size_t D = faceIndsStart[iF + 1] - start;
-
-    // TODO why can't we use edges on non triangular meshes? Implement it.
-
-    if (D != 3) {
-      exception("SurfaceMesh " + name +
-                " attempted to access triangle-edge indices, but it has non-triangular faces. These indices are "
-                "only well-defined on a pure-triangular mesh.");
-    }
-
-    glm::uvec3 thisTriInds{0, 0, 0};
-    for (size_t j = 0; j < 3; j++) {
-      size_t vA = triangleVertexInds.data[3 * iF + j];
-      size_t vB = triangleVertexInds.data[3 * iF + ((j + 1) % 3)];
+  // TODO why can't we use edges on non triangular meshes? Implement it.
+  checkTriangular("attempted to access triangle-edge indices, but it has non-triangular faces. These indices are "
+                  "only well-defined on a pure-triangular mesh.");
 
-      std::pair<size_t, size_t> key = createEdgeKey(vA, vB);
+  EdgeTopology topology = buildEdgeTopology(faceOrderedTriangleVertexInds(), nVertices());
+  if (topology.nEdges > edgePerm.size()) {
+    exception("SurfaceMesh " + name + " edge indexing out of bounds. Did you pass an edge ordering that is too short?");
+  }
 
-      size_t thisEdgeInd;
-      if (seenEdgeInds.find(key) == seenEdgeInds.end()) {
-        // process a new edge in the canonical ordering
-        if (psEdgeInd >= edgePerm.size()) {
-          exception("SurfaceMesh " + name +
-                    " edge indexing out of bounds. Did you pass an edge ordering that is too short?");
-        }
-        thisEdgeInd = edgePerm[psEdgeInd];
-        seenEdgeInds[key] = thisEdgeInd;
-        psEdgeInd++;
-      } else {
-        // we've processed this edge before, retrieve its assigned index
-        thisEdgeInd = seenEdgeInds[key];
+  // apply the user's edge ordering to Polyscope's canonical ordering
+  triangleAllEdgeInds.data.resize(3 * 3 * nFacesTriangulation());
+  halfedgeEdgeCorrespondence.resize(nHalfedges());
+  parallelForChunks(nFaces(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iF = iStart; iF < iEnd; iF++) {
+      size_t iT = faceTriangleStart[iF];
+      glm::uvec3 thisTriInds{0, 0, 0};
+      for (size_t j = 0; j < 3; j++) {
+        uint32_t thisEdgeInd = static_cast<uint32_t>(edgePerm[topology.halfedgeEdge[3 * iF + j]]);
+        halfedgeEdgeCorrespondence[faceIndsStart[iF] + j] = thisEdgeInd;
+        thisTriInds[j] = thisEdgeInd;
       }
 
-      halfedgeEdgeCorrespondence[start + j] = thisEdgeInd;
-      thisTriInds[j] = thisEdgeInd;
-    }
-
-    for (size_t j = 0; j < 3; j++) {
-      for (size_t k = 0; k < 3; k++) {
-        triangleAllEdgeInds.data[9 * iF + 3 * j + k] = thisTriInds[k];
+      for (size_t j = 0; j < 3; j++) {
+        for (size_t k = 0; k < 3; k++) {
+          triangleAllEdgeInds.data[9 * iT + 3 * j + k] = thisTriInds[k];
+        }
       }
     }
-  }
+  });
 
-  nEdgesCount = psEdgeInd;
+  nEdgesCount = topology.nEdges;
   triangleAllEdgeInds.markHostBufferUpdated();
 }
 
 void SurfaceMesh::countEdges() {
+  checkTriangular("attempted to count edges, but mesh has non-triangular faces. Edge functions are only implemented "
+                  "on a pure-triangular mesh.");
 
-  // WARNING: logic duplicated in computeTriangleAllEdgeInds()
-
-  // used to loop over edges
-  std::unordered_map<std::pair<size_t, size_t>, size_t, polyscope::hash_combine::hash<std::pair<size_t, size_t>>>
-      seenEdgeInds;
-
-  auto createEdgeKey = [&](size_t a, size_t b) -> std::pair<size_t, size_t> {
-    return std::make_pair(std::min(a, b), std::max(a, b));
-  };
+  nEdgesCount = buildEdgeTopology(faceOrderedTriangleVertexInds(), nVertices()).nEdges;
+}
 
-  size_t psEdgeInd = 0; // polyscope's edge index, iterated according to Polyscope's canonical ordering
+void SurfaceMesh::checkTriangular(std::string errorMessage) {
   for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t start = faceIndsStart[iF];
-    size_t D = faceIndsStart[iF + 1] - start;
-
-    if (D != 3) {
-      exception("SurfaceMesh " + name +
-                " attempted to count edges, but mesh has non-triangular faces. Edge functions are only implemented on "
-                "a pure-triangular mesh.");
+    if (faceIndsStart[iF + 1] - faceIndsStart[iF] != 3) {
+      exception("SurfaceMesh " + name + " " + errorMessage);
     }
+  }
+}
 
-    for (size_t j = 0; j < 3; j++) {
-      size_t vA = triangleVertexInds.data[3 * iF + j];
-      size_t vB = triangleVertexInds.data[3 * iF + ((j + 1) % 3)];
-
-      std::pair<size_t, size_t> key = createEdgeKey(vA, vB);
+std::vector<uint32_t> SurfaceMesh::faceOrderedTriangleVertexInds() {
+  triangleVertexInds.ensureHostBufferPopulated();
+  const std::vector<uint32_t>& drawOrderInds = triangleVertexInds.data;
 
-      if (seenEdgeInds.find(key) == seenEdgeInds.end()) {
-        size_t thisEdgeInd = psEdgeInd;
-        seenEdgeInds[key] = thisEdgeInd;
-        psEdgeInd++;
-      }
-    }
+  std::vector<uint32_t> faceOrderInds(drawOrderInds.size());
+  size_t iOut = 0;
+  for (size_t iF = 0; iF < nFaces(); iF++) {
+    size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
+    size_t nTri = (D > 2) ? D - 2 : 0;
+    size_t iT = faceTriangleStart[iF];
+    std::copy(drawOrderInds.begin() + 3 * iT, drawOrderInds.begin() + 3 * (iT + nTri), faceOrderInds.begin() + iOut);
+    iOut += 3 * nTri;
   }
 
-  nEdgesCount = psEdgeInd;
+  return faceOrderInds;
 }
 
 size_t SurfaceMesh::nEdges() {
@@ -304,126 +302,138 @@ size_t SurfaceMesh::nEdges() {
 
 void SurfaceMesh::computeTriangleCornerInds() {
 
-  triangleCornerInds.data.clear();
-  triangleCornerInds.data.reserve(3 * nFacesTriangulation());
+  triangleCornerInds.data.resize(3 * nFacesTriangulation());
 
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t iStart = faceIndsStart[iF];
-    size_t D = faceIndsStart[iF + 1] - iStart;
-
-    // emit the data for triangles triangulating this face
-    for (size_t j = 1; (j + 1) < D; j++) {
-      uint32_t c0 = iStart;
-      uint32_t c1 = iStart + j;
-      uint32_t c2 = iStart + j + 1;
-
-      triangleCornerInds.data.push_back(c0);
-      triangleCornerInds.data.push_back(c1);
-      triangleCornerInds.data.push_back(c2);
+  parallelForChunks(nFaces(), [&](size_t iChunk, size_t iChunkStart, size_t iChunkEnd) {
+    for (size_t iF = iChunkStart; iF < iChunkEnd; iF++) {
+      size_t iStart = faceIndsStart[iF];
+      size_t D = faceIndsStart[iF + 1] - iStart;
+      size_t iT = faceTriangleStart[iF];
+
+      // emit the data for triangles triangulating this face
+      for (size_t j = 1; (j + 1) < D; j++) {
+        uint32_t c0 = iStart;
+        uint32_t c1 = iStart + j;
+        uint32_t c2 = iStart + j + 1;
+
+        triangleCornerInds.data[3 * iT + 0] = c0;
+        triangleCornerInds.data[3 * iT + 1] = c1;
+        triangleCornerInds.data[3 * iT + 2] = c2;
+        iT++;
+      }
     }
-  }
+  });
 
   triangleCornerInds.markHostBufferUpdated();
 }
 
 void SurfaceMesh::computeTriangleAllVertexInds() {
 
-  triangleAllVertexInds.data.clear();
-  triangleAllVertexInds.data.reserve(3 * 3 * nFacesTriangulation());
-
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t iStart = faceIndsStart[iF];
-    size_t D = faceIndsStart[iF + 1] - iStart;
-    uint32_t vRoot = faceIndsEntries[iStart];
-
-    // implicitly triangulate from root
-    for (size_t j = 1; (j + 1) < D; j++) {
-      uint32_t vB = faceIndsEntries[iStart + j];
-      uint32_t vC = faceIndsEntries[iStart + ((j + 1) % D)];
-
-      // triangle vertex indices, all three values-each
-      for (size_t k = 0; k < 3; k++) {
-        triangleAllVertexInds.data.push_back(vRoot);
-        triangleAllVertexInds.data.push_back(vB);
-        triangleAllVertexInds.data.push_back(vC);
+  triangleAllVertexInds.data.resize(3 * 3 * nFacesTriangulation());
+
+  parallelForChunks(nFaces(), [&](size_t iChunk, size_t iChunkStart, size_t iChunkEnd) {
+    for (size_t iF = iChunkStart; iF < iChunkEnd; iF++) {
+      size_t iStart = faceIndsStart[iF];
+      size_t D = faceIndsStart[iF + 1] - iStart;
+      size_t iT = faceTriangleStart[iF];
+      uint32_t vRoot = faceIndsEntries[iStart];
+
+      // implicitly triangulate from root
+      for (size_t j = 1; (j + 1) < D; j++) {
+        uint32_t vB = faceIndsEntries[iStart + j];
+        uint32_t vC = faceIndsEntries[iStart + ((j + 1) % D)];
+
+        // triangle vertex indices, all three values-each
+        for (size_t k = 0; k < 3; k++) {
+          triangleAllVertexInds.data[9 * iT + 3 * k + 0] = vRoot;
+          triangleAllVertexInds.data[9 * iT + 3 * k + 1] = vB;
+          triangleAllVertexInds.data[9 * iT + 3 * k + 2] = vC;
+        }
+        iT++;
       }
     }
-  }
+  });
 
   triangleAllVertexInds.markHostBufferUpdated();
 }
 
 void SurfaceMesh::computeTriangleAllHalfedgeInds() {
 
-  triangleAllHalfedgeInds.data.clear();
-  triangleAllHalfedgeInds.data.reserve(3 * 3 * nFacesTriangulation());
+  triangleAllHalfedgeInds.data.resize(3 * 3 * nFacesTriangulation());
 
   bool haveCustomIndex = !halfedgePerm.empty();
 
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t iStart = faceIndsStart[iF];
-    size_t D = faceIndsStart[iF + 1] - iStart;
+  parallelForChunks(nFaces(), [&](size_t iChunk, size_t iChunkStart, size_t iChunkEnd) {
+    for (size_t iF = iChunkStart; iF < iChunkEnd; iF++) {
+      size_t iStart = faceIndsStart[iF];
+      size_t D = faceIndsStart[iF + 1] - iStart;
+      size_t iT = faceTriangleStart[iF];
 
-    // emit the data for triangles triangulating this face
-    for (size_t j = 1; (j + 1) < D; j++) {
+      // emit the data for triangles triangulating this face
+      for (size_t j = 1; (j + 1) < D; j++) {
 
-      // FORNOW: for polygonal faces, substitute the opposite-edge value for all internal edges of the triangulation
+        // FORNOW: for polygonal faces, substitute the opposite-edge value for all internal edges of the triangulation
 
-      uint32_t he0 = iStart + j; // this is a dummy value due to triangulation of polygons
-      uint32_t he1 = iStart + j; // this is the actual right value for the opposite edge
-      uint32_t he2 = iStart + j; // this is a dummy value due to triangulation of polygons
+        uint32_t he0 = iStart + j; // this is a dummy value due to triangulation of polygons
+        uint32_t he1 = iStart + j; // this is the actual right value for the opposite edge
+        uint32_t he2 = iStart + j; // this is a dummy value due to triangulation of polygons
 
-      // substitute non-dummy values for first and last edge if this is not an internal tri
-      if (j == 1) he0 = iStart;
-      if (j + 2 == D) he2 = iStart + D - 1;
+        // substitute non-dummy values for first and last edge if this is not an internal tri
+        if (j == 1) he0 = iStart;
+        if (j + 2 == D) he2 = iStart + D - 1;
 
-      if (haveCustomIndex) {
-        he0 = halfedgePerm[he0];
-        he1 = halfedgePerm[he1];
-        he2 = halfedgePerm[he2];
-      }
+        if (haveCustomIndex) {
+          he0 = halfedgePerm[he0];
+          he1 = halfedgePerm[he1];
+          he2 = halfedgePerm[he2];
+        }
 
-      for (size_t k = 0; k < 3; k++) {
-        triangleAllHalfedgeInds.data.push_back(he0);
-        triangleAllHalfedgeInds.data.push_back(he1);
-        triangleAllHalfedgeInds.data.push_back(he2);
+        for (size_t k = 0; k < 3; k++) {
+          triangleAllHalfedgeInds.data[9 * iT + 3 * k + 0] = he0;
+          triangleAllHalfedgeInds.data[9 * iT + 3 * k + 1] = he1;
+          triangleAllHalfedgeInds.data[9 * iT + 3 * k + 2] = he2;
+        }
+        iT++;
       }
     }
-  }
+  });
 
   triangleAllHalfedgeInds.markHostBufferUpdated();
 }
 
 void SurfaceMesh::computeTriangleAllCornerInds() {
 
-  triangleAllCornerInds.data.clear();
-  triangleAllCornerInds.data.reserve(3 * nFacesTriangulation());
+  triangleAllCornerInds.data.resize(3 * 3 * nFacesTriangulation());
 
   bool haveCustomIndex = !cornerPerm.empty();
 
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t iStart = faceIndsStart[iF];
-    size_t D = faceIndsStart[iF + 1] - iStart;
-
-    // emit the data for triangles triangulating this face
-    for (size_t j = 1; (j + 1) < D; j++) {
-      uint32_t c0 = iStart;
-      uint32_t c1 = iStart + j;
-      uint32_t c2 = iStart + j + 1;
-
-      if (haveCustomIndex) {
-        c0 = cornerPerm[c0];
-        c1 = cornerPerm[c1];
-        c2 = cornerPerm[c2];
-      }
+  parallelForChunks(nFaces(), [&](size_t iChunk, size_t iChunkStart, size_t iChunkEnd) {
+    for (size_t iF = iChunkStart; iF < iChunkEnd; iF++) {
+      size_t iStart = faceIndsStart[iF];
+      size_t D = faceIndsStart[iF + 1] - iStart;
+      size_t iT = faceTriangleStart[iF];
+
+      // emit the data for triangles triangulating this face
+      for (size_t j = 1; (j + 1) < D; j++) {
+        uint32_t c0 = iStart;
+        uint32_t c1 = iStart + j;
+        uint32_t c2 = iStart + j + 1;
+
+        if (haveCustomIndex) {
+          c0 = cornerPerm[c0];
+          c1 = cornerPerm[c1];
+          c2 = cornerPerm[c2];
+        }
 
-      for (size_t k = 0; k < 3; k++) {
-        triangleAllCornerInds.data.push_back(c0);
-        triangleAllCornerInds.data.push_back(c1);
-        triangleAllCornerInds.data.push_back(c2);
+        for (size_t k = 0; k < 3; k++) {
+          triangleAllCornerInds.data[9 * iT + 3 * k + 0] = c0;
+          triangleAllCornerInds.data[9 * iT + 3 * k + 1] = c1;
+          triangleAllCornerInds.data[9 * iT + 3 * k + 2] = c2;
+        }
+        iT++;
       }
     }
-  }
+  });
 
   triangleAllCornerInds.markHostBufferUpdated();
 }
@@ -436,203 +446,277 @@ void SurfaceMesh::computeTriangleAllCornerInds() {
 
 size_t SurfaceMesh::nVertices() { return vertexPositions.size(); }
 
-void SurfaceMesh::computeFaceNormals() {
+void SurfaceMesh::computeGeometry(const GeometryComputeSet& computeSet) {
 
-  vertexPositions.ensureHostBufferPopulated();
+  bool doFaceTangentBasis = computeSet.defaultFaceTangentBasisX || computeSet.defaultFaceTangentBasisY;
+  bool doFaceNormals = computeSet.faceNormals || doFaceTangentBasis;
+  bool doFaceAreas = computeSet.faceAreas;
+  bool doVertexPass = computeSet.vertexNormals || computeSet.vertexAreas;
 
-  faceNormals.data.resize(nFaces());
+  // The per-vertex sums gather from the per-face normals and areas. Make sure those are populated, if they are not
+  // being computed in this same pass.
+  if (computeSet.vertexNormals && !computeSet.faceNormals) faceNormals.ensureHostBufferPopulated();
+  if (doVertexPass && !computeSet.faceAreas) faceAreas.ensureHostBufferPopulated();
+  if (doVertexPass) ensureHaveVertexFaceAdjacency();
 
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t iStart = faceIndsStart[iF];
-    size_t D = faceIndsStart[iF + 1] - iStart;
+  vertexPositions.ensureHostBufferPopulated();
+  const std::vector<glm::vec3>& pos = vertexPositions.data;
+
+  if (computeSet.faceNormals) faceNormals.data.resize(nFaces());
+  if (computeSet.faceCenters) faceCenters.data.resize(nFaces());
+  if (computeSet.faceAreas) faceAreas.data.resize(nFaces());
+  if (computeSet.defaultFaceTangentBasisX) defaultFaceTangentBasisX.data.resize(nFaces());
+  if (computeSet.defaultFaceTangentBasisY) defaultFaceTangentBasisY.data.resize(nFaces());
+
+  // == Face pass
+  parallelForChunks(nFaces(), [&](size_t iChunk, size_t iChunkStart, size_t iChunkEnd) {
+    for (size_t iF = iChunkStart; iF < iChunkEnd; iF++) {
+      size_t start = faceIndsStart[iF];
+      size_t D = faceIndsStart[iF + 1] - start;
+
+      glm::vec3 fN{0., 0., 0.};
+      if (doFaceNormals) {
+        if (D == 3) {
+          glm::vec3 pA = pos[faceIndsEntries[start + 0]];
+          glm::vec3 pB = pos[faceIndsEntries[start + 1]];
+          glm::vec3 pC = pos[faceIndsEntries[start + 2]];
+          fN = glm::cross(pB - pA, pC - pA);
+        } else {
+          for (size_t j = 0; j < D; j++) {
+            glm::vec3 pA = pos[faceIndsEntries[start + j]];
+            glm::vec3 pB = pos[faceIndsEntries[start + (j + 1) % D]];
+            glm::vec3 pC = pos[faceIndsEntries[start + (j + 2) % D]];
+            fN += glm::cross(pC - pB, pA - pB);
+          }
+        }
+        fN = glm::normalize(fN);
+        if (computeSet.faceNormals) faceNormals.data[iF] = fN;
+      }
 
-    glm::vec3 fN{0., 0., 0.};
-    if (D == 3) {
-      glm::vec3 pA = vertexPositions.data[faceIndsEntries[iStart + 0]];
-      glm::vec3 pB = vertexPositions.data[faceIndsEntries[iStart + 1]];
-      glm::vec3 pC = vertexPositions.data[faceIndsEntries[iStart + 2]];
-      fN = glm::cross(pB - pA, pC - pA);
-    } else {
-      for (size_t j = 0; j < D; j++) {
-        glm::vec3 pA = vertexPositions.data[faceIndsEntries[iStart + j]];
-        glm::vec3 pB = vertexPositions.data[faceIndsEntries[iStart + (j + 1) % D]];
-        glm::vec3 pC = vertexPositions.data[faceIndsEntries[iStart + (j + 2) % D]];
-        fN += glm::cross(pC - pB, pA - pB);
+      if (computeSet.faceCenters) {
+        glm::vec3 faceCenter{0., 0., 0.};
+        for (size_t j = 0; j < D; j++) {
+          faceCenter += pos[faceIndsEntries[start + j]];
+        }
+        faceCenter /= D;
+        faceCenters.data[iF] = faceCenter;
       }
-    }
-    fN = glm::normalize(fN);
-    faceNormals.data[iF] = fN;
-  }
 
-  faceNormals.markHostBufferUpdated();
-}
+      if (doFaceAreas) {
+        double fA;
+        if (D == 3) {
+          glm::vec3 pA = pos[faceIndsEntries[start + 0]];
+          glm::vec3 pB = pos[faceIndsEntries[start + 1]];
+          glm::vec3 pC = pos[faceIndsEntries[start + 2]];
+          fA = 0.5 * glm::length(glm::cross(pB - pA, pC - pA));
+        } else {
+          fA = 0;
+          glm::vec3 pRoot = pos[faceIndsEntries[start]];
+          for (size_t j = 1; j + 1 < D; j++) {
+            glm::vec3 pA = pos[faceIndsEntries[start + j]];
+            glm::vec3 pB = pos[faceIndsEntries[start + j + 1]];
+            fA += 0.5 * glm::length(glm::cross(pA - pRoot, pB - pRoot));
+          }
+        }
+        faceAreas.data[iF] = fA;
+      }
 
-void SurfaceMesh::computeFaceCenters() {
+      if (doFaceTangentBasis) {
+        if (D != 3) exception("Default face tangent spaces only available for pure-triangular meshes");
 
-  vertexPositions.ensureHostBufferPopulated();
+        glm::vec3 pA = pos[faceIndsEntries[start + 0]];
+        glm::vec3 pB = pos[faceIndsEntries[start + 1]];
 
-  faceCenters.data.resize(nFaces());
+        glm::vec3 basisX = pB - pA;
+        basisX = glm::normalize(basisX - fN * glm::dot(fN, basisX));
 
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t start = faceIndsStart[iF];
-    size_t D = faceIndsStart[iF + 1] - start;
-    glm::vec3 faceCenter{0., 0., 0.};
-    for (size_t j = 0; j < D; j++) {
-      glm::vec3 pA = vertexPositions.data[faceIndsEntries[start + j]];
-      faceCenter += pA;
+        if (computeSet.defaultFaceTangentBasisX) defaultFaceTangentBasisX.data[iF] = basisX;
+        if (computeSet.defaultFaceTangentBasisY) {
+          defaultFaceTangentBasisY.data[iF] = glm::normalize(-glm::cross(basisX, fN));
+        }
+      }
     }
-    faceCenter /= D;
-    faceCenters.data[iF] = faceCenter;
+  });
+
+  // == Vertex pass
+  // Each vertex gathers from its incident faces, in increasing face order. This gives the same sums as
+  // accumulating over the faces in order, without any conflicting writes.
+  if (doVertexPass) {
+    if (computeSet.vertexNormals) vertexNormals.data.resize(nVertices());
+    if (computeSet.vertexAreas) vertexAreas.data.resize(nVertices());
+
+    const std::vector<uint32_t>& vertexStart = vertexFaceAdjacency.vertexStart;
+    const std::vector<uint32_t>& adjFaceInds = vertexFaceAdjacency.faceInds;
+
+    parallelForChunks(nVertices(), [&](size_t iChunk, size_t iChunkStart, size_t iChunkEnd) {
+      for (size_t iV = iChunkStart; iV < iChunkEnd; iV++) {
+        glm::vec3 vN{0., 0., 0.};
+        float vA = 0.;
+        for (size_t i = vertexStart[iV]; i < vertexStart[iV + 1]; i++) {
+          size_t iF = adjFaceInds[i];
+          if (computeSet.vertexNormals) {
+            vN += faceNormals.data[iF] * static_cast<float>(faceAreas.data[iF]);
+          }
+          if (computeSet.vertexAreas) {
+            size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
+            vA += faceAreas.data[iF] / D;
+          }
+        }
+        if (computeSet.vertexNormals) vertexNormals.data[iV] = glm::normalize(vN);
+        if (computeSet.vertexAreas) vertexAreas.data[iV] = vA;
+      }
+    });
   }
 
-  faceCenters.markHostBufferUpdated();
+  if (computeSet.faceNormals) faceNormals.markHostBufferUpdated();
+  if (computeSet.faceCenters) faceCenters.markHostBufferUpdated();
+  if (computeSet.faceAreas) faceAreas.markHostBufferUpdated();
+  if (computeSet.vertexNormals) vertexNormals.markHostBufferUpdated();
+  if (computeSet.vertexAreas) vertexAreas.markHostBufferUpdated();
+  if (computeSet.defaultFaceTangentBasisX) defaultFaceTangentBasisX.markHostBufferUpdated();
+  if (computeSet.defaultFaceTangentBasisY) defaultFaceTangentBasisY.markHostBufferUpdated();
 }
 
-void SurfaceMesh::computeFaceAreas() {
+void SurfaceMesh::computeFaceNormals() {
+  GeometryComputeSet computeSet;
+  computeSet.faceNormals = true;
+  computeGeometry(computeSet);
+}
 
-  vertexPositions.ensureHostBufferPopulated();
+void SurfaceMesh::computeFaceCenters() {
+  GeometryComputeSet computeSet;
+  computeSet.faceCenters = true;
+  computeGeometry(computeSet);
+}
 
-  faceAreas.data.resize(nFaces());
+void SurfaceMesh::computeFaceAreas() {
+  GeometryComputeSet computeSet;
+  computeSet.faceAreas = true;
+  computeGeometry(computeSet);
+}
 
-  // Loop over faces to compute face-valued quantities
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t start = faceIndsStart[iF];
-    size_t D = faceIndsStart[iF + 1] - start;
+void SurfaceMesh::computeVertexNormals() {
+  GeometryComputeSet computeSet;
+  computeSet.vertexNormals = true;
+  computeGeometry(computeSet);
+}
 
-    // Compute a face normal
-    double fA;
-    if (D == 3) {
-      glm::vec3 pA = vertexPositions.data[faceIndsEntries[start + 0]];
-      glm::vec3 pB = vertexPositions.data[faceIndsEntries[start + 1]];
-      glm::vec3 pC = vertexPositions.data[faceIndsEntries[start + 2]];
-      glm::vec3 fN = glm::cross(pB - pA, pC - pA);
-      fA = 0.5 * glm::length(fN);
-    } else {
-      fA = 0;
-      glm::vec3 pRoot = vertexPositions.data[faceIndsEntries[start]];
-      for (size_t j = 1; j + 1 < D; j++) {
-        glm::vec3 pA = vertexPositions.data[faceIndsEntries[start + j]];
-        glm::vec3 pB = vertexPositions.data[faceIndsEntries[start + j + 1]];
-        fA += 0.5 * glm::length(glm::cross(pA - pRoot, pB - pRoot));
-      }
-    }
+void SurfaceMesh::computeVertexAreas() {
+  GeometryComputeSet computeSet;
+  computeSet.vertexAreas = true;
+  computeGeometry(computeSet);
+}
 
-    faceAreas.data[iF] = fA;
-  }
+void SurfaceMesh::computeDefaultFaceTangentBasisX() {
+  // NOTE: the tangent basis is weirdly split into an 'X' and 'Y' buffer to fit the compute-function-per-buffer
+  // paradigm
+  GeometryComputeSet computeSet;
+  computeSet.defaultFaceTangentBasisX = true;
+  computeGeometry(computeSet);
+}
 
-  faceAreas.markHostBufferUpdated();
+void SurfaceMesh::computeDefaultFaceTangentBasisY() {
+  GeometryComputeSet computeSet;
+  computeSet.defaultFaceTangentBasisY = true;
+  computeGeometry(computeSet);
 }
 
+// === Per-triangle data for indexed rendering ===
+// (each is padded out to fill the last row of its texture)
 
-void SurfaceMesh::computeVertexNormals() {
+void SurfaceMesh::computeTriangleFaceNormals() {
 
   faceNormals.ensureHostBufferPopulated();
-  faceAreas.ensureHostBufferPopulated();
-
-  vertexNormals.data.resize(nVertices());
-
-  const glm::vec3 zero{0., 0., 0.};
+  triangleFaceInds.ensureHostBufferPopulated();
 
-  std::fill(vertexNormals.data.begin(), vertexNormals.data.end(), zero);
+  std::array<uint32_t, 3> texSize = triangleFaceNormals.getTextureSize();
+  triangleFaceNormals.data.assign(texSize[0] * texSize[1], glm::vec3{0., 0., 0.});
 
-  // Accumulate quantities from each face
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t start = faceIndsStart[iF];
-    size_t D = faceIndsStart[iF + 1] - start;
-    for (size_t j = 0; j < D; j++) {
-      size_t iV = faceIndsEntries[start + j];
-      vertexNormals.data[iV] += faceNormals.data[iF] * static_cast<float>(faceAreas.data[iF]);
+  parallelForChunks(nFacesTriangulation(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iT = iStart; iT < iEnd; iT++) {
+      triangleFaceNormals.data[iT] = faceNormals.data[triangleFaceInds.data[3 * iT]];
     }
-  }
-
-  // Normalize
-  for (size_t iV = 0; iV < nVertices(); iV++) {
-    vertexNormals.data[iV] = glm::normalize(vertexNormals.data[iV]);
-  }
+  });
 
-  vertexNormals.markHostBufferUpdated();
+  triangleFaceNormals.markHostBufferUpdated();
 }
 
-void SurfaceMesh::computeVertexAreas() {
+void SurfaceMesh::computeTriangleFaceCenters() {
 
-  faceAreas.ensureHostBufferPopulated();
+  faceCenters.ensureHostBufferPopulated();
+  triangleFaceInds.ensureHostBufferPopulated();
 
-  vertexAreas.data.resize(nVertices());
-  std::fill(vertexAreas.data.begin(), vertexAreas.data.end(), 0.);
+  std::array<uint32_t, 3> texSize = triangleFaceCenters.getTextureSize();
+  triangleFaceCenters.data.assign(texSize[0] * texSize[1], glm::vec3{0., 0., 0.});
 
-  // Accumulate quantities from each face
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
-    size_t start = faceIndsStart[iF];
-    for (size_t j = 0; j < D; j++) {
-      size_t iV = faceIndsEntries[start + j];
-      vertexAreas.data[iV] += faceAreas.data[iF] / D;
+  parallelForChunks(nFacesTriangulation(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iT = iStart; iT < iEnd; iT++) {
+      triangleFaceCenters.data[iT] = faceCenters.data[triangleFaceInds.data[3 * iT]];
     }
-  }
+  });
 
-  vertexAreas.markHostBufferUpdated();
+  triangleFaceCenters.markHostBufferUpdated();
 }
 
-void SurfaceMesh::computeDefaultFaceTangentBasisX() {
-
-  // NOTE: this function is weirdly duplicated into an 'X' and 'Y' paradigm to fit the compute-function-per-buffer
-  // paradigm
+void SurfaceMesh::computeTriangleCornerPositions() {
 
   vertexPositions.ensureHostBufferPopulated();
-  faceNormals.ensureHostBufferPopulated();
-
-  defaultFaceTangentBasisX.data.resize(nFaces());
-
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
-    if (D != 3) exception("Default face tangent spaces only available for pure-triangular meshes");
-
-    size_t start = faceIndsStart[iF];
-
-    glm::vec3 pA = vertexPositions.data[faceIndsEntries[start + 0]];
-    glm::vec3 pB = vertexPositions.data[faceIndsEntries[start + 1]];
-    glm::vec3 N = faceNormals.data[iF];
-
-    glm::vec3 basisX = pB - pA;
-    basisX = glm::normalize(basisX - N * glm::dot(N, basisX));
+  triangleVertexInds.ensureHostBufferPopulated();
 
-    glm::vec3 basisY = glm::normalize(-glm::cross(basisX, N));
+  std::array<uint32_t, 3> texSize = triangleCornerPositions.getTextureSize();
+  triangleCornerPositions.data.assign(texSize[0] * texSize[1], glm::vec3{0., 0., 0.});
 
-    defaultFaceTangentBasisX.data[iF] = basisX;
-  }
+  parallelForChunks(3 * nFacesTriangulation(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iC = iStart; iC < iEnd; iC++) {
+      triangleCornerPositions.data[iC] = vertexPositions.data[triangleVertexInds.data[iC]];
+    }
+  });
 
-  defaultFaceTangentBasisX.markHostBufferUpdated();
+  triangleCornerPositions.markHostBufferUpdated();
 }
 
-void SurfaceMesh::computeDefaultFaceTangentBasisY() {
-
-  // NOTE: this function is weirdly duplicated into an 'X' and 'Y' paradigm to fit the compute-function-per-buffer
-  // paradigm
-
-  vertexPositions.ensureHostBufferPopulated();
-  faceNormals.ensureHostBufferPopulated();
+void SurfaceMesh::computeTriangleEdgeFlags() {
 
-  defaultFaceTangentBasisY.data.resize(nFaces());
+  std::array<uint32_t, 3> texSize = triangleEdgeFlags.getTextureSize();
+  triangleEdgeFlags.data.assign(texSize[0] * texSize[1], 0.);
 
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
-    if (D != 3) exception("Default face tangent spaces only available for pure-triangular meshes");
+  // flag the edges of each triangle which are edges of the original polygon (rather than internal edges of the
+  // triangulation), packed in to bits (x = 1, y = 2, z = 4)
+  parallelForChunks(nFaces(), [&](size_t iChunk, size_t iChunkStart, size_t iChunkEnd) {
+    for (size_t iF = iChunkStart; iF < iChunkEnd; iF++) {
+      size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
+      size_t iT = faceTriangleStart[iF];
+      for (size_t j = 1; (j + 1) < D; j++) {
+        uint32_t flags = 2;
+        if (j == 1) flags |= 1;
+        if (j + 2 == D) flags |= 4;
+        triangleEdgeFlags.data[iT] = static_cast<float>(flags);
+        iT++;
+      }
+    }
+  });
 
-    size_t start = faceIndsStart[iF];
+  triangleEdgeFlags.markHostBufferUpdated();
+}
 
-    glm::vec3 pA = vertexPositions.data[faceIndsEntries[start + 0]];
-    glm::vec3 pB = vertexPositions.data[faceIndsEntries[start + 1]];
-    glm::vec3 N = faceNormals.data[iF];
+void SurfaceMesh::computeTrianglePickInds() {
 
-    glm::vec3 basisX = pB - pA;
-    basisX = glm::normalize(basisX - N * glm::dot(N, basisX));
+  triangleVertexInds.ensureHostBufferPopulated();
+  triangleFaceInds.ensureHostBufferPopulated();
 
-    glm::vec3 basisY = glm::normalize(-glm::cross(basisX, N));
+  std::array<uint32_t, 3> texSize = trianglePickInds.getTextureSize();
+  trianglePickInds.data.assign(texSize[0] * texSize[1], glm::vec4{0., 0., 0., 0.});
 
-    defaultFaceTangentBasisY.data[iF] = basisY;
-  }
+  parallelForChunks(nFacesTriangulation(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iT = iStart; iT < iEnd; iT++) {
+      trianglePickInds.data[iT] = glm::vec4{static_cast<float>(triangleVertexInds.data[3 * iT + 0]),
+                                            static_cast<float>(triangleVertexInds.data[3 * iT + 1]),
+                                            static_cast<float>(triangleVertexInds.data[3 * iT + 2]),
+                                            static_cast<float>(triangleFaceInds.data[3 * iT])};
+    }
+  });
 
-  defaultFaceTangentBasisY.markHostBufferUpdated();
+  trianglePickInds.markHostBufferUpdated();
 }
 
 // === Edge Lengths ===
@@ -668,58 +752,19 @@ void SurfaceMesh::checkTriangular() {
 void SurfaceMesh::ensureHaveManifoldConnectivity() {
   if (!twinHalfedge.empty()) return; // already populated
 
-  triangleVertexInds.ensureHostBufferPopulated();
-
-  twinHalfedge.resize(nHalfedges());
-
-  // Maps from edge (sorted) to all halfedges incident on that edge
-  std::unordered_map<std::pair<size_t, size_t>, std::vector<size_t>,
-                     polyscope::hash_combine::hash<std::pair<size_t, size_t>>>
-      edgeInds;
+  EdgeTopology topology = buildEdgeTopology(faceOrderedTriangleVertexInds(), nVertices(), true);
 
-  // Fill out faceForHalfedge and populate edge lookup map
-  for (size_t iF = 0; iF < nFacesTriangulation(); iF++) {
-    for (size_t j = 0; j < 3; j++) {
-      size_t iV = triangleVertexInds.data[3 * iF + j];
-      size_t iVNext = triangleVertexInds.data[3 * iF + ((j + 1) % 3)];
-      size_t iHe = 3 * iF + j;
-
-
-      std::pair<size_t, size_t> edgeKey(std::min(iV, iVNext), std::max(iV, iVNext));
-
-      // Make sure the key is populated
-      auto it = edgeInds.find(edgeKey);
-      if (it == edgeInds.end()) {
-        it = edgeInds.insert(it, {edgeKey, std::vector<size_t>()});
-      }
-
-      // Add this halfedge to the entry
-      it->second.push_back(iHe);
-    }
+  // for each halfedge, the first other halfedge we find on the same edge
+  twinHalfedge.resize(topology.halfedgeTwin.size());
+  for (size_t iHe = 0; iHe < topology.halfedgeTwin.size(); iHe++) {
+    uint32_t twin = topology.halfedgeTwin[iHe];
+    twinHalfedge[iHe] = (twin == INVALID_IND_32) ? INVALID_IND : twin;
   }
+}
 
-  // Second walk through, setting twins
-  for (size_t iF = 0; iF < nFacesTriangulation(); iF++) {
-    for (size_t j = 0; j < 3; j++) {
-      size_t iV = triangleVertexInds.data[3 * iF + j];
-      size_t iVNext = triangleVertexInds.data[3 * iF + ((j + 1) % 3)];
-      size_t iHe = 3 * iF + j;
-
-      std::pair<size_t, size_t> edgeKey(std::min(iV, iVNext), std::max(iV, iVNext));
-      std::vector<size_t>& edgeHalfedges = edgeInds.find(edgeKey)->second;
-
-      // Pick the first halfedge we find which is not this one
-      size_t myTwin = INVALID_IND;
-      for (size_t t : edgeHalfedges) {
-        if (t != iHe) {
-          myTwin = t;
-          break;
-        }
-      }
-
-      twinHalfedge[iHe] = myTwin;
-    }
-  }
+void SurfaceMesh::ensureHaveVertexFaceAdjacency() {
+  if (!vertexFaceAdjacency.vertexStart.empty()) return; // already populated
+  vertexFaceAdjacency = buildVertexFaceAdjacency(faceIndsStart, faceIndsEntries, nVertices());
 }
 
 void SurfaceMesh::draw() {
@@ -728,6 +773,8 @@ void SurfaceMesh::draw() {
   }
 
   render::engine->setBackfaceCull(backFacePolicy.get() == BackFacePolicy::Cull);
+  updateMeshletDrawRanges();
+  updateLevelOfDetail();
 
   // If no quantity is drawing the surface, we should draw it
   if (dominantQuantity == nullptr) {
@@ -744,6 +791,7 @@ void SurfaceMesh::draw() {
     setSurfaceMeshUniforms(*program);
     program->setUniform("u_baseColor", getSurfaceColor());
     render::engine->setMaterialUniforms(*program, getMaterial());
+    prepareMeshDraw(*program);
 
     program->draw();
   }
@@ -788,26 +836,16 @@ void SurfaceMesh::drawPick() {
   }
 
   render::engine->setBackfaceCull(backFacePolicy.get() == BackFacePolicy::Cull);
+  updateMeshletDrawRanges();
 
   // Set uniforms
   setStructureUniforms(*pickProgram);
 
   if (usingSimplePick) {
-    float radVal;
-    switch (selectionMode.get()) {
-    case MeshSelectionMode::Auto:
-      radVal = 0.2;
-      break;
-    case MeshSelectionMode::VerticesOnly:
-      radVal = 1.;
-      break;
-    case MeshSelectionMode::FacesOnly:
-      radVal = 0.;
-      break;
-    }
-    pickProgram->setUniform("u_vertPickRadius", radVal);
+    pickProgram->setUniform("u_vertPickRadius", getVertexPickRadius());
   }
 
+  prepareMeshDraw(*pickProgram);
   pickProgram->draw();
 
   for (auto& x : quantities) {
@@ -835,10 +873,12 @@ void SurfaceMesh::drawPickDelayed() {
 }
 
 void SurfaceMesh::prepare() {
+  bool indexed = usingIndexedRendering();
+
   // clang-format off
-  program = render::engine->requestShader( "MESH", 
+  program = render::engine->requestShader(indexed ? "INDEXED_MESH" : "MESH", 
       render::engine->addMaterialRules(getMaterial(),
-        addSurfaceMeshRules({"SHADE_BASECOLOR"})
+        addSurfaceMeshRules({"SHADE_BASECOLOR"}, true, true, indexed)
       )
   );
   // clang-format on
@@ -846,30 +886,52 @@ void SurfaceMesh::prepare() {
   // Populate draw buffers
   setMeshGeometryAttributes(*program);
   render::engine->setMaterial(*program, getMaterial());
+
+  if (getMeshletCulling()) ensureHaveMeshlets();
 }
 
-void SurfaceMesh::preparePick() {
+bool SurfaceMesh::wantsSimplePick() {
+  switch (selectionMode.get()) {
+  case MeshSelectionMode::Auto:
+    return !(edgesHaveBeenUsed || halfedgesHaveBeenUsed || cornersHaveBeenUsed);
+  case MeshSelectionMode::VerticesOnly:
+    return true;
+  case MeshSelectionMode::FacesOnly:
+    return true;
+  }
+  return true;
+}
 
+float SurfaceMesh::getVertexPickRadius() {
   switch (selectionMode.get()) {
   case MeshSelectionMode::Auto:
-    usingSimplePick = !(edgesHaveBeenUsed || halfedgesHaveBeenUsed || cornersHaveBeenUsed);
-    break;
+    return 0.2;
   case MeshSelectionMode::VerticesOnly:
-    usingSimplePick = true;
-    break;
+    return 1.;
   case MeshSelectionMode::FacesOnly:
-    usingSimplePick = true;
-    break;
+    return 0.;
   }
+  return 0.2;
+}
 
-  if (usingSimplePick) {
-    pickProgram =
-        render::engine->requestShader("MESH", addSurfaceMeshRules({"MESH_PROPAGATE_PICK_SIMPLE"}, true, false),
-                                      render::ShaderReplacementDefaults::Pick);
-  } else {
-    pickProgram = render::engine->requestShader("MESH", addSurfaceMeshRules({"MESH_PROPAGATE_PICK"}, true, false),
-                                                render::ShaderReplacementDefaults::Pick);
+void SurfaceMesh::preparePick() {
+
+  usingSimplePick = wantsSimplePick();
+
+  // For simple picking, the pick colors are computed in the shader from a per-triangle texture of element indices,
+  // rather than building and uploading several colors per corner. The indices are stored as floats, which only
+  // represent them exactly up to 2^24.
+  const size_t maxShaderPickInds = static_cast<size_t>(1) << 24;
+  usingShaderPickInds = usingSimplePick && nVertices() <= maxShaderPickInds && nFaces() <= maxShaderPickInds;
+
+  std::string pickRule = "MESH_PROPAGATE_PICK";
+  if (usingShaderPickInds) {
+    pickRule = "MESH_PROPAGATE_PICK_SIMPLE_FROM_INDS";
+  } else if (usingSimplePick) {
+    pickRule = "MESH_PROPAGATE_PICK_SIMPLE";
   }
+  pickProgram = render::engine->requestShader("MESH", addSurfaceMeshRules({pickRule}, true, false),
+                                              render::ShaderReplacementDefaults::Pick);
 
   // Populate draw buffers
   setMeshGeometryAttributes(*pickProgram);
@@ -877,6 +939,12 @@ void SurfaceMesh::preparePick() {
 }
 
 void SurfaceMesh::setMeshGeometryAttributes(render::ShaderProgram& p) {
+
+  if (p.getDrawMode() == DrawMode::IndexedTriangles) {
+    setMeshGeometryAttributesIndexed(p);
+    return;
+  }
+
   if (p.hasAttribute("a_vertexPositions")) {
     p.setAttribute("a_vertexPositions", vertexPositions.getIndexedRenderAttributeBuffer(triangleVertexInds));
   }
@@ -893,11 +961,8 @@ void SurfaceMesh::setMeshGeometryAttributes(render::ShaderProgram& p) {
   if (p.hasAttribute("a_normal")) {
     p.setAttribute("a_normal", faceNormals.getIndexedRenderAttributeBuffer(triangleFaceInds));
   }
-  if (p.hasAttribute("a_barycoord")) {
-    p.setAttribute("a_barycoord", baryCoord.getRenderAttributeBuffer());
-  }
-  if (p.hasAttribute("a_edgeIsReal")) {
-    p.setAttribute("a_edgeIsReal", edgeIsReal.getRenderAttributeBuffer());
+  if (p.hasTexture("t_triangleEdgeFlags")) {
+    p.setTextureFromBuffer("t_triangleEdgeFlags", triangleEdgeFlags.getRenderTextureBuffer().get());
   }
   if (wantsCullPosition()) {
     p.setAttribute("a_cullPos", faceCenters.getIndexedRenderAttributeBuffer(triangleFaceInds));
@@ -909,31 +974,69 @@ void SurfaceMesh::setMeshGeometryAttributes(render::ShaderProgram& p) {
   }
 }
 
-void SurfaceMesh::setMeshPickAttributes(render::ShaderProgram& p) {
+void SurfaceMesh::setMeshGeometryAttributesIndexed(render::ShaderProgram& p) {
 
-  // TODO in principle all of the data this shader needs is already available on the GPU via the [...]Inds attribute
-  // buffers. We could move the encoding / offsetting logic to happen in a shader with some uniforms, and avoid any
-  // CPU-side processing. Maybe the solution is to directly render ints?
+  setMeshTriangleBuffersIndexed(p);
 
-  // make sure we have the relevant indexing data
-  triangleVertexInds.ensureHostBufferPopulated();
-  triangleFaceInds.ensureHostBufferPopulated();
-  if (edgesHaveBeenUsed) triangleAllEdgeInds.ensureHostBufferPopulated();
-  if (halfedgesHaveBeenUsed) triangleAllHalfedgeInds.ensureHostBufferPopulated();
-  if (cornersHaveBeenUsed) triangleCornerInds.ensureHostBufferPopulated();
+  if (p.hasAttribute("a_vertexPositions")) {
+    p.setAttribute("a_vertexPositions", vertexPositions.getRenderAttributeBuffer());
+  }
+  if (p.hasAttribute("a_vertexNormals")) {
+    if (getShadeStyle() == MeshShadeStyle::Smooth) {
+      p.setAttribute("a_vertexNormals", vertexNormals.getRenderAttributeBuffer());
+    } else {
+      // these aren't actually used when the normal is looked up per-triangle, but the shader is set up in a lazy way
+      // so it is still needed
+      p.setAttribute("a_vertexNormals", vertexPositions.getRenderAttributeBuffer());
+    }
+  }
+}
+
+void SurfaceMesh::setMeshTriangleBuffersIndexed(render::ShaderProgram& p) {
+
+  // the simplified levels of detail have their own triangles, but share the vertex data
+  LevelOfDetail* level = (currentLevelOfDetail > 0) ? levelsOfDetail[currentLevelOfDetail - 1].get() : nullptr;
+
+  // all vertex data is shared between triangles, drawn via the index buffer
+  p.setIndex((level ? level->triangleVertexInds : triangleVertexInds).getRenderAttributeBuffer());
+
+  // per-triangle data, looked up by primitive index
+  if (p.hasTexture("t_triangleFaceNormals")) {
+    render::ManagedBuffer<glm::vec3>& buff = level ? level->triangleFaceNormals : triangleFaceNormals;
+    p.setTextureFromBuffer("t_triangleFaceNormals", buff.getRenderTextureBuffer().get());
+  }
+  if (p.hasTexture("t_triangleFaceCenters")) {
+    render::ManagedBuffer<glm::vec3>& buff = level ? level->triangleFaceCenters : triangleFaceCenters;
+    p.setTextureFromBuffer("t_triangleFaceCenters", buff.getRenderTextureBuffer().get());
+  }
+  if (p.hasTexture("t_triangleCornerPositions")) {
+    render::ManagedBuffer<glm::vec3>& buff = level ? level->triangleCornerPositions : triangleCornerPositions;
+    p.setTextureFromBuffer("t_triangleCornerPositions", buff.getRenderTextureBuffer().get());
+  }
+  if (p.hasTexture("t_triangleEdgeFlags")) {
+    render::ManagedBuffer<float>& buff = level ? level->triangleEdgeFlags : triangleEdgeFlags;
+    p.setTextureFromBuffer("t_triangleEdgeFlags", buff.getRenderTextureBuffer().get());
+  }
+}
+
+void SurfaceMesh::updatePickIndStarts() {
 
   // nEdges() requires computing number of edges, which is expensive and might not even be implemented for polygonal
   // meshes. This way we only call it if actually needed, and use 0 otherwise.
   size_t nEdgesSafe = edgesHaveBeenUsed ? nEdges() : 0;
 
-  // Get element indices
-  size_t totalPickElements = nVertices() + nFaces() + nEdgesSafe + nHalfedges() + nCorners();
-
   // In "local" indices, indexing elements only within this mesh, used for reading later
   facePickIndStart = nVertices();
   edgePickIndStart = facePickIndStart + nFaces();
   halfedgePickIndStart = edgePickIndStart + nEdgesSafe;
   cornerPickIndStart = halfedgePickIndStart + nHalfedges();
+}
+
+void SurfaceMesh::setMeshPickAttributes(render::ShaderProgram& p) {
+
+  // Get element indices
+  updatePickIndStarts();
+  size_t totalPickElements = cornerPickIndStart + nCorners();
 
   // In "global" indices, indexing all elements in the scene, used to fill buffers for drawing here
   size_t pickStart = pick::requestPickBufferRange(this, totalPickElements);
@@ -943,114 +1046,131 @@ void SurfaceMesh::setMeshPickAttributes(render::ShaderProgram& p) {
   size_t halfedgeGlobalPickIndStart = pickStart + halfedgePickIndStart;
   size_t cornerGlobalPickIndStart = pickStart + cornerPickIndStart;
 
+  // The shader computes the colors from the indices, it only needs to know where each range starts
+  if (usingShaderPickInds) {
+    p.setUniform("u_vertexPickStart", pick::indToVec(vertexGlobalPickIndStart));
+    p.setUniform("u_facePickStart", pick::indToVec(faceGlobalPickIndStart));
+    p.setTextureFromBuffer("t_trianglePickInds", trianglePickInds.getRenderTextureBuffer().get());
+    return;
+  }
+
+  // make sure we have the relevant indexing data
+  triangleVertexInds.ensureHostBufferPopulated();
+  triangleFaceInds.ensureHostBufferPopulated();
+  if (edgesHaveBeenUsed) triangleAllEdgeInds.ensureHostBufferPopulated();
+  if (halfedgesHaveBeenUsed) triangleAllHalfedgeInds.ensureHostBufferPopulated();
+  if (cornersHaveBeenUsed) triangleCornerInds.ensureHostBufferPopulated();
+
   // == Fill buffers
   std::vector<std::array<glm::vec3, 3>> vertexColors, halfedgeColors, cornerColors;
   std::vector<glm::vec3> faceColor;
 
-  // Reserve space
-  vertexColors.reserve(3 * nFacesTriangulation());
-  faceColor.reserve(3 * nFacesTriangulation());
+  // Allocate space
+  vertexColors.resize(3 * nFacesTriangulation());
+  faceColor.resize(3 * nFacesTriangulation());
   if (!usingSimplePick) {
-    halfedgeColors.reserve(3 * nFacesTriangulation());
-    cornerColors.reserve(3 * nFacesTriangulation());
+    halfedgeColors.resize(3 * nFacesTriangulation());
+    cornerColors.resize(3 * nFacesTriangulation());
   }
 
 
-  // Build all quantities in each face
-  size_t iFTri = 0;
-  for (size_t iF = 0; iF < nFaces(); iF++) {
-    size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
+  // Build all quantities in each face (each face fills its own triangles, so they can be done in parallel)
+  parallelForChunks(nFaces(), [&](size_t iChunk, size_t iChunkStart, size_t iChunkEnd) {
+    for (size_t iF = iChunkStart; iF < iChunkEnd; iF++) {
+      size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
+      size_t iFTri = faceTriangleStart[iF];
 
-    glm::vec3 fColor = pick::indToVec(iF + faceGlobalPickIndStart);
+      glm::vec3 fColor = pick::indToVec(iF + faceGlobalPickIndStart);
 
-    for (size_t j = 1; (j + 1) < D; j++) {
+      for (size_t j = 1; (j + 1) < D; j++) {
 
-      // == Build face & vertex index data
+        // == Build face & vertex index data
 
-      // clang-format off
-      std::array<glm::vec3, 3> vColor = {
-        pick::indToVec(triangleVertexInds.data[3*iFTri + 0] + vertexGlobalPickIndStart),
-        pick::indToVec(triangleVertexInds.data[3*iFTri + 1] + vertexGlobalPickIndStart),
-        pick::indToVec(triangleVertexInds.data[3*iFTri + 2] + vertexGlobalPickIndStart),
-      };
-      // clang-format on
-
-      for (int j = 0; j < 3; j++) {
-        faceColor.push_back(fColor);
-        vertexColors.push_back(vColor);
-      }
+        // clang-format off
+        std::array<glm::vec3, 3> vColor = {
+          pick::indToVec(triangleVertexInds.data[3*iFTri + 0] + vertexGlobalPickIndStart),
+          pick::indToVec(triangleVertexInds.data[3*iFTri + 1] + vertexGlobalPickIndStart),
+          pick::indToVec(triangleVertexInds.data[3*iFTri + 2] + vertexGlobalPickIndStart),
+        };
+        // clang-format on
 
-      // Second half does halfedges/edges/corners, not used for simple mode
-      if (usingSimplePick) {
-        iFTri++;
-        continue;
-      }
+        for (int k = 0; k < 3; k++) {
+          faceColor[3 * iFTri + k] = fColor;
+          vertexColors[3 * iFTri + k] = vColor;
+        }
 
+        // Second half does halfedges/edges/corners, not used for simple mode
+        if (usingSimplePick) {
+          iFTri++;
+          continue;
+        }
 
-      // Fill the halfedge buffer with edge or halfedge data, depending on which are in use
-      // In the pick function we will use the halfedge to look up the edge if needed
-      // (this is an optimization to use one less array of values, because we hit implementation limits in the shader)
 
-      // == Build edge index data, if needed
+        // Fill the halfedge buffer with edge or halfedge data, depending on which are in use
+        // In the pick function we will use the halfedge to look up the edge if needed
+        // (this is an optimization to use one less array of values, because we hit implementation limits in the shader)
 
-      if (!usingSimplePick) {
-        if (edgesHaveBeenUsed || halfedgesHaveBeenUsed) {
+        // == Build edge index data, if needed
 
-          const std::vector<uint32_t>& eDataVec =
-              (edgesHaveBeenUsed && !halfedgesHaveBeenUsed) ? triangleAllEdgeInds.data : triangleAllHalfedgeInds.data;
-          size_t offset =
-              (edgesHaveBeenUsed && !halfedgesHaveBeenUsed) ? edgeGlobalPickIndStart : halfedgeGlobalPickIndStart;
+        if (!usingSimplePick) {
+          if (edgesHaveBeenUsed || halfedgesHaveBeenUsed) {
 
-          // clang-format off
-        std::array<glm::vec3, 3> eColor = { 
-          fColor, 
-          pick::indToVec(eDataVec[9*iFTri + 1] + offset), 
-          fColor
-        };
-          // clang-format on
-          if (j == 1) eColor[0] = pick::indToVec(eDataVec[9 * iFTri + 0] + offset);
-          if (j + 2 == D) eColor[2] = pick::indToVec(eDataVec[9 * iFTri + 2] + offset);
+            const std::vector<uint32_t>& eDataVec =
+                (edgesHaveBeenUsed && !halfedgesHaveBeenUsed) ? triangleAllEdgeInds.data : triangleAllHalfedgeInds.data;
+            size_t offset =
+                (edgesHaveBeenUsed && !halfedgesHaveBeenUsed) ? edgeGlobalPickIndStart : halfedgeGlobalPickIndStart;
 
-          for (int j = 0; j < 3; j++) halfedgeColors.push_back(eColor);
-        } else {
-          for (int j = 0; j < 3; j++) halfedgeColors.push_back({fColor, fColor, fColor});
-        }
-      }
+            // clang-format off
+          std::array<glm::vec3, 3> eColor = { 
+            fColor, 
+            pick::indToVec(eDataVec[9*iFTri + 1] + offset), 
+            fColor
+          };
+            // clang-format on
+            if (j == 1) eColor[0] = pick::indToVec(eDataVec[9 * iFTri + 0] + offset);
+            if (j + 2 == D) eColor[2] = pick::indToVec(eDataVec[9 * iFTri + 2] + offset);
 
-      // == Build corner index data, if needed
+            for (int k = 0; k < 3; k++) halfedgeColors[3 * iFTri + k] = eColor;
+          } else {
+            for (int k = 0; k < 3; k++) halfedgeColors[3 * iFTri + k] = {fColor, fColor, fColor};
+          }
+        }
 
-      if (!usingSimplePick) {
-        if (cornersHaveBeenUsed) {
-          // clang-format off
-        std::array<glm::vec3, 3> cColor = { 
-          pick::indToVec(triangleCornerInds.data[3*iFTri + 0] + cornerGlobalPickIndStart), 
-          pick::indToVec(triangleCornerInds.data[3*iFTri + 1] + cornerGlobalPickIndStart), 
-          pick::indToVec(triangleCornerInds.data[3*iFTri + 2] + cornerGlobalPickIndStart), 
-        };
-          // clang-format on
-          for (int j = 0; j < 3; j++) cornerColors.push_back(cColor);
-        } else {
-          for (int j = 0; j < 3; j++) cornerColors.push_back({vColor[0], vColor[1], vColor[2]});
+        // == Build corner index data, if needed
+
+        if (!usingSimplePick) {
+          if (cornersHaveBeenUsed) {
+            // clang-format off
+          std::array<glm::vec3, 3> cColor = { 
+            pick::indToVec(triangleCornerInds.data[3*iFTri + 0] + cornerGlobalPickIndStart), 
+            pick::indToVec(triangleCornerInds.data[3*iFTri + 1] + cornerGlobalPickIndStart), 
+            pick::indToVec(triangleCornerInds.data[3*iFTri + 2] + cornerGlobalPickIndStart), 
+          };
+            // clang-format on
+            for (int k = 0; k < 3; k++) cornerColors[3 * iFTri + k] = cColor;
+          } else {
+            for (int k = 0; k < 3; k++) cornerColors[3 * iFTri + k] = {vColor[0], vColor[1], vColor[2]};
+          }
         }
-      }
 
-      iFTri++;
+        iFTri++;
+      }
     }
-  }
+  });
 
   // == Store data in buffers
 
-  pickProgram->setAttribute("a_vertexColors", vertexColors);
-  pickProgram->setAttribute("a_faceColor", faceColor);
+  p.setAttribute("a_vertexColors", vertexColors);
+  p.setAttribute("a_faceColor", faceColor);
   if (!usingSimplePick) {
-    pickProgram->setAttribute("a_halfedgeColors", halfedgeColors);
-    pickProgram->setAttribute("a_cornerColors", cornerColors);
+    p.setAttribute("a_halfedgeColors", halfedgeColors);
+    p.setAttribute("a_cornerColors", cornerColors);
   }
 }
 
 
 std::vector<std::string> SurfaceMesh::addSurfaceMeshRules(std::vector<std::string> initRules, bool withMesh,
-                                                          bool withSurfaceShade) {
+                                                          bool withSurfaceShade, bool indexed) {
   initRules = addStructureRules(initRules);
 
   if (withMesh) {
@@ -1058,7 +1178,7 @@ std::vector<std::string> SurfaceMesh::addSurfaceMeshRules(std::vector<std::strin
     if (withSurfaceShade) {
       // rules that only get used when we're shading the surface of the mesh
       if (getEdgeWidth() > 0) {
-        initRules.push_back("MESH_WIREFRAME_FROM_BARY");
+        initRules.push_back(indexed ? "MESH_INDEXED_WIREFRAME" : "MESH_WIREFRAME_FROM_BARY");
         initRules.push_back("MESH_WIREFRAME");
       }
 
@@ -1067,6 +1187,10 @@ std::vector<std::string> SurfaceMesh::addSurfaceMeshRules(std::vector<std::strin
         initRules.push_back("PROJ_AND_INV_PROJ_MAT");
       }
 
+      if (indexed && shadeStyle.get() == MeshShadeStyle::Flat) {
+        initRules.push_back("MESH_INDEXED_FACE_NORMAL");
+      }
+
       if (backFacePolicy.get() == BackFacePolicy::Different) {
         initRules.push_back("MESH_BACKFACE_DARKEN");
       }
@@ -1088,7 +1212,7 @@ std::vector<std::string> SurfaceMesh::addSurfaceMeshRules(std::vector<std::strin
     }
 
     if (wantsCullPosition()) {
-      initRules.push_back("MESH_PROPAGATE_CULLPOS");
+      initRules.push_back(indexed ? "MESH_INDEXED_PROPAGATE_CULLPOS" : "MESH_PROPAGATE_CULLPOS");
     }
 
     if (transparencyQuantityName != "") {
@@ -1424,6 +1548,24 @@ void SurfaceMesh::buildCustomOptionsUI() {
     ImGui::EndMenu();
   }
 
+  if (ImGui::MenuItem("Indexed Rendering", NULL, indexedRendering.get())) {
+    setIndexedRendering(!indexedRendering.get());
+  }
+  if (ImGui::MenuItem("Meshlet Culling", NULL, meshletCulling.get())) {
+    setMeshletCulling(!meshletCulling.get());
+  }
+  if (ImGui::BeginMenu("Level of Detail")) {
+    if (ImGui::MenuItem("Enabled", NULL, levelOfDetail.get())) setLevelOfDetail(!levelOfDetail.get());
+    if (ImGui::SliderFloat("Pixel Error", &levelOfDetailPixelError.get(), 0.25, 16., "%.2f")) {
+      levelOfDetailPixelError.manuallyChanged();
+      requestRedraw();
+    }
+    ImGui::TextUnformatted(("Current level: " + std::to_string(currentLevelOfDetail) + " / " +
+                            std::to_string(levelsOfDetail.size()))
+                               .c_str());
+    ImGui::EndMenu();
+  }
+
   // Selection mode
   if (ImGui::BeginMenu("Selection Mode")) {
     if (ImGui::MenuItem("auto", NULL, selectionMode.get() == MeshSelectionMode::Auto))
@@ -1461,12 +1603,284 @@ void SurfaceMesh::buildCustomOptionsUI() {
 }
 
 void SurfaceMesh::recomputeGeometryIfPopulated() {
-  faceNormals.recomputeIfPopulated();
-  faceCenters.recomputeIfPopulated();
-  faceAreas.recomputeIfPopulated();
-  vertexNormals.recomputeIfPopulated();
-  vertexAreas.recomputeIfPopulated();
-  // edgeLengths.recomputeIfPopulated();
+
+  // recompute everything which is in use in a single pass
+  GeometryComputeSet computeSet;
+  computeSet.faceNormals = faceNormals.hasData();
+  computeSet.faceCenters = faceCenters.hasData();
+  computeSet.faceAreas = faceAreas.hasData();
+  computeSet.vertexNormals = vertexNormals.hasData();
+  computeSet.vertexAreas = vertexAreas.hasData();
+  computeSet.defaultFaceTangentBasisX = defaultFaceTangentBasisX.hasData();
+  computeSet.defaultFaceTangentBasisY = defaultFaceTangentBasisY.hasData();
+  // computeSet.edgeLengths = edgeLengths.hasData();
+
+  // the vertex quantities are gathered from these, which are also stale
+  if (computeSet.vertexNormals) computeSet.faceNormals = true;
+  if (computeSet.vertexNormals || computeSet.vertexAreas) computeSet.faceAreas = true;
+
+  if (computeSet.faceNormals || computeSet.faceCenters || computeSet.faceAreas || computeSet.defaultFaceTangentBasisX ||
+      computeSet.defaultFaceTangentBasisY) {
+    computeGeometry(computeSet);
+  }
+
+  // these depend on the geometry above, so they must come after
+  triangleFaceNormals.recomputeIfPopulated();
+  triangleFaceCenters.recomputeIfPopulated();
+  triangleCornerPositions.recomputeIfPopulated();
+}
+
+void SurfaceMesh::ensureHaveMeshlets() {
+  if (!meshlets.empty() && meshletsPositionsUpdateCount == vertexPositions.getUpdateCount()) return;
+
+  vertexPositions.ensureHostBufferPopulated();
+  triangleVertexInds.ensureHostBufferPopulated();
+  meshlets = buildMeshlets(vertexPositions.data, triangleVertexInds.data);
+  meshletsPositionsUpdateCount = vertexPositions.getUpdateCount();
+}
+
+void SurfaceMesh::updateMeshletDrawRanges() {
+  if (!getMeshletCulling()) return;
+  ensureHaveMeshlets();
+
+  // slice planes which apply to this mesh
+  std::vector<std::array<glm::vec3, 2>> worldSlicePlanes;
+  if (render::engine->slicePlanesEnabled()) {
+    for (std::unique_ptr<SlicePlane>& s : state::slicePlanes) {
+      if (!s->getEnabled() || getIgnoreSlicePlane(s->name)) continue;
+      worldSlicePlanes.push_back({s->getCenter(), s->getNormal()});
+    }
+  }
+
+  // back-facing meshlets can only be skipped if back faces are not drawn at all
+  bool cullBackfaces = backFacePolicy.get() == BackFacePolicy::Cull;
+
+  MeshletCullView cullView = buildMeshletCullView(
+      objectTransform.get(), view::getCameraViewMatrix(), view::getCameraPerspectiveMatrix(),
+      view::getProjectionMode() == ProjectionMode::Orthographic, worldSlicePlanes, cullBackfaces);
+  meshletDrawRanges = cullMeshlets(meshlets, cullView);
+}
+
+void SurfaceMesh::ensureHaveBVH() {
+  if (bvh.isBuilt() && bvhPositionsUpdateCount == vertexPositions.getUpdateCount() &&
+      bvhIndicesUpdateCount == triangleVertexInds.getUpdateCount()) {
+    return;
+  }
+
+  vertexPositions.ensureHostBufferPopulated();
+  triangleVertexInds.ensureHostBufferPopulated();
+  bvh.build(vertexPositions.data, triangleVertexInds.data);
+  bvhPositionsUpdateCount = vertexPositions.getUpdateCount();
+  bvhIndicesUpdateCount = triangleVertexInds.getUpdateCount();
+}
+
+RayCastResult SurfaceMesh::rayCast(glm::vec3 origin, glm::vec3 dir, float tMin, float tMax) {
+  RayCastResult result;
+  ensureHaveBVH();
+
+  bool cullBackfaces = backFacePolicy.get() == BackFacePolicy::Cull;
+  TriangleRayHit hit = rayCastTriangles(bvh, origin, dir, tMin, tMax, cullBackfaces, result);
+  if (!hit.isHit) return result;
+
+  // the triangle is in the draw order of the triangulation
+  triangleVertexInds.ensureHostBufferPopulated();
+  triangleFaceInds.ensureHostBufferPopulated();
+  result.faceIndex = triangleFaceInds.data[3 * hit.triangle];
+  for (size_t k = 0; k < 3; k++) result.triangleVertices[k] = triangleVertexInds.data[3 * hit.triangle + k];
+  return result;
+}
+
+bool SurfaceMesh::canRayCastPick() {
+  // edges, halfedges, and corners can only be picked from the pick buffer
+  return wantsSimplePick() && !wantsCullPosition();
+}
+
+uint64_t SurfaceMesh::rayCastPickIndex(const RayCastResult& hit) {
+  updatePickIndStarts();
+
+  // Like the simple pick shader: the nearest vertex if it is within the pick radius, otherwise the face
+  size_t nearestK = 0;
+  for (size_t k = 1; k < 3; k++) {
+    if (hit.baryCoords[k] > hit.baryCoords[nearestK]) nearestK = k;
+  }
+  if (hit.baryCoords[nearestK] > 1. - getVertexPickRadius()) {
+    return hit.triangleVertices[nearestK];
+  }
+  return facePickIndStart + hit.faceIndex;
+}
+
+std::vector<uint64_t> SurfaceMesh::pickIndicesInRegion(const PickRegion& region) {
+  updatePickIndStarts();
+
+  // Vertices, and faces by their centers, following the selection mode
+  std::vector<uint64_t> inds;
+  if (selectionMode.get() != MeshSelectionMode::FacesOnly) {
+    vertexPositions.ensureHostBufferPopulated();
+    inds = pickIndicesOfPositionsInRegion(vertexPositions.data, 0, region);
+  }
+  if (selectionMode.get() != MeshSelectionMode::VerticesOnly) {
+    faceCenters.ensureHostBufferPopulated();
+    std::vector<uint64_t> faceInds = pickIndicesOfPositionsInRegion(faceCenters.data, facePickIndStart, region);
+    inds.insert(inds.end(), faceInds.begin(), faceInds.end());
+  }
+  return inds;
+}
+
+SurfaceMesh::LevelOfDetail::LevelOfDetail(const std::vector<glm::vec3>& vertexPositions,
+                                          const SimplifiedMeshLevel& level)
+    : error(level.error), triangleVertexIndsData(level.triangleVertexInds),
+      // these are not registered with the structure, since they come and go with the hierarchy
+      triangleVertexInds(nullptr, "levelOfDetailTriangleVertexInds", triangleVertexIndsData),
+      triangleFaceNormals(nullptr, "levelOfDetailTriangleFaceNormals", triangleFaceNormalsData),
+      triangleFaceCenters(nullptr, "levelOfDetailTriangleFaceCenters", triangleFaceCentersData),
+      triangleCornerPositions(nullptr, "levelOfDetailTriangleCornerPositions", triangleCornerPositionsData),
+      triangleEdgeFlags(nullptr, "levelOfDetailTriangleEdgeFlags", triangleEdgeFlagsData) {
+
+  size_t nTriangles = triangleVertexIndsData.size() / 3;
+  std::array<uint32_t, 2> triTexSize = dataTextureSize2D(nTriangles);
+  std::array<uint32_t, 2> cornerTexSize = dataTextureSize2D(3 * nTriangles);
+  triangleFaceNormals.setTextureSize(triTexSize[0], triTexSize[1]);
+  triangleFaceCenters.setTextureSize(triTexSize[0], triTexSize[1]);
+  triangleCornerPositions.setTextureSize(cornerTexSize[0], cornerTexSize[1]);
+  triangleEdgeFlags.setTextureSize(triTexSize[0], triTexSize[1]);
+
+  // (each is padded out to fill the last row of its texture)
+  triangleFaceNormalsData.assign(triTexSize[0] * triTexSize[1], glm::vec3{0., 0., 0.});
+  triangleFaceCentersData.assign(triTexSize[0] * triTexSize[1], glm::vec3{0., 0., 0.});
+  triangleCornerPositionsData.assign(cornerTexSize[0] * cornerTexSize[1], glm::vec3{0., 0., 0.});
+
+  // every edge of a simplified triangle is drawn as a real edge
+  triangleEdgeFlagsData.assign(triTexSize[0] * triTexSize[1], 0.);
+
+  parallelForChunks(nTriangles, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iT = iStart; iT < iEnd; iT++) {
+      glm::vec3 pA = vertexPositions[triangleVertexIndsData[3 * iT + 0]];
+      glm::vec3 pB = vertexPositions[triangleVertexIndsData[3 * iT + 1]];
+      glm::vec3 pC = vertexPositions[triangleVertexIndsData[3 * iT + 2]];
+      glm::vec3 n = glm::cross(pB - pA, pC - pA);
+      float len = glm::length(n);
+      triangleFaceNormalsData[iT] = (len > 0.f) ? n / len : glm::vec3{0., 0., 0.};
+      triangleFaceCentersData[iT] = (pA + pB + pC) / 3.f;
+      triangleCornerPositionsData[3 * iT + 0] = pA;
+      triangleCornerPositionsData[3 * iT + 1] = pB;
+      triangleCornerPositionsData[3 * iT + 2] = pC;
+      triangleEdgeFlagsData[iT] = 7.;
+    }
+  });
+
+  triangleVertexInds.markHostBufferUpdated();
+  triangleFaceNormals.markHostBufferUpdated();
+  triangleFaceCenters.markHostBufferUpdated();
+  triangleCornerPositions.markHostBufferUpdated();
+  triangleEdgeFlags.markHostBufferUpdated();
+}
+
+void SurfaceMesh::updateLevelOfDetail() {
+  currentLevelOfDetail = 0;
+  if (!getLevelOfDetail()) return;
+
+  vertexPositions.ensureHostBufferPopulated();
+  triangleVertexInds.ensureHostBufferPopulated();
+  uint64_t positionsUpdateCount = vertexPositions.getUpdateCount();
+
+  // drop the levels once the positions change, the full mesh is drawn until new ones are built
+  if (levelsOfDetailPositionsUpdateCount != positionsUpdateCount) {
+    levelsOfDetail.clear();
+  }
+
+  auto setLevels = [&](const std::vector<SimplifiedMeshLevel>& levels) {
+    levelsOfDetail.clear();
+    for (const SimplifiedMeshLevel& level : levels) {
+      levelsOfDetail.emplace_back(new LevelOfDetail(vertexPositions.data, level));
+    }
+    levelsOfDetailPositionsUpdateCount = positionsUpdateCount;
+  };
+
+  // collect a finished background build, discarding it if the positions changed in the meantime
+  if (levelOfDetailBuild) {
+    if (levelOfDetailBuild->finished) {
+      if (levelOfDetailBuild->positionsUpdateCount == positionsUpdateCount) setLevels(levelOfDetailBuild->levels);
+      levelOfDetailBuild.reset();
+    } else {
+      requestRedraw(); // keep checking
+    }
+  }
+
+  // start a new build if needed
+  if (!levelOfDetailBuild && levelsOfDetailPositionsUpdateCount != positionsUpdateCount) {
+    if (levelOfDetailBackgroundBuild) {
+      // The build works on copies, so the mesh can keep changing (or be deleted) while it runs. The thread is detached
+      // rather than joined, so removing the mesh never waits for it.
+      std::shared_ptr<LevelOfDetailBuild> build = std::make_shared<LevelOfDetailBuild>();
+      build->positionsUpdateCount = positionsUpdateCount;
+      std::vector<glm::vec3> positions = vertexPositions.data;
+      std::vector<uint32_t> triInds = triangleVertexInds.data;
+      std::thread([build, positions, triInds]() {
+        try {
+          build->levels = buildSimplifiedMeshHierarchy(positions, triInds, 1024, 8, &build->cancelled);
+        } catch (...) {
+          build->levels.clear(); // the full mesh will be drawn
+        }
+        build->finished = true;
+      }).detach();
+      levelOfDetailBuild = build;
+      requestRedraw();
+    } else {
+      setLevels(buildSimplifiedMeshHierarchy(vertexPositions.data, triangleVertexInds.data));
+    }
+  }
+
+  if (levelsOfDetail.empty()) return;
+
+  // While the camera is moving, allow a much larger error to keep the frame rate up. Redraw until it stops, so the
+  // full quality levels come back.
+  const float movingErrorFactor = 8.;
+  float allowedPixelError = getLevelOfDetailPixelError();
+  if (view::midflight || ImGui::IsMouseDragging(0) || ImGui::IsMouseDragging(1)) {
+    allowedPixelError *= movingErrorFactor;
+    requestRedraw();
+  }
+
+  // Pixels per world unit at the nearest point of the mesh's bounding box
+  float halfFovTan = std::tan(glm::radians(view::fov) / 2.f);
+  float pixelsPerUnit;
+  if (view::getProjectionMode() == ProjectionMode::Orthographic) {
+    pixelsPerUnit = view::bufferHeight / (4.f * halfFovTan * state::lengthScale);
+  } else {
+    std::tuple<glm::vec3, glm::vec3> bbox = boundingBox();
+    glm::vec3 cameraPos = view::getCameraWorldPosition();
+    float dist = glm::length(cameraPos - glm::clamp(cameraPos, std::get<0>(bbox), std::get<1>(bbox)));
+    if (!(dist > 0.f)) return; // inside the bounding box, only the full mesh will do
+    pixelsPerUnit = view::bufferHeight / (2.f * halfFovTan * dist);
+  }
+
+  // the errors are in object space
+  glm::mat3 linearPart(objectTransform.get());
+  float objectScale =
+      std::max(glm::length(linearPart[0]), std::max(glm::length(linearPart[1]), glm::length(linearPart[2])));
+
+  // the coarsest level which is accurate enough
+  for (size_t iLevel = levelsOfDetail.size(); iLevel > 0; iLevel--) {
+    if (levelsOfDetail[iLevel - 1]->error * objectScale * pixelsPerUnit <= allowedPixelError) {
+      currentLevelOfDetail = iLevel;
+      break;
+    }
+  }
+}
+
+void SurfaceMesh::prepareMeshDraw(render::ShaderProgram& p) {
+  bool indexed = p.getDrawMode() == DrawMode::IndexedTriangles;
+
+  // indexed programs draw the current level of detail (other programs always draw the full mesh)
+  if (indexed && getLevelOfDetail()) setMeshTriangleBuffersIndexed(p);
+
+  // The meshlets index in to the full mesh. Indexed programs are never drawn in ranges: they look up per-triangle data
+  // by gl_PrimitiveID, which restarts at zero for each range of a multi-draw.
+  if (getMeshletCulling() && !indexed) {
+    p.setDrawRanges(meshletDrawRanges);
+  } else {
+    p.clearDrawRanges();
+  }
 }
 
 void SurfaceMesh::refresh() {
@@ -1478,9 +1892,14 @@ void SurfaceMesh::refresh() {
   Structure::refresh(); // call base class version, which refreshes quantities
 }
 
+bool SurfaceMesh::ensureCullingBoundsCurrent() {
+  return ensureBoundsCurrentWith(vertexPositions, boundsPositionsUpdateCount);
+}
+
 void SurfaceMesh::updateObjectSpaceBounds() {
 
   vertexPositions.ensureHostBufferPopulated();
+  boundsPositionsUpdateCount = vertexPositions.getUpdateCount();
 
   // bounding box
   glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
@@ -1787,6 +2206,65 @@ SurfaceMesh* SurfaceMesh::setSelectionMode(MeshSelectionMode newMode) {
 }
 MeshSelectionMode SurfaceMesh::getSelectionMode() { return selectionMode.get(); }
 
+SurfaceMesh* SurfaceMesh::setIndexedRendering(bool newVal) {
+  indexedRendering = newVal;
+  refresh();
+  requestRedraw();
+  return this;
+}
+bool SurfaceMesh::getIndexedRendering() { return indexedRendering.get(); }
+
+SurfaceMesh* SurfaceMesh::setMeshletCulling(bool newVal) {
+  meshletCulling = newVal;
+  if (!newVal) {
+    meshlets.clear();
+    meshletDrawRanges.clear();
+  }
+  requestRedraw();
+  return this;
+}
+bool SurfaceMesh::getMeshletCulling() { return meshletCulling.get(); }
+
+SurfaceMesh* SurfaceMesh::setLevelOfDetail(bool newVal) {
+  levelOfDetail = newVal;
+  if (!newVal) {
+    cancelLevelOfDetailBuild();
+    levelsOfDetail.clear();
+    levelsOfDetailPositionsUpdateCount = INVALID_IND_64;
+    currentLevelOfDetail = 0;
+  }
+  refresh();
+  requestRedraw();
+  return this;
+}
+bool SurfaceMesh::getLevelOfDetail() { return levelOfDetail.get(); }
+
+void SurfaceMesh::cancelLevelOfDetailBuild() {
+  if (!levelOfDetailBuild) return;
+  levelOfDetailBuild->cancelled = true;
+  levelOfDetailBuild.reset();
+}
+
+SurfaceMesh* SurfaceMesh::setLevelOfDetailPixelError(float newVal) {
+  levelOfDetailPixelError = newVal;
+  requestRedraw();
+  return this;
+}
+float SurfaceMesh::getLevelOfDetailPixelError() { return levelOfDetailPixelError.get(); }
+
+SurfaceMesh* SurfaceMesh::setLevelOfDetailBackgroundBuild(bool newVal) {
+  levelOfDetailBackgroundBuild = newVal;
+  return this;
+}
+bool SurfaceMesh::getLevelOfDetailBackgroundBuild() { return levelOfDetailBackgroundBuild; }
+
+size_t SurfaceMesh::getCurrentLevelOfDetail() { return currentLevelOfDetail; }
+
+bool SurfaceMesh::usingIndexedRendering() {
+  // per-element transparency reads from an expanded per-corner buffer
+  return (indexedRendering.get() || levelOfDetail.get()) && transparencyQuantityName == "";
+}
+
 // === Quantity adders
 
 
@@ -0,0 +1,576 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/surface_mesh_instances.h"
+
+#include "polyscope/pick.h"
+#include "polyscope/polyscope.h"
+#include "polyscope/render/engine.h"
+
+#include "imgui.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace polyscope {
+
+// Initialize statics
+const std::string SurfaceMeshInstances::structureTypeName = "Surface Mesh Instances";
+
+// Constructor
+SurfaceMeshInstances::SurfaceMeshInstances(std::string name, SurfaceMesh& baseMesh_,
+                                           std::vector<glm::mat4> transforms, std::vector<glm::vec3> perInstanceColors)
+    : // clang-format off
+      Structure(name, structureTypeName),
+      instanceTransforms(this, uniquePrefix() + "instanceTransforms", instanceTransformsData),
+      instanceColors(this, uniquePrefix() + "instanceColors", instanceColorsData),
+      baseMesh(baseMesh_.getWeakHandle<SurfaceMesh>(&baseMesh_)),
+      nInstancesCount(transforms.size()),
+      surfaceColor(uniquePrefix() + "surfaceColor", getNextUniqueColor()),
+      material(uniquePrefix() + "material", "clay"),
+      backFacePolicy(uniquePrefix() + "backFacePolicy", BackFacePolicy::Different),
+      backFaceColor(uniquePrefix() + "backFaceColor", glm::vec3(1.f - surfaceColor.get().r, 1.f - surfaceColor.get().g, 1.f - surfaceColor.get().b)),
+      edgeColor(uniquePrefix() + "edgeColor", glm::vec3{0., 0., 0.}),
+      edgeWidth(uniquePrefix() + "edgeWidth", 0.),
+      instancePickColors(this, uniquePrefix() + "instancePickColors", instancePickColorsData)
+// clang-format on
+{
+  cullWholeElements.setPassive(false);
+  fillInstanceTransforms(transforms);
+  fillInstanceColors(perInstanceColors);
+  updateObjectSpaceBounds();
+}
+
+bool SurfaceMeshInstances::hasBaseMesh() { return baseMesh.isValid(); }
+
+SurfaceMesh& SurfaceMeshInstances::getBaseMesh() {
+  if (!hasBaseMesh()) exception("surface mesh instances [" + name + "]: the base mesh has been removed");
+  return baseMesh.get();
+}
+
+void SurfaceMeshInstances::fillInstanceTransforms(const std::vector<glm::mat4>& transforms) {
+  nInstancesCount = transforms.size();
+
+  std::array<uint32_t, 2> texSize = dataTextureSize2D(4 * nInstancesCount);
+  instanceTransforms.setTextureSize(texSize[0], texSize[1]);
+  instanceTransforms.data.assign(texSize[0] * texSize[1], glm::vec4{0., 0., 0., 0.});
+  for (size_t iI = 0; iI < nInstancesCount; iI++) {
+    for (int k = 0; k < 4; k++) {
+      instanceTransforms.data[4 * iI + k] = transforms[iI][k];
+    }
+  }
+  instanceTransforms.markHostBufferUpdated();
+}
+
+void SurfaceMeshInstances::fillInstanceColors(const std::vector<glm::vec3>& colors) {
+  instanceColors.data.clear();
+  if (!colors.empty()) {
+    std::array<uint32_t, 2> texSize = dataTextureSize2D(nInstancesCount);
+    instanceColors.setTextureSize(texSize[0], texSize[1]);
+    instanceColors.data.assign(texSize[0] * texSize[1], glm::vec3{0., 0., 0.});
+    std::copy(colors.begin(), colors.end(), instanceColors.data.begin());
+  }
+  instanceColors.markHostBufferUpdated();
+}
+
+void SurfaceMeshInstances::updateInstanceTransforms(const std::vector<glm::mat4>& newTransforms) {
+  validateSize(newTransforms, nInstances(), "newTransforms");
+  fillInstanceTransforms(newTransforms);
+  updateObjectSpaceBounds();
+  requestRedraw();
+}
+
+void SurfaceMeshInstances::buildCustomUI() {
+
+  // Print stats
+  long long int nInstancesL = static_cast<long long int>(nInstances());
+  ImGui::Text("#instances: %lld", nInstancesL);
+  if (!hasBaseMesh()) {
+    ImGui::TextUnformatted("(base mesh has been removed)");
+    return;
+  }
+  ImGui::TextUnformatted(("base mesh: " + getBaseMesh().name).c_str());
+
+  { // Colors
+    if (instanceColors.data.empty()) {
+      if (ImGui::ColorEdit3("Color", &surfaceColor.get()[0], ImGuiColorEditFlags_NoInputs))
+        setSurfaceColor(surfaceColor.get());
+      ImGui::SameLine();
+    }
+  }
+
+  { // Edge options
+    ImGui::PushItemWidth(100 * options::uiScale);
+    if (edgeWidth.get() == 0.) {
+      bool showEdges = false;
+      if (ImGui::Checkbox("Edges", &showEdges)) {
+        setEdgeWidth(1.);
+      }
+    } else {
+      bool showEdges = true;
+      if (ImGui::Checkbox("Edges", &showEdges)) {
+        setEdgeWidth(0.);
+      }
+
+      // Edge color
+      if (ImGui::ColorEdit3("Edge Color", &edgeColor.get()[0], ImGuiColorEditFlags_NoInputs))
+        setEdgeColor(edgeColor.get());
+
+      // Edge width
+      ImGui::SameLine();
+      ImGui::PushItemWidth(75 * options::uiScale);
+      if (ImGui::SliderFloat("Width", &edgeWidth.get(), 0.001, 2.)) {
+        // (the wireframe is only toggled in the shaders when the width becomes zero, so no need to refresh here)
+        edgeWidth.manuallyChanged();
+        requestRedraw();
+      }
+      ImGui::PopItemWidth();
+    }
+    ImGui::PopItemWidth();
+  }
+
+  { // Backface color (only visible if policy is selected)
+    if (backFacePolicy.get() == BackFacePolicy::Custom) {
+      if (ImGui::ColorEdit3("Backface Color", &backFaceColor.get()[0], ImGuiColorEditFlags_NoInputs))
+        setBackFaceColor(backFaceColor.get());
+    }
+  }
+}
+
+
+void SurfaceMeshInstances::buildCustomOptionsUI() {
+  if (render::buildMaterialOptionsGui(material.get())) {
+    material.manuallyChanged();
+    setMaterial(material.get()); // trigger the other updates that happen on set()
+  }
+
+  // backfaces
+  if (ImGui::BeginMenu("Back Face Policy")) {
+    if (ImGui::MenuItem("identical shading", NULL, backFacePolicy.get() == BackFacePolicy::Identical))
+      setBackFacePolicy(BackFacePolicy::Identical);
+    if (ImGui::MenuItem("different shading", NULL, backFacePolicy.get() == BackFacePolicy::Different))
+      setBackFacePolicy(BackFacePolicy::Different);
+    if (ImGui::MenuItem("custom shading", NULL, backFacePolicy.get() == BackFacePolicy::Custom))
+      setBackFacePolicy(BackFacePolicy::Custom);
+    if (ImGui::MenuItem("cull", NULL, backFacePolicy.get() == BackFacePolicy::Cull))
+      setBackFacePolicy(BackFacePolicy::Cull);
+    ImGui::EndMenu();
+  }
+}
+
+
+void SurfaceMeshInstances::draw() {
+  if (!isEnabled() || !hasBaseMesh() || nInstances() == 0) {
+    return;
+  }
+
+  if (getCullWholeElements()) setCullWholeElements(false); // whole elements not supported
+  render::engine->setBackfaceCull(backFacePolicy.get() == BackFacePolicy::Cull);
+
+  // the normals depend on the shading of the base mesh
+  if (program && getBaseMesh().getShadeStyle() != preparedShadeStyle) program.reset();
+
+  // Ensure we have prepared buffers
+  ensureRenderProgramPrepared();
+
+  // Set program uniforms
+  setStructureUniforms(*program);
+  setInstancesUniforms(*program);
+  render::engine->setMaterialUniforms(*program, material.get());
+  program->setUniform("u_baseColor", surfaceColor.get());
+
+  program->draw();
+
+  render::engine->setBackfaceCull(); // return to default setting
+
+  for (auto& x : floatingQuantities) {
+    x.second->draw();
+  }
+}
+
+void SurfaceMeshInstances::drawDelayed() {
+  if (!isEnabled()) {
+    return;
+  }
+
+  for (auto& x : floatingQuantities) {
+    x.second->drawDelayed();
+  }
+}
+
+void SurfaceMeshInstances::drawPick() {
+  if (!isEnabled() || !hasBaseMesh() || nInstances() == 0) {
+    return;
+  }
+
+  // Ensure we have prepared buffers
+  ensurePickProgramPrepared();
+
+  if (getCullWholeElements()) setCullWholeElements(false); // whole elements not supported
+  render::engine->setBackfaceCull(backFacePolicy.get() == BackFacePolicy::Cull);
+
+  // Set uniforms
+  setStructureUniforms(*pickProgram);
+  setInstancesUniforms(*pickProgram, false);
+  pickProgram->setUniform("u_vertPickRadius", 0.2f);
+
+  pickProgram->draw();
+
+  render::engine->setBackfaceCull(); // return to default setting
+
+  for (auto& x : floatingQuantities) {
+    x.second->drawPick();
+  }
+}
+
+void SurfaceMeshInstances::drawPickDelayed() {
+  if (!isEnabled()) {
+    return;
+  }
+
+  for (auto& x : floatingQuantities) {
+    x.second->drawPickDelayed();
+  }
+}
+
+void SurfaceMeshInstances::setInstancesUniforms(render::ShaderProgram& p, bool withSurfaceShade) {
+  SurfaceMesh& base = getBaseMesh();
+
+  if (base.getShadeStyle() == MeshShadeStyle::TriFlat) {
+    glm::mat4 P = view::getCameraPerspectiveMatrix();
+    glm::mat4 Pinv = glm::inverse(P);
+    p.setUniform("u_invProjMatrix", glm::value_ptr(Pinv));
+    p.setUniform("u_viewport", render::engine->getCurrentViewport());
+  }
+
+  if (withSurfaceShade) {
+    if (getEdgeWidth() > 0) {
+      p.setUniform("u_edgeWidth", getEdgeWidth() * render::engine->getCurrentPixelScaling());
+      p.setUniform("u_edgeColor", getEdgeColor());
+    }
+    if (backFacePolicy.get() == BackFacePolicy::Custom) {
+      p.setUniform("u_backfaceColor", getBackFaceColor());
+    }
+  }
+}
+
+void SurfaceMeshInstances::ensureRenderProgramPrepared() {
+  // If already prepared, do nothing
+  if (program) return;
+
+  std::vector<std::string> initRules;
+  if (instanceColors.data.empty()) {
+    initRules.push_back("SHADE_BASECOLOR");
+  } else {
+    initRules.push_back("MESH_INSTANCED_COLOR");
+    initRules.push_back("SHADE_COLOR");
+  }
+
+  // clang-format off
+  program = render::engine->requestShader("INSTANCED_MESH",
+    render::engine->addMaterialRules(getMaterial(),
+      addInstancesRules(initRules)
+    )
+  );
+  // clang-format on
+
+  setInstancesGeometryAttributes(*program);
+  if (program->hasTexture("t_instanceColors")) {
+    program->setTextureFromBuffer("t_instanceColors", instanceColors.getRenderTextureBuffer().get());
+  }
+
+  render::engine->setMaterial(*program, getMaterial());
+  preparedShadeStyle = getBaseMesh().getShadeStyle();
+}
+
+void SurfaceMeshInstances::ensurePickProgramPrepared() {
+
+  // If already prepared, do nothing
+  if (pickProgram) return;
+
+  // clang-format off
+  pickProgram = render::engine->requestShader("INSTANCED_MESH",
+    addInstancesRules({"MESH_INSTANCED_PROPAGATE_PICK"}, false),
+    render::ShaderReplacementDefaults::Pick
+  );
+  // clang-format on
+
+  setInstancesGeometryAttributes(*pickProgram);
+
+  // Request pick indices, a run for each instance
+  SurfaceMesh& base = getBaseMesh();
+  pickIndsPerInstance = base.nVertices() + base.nFaces();
+  pickStart = pick::requestPickBufferRange(this, pickIndsPerInstance * nInstances());
+
+  std::array<uint32_t, 2> texSize = dataTextureSize2D(nInstances());
+  instancePickColors.setTextureSize(texSize[0], texSize[1]);
+  instancePickColors.data.assign(texSize[0] * texSize[1], glm::vec3{0., 0., 0.});
+  for (size_t iI = 0; iI < nInstances(); iI++) {
+    instancePickColors.data[iI] = pick::indToVec(pickStart + iI * pickIndsPerInstance);
+  }
+  instancePickColors.markHostBufferUpdated();
+  pickProgram->setTextureFromBuffer("t_instancePickColors", instancePickColors.getRenderTextureBuffer().get());
+
+  // The colors of the elements within an instance (vertices, then faces), for each triangle corner
+  base.triangleVertexInds.ensureHostBufferPopulated();
+  base.triangleFaceInds.ensureHostBufferPopulated();
+  size_t nCorners = base.triangleVertexInds.data.size();
+  std::vector<std::array<glm::vec3, 3>> vertexColors(nCorners);
+  std::vector<glm::vec3> faceColors(nCorners);
+  parallelForChunks(nCorners / 3, [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iT = iStart; iT < iEnd; iT++) {
+      std::array<glm::vec3, 3> triVertexColors;
+      for (size_t k = 0; k < 3; k++) {
+        triVertexColors[k] = pick::indToVec(base.triangleVertexInds.data[3 * iT + k]);
+      }
+      glm::vec3 faceColor = pick::indToVec(base.nVertices() + base.triangleFaceInds.data[3 * iT]);
+      for (size_t k = 0; k < 3; k++) {
+        vertexColors[3 * iT + k] = triVertexColors;
+        faceColors[3 * iT + k] = faceColor;
+      }
+    }
+  });
+  pickProgram->setAttribute("a_vertexColors", vertexColors);
+  pickProgram->setAttribute("a_faceColor", faceColors);
+}
+
+std::vector<std::string> SurfaceMeshInstances::addInstancesRules(std::vector<std::string> initRules,
+                                                                 bool withSurfaceShade) {
+
+  initRules = addStructureRules(initRules);
+  SurfaceMesh& base = getBaseMesh();
+
+  if (withSurfaceShade) {
+    // rules that only get used when we're shading the surface of the mesh
+    if (getEdgeWidth() > 0) {
+      initRules.push_back("MESH_WIREFRAME_FROM_BARY");
+      initRules.push_back("MESH_WIREFRAME");
+    }
+
+    if (base.getShadeStyle() == MeshShadeStyle::TriFlat) {
+      initRules.push_back("COMPUTE_SHADE_NORMAL_FROM_POSITION");
+      initRules.push_back("PROJ_AND_INV_PROJ_MAT");
+    }
+
+    if (backFacePolicy.get() == BackFacePolicy::Different) {
+      initRules.push_back("MESH_BACKFACE_DARKEN");
+    }
+    if (backFacePolicy.get() == BackFacePolicy::Custom) {
+      initRules.push_back("MESH_BACKFACE_DIFFERENT");
+    }
+  }
+
+  if (backFacePolicy.get() == BackFacePolicy::Identical) {
+    initRules.push_back("MESH_BACKFACE_NORMAL_FLIP");
+  }
+
+  if (backFacePolicy.get() == BackFacePolicy::Different) {
+    initRules.push_back("MESH_BACKFACE_NORMAL_FLIP");
+  }
+
+  if (backFacePolicy.get() == BackFacePolicy::Custom) {
+    initRules.push_back("MESH_BACKFACE_NORMAL_FLIP");
+  }
+
+  if (wantsCullPosition()) {
+    initRules.push_back("MESH_INSTANCED_PROPAGATE_CULLPOS");
+  }
+
+  return initRules;
+}
+
+void SurfaceMeshInstances::setInstancesGeometryAttributes(render::ShaderProgram& p) {
+  SurfaceMesh& base = getBaseMesh();
+
+  // the geometry is the expanded per-corner data of the base mesh, shared with it
+  p.setAttribute("a_vertexPositions", base.vertexPositions.getIndexedRenderAttributeBuffer(base.triangleVertexInds));
+  if (base.getShadeStyle() == MeshShadeStyle::Smooth) {
+    p.setAttribute("a_vertexNormals", base.vertexNormals.getIndexedRenderAttributeBuffer(base.triangleVertexInds));
+  } else {
+    p.setAttribute("a_vertexNormals", base.faceNormals.getIndexedRenderAttributeBuffer(base.triangleFaceInds));
+  }
+  if (p.hasTexture("t_triangleEdgeFlags")) {
+    p.setTextureFromBuffer("t_triangleEdgeFlags", base.triangleEdgeFlags.getRenderTextureBuffer().get());
+  }
+  if (p.hasAttribute("a_cullPos")) {
+    p.setAttribute("a_cullPos", base.faceCenters.getIndexedRenderAttributeBuffer(base.triangleFaceInds));
+  }
+
+  p.setTextureFromBuffer("t_instanceTransforms", instanceTransforms.getRenderTextureBuffer().get());
+  p.setInstanceCount(static_cast<uint32_t>(nInstances()));
+}
+
+
+void SurfaceMeshInstances::refresh() {
+  program.reset();
+  pickProgram.reset();
+  requestRedraw();
+  Structure::refresh(); // call base class version, which refreshes quantities
+}
+
+// (instance transforms are only updated via updateInstanceTransforms(), which recomputes the bounds)
+bool SurfaceMeshInstances::ensureCullingBoundsCurrent() {
+  if (!hasBaseMesh()) return true;
+  return ensureBoundsCurrentWith(getBaseMesh().vertexPositions, boundsPositionsUpdateCount);
+}
+
+void SurfaceMeshInstances::updateObjectSpaceBounds() {
+
+  glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
+  glm::vec3 max = -glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
+
+  if (hasBaseMesh() && nInstances() > 0) {
+
+    // bounding box of the base mesh
+    SurfaceMesh& base = getBaseMesh();
+    base.vertexPositions.ensureHostBufferPopulated();
+    boundsPositionsUpdateCount = base.vertexPositions.getUpdateCount();
+    glm::vec3 baseMin = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
+    glm::vec3 baseMax = -glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
+    for (const glm::vec3& p : base.vertexPositions.data) {
+      baseMin = componentwiseMin(baseMin, p);
+      baseMax = componentwiseMax(baseMax, p);
+    }
+
+    // union of its transformed corners for each instance
+    for (size_t iI = 0; iI < nInstances(); iI++) {
+      glm::mat4 T(instanceTransforms.data[4 * iI + 0], instanceTransforms.data[4 * iI + 1],
+                  instanceTransforms.data[4 * iI + 2], instanceTransforms.data[4 * iI + 3]);
+      for (int iCorner = 0; iCorner < 8; iCorner++) {
+        glm::vec3 c{(iCorner & 1) ? baseMax.x : baseMin.x, (iCorner & 2) ? baseMax.y : baseMin.y,
+                    (iCorner & 4) ? baseMax.z : baseMin.z};
+        glm::vec3 p = glm::vec3(T * glm::vec4(c, 1.));
+        min = componentwiseMin(min, p);
+        max = componentwiseMax(max, p);
+      }
+    }
+  }
+
+  if (!(min.x <= max.x)) {
+    // nothing to draw
+    min = glm::vec3{0., 0., 0.};
+    max = glm::vec3{0., 0., 0.};
+  }
+  objectSpaceBoundingBox = std::make_tuple(min, max);
+  objectSpaceLengthScale = glm::length(max - min);
+}
+
+SurfaceMeshInstancesPickResult SurfaceMeshInstances::interpretPickResult(const PickResult& rawResult) {
+
+  if (rawResult.structure != this) {
+    // caller must ensure that the PickResult belongs to this structure
+    // by checking the structure pointer or name
+    exception("called interpretPickResult(), but the pick result is not from this structure");
+  }
+
+  SurfaceMeshInstancesPickResult result;
+  result.instanceIndex = rawResult.localIndex / pickIndsPerInstance;
+  size_t elementInd = rawResult.localIndex % pickIndsPerInstance;
+  size_t nVertices = getBaseMesh().nVertices();
+
+  if (elementInd < nVertices) {
+    result.elementType = MeshElement::VERTEX;
+    result.index = elementInd;
+  } else {
+    result.elementType = MeshElement::FACE;
+    result.index = elementInd - nVertices;
+  }
+
+  return result;
+}
+
+void SurfaceMeshInstances::buildPickUI(const PickResult& rawResult) {
+  if (!hasBaseMesh()) return;
+  SurfaceMeshInstancesPickResult result = interpretPickResult(rawResult);
+
+  ImGui::TextUnformatted(("Instance #" + std::to_string(result.instanceIndex)).c_str());
+  switch (result.elementType) {
+  case MeshElement::VERTEX: {
+    ImGui::TextUnformatted(("Vertex #" + std::to_string(result.index)).c_str());
+    std::stringstream buffer;
+    buffer << getBaseMesh().vertexPositions.getValue(result.index);
+    ImGui::TextUnformatted(("Position (base mesh): " + buffer.str()).c_str());
+    break;
+  }
+  case MeshElement::FACE: {
+    ImGui::TextUnformatted(("Face #" + std::to_string(result.index)).c_str());
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+
+std::string SurfaceMeshInstances::typeName() { return structureTypeName; }
+
+// === Option getters and setters
+
+
+SurfaceMeshInstances* SurfaceMeshInstances::setSurfaceColor(glm::vec3 val) {
+  surfaceColor = val;
+  requestRedraw();
+  return this;
+}
+glm::vec3 SurfaceMeshInstances::getSurfaceColor() { return surfaceColor.get(); }
+
+SurfaceMeshInstances* SurfaceMeshInstances::setMaterial(std::string m) {
+  material = m;
+  refresh();
+  requestRedraw();
+  return this;
+}
+std::string SurfaceMeshInstances::getMaterial() { return material.get(); }
+
+SurfaceMeshInstances* SurfaceMeshInstances::setBackFacePolicy(BackFacePolicy newPolicy) {
+  backFacePolicy = newPolicy;
+  refresh();
+  requestRedraw();
+  return this;
+}
+BackFacePolicy SurfaceMeshInstances::getBackFacePolicy() { return backFacePolicy.get(); }
+
+SurfaceMeshInstances* SurfaceMeshInstances::setBackFaceColor(glm::vec3 val) {
+  backFaceColor = val;
+  requestRedraw();
+  return this;
+}
+glm::vec3 SurfaceMeshInstances::getBackFaceColor() { return backFaceColor.get(); }
+
+SurfaceMeshInstances* SurfaceMeshInstances::setEdgeColor(glm::vec3 val) {
+  edgeColor = val;
+  requestRedraw();
+  return this;
+}
+glm::vec3 SurfaceMeshInstances::getEdgeColor() { return edgeColor.get(); }
+
+SurfaceMeshInstances* SurfaceMeshInstances::setEdgeWidth(double newVal) {
+  double oldEdgeWidth = edgeWidth.get();
+  edgeWidth = newVal;
+  if (((oldEdgeWidth != 0) != (newVal != 0))) {
+    // if it changed to or from zero, we disable/enable wireframe in the shaders
+    refresh();
+  }
+  requestRedraw();
+  return this;
+}
+double SurfaceMeshInstances::getEdgeWidth() { return edgeWidth.get(); }
+
+
+SurfaceMeshInstances* registerSurfaceMeshInstances(std::string name, SurfaceMesh* baseMesh,
+                                                   const std::vector<glm::mat4>& transforms) {
+  checkInitialized();
+
+  if (baseMesh == nullptr) exception("registerSurfaceMeshInstances: base mesh must not be null");
+
+  SurfaceMeshInstances* s = new SurfaceMeshInstances(name, *baseMesh, transforms, std::vector<glm::vec3>());
+
+  bool success = registerStructure(s);
+  if (!success) {
+    safeDelete(s);
+  }
+
+  return s;
+}
+
+} // namespace polyscope
@@ -45,6 +45,7 @@ void SurfaceParameterizationQuantity::draw() {
   parent.setSurfaceMeshUniforms(*program);
   render::engine->setMaterialUniforms(*program, parent.getMaterial());
 
+  parent.prepareMeshDraw(*program);
   program->draw();
 }
 
@@ -111,7 +112,7 @@ CurveNetwork* SurfaceParameterizationQuantity::createCurveNetworkFromSeams(std::
   // Populate data on the host
   parent.triangleCornerInds.ensureHostBufferPopulated();
   parent.triangleVertexInds.ensureHostBufferPopulated();
-  parent.edgeIsReal.ensureHostBufferPopulated();
+  parent.triangleEdgeFlags.ensureHostBufferPopulated();
   parent.vertexPositions.ensureHostBufferPopulated();
 
   // expand out the coords buffer based on how the quantity is indexed
@@ -135,7 +136,8 @@ CurveNetwork* SurfaceParameterizationQuantity::createCurveNetworkFromSeams(std::
   // loop over all edges
   for(size_t iT = 0; iT <  parent.nFacesTriangulation(); iT++) {
     for(size_t k = 0; k < 3; k++) {
-      if(parent.edgeIsReal.data[3*iT][k] == 0.) continue; // skip internal tesselation edges
+      uint32_t edgeFlags = static_cast<uint32_t>(parent.triangleEdgeFlags.data[iT]);
+      if((edgeFlags & (1u << k)) == 0) continue; // skip internal tesselation edges
 
       // gather data for the edge
       int32_t iV_tail = parent.triangleVertexInds.data[3*iT + (k+0)%3];
@@ -27,6 +27,7 @@ void SurfaceScalarQuantity::draw() {
   setScalarUniforms(*program);
   render::engine->setMaterialUniforms(*program, parent.getMaterial());
 
+  parent.prepareMeshDraw(*program);
   program->draw();
 }
 
@@ -89,20 +90,25 @@ void SurfaceVertexScalarQuantity::createProgram() {
 
   } else {
     // common case: linear interpolation within each triangle
+    bool indexed = parent.usingIndexedRendering();
 
     // clang-format off
-    program = render::engine->requestShader("MESH",
+    program = render::engine->requestShader(indexed ? "INDEXED_MESH" : "MESH",
         render::engine->addMaterialRules(parent.getMaterial(),
           parent.addSurfaceMeshRules(
             addScalarRules(
               {"MESH_PROPAGATE_VALUE"}
-            )
+            ), true, true, indexed
           )
         )
       );
     // clang-format on
 
-    program->setAttribute("a_value", values.getIndexedRenderAttributeBuffer(parent.triangleVertexInds));
+    if (indexed) {
+      program->setAttribute("a_value", values.getRenderAttributeBuffer());
+    } else {
+      program->setAttribute("a_value", values.getIndexedRenderAttributeBuffer(parent.triangleVertexInds));
+    }
   }
 
   parent.setMeshGeometryAttributes(*program);
@@ -58,6 +58,8 @@ void SurfaceVertexVectorQuantity::buildVertexInfoGUI(size_t iV) {
 
 std::string SurfaceVertexVectorQuantity::niceName() { return name + " (vertex vector)"; }
 
+float SurfaceVertexVectorQuantity::getCullingPadding() { return getVectorCullingPadding(); }
+
 // ========================================================
 // ==========            Face Vector             ==========
 // ========================================================
@@ -97,6 +99,8 @@ void SurfaceFaceVectorQuantity::buildFaceInfoGUI(size_t iF) {
 
 std::string SurfaceFaceVectorQuantity::niceName() { return name + " (face vector)"; }
 
+float SurfaceFaceVectorQuantity::getCullingPadding() { return getVectorCullingPadding(); }
+
 
 // ========================================================
 // ==========        Tangent Face Vector       ==========
@@ -147,6 +151,8 @@ std::string SurfaceFaceTangentVectorQuantity::niceName() {
   }
 }
 
+float SurfaceFaceTangentVectorQuantity::getCullingPadding() { return getVectorCullingPadding(); }
+
 // ========================================================
 // ==========       Tangent Vertex Vector      ==========
 // ========================================================
@@ -196,6 +202,8 @@ std::string SurfaceVertexTangentVectorQuantity::niceName() {
   }
 }
 
+float SurfaceVertexTangentVectorQuantity::getCullingPadding() { return getVectorCullingPadding(); }
+
 // ========================================================
 // ==========        Tangent One Form          ============
 // ========================================================
@@ -212,17 +220,19 @@ std::vector<glm::vec2> oneFormToFaceTangentVectors(SurfaceMesh& mesh, const std:
   mesh.defaultFaceTangentBasisX.ensureHostBufferPopulated();
   mesh.defaultFaceTangentBasisY.ensureHostBufferPopulated();
   mesh.triangleAllEdgeInds.ensureHostBufferPopulated();
+  mesh.triangleVertexInds.ensureHostBufferPopulated();
 
   std::vector<glm::vec2> mappedVectorField(mesh.nFaces());
 
   for (size_t iF = 0; iF < mesh.nFaces(); iF++) {
 
+    size_t iT = mesh.faceTriangleStart[iF];
     std::array<float, 3> formValues;
     std::array<glm::vec3, 3> vecValues;
     for (size_t j = 0; j < 3; j++) {
-      size_t vA = mesh.triangleVertexInds.data[3 * iF + j];
-      size_t vB = mesh.triangleVertexInds.data[3 * iF + ((j + 1) % 3)];
-      size_t iE = mesh.triangleAllEdgeInds.data[9 * iF + j];
+      size_t vA = mesh.triangleVertexInds.data[3 * iT + j];
+      size_t vB = mesh.triangleVertexInds.data[3 * iT + ((j + 1) % 3)];
+      size_t iE = mesh.triangleAllEdgeInds.data[9 * iT + j];
 
       bool isCanonicalOriented = (vB > vA) != (canonicalOrientation[iE]); // TODO double check convention
       float orientationSign = isCanonicalOriented ? 1.f : -1.f;
@@ -281,4 +291,6 @@ void SurfaceOneFormTangentVectorQuantity::buildEdgeInfoGUI(size_t iE) {
 
 std::string SurfaceOneFormTangentVectorQuantity::niceName() { return name + " (1-form tangent vector)"; }
 
+float SurfaceOneFormTangentVectorQuantity::getCullingPadding() { return getVectorCullingPadding(); }
+
 } // namespace polyscope
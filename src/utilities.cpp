@@ -76,6 +76,13 @@ glm::mat4 buildTransform(const glm::mat3x4& R, const glm::vec3& T) {
 }
 
 
+std::array<uint32_t, 2> dataTextureSize2D(size_t nEntries) {
+  const size_t maxWidth = 8192;
+  size_t width = std::max(std::min(nEntries, maxWidth), static_cast<size_t>(1));
+  size_t height = std::max((nEntries + width - 1) / width, static_cast<size_t>(1));
+  return std::array<uint32_t, 2>{static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+}
+
 std::string prettyPrintCount(size_t count) {
 
   int nDigits = 1;
@@ -123,6 +130,26 @@ std::string prettyPrintCount(size_t count) {
   }
 }
 
+std::string prettyPrintBytes(size_t bytes) {
+
+  // Print small values exactly
+  if (bytes < 1024) {
+    return std::to_string(bytes) + " B";
+  }
+
+  std::vector<std::string> postFixes = {"KB", "MB", "GB", "TB"};
+  double bytesD = static_cast<double>(bytes) / 1024.;
+  size_t iPostfix = 0;
+  while (bytesD >= 1024. && iPostfix + 1 < postFixes.size()) {
+    bytesD /= 1024.;
+    iPostfix++;
+  }
+
+  char buf[50];
+  snprintf(buf, 50, "%.1f %s", bytesD, postFixes[iPostfix].c_str());
+  return std::string(buf);
+}
+
 void ImGuiHelperMarker(const char* text) {
   ImGui::TextDisabled("(?)");
   if (ImGui::IsItemHovered()) {
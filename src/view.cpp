@@ -846,6 +846,12 @@ std::tuple<float, float> computeClipPlanes() {
 }
 
 glm::vec3 screenCoordsAndDepthToWorldPosition(glm::vec2 screenCoords, float clipDepth) {
+  return screenCoordsAndDepthToWorldPosition(screenCoords, clipDepth, getCameraViewMatrix(),
+                                             getCameraPerspectiveMatrix());
+}
+
+glm::vec3 screenCoordsAndDepthToWorldPosition(glm::vec2 screenCoords, float clipDepth, const glm::mat4& viewMat,
+                                              const glm::mat4& projMat) {
 
   if (clipDepth == 1.) {
     // if we didn't hit anything in the depth buffer, just return infinity
@@ -854,10 +860,8 @@ glm::vec3 screenCoordsAndDepthToWorldPosition(glm::vec2 screenCoords, float clip
   }
 
 
-  glm::mat4 view = getCameraViewMatrix();
-  glm::mat4 viewInv = glm::inverse(view);
-  glm::mat4 proj = getCameraPerspectiveMatrix();
-  glm::mat4 projInv = glm::inverse(proj);
+  glm::mat4 viewInv = glm::inverse(viewMat);
+  glm::mat4 projInv = glm::inverse(projMat);
   // glm::vec2 depthRange = {0., 1.}; // no support for nonstandard depth range, currently
 
   // convert depth to world units
@@ -214,6 +214,7 @@ SurfaceMesh* VolumeGridNodeScalarQuantity::registerIsosurfaceAsMesh(std::string
   }
 
   // extract the mesh
+  values.ensureHostBufferPopulated();
   MC::mcMesh isosurfaceMesh;
   MC::marching_cube(&values.data.front(), isosurfaceLevel.get(), parent.getGridNodeDim().z, parent.getGridNodeDim().y,
                     parent.getGridNodeDim().x, isosurfaceMesh);
@@ -4,6 +4,7 @@
 
 #include "polyscope/color_management.h"
 #include "polyscope/combining_hash_functions.h"
+#include "polyscope/mesh_reordering.h"
 #include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/render/engine.h"
@@ -111,9 +112,8 @@ triangleFaceInds(       this, uniquePrefix() + "triangleFaceInds",    triangleFa
 triangleCellInds(       this, uniquePrefix() + "triangleCellInds",    triangleCellIndsData),
 
 // internal triangle data for rendering
-baryCoord(              this, uniquePrefix() + "baryCoord",           baryCoordData),
-edgeIsReal(             this, uniquePrefix() + "edgeIsReal",          edgeIsRealData),
 faceType(               this, uniquePrefix() + "faceType",            faceTypeData),
+triangleEdgeFlags(      this, uniquePrefix() + "triangleEdgeFlags",   triangleEdgeFlagsData),
 
 // other internally-computed geometry
 faceNormals(            this, uniquePrefix() + "faceNormals",         faceNormalsData,        std::bind(&VolumeMesh::computeFaceNormals, this)),
@@ -484,7 +484,7 @@ void VolumeMesh::drawPick() {
   // Set uniforms
   setVolumeMeshUniforms(*pickProgram);
   setStructureUniforms(*pickProgram);
-  pickProgram->setUniform("u_vertPickRadius", 0.2);
+  pickProgram->setUniform("u_vertPickRadius", getVertexPickRadius());
 
   pickProgram->draw();
 
@@ -547,56 +547,27 @@ void VolumeMesh::preparePick() {
   size_t cellGlobalPickIndStart = pickStart + nVertices();
 
   // == Fill buffers
+  // (following the triangles of the draw buffers, whatever order they are in)
 
-  std::vector<std::array<glm::vec3, 3>> vertexColors, edgeColors, halfedgeColors, cornerColors;
-  std::vector<glm::vec3> faceColor;
+  triangleVertexInds.ensureHostBufferPopulated();
+  triangleCellInds.ensureHostBufferPopulated();
 
-  // Reserve space
-  vertexColors.resize(3 * nFacesTriangulation());
-  edgeColors.resize(3 * nFacesTriangulation());
-  halfedgeColors.resize(3 * nFacesTriangulation());
-  cornerColors.resize(3 * nFacesTriangulation());
-  faceColor.resize(3 * nFacesTriangulation());
+  std::vector<std::array<glm::vec3, 3>> vertexColors(3 * nFacesTriangulation());
+  std::vector<glm::vec3> faceColor(3 * nFacesTriangulation());
 
-  size_t iFront = 0;
-  size_t iBack = nFacesTriangulation() - 1;
-  size_t iF = 0;
-  for (size_t iC = 0; iC < nCells(); iC++) {
-    const std::array<uint32_t, 8>& cell = cells[iC];
-    VolumeCellType cellT = cellType(iC);
-
-    glm::vec3 cellColor = pick::indToVec(cellGlobalPickIndStart + iC);
-    std::array<glm::vec3, 3> cellColorArr{cellColor, cellColor, cellColor};
-
-    for (const std::vector<std::array<size_t, 3>>& face : cellStencil(cellT)) {
-
-      // Emit the actual face in the triangulation
-      for (size_t j = 0; j < face.size(); j++) {
-        const std::array<size_t, 3>& tri = face[j];
+  parallelForChunks(nFacesTriangulation(), [&](size_t iChunk, size_t iStart, size_t iEnd) {
+    for (size_t iT = iStart; iT < iEnd; iT++) {
+      glm::vec3 cellColor = pick::indToVec(cellGlobalPickIndStart + triangleCellInds.data[3 * iT]);
 
-        std::array<glm::vec3, 3> vColor;
-        for (int k = 0; k < 3; k++) {
-          vColor[k] = pick::indToVec(static_cast<size_t>(cell[tri[k]]) + pickStart);
-        }
-
-        // Push exterior faces to the front of the draw buffer, and interior faces to the back.
-        // (see note above)
-        size_t iData;
-        if (faceIsInterior[iF]) {
-          iData = iBack;
-          iBack--;
-        } else {
-          iData = iFront;
-          iFront++;
-        }
-
-        for (int k = 0; k < 3; k++) faceColor[3 * iData + k] = cellColor;
-        for (int k = 0; k < 3; k++) vertexColors[3 * iData + k] = vColor;
+      std::array<glm::vec3, 3> vColor;
+      for (int k = 0; k < 3; k++) {
+        vColor[k] = pick::indToVec(static_cast<size_t>(triangleVertexInds.data[3 * iT + k]) + pickStart);
       }
 
-      iF++;
+      for (int k = 0; k < 3; k++) faceColor[3 * iT + k] = cellColor;
+      for (int k = 0; k < 3; k++) vertexColors[3 * iT + k] = vColor;
     }
-  }
+  });
 
   // === Store data in buffers
   pickProgram->setAttribute("a_vertexColors", vertexColors);
@@ -642,16 +613,12 @@ void VolumeMesh::fillGeometryBuffers(render::ShaderProgram& p) {
 
   p.setAttribute("a_vertexNormals", faceNormals.getIndexedRenderAttributeBuffer(triangleFaceInds));
 
-  bool wantsBary = p.hasAttribute("a_barycoord");
-  bool wantsEdge = (getEdgeWidth() > 0);
+  bool wantsEdge = p.hasTexture("t_triangleEdgeFlags");
   bool wantsAttrCullPosition = wantsCullPosition();
   bool wantsFaceType = p.hasAttribute("a_faceColorType");
 
-  if (wantsBary) {
-    p.setAttribute("a_barycoord", baryCoord.getRenderAttributeBuffer());
-  }
   if (wantsEdge) {
-    p.setAttribute("a_edgeIsReal", edgeIsReal.getRenderAttributeBuffer());
+    p.setTextureFromBuffer("t_triangleEdgeFlags", triangleEdgeFlags.getRenderTextureBuffer().get());
   }
   if (wantsAttrCullPosition) {
     p.setAttribute("a_cullPos", cellCenters.getIndexedRenderAttributeBuffer(triangleCellInds));
@@ -680,13 +647,14 @@ void VolumeMesh::computeConnectivityData() {
   triangleCellInds.data.resize(3 * nFacesTriangulation());
   triangleCellInds.data.clear();
   triangleCellInds.data.resize(3 * nFacesTriangulation());
-  baryCoord.data.clear();
-  baryCoord.data.resize(3 * nFacesTriangulation());
-  edgeIsReal.data.clear();
-  edgeIsReal.data.resize(3 * nFacesTriangulation());
   faceType.data.clear();
   faceType.data.resize(nFaces());
 
+  // one texel per triangle, padded to fill the last row of the texture
+  std::array<uint32_t, 2> edgeFlagTexSize = dataTextureSize2D(nFacesTriangulation());
+  triangleEdgeFlags.data.clear();
+  triangleEdgeFlags.data.resize(edgeFlagTexSize[0] * edgeFlagTexSize[1], 0.);
+
   size_t iF = 0;
   size_t iFront = 0;
   size_t iBack = nFacesTriangulation() - 1;
@@ -718,14 +686,11 @@ void VolumeMesh::computeConnectivityData() {
         for (size_t k = 0; k < 3; k++) triangleFaceInds.data[3 * iData + k] = iF;
         for (size_t k = 0; k < 3; k++) triangleCellInds.data[3 * iData + k] = iC;
 
-        baryCoord.data[3 * iData + 0] = glm::vec3{1., 0., 0.};
-        baryCoord.data[3 * iData + 1] = glm::vec3{0., 1., 0.};
-        baryCoord.data[3 * iData + 2] = glm::vec3{0., 0., 1.};
-
-        glm::vec3 edgeRealV{0., 1., 0.};
-        if (j == 0) edgeRealV.x = 1.;
-        if (j + 1 == face.size()) edgeRealV.z = 1.;
-        for (int k = 0; k < 3; k++) edgeIsReal.data[3 * iData + k] = edgeRealV;
+        // internal edges for triangulated faces, packed in to bits (x = 1, y = 2, z = 4)
+        uint32_t edgeFlags = 2;
+        if (j == 0) edgeFlags |= 1;
+        if (j + 1 == face.size()) edgeFlags |= 4;
+        triangleEdgeFlags.data[iData] = static_cast<float>(edgeFlags);
       }
 
       float faceTypeFloat = faceIsInterior[iF] ? 1. : 0.;
@@ -735,13 +700,41 @@ void VolumeMesh::computeConnectivityData() {
     }
   }
 
+  // Optionally reorder the triangles within the exterior and interior runs to draw in a cache-friendly order (see
+  // options::optimizeMeshDrawOrder). Each triangle keeps all of its data, so this is invisible elsewhere.
+  if (options::optimizeMeshDrawOrder) {
+    std::vector<uint32_t> triangleOrder;
+    std::array<std::array<size_t, 2>, 2> runs{{{0, iFront}, {iFront, nFacesTriangulation()}}};
+    for (const std::array<size_t, 2>& run : runs) {
+      std::vector<uint32_t> runVertexInds(triangleVertexInds.data.begin() + 3 * run[0],
+                                          triangleVertexInds.data.begin() + 3 * run[1]);
+      for (uint32_t iT : computeTriangleDrawOrder(vertexPositions.data, runVertexInds)) {
+        triangleOrder.push_back(static_cast<uint32_t>(run[0] + iT));
+      }
+    }
+
+    std::vector<uint32_t> oldVertexInds = triangleVertexInds.data;
+    std::vector<uint32_t> oldFaceInds = triangleFaceInds.data;
+    std::vector<uint32_t> oldCellInds = triangleCellInds.data;
+    std::vector<float> oldEdgeFlags = triangleEdgeFlags.data;
+    for (size_t iT = 0; iT < triangleOrder.size(); iT++) {
+      size_t iOld = triangleOrder[iT];
+      for (size_t k = 0; k < 3; k++) {
+        triangleVertexInds.data[3 * iT + k] = oldVertexInds[3 * iOld + k];
+        triangleFaceInds.data[3 * iT + k] = oldFaceInds[3 * iOld + k];
+        triangleCellInds.data[3 * iT + k] = oldCellInds[3 * iOld + k];
+      }
+      triangleEdgeFlags.data[iT] = oldEdgeFlags[iOld];
+    }
+  }
+
   triangleVertexInds.markHostBufferUpdated();
   triangleFaceInds.markHostBufferUpdated();
   triangleCellInds.markHostBufferUpdated();
   triangleCellInds.markHostBufferUpdated();
-  baryCoord.markHostBufferUpdated();
-  edgeIsReal.markHostBufferUpdated();
   faceType.markHostBufferUpdated();
+  triangleEdgeFlags.setTextureSize(edgeFlagTexSize[0], edgeFlagTexSize[1]);
+  triangleEdgeFlags.markHostBufferUpdated();
 }
 
 const std::vector<std::vector<std::array<size_t, 3>>>& VolumeMesh::cellStencil(VolumeCellType type) {
@@ -816,6 +809,71 @@ void VolumeMesh::computeCellCenters() {
 }
 
 
+void VolumeMesh::ensureHaveBVH() {
+  if (bvh.isBuilt() && bvhPositionsUpdateCount == vertexPositions.getUpdateCount() &&
+      bvhIndicesUpdateCount == triangleVertexInds.getUpdateCount()) {
+    return;
+  }
+
+  vertexPositions.ensureHostBufferPopulated();
+  triangleVertexInds.ensureHostBufferPopulated();
+  triangleFaceInds.ensureHostBufferPopulated();
+
+  // only the exterior faces can be seen, unless the mesh is sliced
+  bvhTriangles.clear();
+  std::vector<uint32_t> exteriorVertexInds;
+  for (size_t iT = 0; iT < nFacesTriangulation(); iT++) {
+    if (faceIsInterior[triangleFaceInds.data[3 * iT]]) continue;
+    bvhTriangles.push_back(static_cast<uint32_t>(iT));
+    for (size_t k = 0; k < 3; k++) exteriorVertexInds.push_back(triangleVertexInds.data[3 * iT + k]);
+  }
+
+  bvh.build(vertexPositions.data, exteriorVertexInds);
+  bvhPositionsUpdateCount = vertexPositions.getUpdateCount();
+  bvhIndicesUpdateCount = triangleVertexInds.getUpdateCount();
+}
+
+RayCastResult VolumeMesh::rayCast(glm::vec3 origin, glm::vec3 dir, float tMin, float tMax) {
+  RayCastResult result;
+  ensureHaveBVH();
+
+  TriangleRayHit hit = rayCastTriangles(bvh, origin, dir, tMin, tMax, false, result);
+  if (!hit.isHit) return result;
+
+  size_t iT = bvhTriangles[hit.triangle];
+  triangleCellInds.ensureHostBufferPopulated();
+  result.faceIndex = triangleFaceInds.data[3 * iT];
+  result.cellIndex = triangleCellInds.data[3 * iT];
+  for (size_t k = 0; k < 3; k++) result.triangleVertices[k] = triangleVertexInds.data[3 * iT + k];
+  return result;
+}
+
+bool VolumeMesh::canRayCastPick() {
+  if (wantsCullPosition()) return false;
+
+  // slicing exposes interior faces, which are not in the BVH
+  for (std::unique_ptr<SlicePlane>& s : state::slicePlanes) {
+    if (s->getEnabled() && !getIgnoreSlicePlane(s->name)) return false;
+  }
+  return true;
+}
+
+uint64_t VolumeMesh::rayCastPickIndex(const RayCastResult& hit) {
+  cellPickIndStart = nVertices();
+
+  // Like the pick shader: the nearest vertex if it is close enough, otherwise the cell
+  size_t nearestK = 0;
+  for (size_t k = 1; k < 3; k++) {
+    if (hit.baryCoords[k] > hit.baryCoords[nearestK]) nearestK = k;
+  }
+  if (hit.baryCoords[nearestK] > 1. - getVertexPickRadius()) {
+    return hit.triangleVertices[nearestK];
+  }
+  return cellPickIndStart + hit.cellIndex;
+}
+
+float VolumeMesh::getVertexPickRadius() { return 0.2; }
+
 VolumeMeshPickResult VolumeMesh::interpretPickResult(const PickResult& rawResult) {
 
   if (rawResult.structure != this) {
@@ -1000,9 +1058,14 @@ VolumeCellType VolumeMesh::cellType(size_t i) const {
   }
 };
 
+bool VolumeMesh::ensureCullingBoundsCurrent() {
+  return ensureBoundsCurrentWith(vertexPositions, boundsPositionsUpdateCount);
+}
+
 void VolumeMesh::updateObjectSpaceBounds() {
 
   vertexPositions.ensureHostBufferPopulated();
+  boundsPositionsUpdateCount = vertexPositions.getUpdateCount();
 
   // bounding box
   glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
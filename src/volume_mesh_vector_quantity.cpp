@@ -55,6 +55,8 @@ void VolumeMeshVertexVectorQuantity::buildVertexInfoGUI(size_t iV) {
 
 std::string VolumeMeshVertexVectorQuantity::niceName() { return name + " (vertex vector)"; }
 
+float VolumeMeshVertexVectorQuantity::getCullingPadding() { return getVectorCullingPadding(); }
+
 // ========================================================
 // ==========            Cell Vector             ==========
 // ========================================================
@@ -96,4 +98,6 @@ void VolumeMeshCellVectorQuantity::buildCellInfoGUI(size_t iC) {
 
 std::string VolumeMeshCellVectorQuantity::niceName() { return name + " (cell vector)"; }
 
+float VolumeMeshCellVectorQuantity::getCullingPadding() { return getVectorCullingPadding(); }
+
 } // namespace polyscope
@@ -10,12 +10,16 @@
 #include "polyscope/camera_view.h"
 #include "polyscope/curve_network.h"
 #include "polyscope/implicit_helpers.h"
+#include "polyscope/mesh_reordering.h"
+#include "polyscope/mesh_topology.h"
+#include "polyscope/meshlets.h"
 #include "polyscope/pick.h"
 #include "polyscope/point_cloud.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/simple_triangle_mesh.h"
 #include "polyscope/sparse_volume_grid.h"
 #include "polyscope/surface_mesh.h"
+#include "polyscope/surface_mesh_instances.h"
 #include "polyscope/types.h"
 #include "polyscope/volume_grid.h"
 #include "polyscope/volume_mesh.h"
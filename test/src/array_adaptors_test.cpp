@@ -9,6 +9,7 @@
 #include <iostream>
 #include <list>
 #include <string>
+#include <thread>
 #include <vector>
 
 #define POLYSCOPE_NO_STANDARDIZE_FALLTHROUGH
@@ -158,6 +159,16 @@ struct FakeMatrix {
 };
 FakeMatrix fakeMatrix_int{{{1, 2, 3}, {4, 5, 6}}};
 
+// A wannabe Eigen strided view, which has a data() pointer but is not contiguous
+struct FakeStridedView {
+  std::vector<double> myData;
+  size_t size() const { return myData.size() / 2; }
+  long long int innerStride() const { return 2; }
+  const double* data() const { return &myData[0]; }
+  double operator[](size_t i) const { return myData[2 * i]; }
+};
+FakeStridedView fakeStridedView{{0.1, -1., 0.2, -1., 0.3, -1.}};
+
 
 // Nested list access with paren-vector
 struct UserArrayParenBracketCustom {
@@ -234,6 +245,24 @@ TEST(ArrayAdaptorTests, access_ptr) {
               1e-5);
 }
 
+// Test that standardizeArray works with contiguous storage, and moves in temporaries
+TEST(ArrayAdaptorTests, access_Contiguous) {
+  EXPECT_EQ(polyscope::standardizeArray<double>(arr_vecdouble), arr_vecdouble);
+  EXPECT_EQ(polyscope::standardizeArray<double>(arr_arrdouble)[4], .5);
+  EXPECT_EQ(polyscope::standardizeArray<double>(std::make_tuple(&arr_vecdouble[0], arr_vecdouble.size()))[4], .5);
+
+  // strided storage falls back on elementwise access
+  std::vector<double> strided = polyscope::standardizeArray<double>(fakeStridedView);
+  EXPECT_EQ(strided.size(), 3);
+  EXPECT_EQ(strided[2], .3);
+
+  // temporaries are adopted without a copy
+  std::vector<double> temp = arr_vecdouble;
+  const double* tempPtr = temp.data();
+  std::vector<double> adopted = polyscope::standardizeArray<double>(std::move(temp));
+  EXPECT_EQ(adopted.data(), tempPtr);
+}
+
 // Test that standardizeArray works with a custom accessor function
 TEST(ArrayAdaptorTests, access_FuncAccess) {
   EXPECT_EQ(polyscope::standardizeArray<double>(userArray_funcAccess)[0], .1);
@@ -349,6 +378,92 @@ TEST(ArrayAdaptorTests, adaptor_array_vectors) {
 }
 
 
+// Test that access array of vectors works via contiguous storage, and moves in temporaries
+TEST(ArrayAdaptorTests, adaptor_array_vectors_contiguous) {
+
+  std::vector<glm::vec3> data{{0.1, 0.2, 0.3}, {0.4, 0.5, 0.6}};
+  EXPECT_EQ((polyscope::standardizeVectorArray<glm::vec3, 3>(data)), data);
+
+  // {ptr, size} access with matching scalar type
+  std::vector<float> flatData{0.1, 0.2, 0.3, 0.4, 0.5, 0.6};
+  EXPECT_EQ((polyscope::standardizeVectorArray<glm::vec3, 3>(std::make_tuple(&flatData[0], 2))), data);
+  EXPECT_EQ((polyscope::standardizeVectorArray<glm::vec2, 2>(std::make_tuple(&flatData[0], 3)))[2],
+            glm::vec2(0.5, 0.6));
+
+  // temporaries are adopted without a copy
+  std::vector<glm::vec3> temp = data;
+  const glm::vec3* tempPtr = temp.data();
+  std::vector<glm::vec3> adopted = polyscope::standardizeVectorArray<glm::vec3, 3>(std::move(temp));
+  EXPECT_EQ(adopted.data(), tempPtr);
+}
+
+
+// Test that conversions of large arrays, which are split across threads, give the same result as serial ones
+TEST(ArrayAdaptorTests, adaptor_large_arrays) {
+
+  size_t N = 4 * polyscope::PARALLEL_MIN_CHUNK_SIZE + 7;
+
+  std::vector<double> largeScalars(N);
+  for (size_t i = 0; i < N; i++) largeScalars[i] = 0.5 * i;
+  std::vector<float> scalarsOut = polyscope::standardizeArray<float>(largeScalars);
+  EXPECT_EQ(scalarsOut.size(), N);
+  EXPECT_EQ(scalarsOut[N - 1], 0.5f * (N - 1));
+
+  std::vector<std::array<double, 3>> largeVecs(N);
+  for (size_t i = 0; i < N; i++) largeVecs[i] = {{0.5 * i, 1., 2.}};
+  std::vector<glm::vec3> vecsOut = polyscope::standardizeVectorArray<glm::vec3, 3>(largeVecs);
+  EXPECT_EQ(vecsOut.size(), N);
+  EXPECT_EQ(vecsOut[N - 1][0], 0.5f * (N - 1));
+
+  std::vector<std::vector<int>> largeNested(N);
+  for (size_t i = 0; i < N; i++) largeNested[i] = std::vector<int>(1 + i % 3, static_cast<int>(i));
+  std::tuple<std::vector<int>, std::vector<size_t>> nestedOut =
+      polyscope::standardizeNestedList<int, size_t>(largeNested);
+  std::vector<int>& nestedEntries = std::get<0>(nestedOut);
+  std::vector<size_t>& nestedStarts = std::get<1>(nestedOut);
+  EXPECT_EQ(nestedStarts.size(), N + 1);
+  EXPECT_EQ(nestedStarts[N], nestedEntries.size());
+  for (size_t i = 0; i < N; i++) {
+    ASSERT_EQ(nestedStarts[i + 1] - nestedStarts[i], 1 + i % 3);
+    ASSERT_EQ(nestedEntries[nestedStarts[i]], static_cast<int>(i));
+  }
+}
+
+
+namespace {
+// A callable type whose accessor must not be called concurrently, which records if it is called off the owning thread
+struct UserArrayCallableSerial {
+  std::vector<double> myData;
+  std::thread::id owner;
+  mutable bool calledOffOwner = false;
+  size_t size() const { return myData.size(); }
+  double operator()(size_t i) const {
+    if (std::this_thread::get_id() != owner) calledOffOwner = true;
+    return myData[i];
+  }
+};
+} // namespace
+
+// Test that only contiguous arrays and raw pointers are split across threads, and that pointers to the requested type
+// are copied exactly
+TEST(ArrayAdaptorTests, adaptor_large_arrays_serial_access) {
+
+  size_t N = 4 * polyscope::PARALLEL_MIN_CHUNK_SIZE + 7;
+
+  UserArrayCallableSerial largeCallable{std::vector<double>(N, 0.25), std::this_thread::get_id()};
+  largeCallable.myData[N - 1] = 0.5;
+  std::vector<double> callableOut = polyscope::standardizeArray<double>(largeCallable);
+  EXPECT_FALSE(largeCallable.calledOffOwner);
+  EXPECT_EQ(callableOut.size(), N);
+  EXPECT_EQ(callableOut[N - 1], 0.5);
+
+  std::vector<float> largeFloats(N);
+  for (size_t i = 0; i < N; i++) largeFloats[i] = 0.1f * i;
+  std::vector<float> ptrOut = polyscope::standardizeArray<float>(std::make_tuple(largeFloats.data(), N));
+  EXPECT_EQ(ptrOut, largeFloats);
+}
+
+
 // Test that nested access works
 TEST(ArrayAdaptorTests, adaptor_nested_array) {
 
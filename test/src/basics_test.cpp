@@ -6,6 +6,7 @@
 #include "polyscope/pick.h"
 #include "polyscope/point_cloud.h"
 #include "polyscope/polyscope.h"
+#include "polyscope/profiler.h"
 #include "polyscope/surface_mesh.h"
 #include "polyscope/types.h"
 #include "polyscope/volume_mesh.h"
@@ -151,6 +152,18 @@ TEST_F(PolyscopeTest, Screenshot) {
   polyscope::screenshot(opts);
 }
 
+TEST_F(PolyscopeTest, ScreenshotAsync) {
+  polyscope::ScreenshotOptions opts;
+  opts.async = true;
+  for (int i = 0; i < 5; i++) {
+    polyscope::screenshot(opts);
+  }
+  polyscope::show(3);
+
+  polyscope::screenshot("test_screeshot_async.png", opts);
+  polyscope::flushScreenshots();
+}
+
 TEST_F(PolyscopeTest, ScreenshotBuffer) {
   std::vector<unsigned char> buff = polyscope::screenshotToBuffer();
   EXPECT_EQ(buff.size(), polyscope::view::bufferWidth * polyscope::view::bufferHeight * 4);
@@ -159,6 +172,38 @@ TEST_F(PolyscopeTest, ScreenshotBuffer) {
   EXPECT_EQ(buff2.size(), polyscope::view::bufferWidth * polyscope::view::bufferHeight * 4);
 }
 
+TEST_F(PolyscopeTest, Profiler) {
+  auto psPoints = registerPointCloud();
+  polyscope::options::enableProfiler = true;
+  polyscope::options::alwaysRedraw = true;
+  polyscope::show(3);
+
+  std::vector<polyscope::profiler::TimerStats> stats = polyscope::profiler::getTimerStats();
+  auto findStats = [&](std::string name) {
+    for (const polyscope::profiler::TimerStats& s : stats) {
+      if (s.name == name) return s;
+    }
+    ADD_FAILURE() << "no timer named " << name;
+    return polyscope::profiler::TimerStats();
+  };
+  EXPECT_GT(findStats("frame").frameCount, 0u);
+  EXPECT_GT(findStats("frame").gpuFrameCount, 0u);
+  EXPECT_GT(findStats("draw: test1").depth, findStats("frame").depth);
+
+  polyscope::profiler::writeChromeTrace("test_profiler_trace.json");
+
+  polyscope::profiler::clearFrames();
+  EXPECT_EQ(polyscope::profiler::getRetainedFrameCount(), 0u);
+
+  // nothing is recorded while disabled
+  polyscope::options::enableProfiler = false;
+  polyscope::show(3);
+  EXPECT_EQ(polyscope::profiler::getRetainedFrameCount(), 0u);
+
+  polyscope::options::alwaysRedraw = false;
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, ImPlotBasic) {
 
   std::vector<float> xvals = {0., 2., 4., 8.};
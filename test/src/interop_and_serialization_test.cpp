@@ -33,3 +33,205 @@ TEST_F(PolyscopeTest, ManagedBufferAccess) {
 
   polyscope::removeAllStructures();
 }
+
+TEST_F(PolyscopeTest, ManagedBufferPartialUpdate) {
+
+  // register a mesh and draw it, so the positions have a render buffer and an indexed view
+  auto psMesh = registerTriangleMesh();
+  std::vector<double> vScalar(psMesh->nVertices(), 7.);
+  auto q1 = psMesh->addVertexScalarQuantity("vScalar", vScalar);
+  q1->setEnabled(true);
+  polyscope::show(3);
+
+  polyscope::render::ManagedBuffer<glm::vec3>& bufferPos = psMesh->vertexPositions;
+  polyscope::render::ManagedBuffer<float>& bufferScalar = q1->getManagedBuffer<float>("values");
+
+  polyscope::render::ManagedBuffer<uint32_t>& triInds = psMesh->triangleVertexInds;
+  triInds.ensureHostBufferPopulated();
+
+  // update a contiguous range
+  bufferPos.ensureHostBufferPopulated();
+  std::vector<glm::vec3> oldPos = bufferPos.data;
+  bufferPos.data[1] += glm::vec3{0.1, 0.2, 0.3};
+  bufferPos.data[2] += glm::vec3{0.1, 0.2, 0.3};
+  bufferPos.markHostBufferUpdated(1, 2);
+  EXPECT_EQ(bufferPos.getValue(2), bufferPos.data[2]);
+  polyscope::show(3);
+
+  // the device buffer has the new values inside the range, and the old ones outside of it
+  std::vector<glm::vec3> devicePos = bufferPos.getRenderAttributeBuffer()->getDataRange_vec3(0, bufferPos.size());
+  for (size_t i = 0; i < bufferPos.size(); i++) {
+    EXPECT_EQ(devicePos[i], bufferPos.data[i]);
+    if (i < 1 || i > 2) EXPECT_EQ(devicePos[i], oldPos[i]);
+  }
+
+  // ...and so does the indexed view
+  std::vector<glm::vec3> viewPos =
+      bufferPos.getIndexedRenderAttributeBuffer(triInds)->getDataRange_vec3(0, triInds.size());
+  for (size_t i = 0; i < triInds.size(); i++) {
+    EXPECT_EQ(viewPos[i], bufferPos.data[triInds.data[i]]);
+  }
+
+  // update a list of entries
+  bufferScalar.ensureHostBufferPopulated();
+  bufferScalar.data[0] = 3.f;
+  bufferScalar.data[3] = 4.f;
+  bufferScalar.markHostBufferUpdated(std::vector<size_t>{3, 0});
+  EXPECT_EQ(bufferScalar.getValue(3), 4.f);
+  polyscope::show(3);
+
+  std::vector<float> deviceScalar =
+      bufferScalar.getRenderAttributeBuffer()->getDataRange_float(0, bufferScalar.size());
+  for (size_t i = 0; i < bufferScalar.size(); i++) {
+    float expected = (i == 0) ? 3.f : (i == 3) ? 4.f : 7.f;
+    EXPECT_EQ(deviceScalar[i], expected);
+  }
+  std::vector<float> viewScalar =
+      bufferScalar.getIndexedRenderAttributeBuffer(triInds)->getDataRange_float(0, triInds.size());
+  for (size_t i = 0; i < triInds.size(); i++) {
+    EXPECT_EQ(viewScalar[i], bufferScalar.data[triInds.data[i]]);
+  }
+
+  // out of bounds ranges are an error
+  EXPECT_THROW(bufferPos.markHostBufferUpdated(0, bufferPos.size() + 1), std::runtime_error);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, ManagedBufferDeviceUpdateIndexedViews) {
+
+  // register a mesh and draw it, so the positions have a render buffer and an indexed view
+  auto psMesh = registerTriangleMesh();
+  polyscope::show(3);
+
+  // write new data directly to the device buffer, which must get expanded to the indexed views
+  polyscope::render::ManagedBuffer<glm::vec3>& bufferPos = psMesh->vertexPositions;
+  std::vector<glm::vec3> newPos = bufferPos.data;
+  for (glm::vec3& p : newPos) p *= 2.f;
+  bufferPos.getRenderAttributeBuffer()->setData(newPos);
+  bufferPos.markRenderAttributeBufferUpdated();
+  polyscope::show(3);
+
+  // the indexed view holds the expanded new data
+  polyscope::render::ManagedBuffer<uint32_t>& triInds = psMesh->triangleVertexInds;
+  triInds.ensureHostBufferPopulated();
+  std::vector<glm::vec3> viewPos =
+      bufferPos.getIndexedRenderAttributeBuffer(triInds)->getDataRange_vec3(0, triInds.size());
+  ASSERT_EQ(viewPos.size(), triInds.size());
+  for (size_t i = 0; i < triInds.size(); i++) {
+    EXPECT_EQ(viewPos[i], newPos[triInds.data[i]]);
+  }
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, ManagedBufferPrefetch) {
+
+  auto psMesh = registerTriangleMesh();
+  polyscope::show(3);
+
+  // when the data lives on the host, prefetching does nothing
+  polyscope::render::ManagedBuffer<glm::vec3>& bufferPos = psMesh->vertexPositions;
+  bufferPos.prefetchHostBuffer();
+  EXPECT_TRUE(bufferPos.hostBufferPrefetchIsReady());
+
+  // write new data directly to the device buffer, then fetch it back asynchronously
+  std::vector<glm::vec3> newPos = bufferPos.data;
+  bufferPos.getRenderAttributeBuffer()->setData(newPos);
+  bufferPos.markRenderAttributeBufferUpdated();
+  bufferPos.prefetchHostBuffer();
+  polyscope::show(3);
+  EXPECT_TRUE(bufferPos.hostBufferPrefetchIsReady());
+  bufferPos.getValue(2);
+  bufferPos.ensureHostBufferPopulated();
+  EXPECT_EQ(bufferPos.data.size(), psMesh->nVertices());
+
+  // a device update drops a pending prefetch
+  bufferPos.prefetchHostBuffer();
+  bufferPos.markRenderAttributeBufferUpdated();
+  bufferPos.ensureHostBufferPopulated();
+  EXPECT_EQ(bufferPos.data.size(), psMesh->nVertices());
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, ManagedBufferHostMemoryBudget) {
+
+  auto psMesh = registerTriangleMesh();
+  std::vector<double> vScalar(psMesh->nVertices(), 7.);
+  auto q1 = psMesh->addVertexScalarQuantity("vScalar", vScalar);
+  q1->setEnabled(true);
+  polyscope::show(3);
+
+  // with a tiny budget, host copies of uploaded buffers get freed at the end of the frame
+  polyscope::options::hostBufferMemoryBudget = 1;
+  polyscope::show(3);
+
+  polyscope::render::ManagedBuffer<glm::vec3>& bufferPos = psMesh->vertexPositions;
+  EXPECT_TRUE(bufferPos.data.empty());
+  EXPECT_EQ(bufferPos.size(), psMesh->nVertices());
+
+  // accessing restores it
+  bufferPos.ensureHostBufferPopulated();
+  EXPECT_EQ(bufferPos.data.size(), psMesh->nVertices());
+
+  // updates and further frames still work
+  bufferPos.data[0] += glm::vec3{0.1, 0.2, 0.3};
+  bufferPos.markHostBufferUpdated();
+  polyscope::show(3);
+
+  polyscope::options::hostBufferMemoryBudget = 0;
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, ManagedBufferHostMemoryBudgetDouble) {
+
+  // doubles are stored as floats on the device, so their host copy must never be evicted
+  std::vector<double> vals{0.1, 1. / 3., 1e-12, 123456789.123456789};
+  std::vector<double> valsOrig = vals;
+  polyscope::render::ManagedBuffer<double> buffer(nullptr, "test_double", vals);
+  buffer.getRenderAttributeBuffer();
+
+  polyscope::options::hostBufferMemoryBudget = 1;
+  polyscope::show(3);
+
+  buffer.ensureHostBufferPopulated();
+  EXPECT_EQ(buffer.data, valsOrig);
+
+  polyscope::options::hostBufferMemoryBudget = 0;
+}
+
+TEST_F(PolyscopeTest, ManagedBufferMemoryUsage) {
+
+  auto psMesh = registerTriangleMesh();
+  std::vector<double> vScalar(psMesh->nVertices(), 7.);
+  auto q1 = psMesh->addVertexScalarQuantity("vScalar", vScalar);
+  q1->setEnabled(true);
+
+  // before drawing, nothing has been uploaded
+  polyscope::render::ManagedBufferMemoryUsage usageQ = q1->getManagedBufferMemoryUsage();
+  EXPECT_GE(usageQ.hostBytes, psMesh->nVertices() * sizeof(float));
+  EXPECT_EQ(usageQ.deviceBytes, 0u);
+
+  polyscope::show(3);
+
+  // after drawing, the positions live on the device and are expanded to indexed views
+  polyscope::render::ManagedBufferMemoryUsage usageMesh = psMesh->getMemoryUsage(false);
+  EXPECT_GT(usageMesh.hostBytes, 0u);
+  EXPECT_GT(usageMesh.totalDeviceBytes(), 0u);
+
+  bool foundPositions = false;
+  for (auto& entry : psMesh->getManagedBufferMemoryUsageByBuffer()) {
+    if (std::get<0>(entry) == psMesh->vertexPositions.name) {
+      foundPositions = true;
+      EXPECT_GE(std::get<1>(entry).hostBytes, psMesh->nVertices() * sizeof(glm::vec3));
+    }
+  }
+  EXPECT_TRUE(foundPositions);
+
+  // totals include the quantities
+  polyscope::render::ManagedBufferMemoryUsage usageTotal = polyscope::getMemoryUsage();
+  EXPECT_GE(usageTotal.hostBytes, usageMesh.hostBytes + q1->getManagedBufferMemoryUsage().hostBytes);
+
+  polyscope::removeAllStructures();
+}
@@ -44,6 +44,20 @@ TEST_F(PolyscopeTest, PointCloudUpdateGeometry) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, PointCloudRegisterOverloads) {
+  // explicit template arguments with an lvalue
+  std::vector<glm::vec3> points = getPoints();
+  polyscope::PointCloud* psPoints = polyscope::registerPointCloud<std::vector<glm::vec3>>("test1", points);
+  EXPECT_EQ(psPoints->nPoints(), points.size());
+
+  // temporaries are moved in
+  polyscope::PointCloud* psPoints2 = polyscope::registerPointCloud("test2", getPoints());
+  EXPECT_EQ(psPoints2->nPoints(), points.size());
+
+  polyscope::show(3);
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, PointCloudAppearance) {
   auto psPoints = registerPointCloud();
 
@@ -95,6 +109,166 @@ TEST_F(PolyscopeTest, PointCloudPick) {
 }
 
 
+TEST_F(PolyscopeTest, PointCloudPickAsync) {
+  auto psPoints = registerPointCloud();
+
+  std::shared_ptr<polyscope::PickQuery> query = polyscope::pickAtBufferIndsAsync(glm::ivec2(77, 88));
+  polyscope::show(3);
+  EXPECT_TRUE(query->isReady());
+  polyscope::PickResult result = query->getResult();
+  EXPECT_EQ(result.bufferInds, glm::ivec2(77, 88));
+
+  // queries outside the buffer are immediately ready, and miss
+  std::shared_ptr<polyscope::PickQuery> queryOutside = polyscope::pickAtBufferIndsAsync(glm::ivec2(-10, -10));
+  EXPECT_TRUE(queryOutside->isReady());
+  EXPECT_FALSE(queryOutside->getResult().isHit);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, PointCloudPickCached) {
+  auto psPoints = registerPointCloud();
+  EXPECT_FALSE(polyscope::state::globalContext.pickBufferValid);
+
+  // repeated queries reuse the pick buffer until something changes
+  polyscope::PickResult first = polyscope::pickAtBufferInds(glm::ivec2(77, 88));
+  EXPECT_TRUE(polyscope::state::globalContext.pickBufferValid);
+  polyscope::PickResult second = polyscope::pickAtBufferInds(glm::ivec2(77, 88));
+  EXPECT_EQ(first.isHit, second.isHit);
+  EXPECT_EQ(first.localIndex, second.localIndex);
+
+  psPoints->setPointRadius(0.02);
+  EXPECT_FALSE(polyscope::state::globalContext.pickBufferValid);
+  polyscope::pickAtBufferInds(glm::ivec2(77, 88));
+  EXPECT_TRUE(polyscope::state::globalContext.pickBufferValid);
+
+  polyscope::removeAllStructures();
+  EXPECT_FALSE(polyscope::state::globalContext.pickBufferValid);
+}
+
+TEST_F(PolyscopeTest, PointCloudPickRangeReuse) {
+  auto psPoints = registerPointCloud();
+  polyscope::pickAtBufferInds(glm::ivec2(77, 88));
+  uint64_t nextInd = polyscope::state::globalContext.nextPickBufferInd;
+
+  // re-registering and re-picking every frame does not use up more indices
+  for (int i = 0; i < 5; i++) {
+    psPoints = registerPointCloud();
+    polyscope::pickAtBufferInds(glm::ivec2(77, 88));
+    psPoints->refresh();
+    polyscope::pickAtBufferInds(glm::ivec2(77, 88));
+  }
+  EXPECT_EQ(polyscope::state::globalContext.nextPickBufferInd, nextInd);
+
+  // indices map back to the structure which holds them
+  uint64_t start = polyscope::pick::requestPickBufferRange(psPoints, 10);
+  std::tuple<polyscope::Structure*, polyscope::Quantity*, uint64_t> local =
+      polyscope::pick::globalIndexToLocal(start + 3);
+  EXPECT_EQ(std::get<0>(local), psPoints);
+  EXPECT_EQ(std::get<2>(local), 3u);
+  EXPECT_EQ(polyscope::pick::localIndexToGlobal(local), start + 3);
+
+  // a pick buffer read from before a range was released does not resolve to whatever reuses its indices
+  uint64_t issuedAllocationID = polyscope::state::globalContext.nextPickRangeAllocationID;
+  EXPECT_TRUE(polyscope::pick::pickIndexAllocatedBefore(start + 3, issuedAllocationID));
+  polyscope::removeStructure(psPoints);
+  auto psOther = registerPointCloud("other");
+  uint64_t otherStart = polyscope::pick::requestPickBufferRange(psOther, 10);
+  EXPECT_FALSE(polyscope::pick::pickIndexAllocatedBefore(start + 3, issuedAllocationID));
+  EXPECT_TRUE(polyscope::pick::pickIndexAllocatedBefore(otherStart + 3,
+                                                        polyscope::state::globalContext.nextPickRangeAllocationID));
+
+  polyscope::removeAllStructures();
+  EXPECT_EQ(std::get<0>(polyscope::pick::globalIndexToLocal(start + 3)), nullptr);
+  EXPECT_LT(polyscope::state::globalContext.nextPickBufferInd, nextInd);
+}
+
+TEST_F(PolyscopeTest, PointCloudPickRegion) {
+  auto psPoints = registerPointCloud();
+  polyscope::view::resetCameraToHomeView();
+  glm::vec2 windowSize{polyscope::view::windowWidth, polyscope::view::windowHeight};
+
+  // Don't bother checking what is visible, but make sure this doesn't crash
+  polyscope::pickInScreenRectangle(0.25f * windowSize, 0.75f * windowSize);
+  polyscope::pickInScreenLasso({glm::vec2{0., 0.}, glm::vec2{windowSize.x, 0.}, windowSize});
+
+  // including occluded points, the whole window selects every point
+  std::vector<polyscope::RegionPickResult> result =
+      polyscope::pickInScreenRectangle(glm::vec2{0., 0.}, windowSize, true);
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(result[0].structure, psPoints);
+  EXPECT_EQ(result[0].localIndices, (std::vector<uint64_t>{0, 1, 2, 3}));
+
+  result = polyscope::pickInScreenLasso({glm::vec2{-1., -1.}, glm::vec2{3. * windowSize.x, -1.},
+                                         glm::vec2{-1., 3. * windowSize.y}},
+                                        true);
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(result[0].localIndices.size(), 4u);
+
+  // a lasso needs at least 3 points
+  EXPECT_TRUE(polyscope::pickInScreenLasso({glm::vec2{0., 0.}, windowSize}, true).empty());
+
+  polyscope::setRegionSelection(result);
+  EXPECT_TRUE(polyscope::haveRegionSelection());
+  polyscope::removeAllStructures();
+  EXPECT_FALSE(polyscope::haveRegionSelection());
+}
+
+TEST_F(PolyscopeTest, PointCloudCulling) {
+  auto psPoints = registerPointCloud();
+  polyscope::view::resetCameraToHomeView();
+  glm::mat4 viewProjMat = polyscope::view::getCameraPerspectiveMatrix() * polyscope::view::getCameraViewMatrix();
+  EXPECT_FALSE(psPoints->isCulledByFrustum(viewProjMat));
+  EXPECT_FALSE(psPoints->isCulledBySlicePlanes());
+
+  // moved far away, it is out of view
+  psPoints->setPosition(glm::vec3{1e6, 0., 0.});
+  EXPECT_TRUE(psPoints->isCulledByFrustum(viewProjMat));
+  polyscope::options::enableCulling = false;
+  EXPECT_FALSE(psPoints->isCulledByFrustum(viewProjMat));
+  polyscope::options::enableCulling = true;
+  psPoints->resetTransform();
+
+  // all of the points are on the removed side of the plane
+  polyscope::SlicePlane* plane = polyscope::addSceneSlicePlane();
+  plane->setPose(glm::vec3{10., 0., 0.}, glm::vec3{1., 0., 0.});
+  EXPECT_TRUE(psPoints->isCulledBySlicePlanes());
+  polyscope::show(3);
+  EXPECT_EQ(polyscope::getCullingStats().culledBySlicePlanes, 1u);
+
+  psPoints->setIgnoreSlicePlane(plane->name, true);
+  EXPECT_FALSE(psPoints->isCulledBySlicePlanes());
+  polyscope::show(3);
+  EXPECT_EQ(polyscope::getCullingStats().culledBySlicePlanes, 0u);
+
+  polyscope::removeLastSceneSlicePlane();
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, PointCloudCullingFollowsUpdatedPositions) {
+  auto psPoints = registerPointCloud();
+  polyscope::view::resetCameraToHomeView();
+  glm::mat4 viewProjMat = polyscope::view::getCameraPerspectiveMatrix() * polyscope::view::getCameraViewMatrix();
+
+  // updated to positions far away, it is out of view
+  std::vector<glm::vec3> points = getPoints();
+  std::vector<glm::vec3> farPoints = points;
+  for (glm::vec3& p : farPoints) p += glm::vec3{1e6, 0., 0.};
+  psPoints->updatePointPositions(farPoints);
+  EXPECT_TRUE(psPoints->isCulledByFrustum(viewProjMat));
+  polyscope::show(3);
+  EXPECT_EQ(polyscope::getCullingStats().culledByFrustum, 1u);
+
+  // and back in to view, it is drawn again
+  psPoints->updatePointPositions(points);
+  EXPECT_FALSE(psPoints->isCulledByFrustum(viewProjMat));
+  polyscope::show(3);
+  EXPECT_EQ(polyscope::getCullingStats().structuresTested, 1u);
+  EXPECT_EQ(polyscope::getCullingStats().culledByFrustum, 0u);
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, PointCloudColor) {
   auto psPoints = registerPointCloud();
   std::vector<glm::vec3> vColors(psPoints->nPoints(), glm::vec3{.2, .3, .4});
@@ -178,6 +352,43 @@ TEST_F(PolyscopeTest, PointCloudVector) {
 }
 
 
+TEST_F(PolyscopeTest, PointCloudCompactStorage) {
+  auto psPoints = registerPointCloud();
+
+  std::vector<double> vScalar(psPoints->nPoints(), 7.);
+  auto q1 = psPoints->addScalarQuantity("vScalar", vScalar);
+  q1->setEnabled(true);
+  std::vector<glm::vec3> vals(psPoints->nPoints(), {1., 2., 3.});
+  auto q2 = psPoints->addVectorQuantity("vals", vals);
+  q2->setEnabled(true);
+  polyscope::show(3);
+  size_t fullDeviceBytes = psPoints->getMemoryUsage().deviceBytes;
+
+  psPoints->setCompactStorage(true);
+  EXPECT_TRUE(psPoints->getCompactStorage());
+  EXPECT_EQ(psPoints->points.getDeviceStorageFormat(), polyscope::AttributeStorageFormat::UNorm16);
+  polyscope::show(3);
+  EXPECT_LT(psPoints->getMemoryUsage().deviceBytes, fullDeviceBytes);
+
+  psPoints->setPointRenderMode(polyscope::PointRenderMode::Quad);
+  polyscope::show(3);
+
+  // quantities added afterwards pick up the setting
+  auto q3 = psPoints->addScalarQuantity("vScalar2", vScalar);
+  q3->setEnabled(true);
+  q3->updateData(vScalar);
+  polyscope::show(3);
+
+  psPoints->updatePointPositions(getPoints());
+  polyscope::show(3);
+
+  psPoints->setCompactStorage(false);
+  EXPECT_EQ(psPoints->points.getDeviceStorageFormat(), polyscope::AttributeStorageFormat::Float32);
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, PointCloudParam) {
   auto psPoints = registerPointCloud();
   std::vector<glm::vec2> param(psPoints->nPoints(), glm::vec2{.2, .3});
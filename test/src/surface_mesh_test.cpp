@@ -71,12 +71,27 @@ TEST_F(PolyscopeTest, SurfaceMeshPolygon) {
    };
   // clang-format on
 
-  polyscope::registerSurfaceMesh2D("mesh poly", points, faces);
+  polyscope::SurfaceMesh* psMesh = polyscope::registerSurfaceMesh2D("mesh poly", points, faces);
 
   // Make sure we actually added the mesh
   polyscope::show(3);
   EXPECT_TRUE(polyscope::hasSurfaceMesh("mesh poly"));
 
+  // Faces are laid out in the triangulation in order
+  std::vector<uint32_t> expectedTriangleStart = {0, 2, 3, 5, 6};
+  EXPECT_EQ(psMesh->faceTriangleStart, expectedTriangleStart);
+  EXPECT_EQ(psMesh->nFacesTriangulation(), 6u);
+  std::vector<uint32_t> expectedTriangleVertexInds = {1, 3, 2, 1, 2, 0, 3, 1, 0, 2, 0, 1, 2, 1, 3, 0, 2, 3};
+  EXPECT_EQ(psMesh->triangleVertexInds.getPopulatedHostBufferRef(), expectedTriangleVertexInds);
+
+  // Exercise the other lazily-triangulated indices
+  psMesh->triangleAllVertexInds.ensureHostBufferPopulated();
+  psMesh->triangleAllHalfedgeInds.ensureHostBufferPopulated();
+  psMesh->triangleAllCornerInds.ensureHostBufferPopulated();
+  EXPECT_EQ(psMesh->triangleAllCornerInds.data.size(), 9 * psMesh->nFacesTriangulation());
+  psMesh->setIndexedRendering(true);
+  polyscope::show(3);
+
   polyscope::removeAllStructures();
 }
 
@@ -108,6 +123,84 @@ TEST_F(PolyscopeTest, SurfaceMeshAppearance) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, SurfaceMeshIndexedRendering) {
+  auto psMesh = registerTriangleMesh();
+  psMesh->setIndexedRendering(true);
+  EXPECT_TRUE(psMesh->getIndexedRendering());
+  polyscope::show(3);
+
+  // Shade styles
+  psMesh->setShadeStyle(polyscope::MeshShadeStyle::Smooth);
+  polyscope::show(3);
+  psMesh->setShadeStyle(polyscope::MeshShadeStyle::TriFlat);
+  polyscope::show(3);
+  psMesh->setShadeStyle(polyscope::MeshShadeStyle::Flat);
+  polyscope::show(3);
+
+  // Wireframe
+  psMesh->setEdgeWidth(1.);
+  polyscope::show(3);
+
+  // Vertex quantities
+  std::vector<double> vScalar(psMesh->nVertices(), 7.);
+  auto q1 = psMesh->addVertexScalarQuantity("vScalar", vScalar);
+  q1->setEnabled(true);
+  polyscope::show(3);
+  std::vector<glm::vec3> vColors(psMesh->nVertices(), glm::vec3{.2, .3, .4});
+  auto q2 = psMesh->addVertexColorQuantity("vcolor", vColors);
+  q2->setEnabled(true);
+  polyscope::show(3);
+
+  // Other quantities use expanded data
+  std::vector<double> fScalar(psMesh->nFaces(), 7.);
+  auto q3 = psMesh->addFaceScalarQuantity("fScalar", fScalar);
+  q3->setEnabled(true);
+  polyscope::show(3);
+
+  // Moving the vertices updates per-triangle data
+  std::vector<glm::vec3> newPositions = psMesh->vertexPositions.data;
+  for (glm::vec3& p : newPositions) p *= 2.f;
+  psMesh->updateVertexPositions(newPositions);
+  polyscope::show(3);
+
+  polyscope::pickAtBufferInds(glm::ivec2(77, 88));
+
+  psMesh->setIndexedRendering(false);
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, SurfaceMeshGeometryUpdate) {
+  auto psMesh = registerTriangleMesh();
+
+  // populate the computed geometry
+  std::vector<float> faceAreas = psMesh->faceAreas.getPopulatedHostBufferRef();
+  std::vector<float> vertexAreas = psMesh->vertexAreas.getPopulatedHostBufferRef();
+  std::vector<glm::vec3> vertexNormals = psMesh->vertexNormals.getPopulatedHostBufferRef();
+  psMesh->defaultFaceTangentBasisX.ensureHostBufferPopulated();
+
+  // every corner appears in the vertex-face adjacency
+  psMesh->ensureHaveVertexFaceAdjacency();
+  EXPECT_EQ(psMesh->vertexFaceAdjacency.faceInds.size(), psMesh->nCorners());
+
+  // scaling the mesh updates everything in one pass
+  std::vector<glm::vec3> newPositions = psMesh->vertexPositions.data;
+  for (glm::vec3& p : newPositions) p *= 2.f;
+  psMesh->updateVertexPositions(newPositions);
+
+  for (size_t iF = 0; iF < psMesh->nFaces(); iF++) {
+    EXPECT_NEAR(psMesh->faceAreas.getValue(iF), 4.f * faceAreas[iF], 1e-4);
+  }
+  for (size_t iV = 0; iV < psMesh->nVertices(); iV++) {
+    EXPECT_NEAR(psMesh->vertexAreas.getValue(iV), 4.f * vertexAreas[iV], 1e-4);
+    EXPECT_NEAR(glm::length(psMesh->vertexNormals.getValue(iV) - vertexNormals[iV]), 0.f, 1e-4);
+  }
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, SurfaceMeshPick) {
   auto psMesh = registerTriangleMesh();
 
@@ -118,6 +211,80 @@ TEST_F(PolyscopeTest, SurfaceMeshPick) {
   psMesh->setEdgeWidth(1.0);
   polyscope::pickAtBufferInds(glm::ivec2(77, 88));
 
+  // And with an explicit selection mode, which goes back to simple picking
+  psMesh->setSelectionMode(polyscope::MeshSelectionMode::VerticesOnly);
+  polyscope::pickAtBufferInds(glm::ivec2(77, 88));
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, SurfaceMeshRayCast) {
+  auto psMesh = registerTriangleMesh();
+
+  // face 3 lies in the y = 0 plane
+  polyscope::RayCastResult hit = polyscope::rayCast(glm::vec3{0.2, -1., 0.2}, glm::vec3{0., 2., 0.});
+  EXPECT_TRUE(hit.isHit);
+  EXPECT_EQ(psMesh, hit.structure);
+  EXPECT_EQ(3, hit.faceIndex);
+  EXPECT_NEAR(1., hit.distance, 1e-5);
+  EXPECT_NEAR(0., hit.position.y, 1e-5);
+  EXPECT_NEAR(1., hit.baryCoords.x + hit.baryCoords.y + hit.baryCoords.z, 1e-5);
+
+  // pointing away, or too short
+  EXPECT_FALSE(polyscope::rayCast(glm::vec3{0.2, -1., 0.2}, glm::vec3{0., -1., 0.}).isHit);
+  EXPECT_FALSE(polyscope::rayCast(glm::vec3{0.2, -1., 0.2}, glm::vec3{0., 1., 0.}, 0.5).isHit);
+
+  // a slice plane cuts away the near side, so the ray hits face 2 (x + y + z = 1) from the inside
+  polyscope::SlicePlane* plane = polyscope::addSlicePlane();
+  plane->setPose(glm::vec3{0., 0.5, 0.}, glm::vec3{0., 1., 0.});
+  hit = polyscope::rayCast(glm::vec3{0.2, -1., 0.2}, glm::vec3{0., 1., 0.});
+  EXPECT_EQ(2, hit.faceIndex);
+  EXPECT_NEAR(1.6, hit.distance, 1e-5);
+  polyscope::removeAllSlicePlanes();
+
+  // follows the transform and geometry updates
+  psMesh->translate(glm::vec3{0., 1., 0.});
+  EXPECT_NEAR(2., polyscope::rayCast(glm::vec3{0.2, -1., 0.2}, glm::vec3{0., 1., 0.}).distance, 1e-5);
+  psMesh->resetTransform();
+  std::vector<glm::vec3> points;
+  std::vector<std::vector<size_t>> faces;
+  std::tie(points, faces) = getTriangleMesh();
+  for (glm::vec3& p : points) p.y -= 0.5;
+  psMesh->updateVertexPositions(points);
+  EXPECT_NEAR(0.5, polyscope::rayCast(glm::vec3{0.2, -1., 0.2}, glm::vec3{0., 1., 0.}).distance, 1e-5);
+
+  // simple triangle meshes too
+  polyscope::removeAllStructures();
+  registerSimpleTriangleMesh();
+  EXPECT_TRUE(polyscope::rayCast(glm::vec3{0.2, -1., 0.2}, glm::vec3{0., 1., 0.}).isHit);
+
+  // pick with ray casts rather than the pick buffer
+  polyscope::options::pickWithRayCast = true;
+  polyscope::pickAtBufferInds(glm::ivec2(77, 88));
+  polyscope::pickAtScreenCoordsAsync(glm::vec2{0.3, 0.8})->getResult();
+  polyscope::removeAllStructures();
+  psMesh = registerTriangleMesh();
+  polyscope::PickResult pickResult = polyscope::pickAtScreenCoords(glm::vec2{0.3, 0.8});
+  if (pickResult.isHit) psMesh->interpretPickResult(pickResult);
+  polyscope::options::pickWithRayCast = false;
+
+  // ray cast picks resolve to the nearest vertex within the pick radius, and to the face otherwise
+  pickResult = polyscope::PickResult();
+  pickResult.isHit = true;
+  pickResult.structure = psMesh;
+  hit = polyscope::rayCast(glm::vec3{0.05, -1., 0.05}, glm::vec3{0., 1., 0.});
+  pickResult.localIndex = psMesh->rayCastPickIndex(hit);
+  pickResult.position = hit.position;
+  polyscope::SurfaceMeshPickResult meshPick = psMesh->interpretPickResult(pickResult);
+  EXPECT_EQ(polyscope::MeshElement::VERTEX, meshPick.elementType);
+  EXPECT_EQ(3, meshPick.index);
+  hit = polyscope::rayCast(glm::vec3{0.2, -1., 0.2}, glm::vec3{0., 1., 0.});
+  pickResult.localIndex = psMesh->rayCastPickIndex(hit);
+  pickResult.position = hit.position;
+  meshPick = psMesh->interpretPickResult(pickResult);
+  EXPECT_EQ(polyscope::MeshElement::FACE, meshPick.elementType);
+  EXPECT_EQ(3, meshPick.index);
+
   polyscope::removeAllStructures();
 }
 
@@ -171,6 +338,296 @@ TEST_F(PolyscopeTest, SurfaceMeshBackface) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, SurfaceMeshMeshletCulling) {
+
+  // a single triangle facing +z
+  std::vector<glm::vec3> positions = {{0., 0., 0.}, {1., 0., 0.}, {0., 1., 0.}};
+  std::vector<uint32_t> triInds = {0, 1, 2};
+  std::vector<polyscope::Meshlet> meshlets = polyscope::buildMeshlets(positions, triInds);
+  ASSERT_EQ(meshlets.size(), 1u);
+  EXPECT_EQ(meshlets[0].triangleCount, 1u);
+  EXPECT_LT(meshlets[0].coneCutoff, 1.f);
+
+  glm::mat4 viewMat = glm::lookAt(glm::vec3{0., 0., 5.}, glm::vec3{0., 0., 0.}, glm::vec3{0., 1., 0.});
+  glm::mat4 projMat = glm::perspective(glm::radians(45.f), 1.f, 0.1f, 100.f);
+  std::vector<std::array<glm::vec3, 2>> noPlanes;
+
+  // visible from the front
+  polyscope::MeshletCullView front =
+      polyscope::buildMeshletCullView(glm::mat4(1.), viewMat, projMat, false, noPlanes, true);
+  EXPECT_EQ(polyscope::cullMeshlets(meshlets, front).size(), 1u);
+
+  // back-facing, only culled if back faces are
+  glm::mat4 flip = glm::rotate(glm::mat4(1.), glm::pi<float>(), glm::vec3{0., 1., 0.});
+  polyscope::MeshletCullView back = polyscope::buildMeshletCullView(flip, viewMat, projMat, false, noPlanes, true);
+  EXPECT_EQ(polyscope::cullMeshlets(meshlets, back).size(), 0u);
+  back = polyscope::buildMeshletCullView(flip, viewMat, projMat, false, noPlanes, false);
+  EXPECT_EQ(polyscope::cullMeshlets(meshlets, back).size(), 1u);
+
+  // outside the frustum
+  glm::mat4 away = glm::translate(glm::mat4(1.), glm::vec3{100., 0., 0.});
+  polyscope::MeshletCullView outside = polyscope::buildMeshletCullView(away, viewMat, projMat, false, noPlanes, false);
+  EXPECT_EQ(polyscope::cullMeshlets(meshlets, outside).size(), 0u);
+
+  // cut away by a slice plane
+  std::vector<std::array<glm::vec3, 2>> planes = {{glm::vec3{5., 0., 0.}, glm::vec3{1., 0., 0.}}};
+  polyscope::MeshletCullView sliced =
+      polyscope::buildMeshletCullView(glm::mat4(1.), viewMat, projMat, false, planes, false);
+  EXPECT_EQ(polyscope::cullMeshlets(meshlets, sliced).size(), 0u);
+
+  // on a registered mesh, with quantities, picking, and slice planes
+  auto psMesh = registerTriangleMesh();
+  psMesh->setMeshletCulling(true);
+  EXPECT_TRUE(psMesh->getMeshletCulling());
+  polyscope::show(3);
+
+  std::vector<double> vScalar(psMesh->nVertices(), 7.);
+  psMesh->addVertexScalarQuantity("vScalar", vScalar)->setEnabled(true);
+  psMesh->setBackFacePolicy(polyscope::BackFacePolicy::Cull);
+  polyscope::show(3);
+  polyscope::pickAtScreenCoords(glm::vec2{0.3, 0.8});
+
+  polyscope::addSlicePlane();
+  polyscope::show(3);
+  polyscope::removeAllSlicePlanes();
+
+  // together with indexed rendering, flat shading, and edges
+  psMesh->setIndexedRendering(true);
+  psMesh->setShadeStyle(polyscope::MeshShadeStyle::Flat);
+  psMesh->setEdgeWidth(1.);
+  polyscope::show(3);
+  polyscope::pickAtScreenCoords(glm::vec2{0.3, 0.8});
+  psMesh->setIndexedRendering(false);
+
+  psMesh->setMeshletCulling(false);
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, SurfaceMeshLevelOfDetail) {
+
+  // a wavy grid, big enough to simplify
+  size_t N = 64;
+  std::vector<glm::vec3> positions;
+  std::vector<std::array<size_t, 3>> faces;
+  std::vector<uint32_t> triInds;
+  for (size_t i = 0; i < N; i++) {
+    for (size_t j = 0; j < N; j++) {
+      positions.push_back(glm::vec3{i, j, std::sin(0.2 * i) + std::cos(0.3 * j)});
+    }
+  }
+  for (size_t i = 0; i + 1 < N; i++) {
+    for (size_t j = 0; j + 1 < N; j++) {
+      size_t v = i * N + j;
+      faces.push_back({v, v + N, v + 1});
+      faces.push_back({v + 1, v + N, v + N + 1});
+    }
+  }
+  for (std::array<size_t, 3>& f : faces) {
+    for (size_t k = 0; k < 3; k++) triInds.push_back(static_cast<uint32_t>(f[k]));
+  }
+
+  // each level is coarser than the last, and made of the original vertices
+  std::vector<polyscope::SimplifiedMeshLevel> levels = polyscope::buildSimplifiedMeshHierarchy(positions, triInds);
+  ASSERT_GT(levels.size(), 0u);
+  size_t prevCount = triInds.size();
+  float prevError = 0.;
+  for (polyscope::SimplifiedMeshLevel& level : levels) {
+    EXPECT_LT(level.triangleVertexInds.size(), prevCount);
+    EXPECT_GT(level.error, prevError);
+    for (uint32_t iV : level.triangleVertexInds) EXPECT_LT(iV, positions.size());
+    prevCount = level.triangleVertexInds.size();
+    prevError = level.error;
+  }
+
+  // a cancelled build returns nothing
+  std::atomic<bool> cancel{true};
+  EXPECT_EQ(polyscope::buildSimplifiedMeshHierarchy(positions, triInds, 1024, 8, &cancel).size(), 0u);
+
+  // on a registered mesh
+  polyscope::SurfaceMesh* psMesh = polyscope::registerSurfaceMesh("lod", positions, faces);
+  psMesh->setLevelOfDetailBackgroundBuild(false);
+  psMesh->setLevelOfDetail(true);
+  psMesh->setLevelOfDetailPixelError(1e6); // always the coarsest level
+  polyscope::show(3);
+  EXPECT_EQ(psMesh->getCurrentLevelOfDetail(), levels.size());
+
+  // vertex quantities draw on the simplified mesh, others on the full mesh
+  std::vector<double> vScalar(psMesh->nVertices(), 7.);
+  psMesh->addVertexScalarQuantity("vScalar", vScalar)->setEnabled(true);
+  polyscope::show(3);
+  std::vector<double> fScalar(psMesh->nFaces(), 7.);
+  psMesh->addFaceScalarQuantity("fScalar", fScalar)->setEnabled(true);
+  polyscope::show(3);
+  polyscope::pickAtScreenCoords(glm::vec2{0.3, 0.8});
+
+  // with meshlet culling, and in the background
+  psMesh->setMeshletCulling(true);
+  psMesh->setLevelOfDetailPixelError(1.);
+  psMesh->setLevelOfDetailBackgroundBuild(true);
+  psMesh->updateVertexPositions(positions);
+  polyscope::show(3);
+
+  psMesh->setLevelOfDetail(false);
+  polyscope::show(3);
+  EXPECT_EQ(psMesh->getCurrentLevelOfDetail(), 0u);
+
+  // removing the mesh while a background build is running does not wait for it
+  psMesh->setLevelOfDetail(true);
+  polyscope::show(1);
+  polyscope::removeAllStructures();
+  psMesh = polyscope::registerSurfaceMesh("lod", positions, faces);
+  psMesh->setLevelOfDetail(true);
+  polyscope::show(1);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, SurfaceMeshDrawOrder) {
+
+  // a wavy grid of quads
+  size_t N = 32;
+  std::vector<glm::vec3> positions;
+  std::vector<std::vector<size_t>> faces;
+  std::vector<uint32_t> faceStart = {0};
+  std::vector<uint32_t> faceInds;
+  for (size_t i = 0; i < N; i++) {
+    for (size_t j = 0; j < N; j++) {
+      positions.push_back(glm::vec3{i, j, std::sin(0.2 * i) + std::cos(0.3 * j)});
+    }
+  }
+  for (size_t i = 0; i + 1 < N; i++) {
+    for (size_t j = 0; j + 1 < N; j++) {
+      size_t v = i * N + j;
+      faces.push_back({v, v + N, v + N + 1, v + 1});
+      for (size_t iV : faces.back()) faceInds.push_back(static_cast<uint32_t>(iV));
+      faceStart.push_back(static_cast<uint32_t>(faceInds.size()));
+    }
+  }
+
+  // the order is a permutation of the faces (small blocks, to get several of them)
+  std::vector<uint32_t> order = polyscope::computeFaceDrawOrder(positions, faceStart, faceInds, 100);
+  ASSERT_EQ(order.size(), faces.size());
+  std::sort(order.begin(), order.end());
+  for (size_t i = 0; i < order.size(); i++) EXPECT_EQ(order[i], i);
+
+  polyscope::options::optimizeMeshDrawOrder = true;
+
+  // on a registered mesh, the triangles of each face are still found at faceTriangleStart
+  polyscope::SurfaceMesh* psMesh = polyscope::registerSurfaceMesh("draw order", positions, faces);
+  for (size_t iF = 0; iF < psMesh->nFaces(); iF++) {
+    for (size_t k = 0; k < 6; k++) {
+      EXPECT_EQ(psMesh->triangleFaceInds.data[3 * psMesh->faceTriangleStart[iF] + k], iF);
+    }
+  }
+  std::vector<double> vScalar(psMesh->nVertices(), 7.);
+  psMesh->addVertexScalarQuantity("vScalar", vScalar)->setEnabled(true);
+  std::vector<double> fScalar(psMesh->nFaces(), 7.);
+  psMesh->addFaceScalarQuantity("fScalar", fScalar)->setEnabled(true);
+  polyscope::show(3);
+  polyscope::pickAtScreenCoords(glm::vec2{0.3, 0.8});
+
+  // edges, which are matched up through the triangulation
+  auto psTriMesh = registerTriangleMesh("tri draw order");
+  std::vector<size_t> ePerm = {5, 3, 1, 2, 4, 0};
+  psTriMesh->setEdgePermutation(ePerm);
+  std::vector<double> eScalar(ePerm.size(), 9.);
+  psTriMesh->addEdgeScalarQuantity("eScalar", eScalar)->setEnabled(true);
+  polyscope::show(3);
+
+  // the edge numbering of each face does not depend on the draw order
+  std::vector<std::vector<size_t>> triFaces;
+  for (const std::vector<size_t>& f : faces) {
+    triFaces.push_back({f[0], f[1], f[2]});
+    triFaces.push_back({f[0], f[2], f[3]});
+  }
+  std::vector<std::vector<uint32_t>> faceEdges(2);
+  for (int iOpt = 0; iOpt < 2; iOpt++) {
+    polyscope::options::optimizeMeshDrawOrder = (iOpt == 1);
+    polyscope::SurfaceMesh* psTriGrid =
+        polyscope::registerSurfaceMesh("tri grid draw order " + std::to_string(iOpt), positions, triFaces);
+    std::vector<size_t> identityPerm(psTriGrid->nEdges());
+    for (size_t i = 0; i < identityPerm.size(); i++) identityPerm[i] = i;
+    psTriGrid->setEdgePermutation(identityPerm);
+    psTriGrid->triangleAllEdgeInds.ensureHostBufferPopulated();
+    for (size_t iF = 0; iF < psTriGrid->nFaces(); iF++) {
+      for (size_t k = 0; k < 3; k++) {
+        faceEdges[iOpt].push_back(psTriGrid->triangleAllEdgeInds.data[9 * psTriGrid->faceTriangleStart[iF] + k]);
+      }
+    }
+  }
+  EXPECT_EQ(faceEdges[0], faceEdges[1]);
+  polyscope::options::optimizeMeshDrawOrder = true;
+
+  // the other meshes
+  registerSimpleTriangleMesh("simple draw order");
+  std::vector<glm::vec3> verts;
+  std::vector<std::array<int, 8>> cells;
+  std::tie(verts, cells) = getVolumeMeshData();
+  polyscope::registerVolumeMesh("vol draw order", verts, cells);
+  polyscope::show(3);
+  polyscope::pickAtScreenCoords(glm::vec2{0.3, 0.8});
+
+  polyscope::options::optimizeMeshDrawOrder = false;
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, SurfaceMeshInstances) {
+  auto psMesh = registerTriangleMesh();
+
+  std::vector<glm::mat4> transforms;
+  for (int i = 0; i < 5; i++) {
+    transforms.push_back(glm::translate(glm::mat4(1.), glm::vec3{2. * i, 0., 0.}));
+  }
+
+  polyscope::SurfaceMeshInstances* psInst = polyscope::registerSurfaceMeshInstances("inst", psMesh, transforms);
+  EXPECT_EQ(psInst->nInstances(), transforms.size());
+  EXPECT_TRUE(polyscope::hasSurfaceMeshInstances("inst"));
+  polyscope::show(3);
+
+  // per-instance colors
+  std::vector<glm::vec3> colors(transforms.size(), glm::vec3{.2, .3, .4});
+  psInst->updateInstanceColors(colors);
+  polyscope::show(3);
+  polyscope::pickAtScreenCoords(glm::vec2{0.3, 0.8});
+
+  // options
+  psInst->setEdgeWidth(1.);
+  psInst->setBackFacePolicy(polyscope::BackFacePolicy::Custom);
+  polyscope::show(3);
+  polyscope::addSceneSlicePlane();
+  polyscope::show(3);
+  polyscope::removeLastSceneSlicePlane();
+
+  // culling follows the base mesh as it moves out of view and back
+  polyscope::view::resetCameraToHomeView();
+  glm::mat4 viewProjMat = polyscope::view::getCameraPerspectiveMatrix() * polyscope::view::getCameraViewMatrix();
+  std::vector<glm::vec3> positions = psMesh->vertexPositions.data;
+  std::vector<glm::vec3> farPositions = positions;
+  for (glm::vec3& p : farPositions) p += glm::vec3{1e6, 0., 0.};
+  psMesh->updateVertexPositions(farPositions);
+  EXPECT_TRUE(psMesh->isCulledByFrustum(viewProjMat));
+  EXPECT_TRUE(psInst->isCulledByFrustum(viewProjMat));
+  polyscope::show(3);
+  psMesh->updateVertexPositions(positions);
+  EXPECT_FALSE(psMesh->isCulledByFrustum(viewProjMat));
+  EXPECT_FALSE(psInst->isCulledByFrustum(viewProjMat));
+  polyscope::show(3);
+  EXPECT_EQ(polyscope::getCullingStats().culledByFrustum, 0u);
+
+  // follows changes to the base mesh, and draws nothing once it is gone
+  transforms[0] = glm::mat4(1.);
+  psInst->updateInstanceTransforms(transforms);
+  psMesh->setShadeStyle(polyscope::MeshShadeStyle::Flat);
+  polyscope::show(3);
+  polyscope::removeStructure(psMesh);
+  EXPECT_FALSE(psInst->hasBaseMesh());
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, SurfaceMeshColorVertex) {
   auto psMesh = registerTriangleMesh();
   std::vector<glm::vec3> vColors(psMesh->nVertices(), glm::vec3{.2, .3, .4});
@@ -271,6 +728,37 @@ TEST_F(PolyscopeTest, SurfaceMeshScalarEdge) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, SurfaceMeshEdgeTopology) {
+
+  // edges are numbered in order of first appearance
+  std::vector<uint32_t> triInds = {1, 3, 2, 3, 1, 0, 2, 0, 1, 0, 2, 3};
+  polyscope::EdgeTopology topology = polyscope::buildEdgeTopology(triInds, 4, true);
+  EXPECT_EQ(topology.nEdges, 6u);
+  std::vector<uint32_t> expectedEdges = {0, 1, 2, 0, 3, 4, 5, 3, 2, 5, 1, 4};
+  EXPECT_EQ(topology.halfedgeEdge, expectedEdges);
+  for (size_t iHe = 0; iHe < triInds.size(); iHe++) {
+    uint32_t twin = topology.halfedgeTwin[iHe];
+    ASSERT_NE(twin, polyscope::INVALID_IND_32);
+    EXPECT_EQ(topology.halfedgeTwin[twin], iHe);
+    EXPECT_EQ(topology.halfedgeEdge[twin], topology.halfedgeEdge[iHe]);
+  }
+
+  // boundary edges have no twin
+  std::vector<uint32_t> singleTri = {0, 1, 2};
+  polyscope::EdgeTopology topologySingle = polyscope::buildEdgeTopology(singleTri, 3, true);
+  EXPECT_EQ(topologySingle.nEdges, 3u);
+  EXPECT_EQ(topologySingle.halfedgeTwin[0], polyscope::INVALID_IND_32);
+
+  EXPECT_THROW(polyscope::buildEdgeTopology(triInds, 3), std::runtime_error);
+
+  // the mesh uses the same enumeration
+  auto psMesh = registerTriangleMesh();
+  EXPECT_EQ(psMesh->nEdges(), 6u);
+  psMesh->ensureHaveManifoldConnectivity();
+  EXPECT_EQ(psMesh->twinHalfedge.size(), psMesh->nHalfedges());
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, SurfaceMeshScalarCategoricalEdge) {
   auto psMesh = registerTriangleMesh();
   size_t nEdges = 6;
@@ -129,6 +129,41 @@ TEST_F(PolyscopeTest, VolumeMeshPick) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, VolumeMeshRayCast) {
+  std::vector<glm::vec3> verts;
+  std::vector<std::array<int, 8>> cells;
+  std::tie(verts, cells) = getVolumeMeshData();
+  polyscope::VolumeMesh* psVol = polyscope::registerVolumeMesh("vol", verts, cells);
+
+  // the bottom of the hex cell
+  polyscope::RayCastResult hit = polyscope::rayCast(glm::vec3{0.3, 0.4, -1.}, glm::vec3{0., 0., 1.});
+  EXPECT_TRUE(hit.isHit);
+  EXPECT_EQ(psVol, hit.structure);
+  EXPECT_EQ(0, hit.cellIndex);
+  EXPECT_NEAR(1., hit.distance, 1e-5);
+
+  polyscope::options::pickWithRayCast = true;
+  polyscope::PickResult pickResult = polyscope::pickAtScreenCoords(glm::vec2{0.3, 0.8});
+  if (pickResult.isHit) psVol->interpretPickResult(pickResult);
+  polyscope::options::pickWithRayCast = false;
+
+  // ray cast picks resolve to the nearest vertex within the pick radius, and to the cell otherwise
+  pickResult = polyscope::PickResult();
+  pickResult.isHit = true;
+  pickResult.structure = psVol;
+  pickResult.localIndex = psVol->rayCastPickIndex(hit);
+  polyscope::VolumeMeshPickResult volPick = psVol->interpretPickResult(pickResult);
+  EXPECT_EQ(polyscope::VolumeMeshElement::CELL, volPick.elementType);
+  EXPECT_EQ(0, volPick.index);
+  hit = polyscope::rayCast(glm::vec3{0.05, 0.05, -1.}, glm::vec3{0., 0., 1.});
+  pickResult.localIndex = psVol->rayCastPickIndex(hit);
+  volPick = psVol->interpretPickResult(pickResult);
+  EXPECT_EQ(polyscope::VolumeMeshElement::VERTEX, volPick.elementType);
+  EXPECT_EQ(0, volPick.index);
+
+  polyscope::removeAllStructures();
+}
+
 
 TEST_F(PolyscopeTest, VolumeMeshColorVertex) {
   std::vector<glm::vec3> verts;
@@ -234,6 +269,32 @@ TEST_F(PolyscopeTest, VolumeMeshCellVector) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, VolumeMeshCullingFollowsUpdatedPositions) {
+  std::vector<glm::vec3> verts;
+  std::vector<std::array<int, 8>> cells;
+  std::tie(verts, cells) = getVolumeMeshData();
+  polyscope::VolumeMesh* psVol = polyscope::registerVolumeMesh("vol", verts, cells);
+  polyscope::view::resetCameraToHomeView();
+  glm::mat4 viewProjMat = polyscope::view::getCameraPerspectiveMatrix() * polyscope::view::getCameraViewMatrix();
+
+  // updated to positions far away, it is out of view
+  std::vector<glm::vec3> farVerts = verts;
+  for (glm::vec3& p : farVerts) p += glm::vec3{1e6, 0., 0.};
+  psVol->updateVertexPositions(farVerts);
+  EXPECT_TRUE(psVol->isCulledByFrustum(viewProjMat));
+  polyscope::show(3);
+  EXPECT_EQ(polyscope::getCullingStats().culledByFrustum, 1u);
+
+  // and back in to view, it is drawn again
+  psVol->updateVertexPositions(verts);
+  EXPECT_FALSE(psVol->isCulledByFrustum(viewProjMat));
+  polyscope::show(3);
+  EXPECT_EQ(polyscope::getCullingStats().structuresTested, 1u);
+  EXPECT_EQ(polyscope::getCullingStats().culledByFrustum, 0u);
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, VolumeMeshInspect) {
 
   // in another test below we repeat the same logic, but with a second mesh present